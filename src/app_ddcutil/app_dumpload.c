@@ -43,6 +43,7 @@
 
 #include "ddc/ddc_displays.h"
 #include "ddc/ddc_dumpload.h"
+#include "ddc/ddc_dumpload_binary.h"
 #include "ddc/ddc_output.h"
 #include "ddc/ddc_packet_io.h"
 #include "ddc/ddc_read_capabilities.h"
@@ -103,12 +104,113 @@ char * create_simple_vcp_fn_by_dh(
 
 
 
+/** Reports the errors found in a binary profile store.
+ *
+ *  \param  err  #Error_Info returned by a ddc_dumpload_binary.c function
+ *  \param  fn   file name
+ */
+static void
+report_binary_profile_errors(Error_Info * err, const char * fn) {
+   FILE * ferr = stderr;
+   f0printf(ferr, "Invalid data in %s:\n", fn);
+   if (err->cause_ct == 0)
+      f0printf(ferr, "   %s\n", (err->detail) ? err->detail : psc_desc(err->status_code));
+   for (int ndx = 0; ndx < err->cause_ct; ndx++)
+      f0printf(ferr, "   %s\n", err->causes[ndx]->detail);
+}
+
+
+/** Adds the profile for one monitor to a binary profile store.
+ *
+ *  If the file already exists it must be a binary profile store.  Any
+ *  existing section for the same EDID is replaced, other sections are
+ *  retained.
+ *
+ *  \param  data      profile to write
+ *  \param  filename  name of binary profile store
+ *  \return status code
+ */
+static Status_Errno_DDC
+dumpvcp_as_binary_file(Dumpload_Data * data, const char * filename)
+{
+   bool debug = false;
+   DBGMSF(debug, "Starting. filename=%s", filename);
+   FILE * ferr = stderr;
+   Status_Errno_DDC ddcrc = 0;
+   GPtrArray * existing_profiles = NULL;
+
+   if (regular_file_exists(filename)) {
+      GByteArray * existing = read_binary_file(filename, 0, false);
+      if (!existing || !is_dumpload_binary(existing->data, existing->len)) {
+         f0printf(ferr, "Not a binary profile store, will not overwrite: %s\n", filename);
+         ddcrc = DDCRC_BAD_DATA;
+      }
+      else {
+         Error_Info * err = create_dumpload_data_array_from_binary(
+                               existing->data, existing->len, &existing_profiles);
+         if (err) {
+            report_binary_profile_errors(err, filename);
+            ddcrc = err->status_code;
+            errinfo_free(err);
+         }
+      }
+      if (existing)
+         g_byte_array_free(existing, true);
+   }
+
+   if (ddcrc == 0) {
+      int existing_ct = (existing_profiles) ? existing_profiles->len : 0;
+      Dumpload_Data ** profiles = calloc(existing_ct+1, sizeof(Dumpload_Data*));
+      int profile_ct = 0;
+      for (int ndx = 0; ndx < existing_ct; ndx++) {
+         Dumpload_Data * cur = g_ptr_array_index(existing_profiles, ndx);
+         if (memcmp(cur->edidbytes, data->edidbytes, 128) != 0)
+            profiles[profile_ct++] = cur;
+      }
+      profiles[profile_ct++] = data;
+
+      Buffer * buf = dumpload_data_to_binary(profiles, profile_ct);
+      free(profiles);
+
+      // write a temporary file and rename it, so that a failed write
+      // does not destroy the profiles already in the store
+      char * tmpfn = g_strdup_printf("%s.%d.tmp", filename, getpid());
+      FILE * output_fp = NULL;
+      ddcrc = fopen_mkdir(tmpfn, "w", ferr, &output_fp);
+      if (output_fp) {
+         errno = 0;
+         bool ok = fwrite(buf->bytes, 1, buf->len, output_fp) == buf->len;
+         ok = (fclose(output_fp) == 0) && ok;
+         if (ok && rename(tmpfn, filename) < 0)
+            ok = false;
+         if (!ok) {
+            int errsv = (errno) ? errno : EIO;
+            ddcrc = -errsv;
+            f0printf(ferr, "Error writing %s: %s\n", filename, strerror(errsv));
+            unlink(tmpfn);
+         }
+      }
+      g_free(tmpfn);
+      buffer_free(buf, __func__);
+   }
+
+   if (existing_profiles)
+      g_ptr_array_free(existing_profiles, true);
+   DBGMSF(debug, "Returning: %s", psc_desc(ddcrc));
+   return ddcrc;
+}
+
+
 /** Executes the DUMPVCP command, writing the output to a file.
  *
  *  \param  dh        display handle
  *  \param  filename  name of file to write to,
  *                    if NULL, the file name is generated
  *  \return status code
+ *
+ *  \remark
+ *  If the file name ends in #DUMPLOAD_BINARY_SUFFIX, the data is added
+ *  to a binary profile store instead of being written in text form.
  */
 Status_Errno_DDC
 dumpvcp_as_file(Display_Handle * dh, const char * filename)
@@ -123,7 +225,11 @@ dumpvcp_as_file(Display_Handle * dh, const char * filename)
 
    Dumpload_Data * data = NULL;
    ddcrc = dumpvcp_as_dumpload_data(dh, &data);
-   if (ddcrc == 0) {
+   if (ddcrc == 0 && filename && str_ends_with(filename, DUMPLOAD_BINARY_SUFFIX)) {
+      ddcrc = dumpvcp_as_binary_file(data, filename);
+      free_dumpload_data(data);
+   }
+   else if (ddcrc == 0) {
       GPtrArray * strings = convert_dumpload_data_to_string_array(data);
       FILE * output_fp = NULL;
 
@@ -229,6 +335,83 @@ read_vcp_file(const char * fn)
 }
 
 
+/** Checks whether a file is a binary profile store.
+ *
+ *  \param  fn  file name
+ *  \return true/false
+ */
+static bool
+is_binary_profile_file(const char * fn) {
+   bool result = false;
+   FILE * fp = fopen(fn, "r");
+   if (fp) {
+      Byte magic[DUMPLOAD_BINARY_MAGIC_LEN];
+      if (fread(magic, 1, sizeof(magic), fp) == sizeof(magic))
+         result = (memcmp(magic, DUMPLOAD_BINARY_MAGIC, sizeof(magic)) == 0);
+      fclose(fp);
+   }
+   return result;
+}
+
+
+/** Reads the profile for a single monitor from a binary profile store.
+ *
+ *  \param  fn  file name
+ *  \param  dh  if non-NULL, select the profile for this display,
+ *              otherwise select the profile of the first detected
+ *              display having a profile in the store
+ *  \return pointer to newly allocated #Dumpload_Data struct,
+ *          NULL if no profile found or invalid data.
+ *          Caller is responsible for freeing
+ */
+Dumpload_Data *
+read_binary_vcp_file(const char * fn, Display_Handle * dh)
+{
+   FILE * ferr = stderr;
+   bool debug = false;
+   DBGMSF(debug, "Starting. fn=%s, dh=%s", fn, dh_repr_t(dh));
+
+   Dumpload_Data * data = NULL;
+   GByteArray * bytes = read_binary_file(fn, 0, false);
+   if (!bytes) {
+      f0printf(ferr, "%s: %s\n", strerror(errno), fn);
+      goto bye;
+   }
+
+   Error_Info * err = NULL;
+   int section_ndx = -1;
+   if (dh) {
+      err = dumpload_binary_find_section(bytes->data, bytes->len,
+                                         dh->dref->pedid->bytes, &section_ndx);
+   }
+   else {
+      GPtrArray * all_displays = ddc_get_all_displays();
+      for (int ndx = 0; ndx < all_displays->len && !err && section_ndx < 0; ndx++) {
+         Display_Ref * dref = g_ptr_array_index(all_displays, ndx);
+         if (dref->dispno > 0 && dref->pedid)
+            err = dumpload_binary_find_section(bytes->data, bytes->len,
+                                               dref->pedid->bytes, &section_ndx);
+      }
+   }
+   if (!err) {
+      if (section_ndx < 0)
+         f0printf(ferr, "No profile for %s in %s\n",
+                        (dh) ? "specified display" : "any connected display", fn);
+      else
+         err = create_dumpload_data_from_binary(bytes->data, bytes->len, section_ndx, &data);
+   }
+   if (err) {
+      report_binary_profile_errors(err, fn);
+      errinfo_free(err);
+   }
+   g_byte_array_free(bytes, true);
+
+bye:
+   DBGMSF(debug, "Returning: %p  ", data );
+   return data;
+}
+
+
 /* Apply the VCP settings stored in a file to the monitor
  * indicated in that file.
  *
@@ -249,7 +432,9 @@ bool loadvcp_by_file(const char * fn, Display_Handle * dh) {
    Status_Errno_DDC ddcrc = 0;
    Error_Info * ddc_excp = NULL;
 
-   Dumpload_Data * pdata = read_vcp_file(fn);
+   Dumpload_Data * pdata = (is_binary_profile_file(fn))
+                                 ? read_binary_vcp_file(fn, dh)
+                                 : read_vcp_file(fn);
    if (!pdata) {
       // Redundant, read_vcp_file() issues message:
       // f0printf(ferr, "Unable to load VCP data from file: %s\n", fn);
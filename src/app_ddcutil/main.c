@@ -53,6 +53,7 @@
 #include "base/status_code_mgt.h"
 #include "base/thread_retry_data.h"
 #include "base/thread_sleep_data.h"
+#include "base/trace_ring.h"
 #include "base/tuned_sleep.h"
 
 #include "ddc/common_init.h"
@@ -124,6 +125,7 @@ report_performance_options(int depth)
       rpt_label(depth, "Performance and Retry Options:");
       rpt_vstring(d1, "Deferred sleep enabled:                      %s", sbool( is_deferred_sleep_enabled() ) );
       rpt_vstring(d1, "Sleep suppression (reduced sleeps) enabled:  %s", sbool( is_sleep_suppression_enabled() ) );
+      rpt_vstring(d1, "Idle aware sleep enabled:                    %s", sbool( is_idle_aware_sleep_enabled() ) );
       bool dsa_enabled =  tsd_get_dsa_enabled_default();
       rpt_vstring(d1, "Dynamic sleep adjustment enabled:            %s", sbool(dsa_enabled) );
       if ( dsa_enabled )
@@ -321,6 +323,8 @@ displayid_requirement_name(Displayid_Requirement id) {
  *  or, if a display is not optional for the command, a reference to the
  *  default display (--display 1).
  *
+ *  Where possible, the display is located without detecting all displays.
+ *
  *  \param  parsed_cmd  parsed command line
  *  \param  displayid_required how to handle no display specified on command line
  *  \param  dref_loc  where to return display reference
@@ -337,7 +341,6 @@ find_dref(
    DBGTRC(debug, TRACE_GROUP, "did: %s, set_default_display: %s",
                                     did_repr(parsed_cmd->pdid),
                                     displayid_requirement_name(displayid_required));
-   FILE * outf = fout();
    Status_Errno_DDC final_result = DDCRC_OK;
    Display_Ref * dref = NULL;
    Call_Options callopts = CALLOPT_ERR_MSG;        // emit error messages
@@ -345,50 +348,12 @@ find_dref(
       callopts |= CALLOPT_FORCE;
 
    Display_Identifier * did_work = parsed_cmd->pdid;
-   if (did_work && did_work->id_type == DISP_ID_BUSNO) {
-      DBGTRC(debug, DDCA_TRC_NONE, "Special handling for explicit --busno");
-      int busno = did_work->busno;
-      // is this really a monitor?
-      I2C_Bus_Info * businfo = i2c_detect_single_bus(busno);
-      if (businfo) {
-         if (businfo->flags & I2C_BUS_ADDR_0X50)  {
-            dref = create_bus_display_ref(busno);
-            dref->dispno = -1;     // should use some other value for unassigned vs invalid
-            dref->pedid = businfo->edid;    // needed?
-            dref->mmid  = monitor_model_key_new(
-                             dref->pedid->mfg_id,
-                             dref->pedid->model_name,
-                             dref->pedid->product_code);
-
-            // dref->pedid = i2c_get_parsed_edid_by_busno(did_work->busno);
-            dref->detail = businfo;
-            dref->flags |= DREF_DDC_IS_MONITOR_CHECKED;
-            dref->flags |= DREF_DDC_IS_MONITOR;
-            dref->flags |= DREF_TRANSIENT;
-            if (!ddc_initial_checks_by_dref(dref)) {
-               f0printf(outf, "DDC communication failed for monitor on bus /dev/i2c-%d\n", busno);
-               free_display_ref(dref);
-               i2c_free_bus_info(businfo);
-               dref = NULL;
-               final_result = DDCRC_INVALID_DISPLAY;
-            }
-            else {
-               DBGTRC(debug, TRACE_GROUP, "Synthetic Display_Ref");
-               final_result = DDCRC_OK;
-            }
-         }  // has edid
-         else {   // no EDID found
-            f0printf(fout(), "No monitor detected on bus /dev/i2c-%d\n", busno);
-            i2c_free_bus_info(businfo);
-            final_result = DDCRC_INVALID_DISPLAY;
-         }
-      }    // businfo allocated
-      else {
-         f0printf(fout(), "Bus /dev/i2c-%d not found\n", busno);
-         final_result = DDCRC_INVALID_DISPLAY;
-      }
-   }       // DISP_ID_BUSNO
-   else {
+   if (did_work) {
+      // try to locate the display without detecting every display
+      final_result = ddc_find_transient_display_ref(did_work, callopts, &dref);
+      DBGTRC(debug, TRACE_GROUP, "ddc_find_transient_display_ref() returned %s", psc_desc(final_result));
+   }
+   if (!did_work || final_result == DDCRC_UNIMPLEMENTED) {
       if (!did_work && displayid_required == DISPLAY_ID_OPTIONAL) {
          DBGTRC(debug, DDCA_TRC_NONE, "No monitor specified, none required for command");
          dref = NULL;
@@ -410,7 +375,7 @@ find_dref(
             free_display_identifier(did_work);
          final_result = (dref) ? DDCRC_OK : DDCRC_INVALID_DISPLAY;
       }
-   }  // !DISP_ID_BUSNO
+   }  // full detection
 
    *dref_loc = dref;
    DBGTRC(debug, TRACE_GROUP,
@@ -685,6 +650,11 @@ main(int argc, char *argv[]) {
       main_rc = (vcpinfo_ok) ? EXIT_SUCCESS : EXIT_FAILURE;
    }
 
+   else if (parsed_cmd->cmd_id == CMDID_TRACE_DECODE) {
+      bool decode_ok = trace_ring_decode_file(parsed_cmd->args[0]);
+      main_rc = (decode_ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+   }
+
 #ifdef INCLUDE_TESTCASES
    else if (parsed_cmd->cmd_id == CMDID_LISTTESTS) {
       show_test_cases();
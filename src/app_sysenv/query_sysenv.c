@@ -52,6 +52,7 @@
 #include "query_sysenv_i2c.h"
 #include "query_sysenv_logs.h"
 #include "query_sysenv_modules.h"
+#include "query_sysenv_probes.h"
 #include "query_sysenv_procfs.h"
 #include "query_sysenv_sysfs.h"
 #include "query_sysenv_xref.h"
@@ -99,6 +100,74 @@ static void report_endian(int depth) {
 }
 
 
+//
+// Probes run concurrently
+//
+
+// Timeouts for probes started by sysenv_start_probe()
+#define SYSENV_PROBE_TIMEOUT_MILLISEC      10000
+#define SYSENV_LOG_PROBE_TIMEOUT_MILLISEC  60000
+
+static void probe_cpu(Env_Accumulator * accum) {
+   int d0 = 0;
+   int d1 = d0+1;
+   rpt_nl();
+   rpt_vstring(d0,"Processor information as reported by lscpu:");
+   bool ok = execute_shell_cmd_rpt("lscpu", 1);
+   if (!ok) {   // lscpu should always be there, but just in case:
+      rpt_vstring(1, "Command lscpu not found");
+      rpt_nl();
+      rpt_title("Processor information from /proc/cpuinfo:", d0);
+      // uniq because entries for each processor of a mulit-processor cpu
+      execute_shell_cmd_rpt( "cat /proc/cpuinfo | grep vendor_id | uniq", d1);
+      execute_shell_cmd_rpt( "cat /proc/cpuinfo | grep \"cpu family\" | uniq", d1);
+      execute_shell_cmd_rpt( "cat /proc/cpuinfo | grep \"model[[:space:]][[:space:]]\" | uniq",  d1);   //  "model"
+      execute_shell_cmd_rpt( "cat /proc/cpuinfo | grep \"model name\" | uniq",  d1);   // "model name"
+   }
+}
+
+static void probe_dmi(Env_Accumulator * accum) {
+   rpt_nl();
+   if (accum->is_arm) {
+      rpt_vstring(0, "Skipping dmidecode checks on architecture %s.", accum->architecture);
+   }
+   else {
+      query_dmidecode();
+   }
+}
+
+static void probe_nvidia(Env_Accumulator * accum) {
+   rpt_nl();
+   query_proc_driver_nvidia();
+}
+
+static void probe_xrandr(Env_Accumulator * accum) {
+   rpt_nl();
+   rpt_vstring(0,"xrandr connection report:");
+   execute_shell_cmd_rpt("xrandr|grep connected", 1 /* depth */);
+   rpt_nl();
+}
+
+static void probe_conflicting_programs(Env_Accumulator * accum) {
+   rpt_vstring(0,"Checking for possibly conflicting programs...");
+   execute_shell_cmd_rpt("ps aux | grep ddccontrol | grep -v grep", 1);
+   rpt_nl();
+}
+
+static void probe_amdgpu_parameters(Env_Accumulator * accum) {
+   rpt_nl();
+   rpt_vstring(0, "amdgpu configuration parameters:");
+   if (driver_name_list_find_exact(accum->driver_list, "amdgpu")) {
+      query_sys_amdgpu_parameters(1);
+   }
+   rpt_nl();
+}
+
+static void probe_modprobe_d(Env_Accumulator * accum) {
+   probe_modules_d(0);
+}
+
+
 //
 // Higher level functions
 //
@@ -144,6 +213,14 @@ static void query_base_env(Env_Accumulator * accum) {
                         );
    free(release);
 
+   // CPU and DMI information cannot change without a reboot
+   Sysenv_Probe * cpu_probe = NULL;
+   Sysenv_Probe * dmi_probe = NULL;
+   if (get_output_level() >= DDCA_OL_VERBOSE) {
+      cpu_probe = sysenv_start_probe("cpu", probe_cpu, accum, SYSENV_PROBE_TIMEOUT_MILLISEC, true);
+      dmi_probe = sysenv_start_probe("dmi", probe_dmi, accum, SYSENV_PROBE_TIMEOUT_MILLISEC, true);
+   }
+
 #ifdef REDUNDANT
    rpt_nl();
    rpt_vstring(0,"/etc/os-release...");
@@ -170,27 +247,8 @@ static void query_base_env(Env_Accumulator * accum) {
       rpt_vstring(d1, "Not a gcc compatible compiler");
 #endif
 
-      rpt_nl();
-      rpt_vstring(d0,"Processor information as reported by lscpu:");
-        bool ok = execute_shell_cmd_rpt("lscpu", 1);
-        if (!ok) {   // lscpu should always be there, but just in case:
-           rpt_vstring(1, "Command lscpu not found");
-           rpt_nl();
-           rpt_title("Processor information from /proc/cpuinfo:", d0);
-           // uniq because entries for each processor of a mulit-processor cpu
-           execute_shell_cmd_rpt( "cat /proc/cpuinfo | grep vendor_id | uniq", d1);
-           execute_shell_cmd_rpt( "cat /proc/cpuinfo | grep \"cpu family\" | uniq", d1);
-           execute_shell_cmd_rpt( "cat /proc/cpuinfo | grep \"model[[:space:]][[:space:]]\" | uniq",  d1);   //  "model"
-           execute_shell_cmd_rpt( "cat /proc/cpuinfo | grep \"model name\" | uniq",  d1);   // "model name"
-       }
-
-       rpt_nl();
-        if (accum->is_arm) {
-           rpt_vstring(d0, "Skipping dmidecode checks on architecture %s.", accum->architecture);
-        }
-        else {
-           query_dmidecode();
-        }
+      sysenv_report_probe(cpu_probe);
+      sysenv_report_probe(dmi_probe);
 
       rpt_nl();
       report_endian(d0);
@@ -609,6 +667,30 @@ void query_sysenv() {
    rpt_nl();
    query_card_and_driver_using_sysfs(accumulator);
 
+   // Start slow probes that only read the accumulator, whose output
+   // is reported in its usual place below
+   Sysenv_Probe * nvidia_probe       = NULL;
+   Sysenv_Probe * xrandr_probe       = NULL;
+   Sysenv_Probe * conflicts_probe    = NULL;
+   Sysenv_Probe * amdgpu_probe       = NULL;
+   Sysenv_Probe * config_files_probe = NULL;
+   Sysenv_Probe * logs_probe         = NULL;
+   Sysenv_Probe * modprobe_d_probe   = NULL;
+   if (output_level >= DDCA_OL_VERBOSE) {
+      int timeout = SYSENV_PROBE_TIMEOUT_MILLISEC;
+      nvidia_probe    = sysenv_start_probe("nvidia",     probe_nvidia,               accumulator, timeout, false);
+      xrandr_probe    = sysenv_start_probe("xrandr",     probe_xrandr,               accumulator, timeout, false);
+      conflicts_probe = sysenv_start_probe("conflicts",  probe_conflicting_programs, accumulator, timeout, false);
+      amdgpu_probe    = sysenv_start_probe("amdgpu",     probe_amdgpu_parameters,    accumulator, timeout, false);
+      modprobe_d_probe= sysenv_start_probe("modprobe_d", probe_modprobe_d,           accumulator, timeout, false);
+#ifndef SYSENV_QUICK_TEST_RUN
+      config_files_probe = sysenv_start_probe("config_files", probe_config_files, accumulator,
+                                              SYSENV_LOG_PROBE_TIMEOUT_MILLISEC, false);
+      logs_probe         = sysenv_start_probe("logs",         probe_logs,         accumulator,
+                                              SYSENV_LOG_PROBE_TIMEOUT_MILLISEC, false);
+#endif
+   }
+
    rpt_nl();
    rpt_vstring(0,"*** Primary Check 2: Check that /dev/i2c-* exist and writable ***");
    rpt_nl();
@@ -659,20 +741,13 @@ void query_sysenv() {
    query_sys_bus_i2c(accumulator);
 
    if (output_level >= DDCA_OL_VERBOSE) {
-      rpt_nl();
-      query_proc_driver_nvidia();
+      sysenv_report_probe(nvidia_probe);
 
       rpt_nl();
       query_i2c_buses();
 
-      rpt_nl();
-      rpt_vstring(0,"xrandr connection report:");
-      execute_shell_cmd_rpt("xrandr|grep connected", 1 /* depth */);
-      rpt_nl();
-
-      rpt_vstring(0,"Checking for possibly conflicting programs...");
-      execute_shell_cmd_rpt("ps aux | grep ddccontrol | grep -v grep", 1);
-      rpt_nl();
+      sysenv_report_probe(xrandr_probe);
+      sysenv_report_probe(conflicts_probe);
 
       query_using_shell_command(accumulator->dev_i2c_device_numbers,
                                 "i2cdetect -y %d",   // command to issue
@@ -695,21 +770,13 @@ void query_sysenv() {
       // temp
       // get_i2c_smbus_devices_using_udev();
 
-      Driver_Name_Node * driver_list = accumulator->driver_list;
-      rpt_nl();
-      rpt_vstring(0, "amdgpu configuration parameters:");
-      if (driver_name_list_find_exact(driver_list, "amdgpu")) {
-         query_sys_amdgpu_parameters(1);
-      }
-      // else
-      //    rpt_vstring(0, "!!! not amdgpu");
-      rpt_nl();
+      sysenv_report_probe(amdgpu_probe);
 
 #ifdef SYSENV_QUICK_TEST_RUN
       DBGMSG("!!! Skipping config file and log checking to speed up testing !!!");
 #else
-      probe_config_files(accumulator);
-      probe_logs(accumulator);
+      sysenv_report_probe(config_files_probe);
+      sysenv_report_probe(logs_probe);
 #endif
 
 #ifdef USE_LIBDRM
@@ -722,7 +789,7 @@ void query_sysenv() {
 
       device_xref_report(0);
 
-      probe_modules_d(0);
+      sysenv_report_probe(modprobe_d_probe);
 
       dump_sysfs_i2c();
 
@@ -750,7 +817,9 @@ void query_sysenv() {
    rpt_nl();
    final_analysis(accumulator, 0);
 
-   env_accumulator_free(accumulator);     // make Coverity happy
+   // a probe that timed out may still be reading the accumulator
+   if (sysenv_abandoned_probe_count() == 0)
+      env_accumulator_free(accumulator);     // make Coverity happy
 
    DBGTRC(debug, TRACE_GROUP, "Done");
 }
@@ -761,5 +830,6 @@ void init_sysenv() {
    RTTI_ADD_FUNC(probe_i2c_devices_using_udev);
 #endif
    init_query_sysfs();
+   init_query_sysenv_probes();
 }
 
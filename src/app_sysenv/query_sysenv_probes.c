@@ -0,0 +1,302 @@
+/** @file query_sysenv_probes.c
+ *
+ *  Run environment probes concurrently, buffering the output of each.
+ *
+ *  Many probes of the ENVIRONMENT command execute external commands or
+ *  scan logs, and spend most of their time waiting.  A probe is started
+ *  on its own thread with its report output captured in a buffer.  The
+ *  buffered output is emitted at the point in the report where the probe
+ *  would have been executed serially, so the report is unchanged.
+ *
+ *  The output of probes reporting facts that cannot change without a
+ *  reboot, e.g. DMI information, can be cached between runs.  Since the
+ *  output may depend on the privileges of the user, e.g. some DMI values
+ *  are readable only by root, output is cached separately for each
+ *  effective user id.
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/** \cond */
+#include <assert.h>
+#include <glib-2.0/glib.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "util/file_util.h"
+#include "util/report_util.h"
+#include "util/string_util.h"
+#include "util/timestamp.h"
+#include "util/xdg_util.h"
+/** \endcond */
+
+#include "base/core.h"
+#include "base/rtti.h"
+
+#include "query_sysenv_probes.h"
+
+// Default trace class for this file
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_ENV;
+
+#define SYSENV_PROBE_MARKER "SEPR"
+struct Sysenv_Probe {
+   char               marker[4];
+   char *             name;
+   Sysenv_Probe_Func  func;
+   Env_Accumulator *  accum;
+   DDCA_Output_Level  output_level;     ///< output level of thread that started the probe
+   int                timeout_millisec;
+   bool               cache_until_reboot;
+   bool               from_cache;
+   gint64             start_time;       ///< g_get_monotonic_time() value
+   uint64_t           elapsed_nanos;
+   GThread *          thread;
+   GMutex             mutex;
+   GCond              cond;
+   bool               done;
+   bool               abandoned;        ///< timed out, probe thread frees the probe
+   char *             output;
+   size_t             output_size;
+};
+
+static gint abandoned_probe_ct = 0;     // abandoned probes whose function has not returned
+
+
+static void
+free_sysenv_probe(Sysenv_Probe * probe) {
+   assert(memcmp(probe->marker, SYSENV_PROBE_MARKER, 4) == 0);
+   probe->marker[3] = 'x';
+   if (probe->thread)
+      g_thread_unref(probe->thread);
+   g_mutex_clear(&probe->mutex);
+   g_cond_clear(&probe->cond);
+   free(probe->output);
+   free(probe->name);
+   free(probe);
+}
+
+
+//
+// Cached probe output
+//
+
+/** Returns the id of the current boot, which keys cached probe output */
+static char *
+get_boot_id() {
+   return file_get_first_line("/proc/sys/kernel/random/boot_id", /*verbose=*/ false);
+}
+
+
+static char *
+probe_cache_file_name(const char * probe_name) {
+   char * simple_fn = g_strdup_printf("sysenv_%s_%d", probe_name, (int) geteuid());
+   char * result = xdg_cache_home_file("ddcutil", simple_fn);
+   g_free(simple_fn);
+   return result;
+}
+
+
+/** Loads cached output for a probe, if it was saved during the current boot.
+ *
+ *  The first line of the cache file is the boot id.
+ */
+static bool
+load_cached_probe_output(Sysenv_Probe * probe) {
+   bool debug = false;
+   bool ok = false;
+   char * boot_id = get_boot_id();
+   char * fn = probe_cache_file_name(probe->name);
+   gchar * contents = NULL;
+   gsize   length = 0;
+   if (boot_id && fn && g_file_get_contents(fn, &contents, &length, NULL)) {
+      char * nl = memchr(contents, '\n', length);
+      if (nl && strlen(boot_id) == nl-contents && memcmp(contents, boot_id, nl-contents) == 0) {
+         probe->output_size = length - (nl+1-contents);
+         probe->output = malloc(probe->output_size+1);
+         memcpy(probe->output, nl+1, probe->output_size);
+         probe->output[probe->output_size] = '\0';
+         ok = true;
+      }
+      g_free(contents);
+   }
+   free(fn);
+   free(boot_id);
+   DBGTRC(debug, TRACE_GROUP, "probe=%s, returning %s", probe->name, sbool(ok));
+   return ok;
+}
+
+
+static void
+save_cached_probe_output(Sysenv_Probe * probe) {
+   bool debug = false;
+   char * boot_id = get_boot_id();
+   char * fn = probe_cache_file_name(probe->name);
+   if (boot_id && fn) {
+      FILE * fp = NULL;
+      fopen_mkdir(fn, "w", NULL, &fp);
+      if (fp) {
+         fprintf(fp, "%s\n", boot_id);
+         fwrite(probe->output, 1, probe->output_size, fp);
+         fclose(fp);
+      }
+   }
+   DBGTRC(debug, TRACE_GROUP, "probe=%s, fn=%s", probe->name, fn);
+   free(fn);
+   free(boot_id);
+}
+
+
+//
+// Probe execution
+//
+
+static gpointer
+sysenv_probe_thread_func(gpointer data) {
+   bool debug = false;
+   Sysenv_Probe * probe = data;
+   DBGTRC(debug, TRACE_GROUP, "Starting probe %s", probe->name);
+   set_output_level(probe->output_level);
+
+   char * buf = NULL;
+   size_t bufsz = 0;
+   FILE * fp = open_memstream(&buf, &bufsz);
+   uint64_t start = cur_realtime_nanosec();
+   if (fp) {
+      rpt_push_output_dest(fp);
+      set_fout(fp);
+      probe->func(probe->accum);
+      set_fout_to_default();
+      rpt_pop_output_dest();
+      fclose(fp);
+   }
+
+   g_mutex_lock(&probe->mutex);
+   probe->elapsed_nanos = cur_realtime_nanosec() - start;
+   probe->output = buf;
+   probe->output_size = bufsz;
+   probe->done = true;
+   bool abandoned = probe->abandoned;
+   g_cond_signal(&probe->cond);
+   g_mutex_unlock(&probe->mutex);
+
+   DBGTRC(debug, TRACE_GROUP, "Done. probe %s, elapsed millisec: %"PRIu64", abandoned=%s",
+                              probe->name, probe->elapsed_nanos/(1000*1000), sbool(abandoned));
+   if (abandoned) {
+      free_sysenv_probe(probe);
+      g_atomic_int_add(&abandoned_probe_ct, -1);
+   }
+   return NULL;
+}
+
+
+/** Starts a probe on a separate thread.
+ *
+ *  @param name               probe name, also names the cache file
+ *  @param func               function executing the probe
+ *  @param accum              accumulated environment information, only read by the probe
+ *  @param timeout_millisec   maximum time from start of the probe until its output is reported
+ *  @param cache_until_reboot if true, the probe output is cached, and reused
+ *                            until the system is rebooted
+ *  @return probe handle, to be passed to #sysenv_report_probe()
+ */
+Sysenv_Probe *
+sysenv_start_probe(
+      const char *       name,
+      Sysenv_Probe_Func  func,
+      Env_Accumulator *  accum,
+      int                timeout_millisec,
+      bool               cache_until_reboot)
+{
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP, "Starting. name=%s, timeout_millisec=%d, cache_until_reboot=%s",
+                              name, timeout_millisec, sbool(cache_until_reboot));
+   Sysenv_Probe * probe = calloc(1, sizeof(Sysenv_Probe));
+   memcpy(probe->marker, SYSENV_PROBE_MARKER, 4);
+   probe->name = strdup(name);
+   probe->func = func;
+   probe->accum = accum;
+   probe->output_level = get_output_level();
+   probe->timeout_millisec = timeout_millisec;
+   probe->cache_until_reboot = cache_until_reboot;
+   probe->start_time = g_get_monotonic_time();
+   g_mutex_init(&probe->mutex);
+   g_cond_init(&probe->cond);
+
+   if (cache_until_reboot && load_cached_probe_output(probe)) {
+      probe->from_cache = true;
+      probe->done = true;
+   }
+   else {
+      probe->thread = g_thread_new(name, sysenv_probe_thread_func, probe);
+   }
+   DBGTRC(debug, TRACE_GROUP, "Done. from_cache=%s", sbool(probe->from_cache));
+   return probe;
+}
+
+
+/** Waits for a probe to complete, and writes its buffered output to the
+ *  current report destination.
+ *
+ *  If the probe does not complete within its timeout, a message is reported
+ *  instead.  The probe thread is left to finish on its own, and its output
+ *  is discarded.  Until it finishes, the #Env_Accumulator passed to
+ *  #sysenv_start_probe() must not be freed.  See #sysenv_abandoned_probe_count().
+ *
+ *  @param probe  probe handle returned by #sysenv_start_probe(),
+ *                no longer valid after this call
+ */
+void
+sysenv_report_probe(Sysenv_Probe * probe) {
+   bool debug = false;
+   assert(probe && memcmp(probe->marker, SYSENV_PROBE_MARKER, 4) == 0);
+   DBGTRC(debug, TRACE_GROUP, "Starting. probe=%s", probe->name);
+
+   gint64 end_time = probe->start_time + (gint64) probe->timeout_millisec * 1000;
+   g_mutex_lock(&probe->mutex);
+   while (!probe->done) {
+      if (!g_cond_wait_until(&probe->cond, &probe->mutex, end_time))
+         break;
+   }
+   bool done = probe->done;
+   if (!done) {
+      rpt_vstring(0, "Probe %s did not complete within %d seconds.  Output omitted.",
+                     probe->name, probe->timeout_millisec/1000);
+      DBGTRC(debug, TRACE_GROUP, "Done. probe=%s timed out", probe->name);
+      // once the mutex is released, the probe thread may free the probe at any time
+      probe->abandoned = true;
+      g_atomic_int_inc(&abandoned_probe_ct);
+   }
+   g_mutex_unlock(&probe->mutex);
+
+   if (done) {
+      if (probe->output_size > 0)
+         fwrite(probe->output, 1, probe->output_size, rpt_cur_output_dest());
+      if (probe->cache_until_reboot && !probe->from_cache)
+         save_cached_probe_output(probe);
+      DBGTRC(debug, TRACE_GROUP, "Done. probe=%s, from_cache=%s, elapsed millisec: %"PRIu64,
+                                 probe->name, sbool(probe->from_cache), probe->elapsed_nanos/(1000*1000));
+      free_sysenv_probe(probe);
+   }
+}
+
+
+/** Returns the number of probes that timed out and are still running.
+ *
+ *  @return number of abandoned probes
+ */
+int
+sysenv_abandoned_probe_count() {
+   return g_atomic_int_get(&abandoned_probe_ct);
+}
+
+
+void init_query_sysenv_probes() {
+   RTTI_ADD_FUNC(sysenv_start_probe);
+   RTTI_ADD_FUNC(sysenv_report_probe);
+   RTTI_ADD_FUNC(load_cached_probe_output);
+   RTTI_ADD_FUNC(save_cached_probe_output);
+}
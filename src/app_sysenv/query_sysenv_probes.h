@@ -0,0 +1,45 @@
+/** @file query_sysenv_probes.h
+ *
+ *  Run environment probes concurrently, buffering the output of each
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef QUERY_SYSENV_PROBES_H_
+#define QUERY_SYSENV_PROBES_H_
+
+/** \cond */
+#include <stdbool.h>
+/** \endcond */
+
+#include "query_sysenv_base.h"
+
+/** Signature of a function that can be run as a concurrent probe.
+ *
+ *  The function writes its report using the rpt_ functions, and must
+ *  at most read the #Env_Accumulator.
+ */
+typedef void (*Sysenv_Probe_Func)(Env_Accumulator * accum);
+
+typedef struct Sysenv_Probe Sysenv_Probe;
+
+Sysenv_Probe *
+sysenv_start_probe(
+      const char *       name,
+      Sysenv_Probe_Func  func,
+      Env_Accumulator *  accum,
+      int                timeout_millisec,
+      bool               cache_until_reboot);
+
+void
+sysenv_report_probe(
+      Sysenv_Probe *     probe);
+
+int
+sysenv_abandoned_probe_count();
+
+void
+init_query_sysenv_probes();
+
+#endif /* QUERY_SYSENV_PROBES_H_ */
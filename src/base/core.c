@@ -48,6 +48,7 @@
 
 #include "base/ddc_errno.h"
 #include "base/linux_errno.h"
+#include "base/trace_ring.h"
 
 #include "base/core.h"
 
@@ -786,6 +787,9 @@ void severemsg(
  *  - funcname is the name of a function being traced
  *  - filename is the name of a file being traced
  *
+ *  If the trace ring is enabled, the message is recorded in binary form
+ *  instead of being formatted and output.  See trace_ring.c.
+ *
  *  @param trace_group   trace group of caller, 0xff to always output
  *  @param funcname      function name of caller
  *  @param lineno        line number in caller
@@ -804,7 +808,14 @@ bool dbgtrc(
         ...)
 {
    bool msg_emitted = false;
-   if ( is_tracing(trace_group, filename, funcname) ) {
+   if ( trace_ring_enabled && is_tracing(trace_group, filename, funcname) ) {
+      va_list(args);
+      va_start(args, format);
+      trace_ring_record(funcname, lineno, filename, format, args);
+      va_end(args);
+      msg_emitted = true;
+   }
+   else if ( is_tracing(trace_group, filename, funcname) ) {
       va_list(args);
       va_start(args, format);
       char * buffer = g_strdup_vprintf(format, args);
@@ -58,6 +58,7 @@ static Status_Code_Info ddcrc_info[] = {
       EDENTRY(DDCRC_LOCKED                   , "display locked"),
       EDENTRY(DDCRC_ALREADY_OPEN             , "already open in current thread"),
       EDENTRY(DDCRC_BAD_DATA                 , "invalid data"),
+      EDENTRY(DDCRC_STALLED                  , "I2C read stalled"),
    // EDENTRY(DDCRC_CAP_FATAL                , "incorrect, unusable capabilities string"),
    // EDENTRY(DDCRC_CAP_WARNING              , "errors in capabilities string, but usable")
     };
@@ -9,6 +9,7 @@
 #include <config.h>
 
 #include <assert.h>
+#include <glib-2.0/glib.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -30,6 +31,9 @@
 
 DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDCIO;
 
+// number of packets allocated on the heap, i.e. not in a DDC_Packet_Storage
+static int ddc_packet_allocation_ct = 0;
+
 
 //
 // Utilities
@@ -205,6 +209,12 @@ void free_ddc_packet(DDC_Packet * packet) {
 
    // dump_packet(packet);
 
+   // storage is owned by the caller, typically a Display_Handle
+   if (packet && packet->preallocated) {
+      DBGMSF(debug, "Preallocated packet, not freed");
+      return;
+   }
+
    if (packet) {
       if (packet->parsed.raw_parsed) {
          DBGMSF(debug, "freeing packet->parsed.raw=%p", packet->parsed.raw_parsed);
@@ -221,6 +231,52 @@ void free_ddc_packet(DDC_Packet * packet) {
 }
 
 
+/** Returns the number of DDC packets that have been allocated on the heap.
+ *
+ *  Packets built in a #DDC_Packet_Storage are not counted, so the count
+ *  does not change for non-table feature reads and writes.
+ */
+int get_ddc_packet_allocation_count() {
+   return g_atomic_int_get(&ddc_packet_allocation_ct);
+}
+
+
+static void set_packet_tag(DDC_Packet * packet, const char * tag) {
+   if (tag) {
+      strncpy(packet->tag, tag, sizeof(packet->tag));  // no need to check if packet->tag truncated
+      packet->tag[sizeof(packet->tag)-1] = '\0';
+   }
+   else
+      packet->tag[0] = '\0';
+}
+
+
+/** Initializes an empty DDC packet in caller supplied storage.
+ *
+ *  \param  storage   where to build the packet
+ *  \param  tag       debug string (may be NULL)
+ *  \return pointer to the packet within **storage**
+ *
+ *  \remark
+ *  #free_ddc_packet() does nothing for such a packet.
+ */
+static DDC_Packet *
+init_empty_ddc_packet(DDC_Packet_Storage * storage, const char * tag) {
+   DDC_Packet * packet = &storage->packet;
+   memcpy(storage->buffer.marker, BUFFER_MARKER, 4);
+   storage->buffer.bytes          = storage->bytes;
+   storage->buffer.buffer_size    = sizeof(storage->bytes);
+   storage->buffer.len            = 0;
+   storage->buffer.size_increment = 0;
+   packet->raw_bytes = &storage->buffer;
+   set_packet_tag(packet, tag);
+   packet->type = DDC_PACKET_TYPE_NONE;
+   packet->parsed.raw_parsed = NULL;
+   packet->preallocated = true;
+   return packet;
+}
+
+
 /** Base function for creating any DDC packet
  *
  *  \param  max_size  size of buffer allocated for packet bytes
@@ -234,15 +290,12 @@ create_empty_ddc_packet(int max_size, const char * tag) {
 
    DDC_Packet * packet = malloc(sizeof(DDC_Packet));
    packet->raw_bytes = buffer_new(max_size, "empty DDC packet");
-   if (tag) {
-      strncpy(packet->tag, tag, sizeof(packet->tag));  // no need to check if packet->tag truncated
-      packet->tag[sizeof(packet->tag)-1] = '\0';
-   }
-   else
-      packet->tag[0] = '\0';
+   set_packet_tag(packet, tag);
    // DBGMSG("packet->tag=%s", packet->tag);
    packet->type = DDC_PACKET_TYPE_NONE;
    packet->parsed.raw_parsed = NULL;
+   packet->preallocated = false;
+   g_atomic_int_inc(&ddc_packet_allocation_ct);
 
    DBGMSF(debug, "Done. Returning %p, packet->tag=%p", packet, packet->tag);
    if (debug)
@@ -256,6 +309,29 @@ create_empty_ddc_packet(int max_size, const char * tag) {
 // Request Packets
 //
 
+// Sets the bytes of a request packet, whose buffer must hold at least data_bytect+4 bytes
+static void
+fill_ddc_request_packet(
+      DDC_Packet * packet,
+      Byte *       data_bytes,
+      int          data_bytect)
+{
+   buffer_set_byte( packet->raw_bytes, 0, 0x6e);
+   buffer_set_byte( packet->raw_bytes, 1, 0x51);
+   buffer_set_byte( packet->raw_bytes, 2, data_bytect | 0x80);
+   buffer_set_bytes(packet->raw_bytes, 3, data_bytes, data_bytect);
+   int packet_size_wo_checksum = 3 + data_bytect;
+   Byte checksum = ddc_checksum(packet->raw_bytes->bytes, packet_size_wo_checksum, false);
+   buffer_set_byte(packet->raw_bytes, packet_size_wo_checksum, checksum);
+   buffer_set_length(packet->raw_bytes, 3 + data_bytect + 1);
+   if (data_bytect > 0)
+      packet->type = data_bytes[0];
+   else
+      packet->type = 0x00;
+   // dump_buffer(packet->buf);
+}
+
+
 /** Creates a generic DDC request packet
  *
  *  \param  data_bytes   data bytes of packet
@@ -275,19 +351,7 @@ create_ddc_base_request_packet(
    assert( data_bytect <= 32 );
 
    DDC_Packet * packet = create_empty_ddc_packet(3+data_bytect+1, tag);
-   buffer_set_byte( packet->raw_bytes, 0, 0x6e);
-   buffer_set_byte( packet->raw_bytes, 1, 0x51);
-   buffer_set_byte( packet->raw_bytes, 2, data_bytect | 0x80);
-   buffer_set_bytes(packet->raw_bytes, 3, data_bytes, data_bytect);
-   int packet_size_wo_checksum = 3 + data_bytect;
-   Byte checksum = ddc_checksum(packet->raw_bytes->bytes, packet_size_wo_checksum, false);
-   buffer_set_byte(packet->raw_bytes, packet_size_wo_checksum, checksum);
-   buffer_set_length(packet->raw_bytes, 3 + data_bytect + 1);
-   if (data_bytect > 0)
-      packet->type = data_bytes[0];
-   else
-      packet->type = 0x00;
-   // dump_buffer(packet->buf);
+   fill_ddc_request_packet(packet, data_bytes, data_bytect);
 
    DBGMSF(debug, "Done. packet=%p", packet);
    return packet;
@@ -401,7 +465,7 @@ create_ddc_multi_part_write_request_packet(
    assert (bytect + 4 <= 35);    // is this the right limit?, spec unclear
    DDC_Packet * packet_ptr = NULL;
 
-   Byte ofs_hi_byte = (offset >> 16) & 0xff;
+   Byte ofs_hi_byte = (offset >> 8) & 0xff;
    Byte ofs_lo_byte = offset & 0xff;
 
 
@@ -438,6 +502,25 @@ create_ddc_getvcp_request_packet(Byte vcp_code, const char * tag)
 }
 
 
+/** Builds a Get VCP request packet in caller supplied storage.
+ *
+ *  \param  storage   where to build the packet
+ *  \param  vcp_code  VCP feature code
+ *  \param  tag       debug string
+ *  \return pointer to the packet within **storage**
+ */
+DDC_Packet *
+init_ddc_getvcp_request_packet(DDC_Packet_Storage * storage, Byte vcp_code, const char * tag)
+{
+   Byte data_bytes[] = { 0x01,     // Command: get VCP Feature
+                         vcp_code  // VCP opcode
+                       };
+   DDC_Packet * pkt = init_empty_ddc_packet(storage, tag);
+   fill_ddc_request_packet(pkt, data_bytes, 2);
+   return pkt;
+}
+
+
 /** Creates a Set VCP request packet
  *
  *  \param   vcp_code  VCP feature code
@@ -460,6 +543,32 @@ create_ddc_setvcp_request_packet(Byte vcp_code, int new_value, const char * tag)
 }
 
 
+/** Builds a Set VCP request packet in caller supplied storage.
+ *
+ *  \param   storage   where to build the packet
+ *  \param   vcp_code  VCP feature code
+ *  \param   int       new value
+ *  \param   tag       debug string
+ *  \return  pointer to the packet within **storage**
+ */
+DDC_Packet *
+init_ddc_setvcp_request_packet(
+      DDC_Packet_Storage * storage,
+      Byte                 vcp_code,
+      int                  new_value,
+      const char *         tag)
+{
+   Byte data_bytes[] = { 0x03,   // Command: set VCP Feature
+                         vcp_code,  // VCP opcode
+                         (new_value >> 8) & 0xff,
+                         new_value & 0xff
+                       };
+   DDC_Packet * pkt = init_empty_ddc_packet(storage, tag);
+   fill_ddc_request_packet(pkt, data_bytes, 4);
+   return pkt;
+}
+
+
 /** Creates a request packet for Save Settings command.
  *
  *  \param  tag   debug string
@@ -481,6 +590,65 @@ create_ddc_save_settings_request_packet(const char * tag)
 // Response Packets
 //
 
+// Checks the source address and data length of a raw I2C response
+static Status_DDC
+check_response_envelope(
+      Byte *  i2c_response_bytes,
+      bool    debug,
+      int *   data_ct_loc)
+{
+   Status_DDC result = DDCRC_OK;
+   if (i2c_response_bytes[0] != 0x6e ) {
+      DDCMSG(debug, "Unexpected source address 0x%02x, should be 0x6e", i2c_response_bytes[0]);
+      result = DDCRC_DDC_DATA;     // was DDCRC_RESPONSE_ENVELOPE
+   }
+   else {
+      int data_ct = i2c_response_bytes[1] & 0x7f;
+      // DBGMSG("data_ct=%d", data_ct);
+      if (data_ct > MAX_DDC_DATA_SIZE) {
+         if ( is_double_byte(&i2c_response_bytes[1])) {
+            result = DDCRC_DDC_DATA;    // was DDCRC_DOUBLE_BYTE
+            DDCMSG(debug, "Double byte in packet.");
+         }
+         else {
+            result = DDCRC_DDC_DATA;     // was  DDCRC_PACKET_SIZE
+            DDCMSG(debug,"Invalid data length in packet: %d exceeds MAX_DDC_DATA_SIZE", data_ct);
+         }
+      }
+      *data_ct_loc = data_ct;
+   }
+   return result;
+}
+
+
+// Copies a raw I2C response with a valid envelope to a packet whose buffer
+// holds at least data_ct+4 bytes, and verifies the checksum
+static Status_DDC
+fill_ddc_response_packet(
+      DDC_Packet * packet,
+      Byte *       i2c_response_bytes,
+      int          data_ct,
+      bool         debug)
+{
+   Status_DDC result = DDCRC_OK;
+   if (data_ct > 0)
+      packet->type = i2c_response_bytes[2];
+   Byte * packet_bytes = packet->raw_bytes->bytes;
+   buffer_set_byte(  packet->raw_bytes, 0, 0x6f);     // implicit, would be 0x50 on access bus
+   buffer_set_byte(  packet->raw_bytes, 1, 0x6e);     // i2c_response_bytes[0]
+   buffer_set_bytes( packet->raw_bytes, 2, i2c_response_bytes+1, 1 + data_ct + 1);
+   buffer_set_length(packet->raw_bytes, 3 + data_ct + 1);
+   Byte calculated_checksum = ddc_checksum(packet_bytes, 3 + data_ct, true);   // replacing right byte?
+   Byte actual_checksum = packet_bytes[3+data_ct];
+   if (calculated_checksum != actual_checksum) {
+      DDCMSG(debug, "Actual checksum 0x%02x, expected 0x%02x",
+                       actual_checksum, calculated_checksum);
+      result = DDCRC_DDC_DATA;    //  was DDCRC_CHECKSUM
+   }
+   return result;
+}
+
+
 /** Performs tasks common to creating any DDC response packet.
  *  Checks for malformed packet, but not packet contents.
  *
@@ -510,44 +678,15 @@ create_ddc_base_response_packet(
    DBGTRC(debug, TRACE_GROUP,
           "Starting. i2c_response_bytes=%s", hexstring_t(i2c_response_bytes, 20) );
 
-   int result = DDCRC_OK;
+   int data_ct = 0;
    DDC_Packet * packet = NULL;
-   if (i2c_response_bytes[0] != 0x6e ) {
-      DDCMSG(debug, "Unexpected source address 0x%02x, should be 0x6e", i2c_response_bytes[0]);
-      result = DDCRC_DDC_DATA;     // was DDCRC_RESPONSE_ENVELOPE
-   }
-   else {
-      int data_ct = i2c_response_bytes[1] & 0x7f;
-      // DBGMSG("data_ct=%d", data_ct);
-      if (data_ct > MAX_DDC_DATA_SIZE) {
-         if ( is_double_byte(&i2c_response_bytes[1])) {
-            result = DDCRC_DDC_DATA;    // was DDCRC_DOUBLE_BYTE
-            DDCMSG(debug, "Double byte in packet.");
-         }
-         else {
-            result = DDCRC_DDC_DATA;     // was  DDCRC_PACKET_SIZE
-            DDCMSG(debug,"Invalid data length in packet: %d exceeds MAX_DDC_DATA_SIZE", data_ct);
-         }
-      }
-      else {
-         packet = create_empty_ddc_packet(3 + data_ct + 1, tag);
-         // DBGMSG("create_empty_ddc_packet() returned %p", packet);
-         if (data_ct > 0)
-            packet->type = i2c_response_bytes[2];
-         Byte * packet_bytes = packet->raw_bytes->bytes;
-         buffer_set_byte(  packet->raw_bytes, 0, 0x6f);     // implicit, would be 0x50 on access bus
-         buffer_set_byte(  packet->raw_bytes, 1, 0x6e);     // i2c_response_bytes[0]
-         buffer_set_bytes( packet->raw_bytes, 2, i2c_response_bytes+1, 1 + data_ct + 1);
-         buffer_set_length(packet->raw_bytes, 3 + data_ct + 1);
-         Byte calculated_checksum = ddc_checksum(packet_bytes, 3 + data_ct, true);   // replacing right byte?
-         Byte actual_checksum = packet_bytes[3+data_ct];
-         if (calculated_checksum != actual_checksum) {
-            DDCMSG(debug, "Actual checksum 0x%02x, expected 0x%02x",
-                             actual_checksum, calculated_checksum);
-            result = DDCRC_DDC_DATA;    //  was DDCRC_CHECKSUM
-            free_ddc_packet(packet);
-         }
-      }
+   int result = check_response_envelope(i2c_response_bytes, debug, &data_ct);
+   if (result == DDCRC_OK) {
+      packet = create_empty_ddc_packet(3 + data_ct + 1, tag);
+      // DBGMSG("create_empty_ddc_packet() returned %p", packet);
+      result = fill_ddc_response_packet(packet, i2c_response_bytes, data_ct, debug);
+      if (result != DDCRC_OK)
+         free_ddc_packet(packet);
    }
 
    if (result != DDCRC_OK) {
@@ -1060,6 +1199,72 @@ create_ddc_getvcp_response_packet(
 }
 
 
+/** Builds a Get VCP response packet in caller supplied storage, checking for
+ *  DDC Null Response, the expected packet type and the expected feature code.
+ *
+ *  This is the allocation free equivalent of #create_ddc_typed_response_packet()
+ *  for **expected_type** DDC_PACKET_TYPE_QUERY_VCP_RESPONSE.  The parsed response
+ *  is stored in **storage** as well.
+ *
+ *  \param storage                     where to build the packet
+ *  \param i2c_response_bytes          pointer to raw packet bytes
+ *  \param response_bytes_buffer_size  size of buffer pointed to by **i2c_response_bytes**
+ *  \param expected_vcp_opcode         VCP feature code
+ *  \param tag                         debug string (may be NULL)
+ *  \param packet_ptr_addr             where to return pointer to the packet within **storage**
+ *  \return status code, as from #create_ddc_typed_response_packet()
+ *
+ *  The pointer returned at packet_ptr_addr is non-null iff the status code is 0.
+ */
+Status_DDC
+init_ddc_getvcp_response_packet(
+      DDC_Packet_Storage * storage,
+      Byte *               i2c_response_bytes,
+      int                  response_bytes_buffer_size,
+      Byte                 expected_vcp_opcode,
+      const char *         tag,
+      DDC_Packet **        packet_ptr_addr)
+{
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP,
+          "Starting. i2c_response_bytes=%s", hexstring_t(i2c_response_bytes, 20));
+
+   int data_ct = 0;
+   DDC_Packet * packet = init_empty_ddc_packet(storage, tag);
+   Status_DDC result = check_response_envelope(i2c_response_bytes, debug, &data_ct);
+   if (result == DDCRC_OK)
+      result = fill_ddc_response_packet(packet, i2c_response_bytes, data_ct, debug);
+   if (result != DDCRC_OK) {
+      DDCMSG(debug, "i2c_response_bytes: %s",
+                       hexstring_t(i2c_response_bytes, response_bytes_buffer_size));
+   }
+   else if (isNullPacket(packet)) {
+      result = DDCRC_NULL_RESPONSE;
+   }
+   else if (get_data_start(packet)[0] != DDC_PACKET_TYPE_QUERY_VCP_RESPONSE) {
+      result = DDCRC_DDC_DATA;      // was: DDCRC_RESPONSE_TYPE
+   }
+   if (result < 0)
+      log_status_code(result, __func__);
+
+   if (result == DDCRC_OK) {
+      packet->parsed.nontable_response = &storage->nontable_response;
+      result = interpret_vcp_feature_response_std(
+                  get_data_start(packet),
+                  get_data_len(packet),
+                  expected_vcp_opcode,
+                  packet->parsed.nontable_response);
+   }
+
+   *packet_ptr_addr = (result == DDCRC_OK) ? packet : NULL;
+   DBGTRC(debug, TRACE_GROUP,
+          "Returning %s, *packet_ptr_addr=%p", ddcrc_desc_t(result), *packet_ptr_addr);
+   if ( (debug || IS_TRACING()) && result == DDCRC_OK)
+      dbgrpt_packet(packet, 1);
+   return result;
+}
+
+
 //
 // Operations on response packets
 // 
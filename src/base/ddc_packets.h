@@ -117,10 +117,26 @@ struct {
 
    // additional fields for new way of parsing result data
    // Parsed_Response_Data * parsed_response;
+
+   bool             preallocated;       ///* packet lives in a #DDC_Packet_Storage
 } DDC_Packet;
 
+/** Storage for a #DDC_Packet that requires no heap allocation.
+ *
+ *  Used for the request and response packets of non-table feature
+ *  reads and writes, which are by far the most frequent exchanges.
+ */
+typedef
+struct {
+   DDC_Packet                    packet;
+   Buffer                        buffer;
+   Byte                          bytes[MAX_DDC_PACKET_INC_CHECKSUM];
+   Parsed_Nontable_Vcp_Response  nontable_response;
+} DDC_Packet_Storage;
+
 void dbgrpt_packet(DDC_Packet * packet, int depth);
 void free_ddc_packet(DDC_Packet * packet);
+int  get_ddc_packet_allocation_count();
 
 bool is_double_byte(Byte * pb);
 
@@ -205,6 +221,21 @@ create_ddc_getvcp_request_packet(
       Byte          vcp_code,
       const char *  tag);
 
+DDC_Packet *
+init_ddc_getvcp_request_packet(
+      DDC_Packet_Storage * storage,
+      Byte          vcp_code,
+      const char *  tag);
+
+Status_DDC
+init_ddc_getvcp_response_packet(
+      DDC_Packet_Storage * storage,
+      Byte *        i2c_response_bytes,
+      int           response_bytes_buffer_size,
+      Byte          expected_vcp_opcode,
+      const char *  tag,
+      DDC_Packet ** packet_ptr);
+
 Status_DDC
 create_ddc_getvcp_response_packet(
       Byte *        i2c_response_bytes,
@@ -219,6 +250,13 @@ create_ddc_setvcp_request_packet(
       int           new_value,
       const char *  tag);
 
+DDC_Packet *
+init_ddc_setvcp_request_packet(
+      DDC_Packet_Storage * storage,
+      Byte          vcp_code,
+      int           new_value,
+      const char *  tag);
+
 DDC_Packet *
 create_ddc_save_settings_request_packet(
       const char * tag);
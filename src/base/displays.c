@@ -98,6 +98,40 @@ bool dpath_eq(DDCA_IO_Path p1, DDCA_IO_Path p2) {
 }
 
 
+/** Hash function for #DDCA_IO_Path keys, with signature GHashFunc.
+ *
+ *  \param  key  pointer to #DDCA_IO_Path
+ *  \return hash value
+ */
+guint dpath_hash(gconstpointer key) {
+   const DDCA_IO_Path * path = key;
+   guint result = path->io_mode;
+   switch(path->io_mode) {
+   case DDCA_IO_I2C:
+      result = result << 16 | path->path.i2c_busno;
+      break;
+   case DDCA_IO_ADL:
+      result = result << 16 | path->path.adlno.iAdapterIndex << 8 | path->path.adlno.iDisplayIndex;
+      break;
+   case DDCA_IO_USB:
+      result = result << 16 | path->path.hiddev_devno;
+      break;
+   }
+   return result;
+}
+
+
+/** Equality function for #DDCA_IO_Path keys, with signature GEqualFunc.
+ *
+ *  \param  a  pointer to #DDCA_IO_Path
+ *  \param  b  pointer to #DDCA_IO_Path
+ *  \return true if the paths are equal
+ */
+gboolean dpath_hash_equal(gconstpointer a, gconstpointer b) {
+   return dpath_eq(*(const DDCA_IO_Path *) a, *(const DDCA_IO_Path *) b);
+}
+
+
 // *** Display_Async_Rec ***
 
 // At least temporarily for development, base all async operations for a display
@@ -20,6 +20,7 @@
 #include "private/ddcutil_types_private.h"
 
 #include "core.h"
+#include "ddc_packets.h"
 #include "dynamic_features.h"
 #include "feature_sets.h"
 #include "vcp_version.h"
@@ -56,6 +57,8 @@ void init_displays();
 
 char *  io_mode_name(DDCA_IO_Mode val);
 bool    dpath_eq(DDCA_IO_Path p1, DDCA_IO_Path p2);
+guint   dpath_hash(gconstpointer key);
+gboolean dpath_hash_equal(gconstpointer a, gconstpointer b);
 char * dpath_short_name_t(DDCA_IO_Path * dpath);
 char *  dpath_repr_t(DDCA_IO_Path * dpath);  // value valid until next call
 
@@ -233,6 +236,8 @@ typedef struct {
    Display_Ref* dref;
    int          fd;     // Linux file descriptor if ddc_io_mode == DDC_IO_DEVI2C or USB_IO                           // added 7/2016
    char *       repr;
+   DDC_Packet_Storage  request_storage;    ///< reused for non-table feature requests
+   DDC_Packet_Storage  response_storage;   ///< reused for non-table feature responses
 } Display_Handle;
 
 Display_Handle * create_bus_display_handle_from_display_ref(int fd, Display_Ref * dref);
@@ -21,10 +21,13 @@
 #include "util/string_util.h"
 
 #include "base/core.h"
+#include "base/ddc_packets.h"
 #include "base/sleep.h"
 #include "base/parms.h"
 #include "base/ddc_errno.h"
 #include "base/linux_errno.h"
+#include "base/thread_display_stats.h"
+#include "base/timeline.h"
 
 #include "base/execution_stats.h"
 
@@ -83,13 +86,15 @@ static bool                 debug_sleep_stats_mutex = false;
 
 static
 IO_Event_Type_Stats io_event_stats[] = {
-      // id           name             desc           nanosec  count
-      {IE_WRITE,      "IE_WRITE",      "write calls",       0, 0},
-      {IE_READ,       "IE_READ",       "read calls",        0, 0},
-      {IE_WRITE_READ, "IE_WRITE_READ", "write/read calls",  0, 0},
-      {IE_OPEN,       "IE_OPEN",       "open file calls",   0, 0},
-      {IE_CLOSE,      "IE_CLOSE",      "close file calls",  0, 0},
-      {IE_OTHER,      "IE_OTHER",      "other I/O calls",   0, 0},
+      // id              name                desc                nanosec  count
+      {IE_WRITE,         "IE_WRITE",         "write calls",         0, 0},
+      {IE_READ,          "IE_READ",          "read calls",          0, 0},
+      {IE_WRITE_READ,    "IE_WRITE_READ",    "write/read calls",    0, 0},
+      {IE_OPEN,          "IE_OPEN",          "open file calls",     0, 0},
+      {IE_CLOSE,         "IE_CLOSE",         "close file calls",    0, 0},
+      {IE_HIDDEV_REPORT, "IE_HIDDEV_REPORT", "hiddev report calls", 0, 0},
+      {IE_HIDRAW_REPORT, "IE_HIDRAW_REPORT", "hidraw report calls", 0, 0},
+      {IE_OTHER,         "IE_OTHER",         "other I/O calls",     0, 0},
 };
 #define IO_EVENT_TYPE_CT (sizeof(io_event_stats)/sizeof(IO_Event_Type_Stats))
 static GMutex io_event_stats_mutex;
@@ -187,6 +192,8 @@ void log_io_call(
 
    g_mutex_unlock(&io_event_stats_mutex);
 
+   timeline_record_span(TL_IO, io_event_name(event_type), start_time_nanos, end_time_nanos, 0);
+
    DBGMSF(debug, "Updated total nanosec = %"PRIu64", as millis=%"PRIu64,
                   io_event_stats[event_type].call_nanosec, io_event_stats[event_type].call_nanosec /(1000*1000) );
 }
@@ -353,6 +360,7 @@ log_status_code(Public_Status_Code rc, const char * caller_name) {
    // if ( ddcrc_is_derived_status_code(rc) )
    //    pcounts = secondary_status_code_counts;
    log_any_status_code(pcounts, rc, caller_name);
+   tds_record_status_code(rc, false);
    return rc;
 }
 
@@ -371,6 +379,7 @@ log_retryable_status_code(Public_Status_Code rc, const char * caller_name) {
    // DBGMSG("rc=%d, caller_name=%s", rc, caller_name);
    Status_Code_Counts * pcounts = retryable_error_code_counts;
    log_any_status_code(pcounts, rc, caller_name);
+   tds_record_status_code(rc, true);
    return rc;
 }
 
@@ -567,6 +576,7 @@ void report_execution_stats(int depth) {
    rpt_vstring(d1, "Total IO events:      %5d", total_io_event_count());
    rpt_vstring(d1, "IO error count:       %5d", get_true_io_error_count(primary_error_code_counts));
    rpt_vstring(d1, "Total sleep events:   %5d", total_sleep_event_ct);
+   rpt_vstring(d1, "Heap DDC packets:     %5d", get_ddc_packet_allocation_count());
    rpt_nl();
    rpt_title("Sleep Event type      Count", d1);
    for (int id=0; id < SLEEP_EVENT_ID_CT; id++) {
@@ -48,6 +48,8 @@ typedef enum {
    IE_WRITE_READ,          ///< write/read operation, typical for I2C
    IE_OPEN,                ///< device file open
    IE_CLOSE,               ///< device file close
+   IE_HIDDEV_REPORT,       ///< USB HID report exchange using hiddev
+   IE_HIDRAW_REPORT,       ///< USB HID report exchange using hidraw
    IE_OTHER                ///< other IO event
 } IO_Event_Type;
 
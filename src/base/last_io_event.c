@@ -92,6 +92,23 @@ void free_io_event_timestamp(int fd) {
 
 // *** Last IO
 
+/** Returns the time at which the most recent I/O on a file descriptor finished.
+ *
+ *  \param  fd  Linux file descriptor
+ *  \return finish time in nanoseconds, 0 if no I/O has been recorded
+ */
+uint64_t get_last_io_finish_time(int fd) {
+   ensure_initialized();
+   uint64_t result = 0;
+   G_LOCK(timestamps_lock);
+   IO_Event_Timestamp * ts = find_io_event_timestamp(fd);
+   if (ts)
+      result = ts->finish_time;
+   G_UNLOCK(timestamps_lock);
+   return result;
+}
+
+
 void record_io_finish(
       int           fd,
       uint64_t      finish_time,
@@ -26,6 +26,7 @@ struct {
 IO_Event_Timestamp * get_io_event_timestamp(int fd);
 // IO_Event_Timestamp * new_io_event_timestamp(int fd);
 void free_io_event_timestamp(int fd);
+uint64_t get_last_io_finish_time(int fd);
 
 void record_io_finish(
       int              fd,
@@ -110,6 +110,54 @@
 #define DISPLAY_CHECK_ASYNC_THRESHOLD_STANDARD  3
 #define DISPLAY_CHECK_ASYNC_THRESHOLD_DEFAULT   DISPLAY_CHECK_ASYNC_NEVER
 
+/** Probe I2C buses in parallel during detection if at least this number of buses */
+#define I2C_BUS_CHECK_ASYNC_NEVER              0xff
+#define I2C_BUS_CHECK_ASYNC_THRESHOLD_STANDARD 4
+#define I2C_BUS_CHECK_ASYNC_THRESHOLD_DEFAULT  I2C_BUS_CHECK_ASYNC_NEVER
+/** Maximum number of threads used to probe I2C buses */
+#define I2C_BUS_CHECK_MAX_THREADS              8
+
 #define DEFAULT_SLEEP_LESS true
+/** Shorten protocol sleeps by the time the display has already been idle.
+ *  Off by default until validated on a wider range of hardware. */
+#define DEFAULT_IDLE_AWARE_SLEEP false
+
+/** Consecutive failed DDC exchanges on an I2C bus before the next I2C IO strategy is tried */
+#define I2C_STRATEGY_FALLBACK_FAILURES         2
+/** Consecutive failed DDC exchanges on an I2C bus before a learned I2C IO strategy is relearned */
+#define I2C_STRATEGY_RELEARN_FAILURES         12
+
+/** Maximum DDC read deadline, used until enough read times have been observed */
+#define I2C_READ_DEADLINE_MILLISEC_DEFAULT  1000
+/** Minimum DDC read deadline */
+#define I2C_READ_DEADLINE_MILLISEC_MIN        20
+/** DDC read deadline as a multiple of the 90th percentile of recent read times */
+#define I2C_READ_DEADLINE_FACTOR               4
+/** Number of observed read times before the read deadline is derived from them */
+#define I2C_READ_DEADLINE_MIN_SAMPLES          8
+
+/** Maximum number of data bytes in a table write fragment */
+#define MULTI_PART_WRITE_FRAGMENT_SIZE_MAX    28
+/** Minimum number of data bytes in a table write fragment, when reduced after failures */
+#define MULTI_PART_WRITE_FRAGMENT_SIZE_MIN     4
+/** Minimum delay after a table write fragment, when reduced after successful writes */
+#define MULTI_PART_WRITE_DELAY_MILLIS_MIN     10
+/** Maximum delay after a table write fragment, when increased after failed writes */
+#define MULTI_PART_WRITE_DELAY_MILLIS_MAX    400
+/** Number of table write fragments written on the first try before the pacing is relaxed */
+#define MULTI_PART_WRITE_ADAPT_FRAGMENTS      16
+
+/** Time for which a cached non-table feature value is used, unless set for the feature */
+#define VCP_VALUE_CACHE_TTL_MILLISEC_DEFAULT  5000
+
+/** Maximum wait for a display whose device is locked by another process */
+#define PROCESS_LOCK_WAIT_MILLISEC_DEFAULT     5000
+/** Interval between attempts to acquire a device lock held by another process */
+#define PROCESS_LOCK_POLL_MILLISEC             10
+
+/** Number of binary trace records retained for each thread, see trace_ring.c */
+#define TRACE_RING_RECORDS_PER_THREAD        4096
+/** Maximum number of timeline events recorded for each thread, see timeline.c */
+#define TIMELINE_MAX_EVENTS_PER_THREAD     200000
 
 #endif /* PARMS_H_ */
@@ -31,6 +31,7 @@
 #include "base/displays.h"
 #include "base/parms.h"
 #include "base/sleep.h"
+#include "base/thread_display_stats.h"
 #include "base/thread_retry_data.h"    // temp circular
 
 #include "thread_sleep_data.h"
@@ -151,6 +152,7 @@ void ptd_cross_thread_operation_block() {
 void per_thread_data_destroy(void * data) {
    if (data) {
       Per_Thread_Data * ptd = data;
+      release_thread_display_stats(ptd);
       free(ptd->description);
       free(ptd);
    }
@@ -175,6 +177,7 @@ void release_thread_data_module() {
 static void init_per_thread_data(Per_Thread_Data * ptd) {
    init_thread_sleep_data(ptd);
    init_thread_retry_data(ptd);
+   init_thread_display_stats(ptd);
 }
 
 
@@ -485,13 +488,3 @@ void ptd_list_threads(int depth) {
    ptd_apply_all_sorted(ptd_thread_summary, GINT_TO_POINTER(d1));
    rpt_nl();
 }
-
-
-void report_all_thread_status_counts(int depth) {
-   bool debug = false;
-   DBGMSF(debug, "Starting");
-   rpt_label(depth, "No per-thread status code statistics are collected");
-   rpt_nl();
-   DBGMSF(debug, "Done");
-}
-
@@ -2,8 +2,9 @@
  *
  *  Maintains per-thread settings and statistics.
  *
- *  The dependencies between this file and thread_retry_data.c and thread_sleep.data
- *  are not unidirectional.  The functionality has been split into 3 files for clarity.
+ *  The dependencies between this file and thread_retry_data.c, thread_sleep.data,
+ *  and thread_display_stats.c are not unidirectional.  The functionality has been
+ *  split into 4 files for clarity.
  */
 
 // Copyright (C) 2018-2021 Sanford Rockowitz <rockowitz@minsoft.com>
@@ -85,6 +86,12 @@ typedef struct {
    Retry_Op_Value lowest_maxtries[4];
 
    Per_Thread_Try_Stats  try_stats[4];
+
+   // Per-display statistics, see thread_display_stats.c
+   bool           thread_display_stats_defined;
+   void *         cur_display_stats;   // Thread_Display_Stats for display being accessed, NULL if none
+   GHashTable *   display_stats;       // DDCA_IO_Path * -> Thread_Display_Stats *
+   GHashTable *   status_counts;       // status code -> occurrence count, all displays
 } Per_Thread_Data;
 
 bool ptd_cross_thread_operation_start();
@@ -109,5 +116,4 @@ void ptd_list_threads(int depth);
 
 void dbgrpt_per_thread_data_locks(int depth);
 
-void report_all_thread_status_counts(int depth);
 #endif /* PER_THREAD_DATA_H_ */
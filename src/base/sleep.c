@@ -37,10 +37,32 @@ void init_sleep_stats() {
    sleep_stats.total_sleep_calls = 0;
    sleep_stats.requested_sleep_milliseconds = 0;
    sleep_stats.actual_sleep_nanos = 0;
+   sleep_stats.shortened_sleep_calls = 0;
+   sleep_stats.skipped_sleep_calls = 0;
+   sleep_stats.saved_sleep_milliseconds = 0;
    G_UNLOCK(sleep_stats);
 }
 
 
+/** Records that a protocol sleep was shortened or skipped because
+ *  the display had already been idle for part or all of the sleep time.
+ *
+ * \param required_millis   sleep time required by the protocol
+ * \param remaining_millis  sleep time still to be performed
+ */
+void record_sleep_reduction(int required_millis, int remaining_millis) {
+   if (remaining_millis < required_millis) {
+      G_LOCK(sleep_stats);
+      if (remaining_millis <= 0)
+         sleep_stats.skipped_sleep_calls++;
+      else
+         sleep_stats.shortened_sleep_calls++;
+      sleep_stats.saved_sleep_milliseconds += required_millis - remaining_millis;
+      G_UNLOCK(sleep_stats);
+   }
+}
+
+
 /** Returns the current sleep statistics
  *
  * \return a copy of struct Sleep_Stats, containing thee current value
@@ -73,6 +95,12 @@ void report_sleep_stats(int depth) {
    rpt_vstring(d1, "Actual sleep milliseconds (nanosec):            %10"PRIu64"  (%13" PRIu64 ")",
                    stats_copy.actual_sleep_nanos / (1000*1000),
                    stats_copy.actual_sleep_nanos);
+   rpt_vstring(d1, "Sleeps shortened by time already idle:          %10d",
+                   stats_copy.shortened_sleep_calls);
+   rpt_vstring(d1, "Sleeps skipped by time already idle:            %10d",
+                   stats_copy.skipped_sleep_calls);
+   rpt_vstring(d1, "Sleep milliseconds saved by time already idle:  %10d",
+                   stats_copy.saved_sleep_milliseconds);
 }
 
 
@@ -33,9 +33,13 @@ typedef struct {
    uint64_t actual_sleep_nanos;
    int      requested_sleep_milliseconds;
    int      total_sleep_calls;
+   int      shortened_sleep_calls;        ///< reduced by time already idle
+   int      skipped_sleep_calls;          ///< eliminated by time already idle
+   int      saved_sleep_milliseconds;     ///< total reduction by time already idle
 } Sleep_Stats;
 
 void         init_sleep_stats();
+void         record_sleep_reduction(int required_millis, int remaining_millis);
 Sleep_Stats  get_sleep_stats();
 void         report_sleep_stats(int depth);
 
@@ -0,0 +1,349 @@
+/** \file thread_display_stats.c
+ *
+ *  Maintains try counts and status code counts by display, on a per thread
+ *  basis.
+ *
+ *  The global statistics in ddc_try_stats.c and execution_stats.c cannot say
+ *  which display is responsible when one of several monitors is failing.
+ *  Each thread records the display it is currently accessing, and try
+ *  outcomes and status codes are additionally counted in a #Thread_Display_Stats
+ *  record for that display in the thread's #Per_Thread_Data.  Since only
+ *  the owning thread updates its records, recording requires no locks.
+ *  Reports roll up the records for each display across all threads.
+ *
+ *  Displays are identified by their #DDCA_IO_Path, which corresponds
+ *  one to one with a Distinct_Display_Ref.
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "public/ddcutil_status_codes.h"
+
+#include <assert.h>
+#include <glib-2.0/glib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/report_util.h"
+#include "util/string_util.h"
+
+#include "base/core.h"
+#include "base/ddc_errno.h"
+#include "base/parms.h"
+#include "base/per_thread_data.h"
+#include "base/status_code_mgt.h"
+#include "base/thread_retry_data.h"
+#include "base/timeline.h"
+
+#include "base/thread_display_stats.h"
+
+
+/** Statistics for one display, as seen by one thread */
+typedef struct {
+   DDCA_IO_Path  io_path;
+   uint32_t      try_counters[RETRY_OP_COUNT][MAX_MAX_TRIES+2];  // same layout as Try_Data2
+   GHashTable *  status_counts;              // status code -> count
+   GHashTable *  retryable_status_counts;    // status code -> count, within retry loops
+} Thread_Display_Stats;
+
+
+static Thread_Display_Stats * new_thread_display_stats(DDCA_IO_Path io_path) {
+   Thread_Display_Stats * stats = g_new0(Thread_Display_Stats, 1);
+   stats->io_path = io_path;
+   stats->status_counts           = g_hash_table_new(NULL, NULL);
+   stats->retryable_status_counts = g_hash_table_new(NULL, NULL);
+   return stats;
+}
+
+
+static void free_thread_display_stats(void * data) {
+   Thread_Display_Stats * stats = data;
+   if (stats) {
+      g_hash_table_destroy(stats->status_counts);
+      g_hash_table_destroy(stats->retryable_status_counts);
+      free(stats);
+   }
+}
+
+
+/** Initializes the per-display statistics section of struct #Per_Thread_Data
+ *
+ *  \param  data
+ */
+void init_thread_display_stats(Per_Thread_Data * data) {
+   data->display_stats = g_hash_table_new_full(dpath_hash, dpath_hash_equal,
+                                               NULL, free_thread_display_stats);
+   data->status_counts = g_hash_table_new(NULL, NULL);
+   data->cur_display_stats = NULL;
+   data->thread_display_stats_defined = true;
+}
+
+
+/** Releases the per-display statistics section of struct #Per_Thread_Data
+ *
+ *  \param  data
+ */
+void release_thread_display_stats(Per_Thread_Data * data) {
+   if (data->thread_display_stats_defined) {
+      g_hash_table_destroy(data->display_stats);
+      g_hash_table_destroy(data->status_counts);
+      data->cur_display_stats = NULL;
+      data->thread_display_stats_defined = false;
+   }
+}
+
+
+static inline void bump_count(GHashTable * counts, int key) {
+   int ct = GPOINTER_TO_INT(g_hash_table_lookup(counts, GINT_TO_POINTER(key)));
+   g_hash_table_insert(counts, GINT_TO_POINTER(key), GINT_TO_POINTER(ct+1));
+}
+
+
+/** Sets the display to which subsequent try and status code statistics,
+ *  and timeline events, on the current thread are attributed.
+ *
+ *  \param  io_path  display path, NULL if no display
+ */
+void tds_set_current_display(DDCA_IO_Path * io_path) {
+   timeline_set_current_display(io_path);
+   ptd_cross_thread_operation_block();
+   Per_Thread_Data * data = ptd_get_per_thread_data();
+   assert(data->thread_display_stats_defined);
+   Thread_Display_Stats * cur = data->cur_display_stats;
+   if (!io_path) {
+      data->cur_display_stats = NULL;
+   }
+   else if (!cur || !dpath_eq(cur->io_path, *io_path)) {
+      cur = g_hash_table_lookup(data->display_stats, io_path);
+      if (!cur) {
+         cur = new_thread_display_stats(*io_path);
+         g_hash_table_insert(data->display_stats, &cur->io_path, cur);
+      }
+      data->cur_display_stats = cur;
+   }
+}
+
+
+/** Records the outcome of a retryable operation for the current display
+ *  of the current thread.
+ *
+ *  \param  retry_type
+ *  \param  rc         status code
+ *  \param  tryct      number of tries
+ */
+void tds_record_tries(Retry_Operation retry_type, DDCA_Status rc, int tryct) {
+   ptd_cross_thread_operation_block();
+   Per_Thread_Data * data = ptd_get_per_thread_data();
+   Thread_Display_Stats * cur = data->cur_display_stats;
+   if (cur) {
+      int index = 0;            // failed fatally
+      if (rc == 0)
+         index = tryct+1;
+      else if (rc == DDCRC_RETRIES || rc == DDCRC_ALL_TRIES_ZERO)
+         index = 1;
+      assert(index < MAX_MAX_TRIES+2);
+      cur->try_counters[retry_type][index]++;
+   }
+}
+
+
+/** Records a status code occurrence for the current thread, and for the
+ *  thread's current display if one is set.
+ *
+ *  \param  rc         status code
+ *  \param  retryable  true if the status code occurred within a retry loop
+ */
+void tds_record_status_code(DDCA_Status rc, bool retryable) {
+   ptd_cross_thread_operation_block();
+   Per_Thread_Data * data = ptd_get_per_thread_data();
+   if (!data->thread_display_stats_defined)
+      return;
+   if (!retryable)
+      bump_count(data->status_counts, rc);
+   Thread_Display_Stats * cur = data->cur_display_stats;
+   if (cur)
+      bump_count( (retryable) ? cur->retryable_status_counts : cur->status_counts, rc);
+}
+
+
+static void reset_thread_display_stats(Per_Thread_Data * data, void * arg) {
+   if (!data->thread_display_stats_defined)
+      return;
+   g_hash_table_remove_all(data->status_counts);
+   GHashTableIter iter;
+   gpointer key, value;
+   g_hash_table_iter_init(&iter, data->display_stats);
+   while (g_hash_table_iter_next(&iter, &key, &value)) {
+      Thread_Display_Stats * stats = value;
+      memset(stats->try_counters, 0, sizeof(stats->try_counters));
+      g_hash_table_remove_all(stats->status_counts);
+      g_hash_table_remove_all(stats->retryable_status_counts);
+   }
+}
+
+
+/** Resets the per-display statistics of all threads. */
+void tds_reset_all_threads() {
+   ptd_apply_all(reset_thread_display_stats, NULL);
+}
+
+
+//
+// Reporting
+//
+
+static void add_counts(GHashTable * accum, GHashTable * counts) {
+   GHashTableIter iter;
+   gpointer key, value;
+   g_hash_table_iter_init(&iter, counts);
+   while (g_hash_table_iter_next(&iter, &key, &value)) {
+      int ct = GPOINTER_TO_INT(g_hash_table_lookup(accum, key));
+      g_hash_table_insert(accum, key, GINT_TO_POINTER(ct + GPOINTER_TO_INT(value)));
+   }
+}
+
+
+// Ptd_Func signature, arg is hash table DDCA_IO_Path * -> Thread_Display_Stats *
+static void accumulate_thread_display_stats(Per_Thread_Data * data, void * arg) {
+   GHashTable * totals = arg;
+   if (!data->thread_display_stats_defined)
+      return;
+   GHashTableIter iter;
+   gpointer key, value;
+   g_hash_table_iter_init(&iter, data->display_stats);
+   while (g_hash_table_iter_next(&iter, &key, &value)) {
+      Thread_Display_Stats * stats = value;
+      Thread_Display_Stats * total = g_hash_table_lookup(totals, &stats->io_path);
+      if (!total) {
+         total = new_thread_display_stats(stats->io_path);
+         g_hash_table_insert(totals, &total->io_path, total);
+      }
+      for (int retry_type = 0; retry_type < RETRY_OP_COUNT; retry_type++) {
+         for (int ndx = 0; ndx < MAX_MAX_TRIES+2; ndx++)
+            total->try_counters[retry_type][ndx] += stats->try_counters[retry_type][ndx];
+      }
+      add_counts(total->status_counts,           stats->status_counts);
+      add_counts(total->retryable_status_counts, stats->retryable_status_counts);
+   }
+}
+
+
+static gint compare_status_count_keys(gconstpointer a, gconstpointer b) {
+   int ia = GPOINTER_TO_INT(a);
+   int ib = GPOINTER_TO_INT(b);
+   return (ia < ib) ? 1 : (ia > ib) ? -1 : 0;    // same order as report_all_status_counts()
+}
+
+
+static void report_status_code_counts(GHashTable * counts, const char * title, int depth) {
+   int total = 0;
+   GList * keys = g_list_sort(g_hash_table_get_keys(counts), compare_status_count_keys);
+   rpt_vstring(depth, "%s:%s", title, (keys) ? "" : " None");
+   for (GList * cur = keys; cur; cur = cur->next) {
+      int rc = GPOINTER_TO_INT(cur->data);
+      int ct = GPOINTER_TO_INT(g_hash_table_lookup(counts, cur->data));
+      total += ct;
+      Status_Code_Info * desc = find_status_code_info(rc);
+      rpt_vstring(depth+1, "%5d   %-28s (%5d)", ct, (desc) ? desc->name : "", rc);
+   }
+   if (keys)
+      rpt_vstring(depth+1, "Total: %d", total);
+   g_list_free(keys);
+}
+
+
+static void report_try_counters(uint32_t counters[MAX_MAX_TRIES+2], Retry_Operation retry_type, int depth) {
+   int total = 0;
+   for (int ndx = 0; ndx < MAX_MAX_TRIES+2; ndx++)
+      total += counters[ndx];
+   if (total == 0)
+      return;
+
+   // Successes by number of tries, as a compact list, e.g. "1:40 2:3"
+   char buf[200] = "";
+   int successes = 0;
+   for (int ndx = 2; ndx < MAX_MAX_TRIES+2; ndx++) {
+      if (counters[ndx] > 0) {
+         int pos = strlen(buf);
+         g_snprintf(buf+pos, sizeof(buf)-pos, "%s%d:%d", (pos > 0) ? " " : "", ndx-1, counters[ndx]);
+         successes += counters[ndx];
+      }
+   }
+   rpt_vstring(depth, "%-18s attempts: %4d, succeeded: %4d (by tries: %s), max tries exceeded: %3d, fatal: %3d",
+                      retry_type_description(retry_type), total, successes,
+                      (successes > 0) ? buf : "none", counters[1], counters[0]);
+}
+
+
+static gint compare_display_stats(gconstpointer a, gconstpointer b) {
+   const Thread_Display_Stats * sa = a;
+   const Thread_Display_Stats * sb = b;
+   if (sa->io_path.io_mode != sb->io_path.io_mode)
+      return (sa->io_path.io_mode < sb->io_path.io_mode) ? -1 : 1;
+   guint ha = dpath_hash(&sa->io_path);
+   guint hb = dpath_hash(&sb->io_path);
+   return (ha < hb) ? -1 : (ha > hb) ? 1 : 0;
+}
+
+
+/** Reports try statistics and status code counts for each display,
+ *  totaled across all threads.
+ *
+ *  \param  depth  logical indentation depth
+ */
+void report_all_display_stats(int depth) {
+   bool debug = false;
+   DBGMSF(debug, "Starting");
+   int d1 = depth+1;
+   int d2 = depth+2;
+
+   GHashTable * totals = g_hash_table_new_full(dpath_hash, dpath_hash_equal,
+                                               NULL, free_thread_display_stats);
+   ptd_apply_all(accumulate_thread_display_stats, totals);
+
+   rpt_label(depth, "Statistics by display:");
+   if (g_hash_table_size(totals) == 0) {
+      rpt_label(d1, "No display operations recorded");
+   }
+   else {
+      GList * displays = g_list_sort(g_hash_table_get_values(totals), compare_display_stats);
+      for (GList * cur = displays; cur; cur = cur->next) {
+         Thread_Display_Stats * stats = cur->data;
+         rpt_vstring(d1, "%s:", dpath_repr_t(&stats->io_path));
+         for (int retry_type = 0; retry_type < RETRY_OP_COUNT; retry_type++)
+            report_try_counters(stats->try_counters[retry_type], retry_type, d2);
+         report_status_code_counts(stats->status_counts,           "Errors",           d2);
+         report_status_code_counts(stats->retryable_status_counts, "Errors in retry loops", d2);
+      }
+      g_list_free(displays);
+   }
+   g_hash_table_destroy(totals);
+   rpt_nl();
+   DBGMSF(debug, "Done");
+}
+
+
+// Ptd_Func signature
+static void report_thread_status_counts(Per_Thread_Data * data, void * arg) {
+   int depth = GPOINTER_TO_INT(arg);
+   if (!data->thread_display_stats_defined)
+      return;
+   char title[40];
+   g_snprintf(title, sizeof(title), "Thread %d errors", data->thread_id);
+   report_status_code_counts(data->status_counts, title, depth);
+}
+
+
+/** Reports status code counts for each thread.
+ *
+ *  \param  depth  logical indentation depth
+ */
+void report_all_thread_status_counts(int depth) {
+   bool debug = false;
+   DBGMSF(debug, "Starting");
+   rpt_label(depth, "Status code counts by thread:");
+   ptd_apply_all_sorted(report_thread_status_counts, GINT_TO_POINTER(depth+1));
+   rpt_nl();
+   DBGMSF(debug, "Done");
+}
@@ -0,0 +1,30 @@
+/** \file thread_display_stats.h
+ *
+ *  Try and status code statistics by display, maintained on a per thread basis.
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef THREAD_DISPLAY_STATS_H_
+#define THREAD_DISPLAY_STATS_H_
+
+#include <stdbool.h>
+
+#include "public/ddcutil_types.h"
+
+#include "base/displays.h"
+#include "base/per_thread_data.h"
+
+void init_thread_display_stats(Per_Thread_Data * data);
+void release_thread_display_stats(Per_Thread_Data * data);
+
+void tds_set_current_display(DDCA_IO_Path * io_path);
+void tds_record_tries(Retry_Operation retry_type, DDCA_Status rc, int tryct);
+void tds_record_status_code(DDCA_Status rc, bool retryable);
+void tds_reset_all_threads();
+
+void report_all_display_stats(int depth);
+void report_all_thread_status_counts(int depth);
+
+#endif /* THREAD_DISPLAY_STATS_H_ */
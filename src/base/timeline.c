@@ -0,0 +1,306 @@
+/** \file timeline.c
+ *
+ *  Opt-in recorder of the timeline of DDC communication.
+ *
+ *  The IO, sleep, and retry statistics in execution_stats.c and
+ *  ddc_try_stats.c are aggregated totals, which cannot show where the time
+ *  of a particular slow operation is spent.  When the timeline is enabled,
+ *  each system call, protocol sleep, retryable operation outcome, and
+ *  feature read or write is recorded as an event with its start and end
+ *  times, thread, display, and feature code.
+ *
+ *  The events are written in Chrome trace event JSON format at program
+ *  exit, or on request.  The file can be viewed using chrome://tracing
+ *  or https://ui.perfetto.dev.
+ *
+ *  Each thread appends to its own event array.  The display and feature
+ *  code are those the thread is currently accessing, as set by
+ *  #timeline_set_current_display() and #timeline_set_current_feature().
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "config.h"
+
+/** \cond */
+#include <assert.h>
+#include <errno.h>
+#include <glib-2.0/glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef TARGET_BSD
+#include <pthread_np.h>
+#else
+#include <sys/types.h>
+#include <sys/syscall.h>
+#endif
+#include <unistd.h>
+/** \endcond */
+
+#include "util/timestamp.h"
+
+#include "base/displays.h"
+#include "base/parms.h"
+#include "base/status_code_mgt.h"
+
+#include "base/timeline.h"
+
+
+static const char * timeline_category_names[] = {
+      "io",
+      "sleep",
+      "retry",
+      "vcp"
+};
+
+/** One recorded event */
+typedef struct {
+   uint64_t           start_nanos;
+   uint64_t           end_nanos;
+   const char *       name;              ///< always a constant string
+   Timeline_Category  category;
+   bool               instant;
+   bool               has_display;
+   DDCA_IO_Path       io_path;
+   int                feature_code;      ///< -1 if none
+   int                tryct;             ///< 0 unless TL_RETRY
+   DDCA_Status        status;
+} Timeline_Event;
+
+/** Events and current context of one thread */
+typedef struct {
+   pid_t              thread_id;
+   bool               has_display;
+   DDCA_IO_Path       io_path;
+   int                feature_code;
+   GMutex             events_mutex;      ///< uncontended except while writing the file
+   GArray *           events;            ///< Timeline_Event
+   int                dropped_ct;
+} Timeline_Thread;
+
+
+bool               timeline_enabled = false;
+static char *      timeline_file_name = NULL;
+static uint64_t    timeline_start_nanos = 0;
+static GPtrArray * timeline_threads = NULL;       // Timeline_Thread *, never freed
+static GMutex      timeline_threads_mutex;
+// Thread records outlive their threads, so that their events are written
+static GPrivate    timeline_thread_key = G_PRIVATE_INIT(NULL);
+
+
+static void write_at_exit() {
+   if (timeline_enabled)
+      timeline_write(NULL);
+}
+
+
+/** Enables the timeline recorder.
+ *
+ *  \param  filename  file to which the timeline is written at program exit
+ */
+void timeline_enable(const char * filename) {
+   g_mutex_lock(&timeline_threads_mutex);
+   if (!timeline_threads) {
+      timeline_threads = g_ptr_array_new();
+      timeline_start_nanos = cur_realtime_nanosec();
+      atexit(write_at_exit);
+   }
+   free(timeline_file_name);
+   timeline_file_name = g_strdup(filename);
+   timeline_enabled = true;
+   g_mutex_unlock(&timeline_threads_mutex);
+}
+
+
+static Timeline_Thread * get_timeline_thread() {
+   Timeline_Thread * tt = g_private_get(&timeline_thread_key);
+   if (!tt) {
+      tt = g_new0(Timeline_Thread, 1);
+#ifdef TARGET_BSD
+      tt->thread_id = pthread_getthreadid_np();
+#else
+      tt->thread_id = syscall(SYS_gettid);
+#endif
+      tt->feature_code = -1;
+      g_mutex_init(&tt->events_mutex);
+      tt->events = g_array_sized_new(false, false, sizeof(Timeline_Event), 1000);
+      g_mutex_lock(&timeline_threads_mutex);
+      g_ptr_array_add(timeline_threads, tt);
+      g_mutex_unlock(&timeline_threads_mutex);
+      g_private_set(&timeline_thread_key, tt);
+   }
+   return tt;
+}
+
+
+/** Sets the display to which subsequent events on the current thread
+ *  are attributed.
+ *
+ *  \param  io_path  display path, NULL if no display
+ */
+void timeline_set_current_display(DDCA_IO_Path * io_path) {
+   if (timeline_enabled) {
+      Timeline_Thread * tt = get_timeline_thread();
+      tt->has_display = io_path;
+      if (io_path)
+         tt->io_path = *io_path;
+   }
+}
+
+
+/** Sets the feature code to which subsequent events on the current thread
+ *  are attributed.
+ *
+ *  \param  feature_code  VCP feature code, -1 if none
+ *  \return prior feature code
+ */
+int timeline_set_current_feature(int feature_code) {
+   int prior = -1;
+   if (timeline_enabled) {
+      Timeline_Thread * tt = get_timeline_thread();
+      prior = tt->feature_code;
+      tt->feature_code = feature_code;
+   }
+   return prior;
+}
+
+
+static void add_event(
+      Timeline_Category category,
+      const char *      name,
+      bool              instant,
+      uint64_t          start_nanos,
+      uint64_t          end_nanos,
+      int               tryct,
+      DDCA_Status       status)
+{
+   Timeline_Thread * tt = get_timeline_thread();
+   if (tt->events->len >= TIMELINE_MAX_EVENTS_PER_THREAD) {
+      tt->dropped_ct++;
+      return;
+   }
+   Timeline_Event evt;
+   evt.start_nanos  = start_nanos;
+   evt.end_nanos    = end_nanos;
+   evt.name         = name;
+   evt.category     = category;
+   evt.instant      = instant;
+   evt.has_display  = tt->has_display;
+   evt.io_path      = tt->io_path;
+   evt.feature_code = tt->feature_code;
+   evt.tryct        = tryct;
+   evt.status       = status;
+   g_mutex_lock(&tt->events_mutex);
+   g_array_append_val(tt->events, evt);
+   g_mutex_unlock(&tt->events_mutex);
+}
+
+
+/** Records an event with a duration.
+ *
+ *  \param  category     event category
+ *  \param  name         event name, must be a constant string
+ *  \param  start_nanos  start time, as returned by cur_realtime_nanosec()
+ *  \param  end_nanos    end time, as returned by cur_realtime_nanosec()
+ *  \param  status       status code, 0 if success or not applicable
+ */
+void timeline_record_span(
+      Timeline_Category category,
+      const char *      name,
+      uint64_t          start_nanos,
+      uint64_t          end_nanos,
+      DDCA_Status       status)
+{
+   if (timeline_enabled)
+      add_event(category, name, false, start_nanos, end_nanos, 0, status);
+}
+
+
+/** Records the outcome of a retryable operation.
+ *
+ *  \param  name    operation name, must be a constant string
+ *  \param  tryct   number of tries
+ *  \param  status  status code of the operation
+ */
+void timeline_record_tries(
+      const char *      name,
+      int               tryct,
+      DDCA_Status       status)
+{
+   if (timeline_enabled) {
+      uint64_t now = cur_realtime_nanosec();
+      add_event(TL_RETRY, name, true, now, now, tryct, status);
+   }
+}
+
+
+static void write_event(FILE * fp, pid_t pid, pid_t tid, Timeline_Event * evt) {
+   // timestamps are in microseconds
+   double ts = (evt->start_nanos - timeline_start_nanos) / 1000.0;
+   fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f",
+               evt->name, timeline_category_names[evt->category], pid, tid, ts);
+   if (evt->instant)
+      fprintf(fp, ",\"ph\":\"i\",\"s\":\"t\"");
+   else
+      fprintf(fp, ",\"ph\":\"X\",\"dur\":%.3f", (evt->end_nanos - evt->start_nanos) / 1000.0);
+
+   fprintf(fp, ",\"args\":{");
+   char * sepr = "";
+   if (evt->has_display) {
+      fprintf(fp, "\"display\":\"%s\"", dpath_short_name_t(&evt->io_path));
+      sepr = ",";
+   }
+   if (evt->feature_code >= 0) {
+      fprintf(fp, "%s\"feature\":\"0x%02x\"", sepr, evt->feature_code);
+      sepr = ",";
+   }
+   if (evt->category == TL_RETRY) {
+      fprintf(fp, "%s\"tries\":%d", sepr, evt->tryct);
+      sepr = ",";
+   }
+   if (evt->status != 0)
+      fprintf(fp, "%s\"status\":\"%s\"", sepr, psc_name(evt->status));
+   fprintf(fp, "}}");
+}
+
+
+/** Writes the recorded events of all threads in Chrome trace event format.
+ *
+ *  \param  filename  file name, if NULL use the name set by #timeline_enable()
+ *  \return 0 if success, -errno if error
+ */
+Status_Errno timeline_write(const char * filename) {
+   if (!filename)
+      filename = timeline_file_name;
+   if (!timeline_threads || !filename)
+      return -EINVAL;
+   FILE * fp = fopen(filename, "w");
+   if (!fp)
+      return -errno;
+
+   pid_t pid = getpid();
+   bool first = true;
+   fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+   g_mutex_lock(&timeline_threads_mutex);
+   for (int ndx = 0; ndx < timeline_threads->len; ndx++) {
+      Timeline_Thread * tt = g_ptr_array_index(timeline_threads, ndx);
+      g_mutex_lock(&tt->events_mutex);
+      fprintf(fp, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                  "\"args\":{\"name\":\"Thread %d%s\"}}",
+                  (first) ? "" : ",", pid, tt->thread_id, tt->thread_id,
+                  (tt->dropped_ct > 0) ? ", events dropped" : "");
+      first = false;
+      for (int evtndx = 0; evtndx < tt->events->len; evtndx++)
+         write_event(fp, pid, tt->thread_id, &g_array_index(tt->events, Timeline_Event, evtndx));
+      g_mutex_unlock(&tt->events_mutex);
+   }
+   g_mutex_unlock(&timeline_threads_mutex);
+   fprintf(fp, "\n]}\n");
+
+   int rc = (ferror(fp)) ? -EIO : 0;
+   if (fclose(fp) != 0 && rc == 0)
+      rc = -errno;
+   return rc;
+}
@@ -0,0 +1,47 @@
+/** \file timeline.h
+ *
+ *  Records DDC transactions, sleeps, and retries with their start and end
+ *  times, for output in Chrome trace event format
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef TIMELINE_H_
+#define TIMELINE_H_
+
+/** \cond */
+#include <inttypes.h>
+#include <stdbool.h>
+/** \endcond */
+
+#include "public/ddcutil_types.h"
+
+#include "base/status_code_mgt.h"
+
+/** Timeline event categories */
+typedef enum {
+   TL_IO,          ///< system call, e.g. read(), write(), ioctl()
+   TL_SLEEP,       ///< sleep required by the DDC protocol
+   TL_RETRY,       ///< outcome of a retryable operation
+   TL_VCP          ///< feature read or write, including retries and sleeps
+} Timeline_Category;
+
+extern bool timeline_enabled;
+
+void         timeline_enable(const char * filename);
+void         timeline_set_current_display(DDCA_IO_Path * io_path);
+int          timeline_set_current_feature(int feature_code);
+void         timeline_record_span(
+                Timeline_Category category,
+                const char *      name,
+                uint64_t          start_nanos,
+                uint64_t          end_nanos,
+                DDCA_Status       status);
+void         timeline_record_tries(
+                const char *      name,
+                int               tryct,
+                DDCA_Status       status);
+Status_Errno timeline_write(const char * filename);
+
+#endif /* TIMELINE_H_ */
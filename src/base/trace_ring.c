@@ -0,0 +1,778 @@
+/** \file trace_ring.c
+ *
+ *  Low overhead recording of trace messages.
+ *
+ *  Normally dbgtrc() formats each trace message and writes it to the
+ *  current FOUT device, which greatly perturbs the timing of DDC exchanges.
+ *  When the trace ring is enabled, dbgtrc() instead records the time, the
+ *  thread id, the call site, and the raw argument values as a fixed size
+ *  binary record in a ring buffer owned by the calling thread.  Once a
+ *  thread's ring buffer and a call site have been registered, recording
+ *  requires neither locks nor memory allocation.
+ *
+ *  The ring buffers are written to a file on request, at program exit,
+ *  and if the program crashes.  Command "ddcutil trace-decode" formats the
+ *  records in the file as conventional trace messages.
+ *
+ *  The format string determines how arguments are recorded.  String
+ *  arguments are copied into the record, and may be truncated.  Other
+ *  arguments are recorded as 64 bit words.  If a record is too small for
+ *  all arguments, the remaining arguments are decoded as "<?>".
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "config.h"
+
+/** \cond */
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <glib-2.0/glib.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef TARGET_BSD
+#include <pthread_np.h>
+#else
+#include <sys/types.h>
+#include <sys/syscall.h>
+#endif
+#include <unistd.h>
+/** \endcond */
+
+#include "util/coredefs_base.h"
+#include "util/string_util.h"
+#include "util/timestamp.h"
+
+#include "base/core.h"
+#include "base/parms.h"
+
+#include "base/trace_ring.h"
+
+
+#define TRACE_RING_FILE_MARKER   "DDCTRING"
+#define TRACE_RING_FILE_VERSION  1
+#define TRACE_RING_ARG_WORDS     14      ///< record size is 128 bytes
+#define TRACE_RING_STRING_WORDS   4      ///< maximum words occupied by a string argument
+#define TRACE_RING_MAX_THREADS   64
+#define TRACE_RING_CALL_SITES  4096      ///< must be a power of 2
+
+#define TRACE_RECORD_ARGS_TRUNCATED  0x01
+
+/** One recorded trace message */
+typedef struct {
+   uint64_t  timestamp;                   ///< nanoseconds since program start
+   uint32_t  thread_id;
+   uint16_t  call_site_id;
+   uint8_t   arg_words;                   ///< number of words of args[] used
+   uint8_t   flags;
+   uint64_t  args[TRACE_RING_ARG_WORDS];
+} Trace_Record;
+
+typedef enum {
+   CALL_SITE_FREE,
+   CALL_SITE_CLAIMED,                     ///< being registered by some thread
+   CALL_SITE_READY
+} Call_Site_State;
+
+/** A trace call, identified by function and line number */
+typedef struct {
+   gint          state;                   ///< Call_Site_State
+   int           lineno;
+   const char *  funcname;                ///< __func__ of caller
+   const char *  filename;                ///< __FILE__ of caller
+   char *        format;                  ///< copy, as the format need not be a literal
+} Call_Site;
+
+/** Records of one thread, written only by that thread */
+typedef struct {
+   uint32_t      thread_id;
+   uint64_t      recorded_ct;             ///< next record is records[recorded_ct % size]
+   Trace_Record  records[TRACE_RING_RECORDS_PER_THREAD];
+} Trace_Ring;
+
+// Trace ring file layout:
+//   Trace_File_Header
+//   call_site_ct * (Trace_File_Call_Site, funcname, filename, format)
+//   ring_ct * (Trace_File_Ring, record_ct * Trace_Record)
+
+typedef struct {
+   char      marker[8];                   ///< TRACE_RING_FILE_MARKER, not null terminated
+   uint32_t  version;
+   uint32_t  record_size;                 ///< sizeof(Trace_Record) of the writing program
+   uint32_t  call_site_ct;
+   uint32_t  ring_ct;
+} Trace_File_Header;
+
+typedef struct {
+   uint32_t  call_site_id;
+   int32_t   lineno;
+   uint16_t  funcname_len;                ///< lengths of the strings that follow,
+   uint16_t  filename_len;                ///< without terminating nulls
+   uint16_t  format_len;
+   uint16_t  reserved;
+} Trace_File_Call_Site;
+
+typedef struct {
+   uint32_t  thread_id;
+   uint32_t  record_ct;                   ///< records that follow, oldest first
+   uint64_t  recorded_ct;                 ///< records ever written by the thread
+} Trace_File_Ring;
+
+
+bool                trace_ring_enabled = false;
+static char *       dump_file_name = NULL;
+static Call_Site    call_sites[TRACE_RING_CALL_SITES];
+static Trace_Ring * rings[TRACE_RING_MAX_THREADS];
+static gint         ring_ct = 0;
+static char         no_ring_marker;       // thread could not be assigned a ring
+// Rings outlive their threads, so that records of ended threads are dumped
+static GPrivate     thread_ring_key = G_PRIVATE_INIT(NULL);
+
+
+//
+// Format string parsing, common to recording and decoding
+//
+
+typedef enum {
+   ARG_NONE,
+   ARG_INT,
+   ARG_LONG,
+   ARG_LONG_LONG,
+   ARG_SIZE,
+   ARG_INTMAX,
+   ARG_PTRDIFF,
+   ARG_DOUBLE,
+   ARG_LONG_DOUBLE,
+   ARG_POINTER,
+   ARG_STRING
+} Arg_Type;
+
+typedef struct {
+   int       len;                         ///< length of the specification, including '%'
+   bool      valid;
+   bool      star_width;
+   bool      star_precision;
+   int       precision;                   ///< -1 if not specified or '*'
+   Arg_Type  type;
+} Conversion_Spec;
+
+
+// Parses the conversion specification starting at spec[0] == '%'
+static void parse_conversion(const char * spec, Conversion_Spec * conv) {
+   memset(conv, 0, sizeof(Conversion_Spec));
+   conv->precision = -1;
+   const char * p = spec+1;
+   while (*p && strchr("-+ #0'I", *p))
+      p++;
+   if (*p == '*') {
+      conv->star_width = true;
+      p++;
+   }
+   else {
+      while (g_ascii_isdigit(*p))
+         p++;
+   }
+   if (*p == '.') {
+      p++;
+      if (*p == '*') {
+         conv->star_precision = true;
+         p++;
+      }
+      else {
+         conv->precision = 0;
+         while (g_ascii_isdigit(*p))
+            conv->precision = conv->precision*10 + (*p++ - '0');
+      }
+   }
+
+   Arg_Type int_type = ARG_INT;
+   bool     long_double = false;
+   switch (*p) {
+   case 'h':  p++;  if (*p == 'h') p++;                          break;
+   case 'l':  p++;  int_type = ARG_LONG;
+              if (*p == 'l') { p++; int_type = ARG_LONG_LONG; }  break;
+   case 'q':  p++;  int_type = ARG_LONG_LONG;                    break;
+   case 'L':  p++;  int_type = ARG_LONG_LONG; long_double = true; break;
+   case 'j':  p++;  int_type = ARG_INTMAX;                       break;
+   case 'z':
+   case 'Z':  p++;  int_type = ARG_SIZE;                         break;
+   case 't':  p++;  int_type = ARG_PTRDIFF;                      break;
+   }
+
+   conv->valid = true;
+   switch (*p) {
+   case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c':
+      conv->type = int_type;
+      break;
+   case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+      conv->type = (long_double) ? ARG_LONG_DOUBLE : ARG_DOUBLE;
+      break;
+   case 'p':
+      conv->type = ARG_POINTER;
+      break;
+   case 's':
+      conv->type = ARG_STRING;
+      break;
+   case '%':
+      conv->type = ARG_NONE;
+      break;
+   default:          // includes %n, %m, and truncated specifications
+      conv->valid = false;
+      break;
+   }
+   conv->len = (*p) ? p+1-spec : p-spec;
+}
+
+
+// Number of argument words a conversion requires, apart from a string's contents
+static int conversion_words(Conversion_Spec * conv) {
+   return conv->star_width + conv->star_precision + ((conv->type == ARG_NONE) ? 0 : 1);
+}
+
+
+//
+// Recording
+//
+
+// Returns NULL if the maximum number of threads already have rings
+static Trace_Ring * get_thread_ring() {
+   Trace_Ring * ring = g_private_get(&thread_ring_key);
+   if (!ring) {
+      int ndx = g_atomic_int_add(&ring_ct, 1);
+      if (ndx < TRACE_RING_MAX_THREADS) {
+         ring = g_new0(Trace_Ring, 1);
+#ifdef TARGET_BSD
+         ring->thread_id = pthread_getthreadid_np();
+#else
+         ring->thread_id = syscall(SYS_gettid);
+#endif
+         g_atomic_pointer_set(&rings[ndx], ring);
+         g_private_set(&thread_ring_key, ring);
+      }
+      else {
+         g_private_set(&thread_ring_key, &no_ring_marker);
+      }
+   }
+   if (ring == (Trace_Ring *) &no_ring_marker)
+      ring = NULL;
+   return ring;
+}
+
+
+// Returns -1 if the call site table is full
+static int get_call_site_id(
+      const char * funcname,
+      int          lineno,
+      const char * filename,
+      const char * format)
+{
+   guint hash = (guint) (((uintptr_t) funcname >> 3) ^ ((guint) lineno * 2654435761u));
+   for (int probe = 0; probe < TRACE_RING_CALL_SITES; probe++) {
+      int ndx = (hash + probe) & (TRACE_RING_CALL_SITES-1);
+      Call_Site * site = &call_sites[ndx];
+      gint state = g_atomic_int_get(&site->state);
+      if (state == CALL_SITE_FREE) {
+         if (g_atomic_int_compare_and_exchange(&site->state, CALL_SITE_FREE, CALL_SITE_CLAIMED)) {
+            site->funcname = funcname;
+            site->lineno   = lineno;
+            site->filename = filename;
+            site->format   = g_strdup(format);
+            g_atomic_int_set(&site->state, CALL_SITE_READY);
+            return ndx;
+         }
+         state = g_atomic_int_get(&site->state);
+      }
+      while (state == CALL_SITE_CLAIMED)
+         state = g_atomic_int_get(&site->state);
+      if (site->funcname == funcname && site->lineno == lineno)
+         return ndx;
+   }
+   return -1;
+}
+
+
+// Returns number of words of rec->args used
+static int record_args(const char * format, va_list args, Trace_Record * rec) {
+   int used = 0;
+   for (const char * p = format; *p; p++) {
+      if (*p != '%')
+         continue;
+      Conversion_Spec conv;
+      parse_conversion(p, &conv);
+      if (!conv.valid)
+         break;
+      p += conv.len-1;
+      if (used + conversion_words(&conv) > TRACE_RING_ARG_WORDS) {
+         rec->flags |= TRACE_RECORD_ARGS_TRUNCATED;
+         break;
+      }
+      if (conv.star_width)
+         rec->args[used++] = (int64_t) va_arg(args, int);
+      int precision = conv.precision;
+      if (conv.star_precision) {
+         precision = va_arg(args, int);
+         rec->args[used++] = (int64_t) precision;
+      }
+
+      switch (conv.type) {
+      case ARG_NONE:
+         break;
+      case ARG_INT:
+         rec->args[used++] = (int64_t) va_arg(args, int);
+         break;
+      case ARG_LONG:
+         rec->args[used++] = (int64_t) va_arg(args, long);
+         break;
+      case ARG_LONG_LONG:
+         rec->args[used++] = (int64_t) va_arg(args, long long);
+         break;
+      case ARG_SIZE:
+         rec->args[used++] = (uint64_t) va_arg(args, size_t);
+         break;
+      case ARG_INTMAX:
+         rec->args[used++] = (int64_t) va_arg(args, intmax_t);
+         break;
+      case ARG_PTRDIFF:
+         rec->args[used++] = (int64_t) va_arg(args, ptrdiff_t);
+         break;
+      case ARG_DOUBLE:
+      case ARG_LONG_DOUBLE:
+      {
+         double d = (conv.type == ARG_DOUBLE) ? va_arg(args, double)
+                                              : (double) va_arg(args, long double);
+         memcpy(&rec->args[used++], &d, sizeof(double));
+         break;
+      }
+      case ARG_POINTER:
+         rec->args[used++] = (uintptr_t) va_arg(args, void *);
+         break;
+      case ARG_STRING:
+      {
+         const char * s = va_arg(args, char *);
+         if (!s)
+            s = "(null)";
+         int maxchars = MIN(TRACE_RING_STRING_WORDS, TRACE_RING_ARG_WORDS-used) * 8 - 1;
+         if (precision >= 0 && precision < maxchars)
+            maxchars = precision;
+         int len = strnlen(s, maxchars);
+         char * dest = (char *) &rec->args[used];
+         memcpy(dest, s, len);
+         dest[len] = '\0';
+         used += len/8 + 1;     // the decoder recovers the word count from the length
+         break;
+      }
+      }
+   }
+   return used;
+}
+
+
+/** Records a trace message in the current thread's ring buffer.
+ *  Called by dbgtrc() when the trace ring is enabled.
+ *
+ *  \param  funcname  function name of caller
+ *  \param  lineno    line number in caller
+ *  \param  filename  file name of caller
+ *  \param  format    format string for message
+ *  \param  args      arguments for format string
+ */
+void trace_ring_record(
+      const char * funcname,
+      int          lineno,
+      const char * filename,
+      const char * format,
+      va_list      args)
+{
+   Trace_Ring * ring = get_thread_ring();
+   if (!ring)
+      return;
+   int call_site_id = get_call_site_id(funcname, lineno, filename, format);
+   if (call_site_id < 0)
+      return;
+
+   Trace_Record * rec = &ring->records[ring->recorded_ct % TRACE_RING_RECORDS_PER_THREAD];
+   rec->timestamp    = elapsed_time_nanosec();
+   rec->thread_id    = ring->thread_id;
+   rec->call_site_id = call_site_id;
+   rec->flags        = 0;
+   rec->arg_words    = record_args(format, args, rec);
+   // publish the record to a concurrent trace_ring_dump()
+   __atomic_store_n(&ring->recorded_ct, ring->recorded_ct+1, __ATOMIC_RELEASE);
+}
+
+
+//
+// Writing the trace ring file
+//
+// Uses only async-signal-safe functions, as it is called from a signal handler.
+//
+
+static bool write_all(int fd, const void * buf, size_t len) {
+   const char * p = buf;
+   while (len > 0) {
+      ssize_t ct = write(fd, p, len);
+      if (ct < 0 && errno == EINTR)
+         continue;
+      if (ct <= 0)
+         return false;
+      p   += ct;
+      len -= ct;
+   }
+   return true;
+}
+
+
+/** Writes the call sites and the records of all threads to a file.
+ *
+ *  Records written by other threads while the dump is in progress
+ *  may be omitted, or may be incomplete.
+ *
+ *  \param  filename  file name, if NULL use the name set by #trace_ring_enable()
+ *  \return 0 if success, -errno if error
+ */
+Status_Errno trace_ring_dump(const char * filename) {
+   if (!filename)
+      filename = dump_file_name;
+   if (!filename)
+      return -EINVAL;
+   int fd = open(filename, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+   if (fd < 0)
+      return -errno;
+
+   Trace_Ring * dumped_rings[TRACE_RING_MAX_THREADS];
+   int dumped_ring_ct = 0;
+   int max_ndx = MIN(g_atomic_int_get(&ring_ct), TRACE_RING_MAX_THREADS);
+   for (int ndx = 0; ndx < max_ndx; ndx++) {
+      Trace_Ring * ring = g_atomic_pointer_get(&rings[ndx]);
+      if (ring)
+         dumped_rings[dumped_ring_ct++] = ring;
+   }
+   bool dumped_sites[TRACE_RING_CALL_SITES];
+   Trace_File_Header header;
+   memset(&header, 0, sizeof(header));
+   memcpy(header.marker, TRACE_RING_FILE_MARKER, sizeof(header.marker));
+   header.version     = TRACE_RING_FILE_VERSION;
+   header.record_size = sizeof(Trace_Record);
+   header.ring_ct     = dumped_ring_ct;
+   for (int ndx = 0; ndx < TRACE_RING_CALL_SITES; ndx++) {
+      dumped_sites[ndx] = (g_atomic_int_get(&call_sites[ndx].state) == CALL_SITE_READY);
+      if (dumped_sites[ndx])
+         header.call_site_ct++;
+   }
+
+   bool ok = write_all(fd, &header, sizeof(header));
+   for (int ndx = 0; ok && ndx < TRACE_RING_CALL_SITES; ndx++) {
+      if (!dumped_sites[ndx])
+         continue;
+      Call_Site * site = &call_sites[ndx];
+      Trace_File_Call_Site fsite;
+      memset(&fsite, 0, sizeof(fsite));
+      fsite.call_site_id = ndx;
+      fsite.lineno       = site->lineno;
+      fsite.funcname_len = strlen(site->funcname);
+      fsite.filename_len = strlen(site->filename);
+      fsite.format_len   = strlen(site->format);
+      ok = write_all(fd, &fsite, sizeof(fsite))                         &&
+           write_all(fd, site->funcname, fsite.funcname_len)            &&
+           write_all(fd, site->filename, fsite.filename_len)            &&
+           write_all(fd, site->format,   fsite.format_len);
+   }
+
+   for (int ndx = 0; ok && ndx < dumped_ring_ct; ndx++) {
+      Trace_Ring * ring = dumped_rings[ndx];
+      uint64_t recorded_ct = __atomic_load_n(&ring->recorded_ct, __ATOMIC_ACQUIRE);
+      Trace_File_Ring fring;
+      memset(&fring, 0, sizeof(fring));
+      fring.thread_id   = ring->thread_id;
+      fring.recorded_ct = recorded_ct;
+      fring.record_ct   = MIN(recorded_ct, TRACE_RING_RECORDS_PER_THREAD);
+      // oldest record first, the ring may wrap
+      int first = (recorded_ct - fring.record_ct) % TRACE_RING_RECORDS_PER_THREAD;
+      int ct1   = MIN(fring.record_ct, TRACE_RING_RECORDS_PER_THREAD - first);
+      ok = write_all(fd, &fring, sizeof(fring))                                     &&
+           write_all(fd, &ring->records[first], ct1 * sizeof(Trace_Record))         &&
+           write_all(fd, &ring->records[0], (fring.record_ct-ct1) * sizeof(Trace_Record));
+   }
+
+   int errsv = errno;
+   close(fd);
+   return (ok) ? 0 : -errsv;
+}
+
+
+static void dump_at_exit() {
+   if (trace_ring_enabled)
+      trace_ring_dump(NULL);
+}
+
+
+static const int crash_signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+static struct sigaction prior_crash_actions[ARRAY_SIZE(crash_signals)];
+
+
+// Restores the action that was in effect before trace_ring_enable() was called,
+// which may be a handler installed by the program using the library, and
+// re-raises the signal so that action is taken once this handler returns.
+static void dump_on_crash(int signum) {
+   if (trace_ring_enabled)
+      trace_ring_dump(NULL);
+   for (int ndx = 0; ndx < ARRAY_SIZE(crash_signals); ndx++) {
+      if (crash_signals[ndx] == signum)
+         sigaction(signum, &prior_crash_actions[ndx], NULL);
+   }
+   raise(signum);
+}
+
+
+/** Enables recording of trace messages in ring buffers, and sets
+ *  the file to which they are written at program exit or crash.
+ *
+ *  Any signal handlers already installed for crash signals are saved,
+ *  and invoked after the trace ring has been written.
+ *
+ *  \param  filename  file name
+ */
+void trace_ring_enable(const char * filename) {
+   static bool handlers_installed = false;
+   free(dump_file_name);
+   dump_file_name = g_strdup(filename);
+   trace_ring_enabled = true;
+
+   if (!handlers_installed) {
+      atexit(dump_at_exit);
+      struct sigaction sa;
+      memset(&sa, 0, sizeof(sa));
+      sa.sa_handler = dump_on_crash;
+      sigemptyset(&sa.sa_mask);
+      for (int ndx = 0; ndx < ARRAY_SIZE(crash_signals); ndx++)
+         sigaction(crash_signals[ndx], &sa, &prior_crash_actions[ndx]);
+      handlers_installed = true;
+   }
+}
+
+
+/** Returns the name of the file to which the trace ring is written
+ *  at program exit or crash, NULL if the trace ring is not enabled.
+ */
+char * trace_ring_file_name() {
+   return dump_file_name;
+}
+
+
+//
+// Decoding the trace ring file
+//
+
+static bool take_bytes(const char ** pos, const char * end, void * dest, size_t len) {
+   if (end - *pos < len)
+      return false;
+   memcpy(dest, *pos, len);
+   *pos += len;
+   return true;
+}
+
+
+static char * take_string(const char ** pos, const char * end, size_t len) {
+   if (end - *pos < len)
+      return NULL;
+   char * s = g_strndup(*pos, len);
+   *pos += len;
+   return s;
+}
+
+
+// Formats the arguments of a record as directed by the format string
+static void format_record(Trace_Record * rec, const char * format, GString * msg) {
+   // the count is read from the file, so may be invalid
+   int arg_words = MIN(rec->arg_words, TRACE_RING_ARG_WORDS);
+   int used = 0;
+   for (const char * p = format; *p; p++) {
+      if (*p != '%') {
+         g_string_append_c(msg, *p);
+         continue;
+      }
+      Conversion_Spec conv;
+      parse_conversion(p, &conv);
+      if (!conv.valid) {
+         g_string_append(msg, p);
+         break;
+      }
+      if (conv.type == ARG_NONE) {
+         g_string_append_c(msg, '%');
+         p += conv.len-1;
+         continue;
+      }
+      if (used + conversion_words(&conv) > arg_words) {
+         g_string_append(msg, "<?>");
+         p += conv.len-1;
+         continue;
+      }
+
+      // replace '*' width and precision by their recorded values
+      GString * spec = g_string_sized_new(conv.len+10);
+      for (int ndx = 0; ndx < conv.len; ndx++) {
+         if (p[ndx] == '*')
+            g_string_append_printf(spec, "%d", (int) rec->args[used++]);
+         else
+            g_string_append_c(spec, p[ndx]);
+      }
+      p += conv.len-1;
+
+      uint64_t word = rec->args[used];
+      double   d;
+      memcpy(&d, &word, sizeof(double));
+      switch (conv.type) {
+      case ARG_NONE:
+         break;
+      case ARG_INT:
+         g_string_append_printf(msg, spec->str, (int) word);         used++;  break;
+      case ARG_LONG:
+         g_string_append_printf(msg, spec->str, (long) word);        used++;  break;
+      case ARG_LONG_LONG:
+         g_string_append_printf(msg, spec->str, (long long) word);   used++;  break;
+      case ARG_SIZE:
+         g_string_append_printf(msg, spec->str, (size_t) word);      used++;  break;
+      case ARG_INTMAX:
+         g_string_append_printf(msg, spec->str, (intmax_t) word);    used++;  break;
+      case ARG_PTRDIFF:
+         g_string_append_printf(msg, spec->str, (ptrdiff_t) word);   used++;  break;
+      case ARG_DOUBLE:
+         g_string_append_printf(msg, spec->str, d);                  used++;  break;
+      case ARG_LONG_DOUBLE:
+         g_string_append_printf(msg, spec->str, (long double) d);    used++;  break;
+      case ARG_POINTER:
+         g_string_append_printf(msg, spec->str, (void *) (uintptr_t) word);  used++;  break;
+      case ARG_STRING:
+      {
+         char s[TRACE_RING_STRING_WORDS*8+1];
+         int maxchars = MIN(TRACE_RING_STRING_WORDS, arg_words-used) * 8;
+         int len = strnlen((char *) &rec->args[used], maxchars);
+         memcpy(s, &rec->args[used], len);
+         s[len] = '\0';
+         g_string_append_printf(msg, spec->str, s);
+         used += len/8 + 1;
+         break;
+      }
+      }
+      g_string_free(spec, true);
+   }
+   if (rec->flags & TRACE_RECORD_ARGS_TRUNCATED)
+      g_string_append(msg, " ...");
+}
+
+
+static gint compare_record_timestamps(gconstpointer a, gconstpointer b) {
+   const Trace_Record * rec1 = a;
+   const Trace_Record * rec2 = b;
+   return (rec1->timestamp > rec2->timestamp) - (rec1->timestamp < rec2->timestamp);
+}
+
+
+/** Writes the records in a trace ring file to the current FOUT device
+ *  as conventional trace messages, ordered by time.
+ *
+ *  \param  filename  name of file written by #trace_ring_dump()
+ *  \return true if success, false if the file could not be read or is invalid
+ */
+bool trace_ring_decode_file(const char * filename) {
+   bool ok = false;
+   gchar * contents = NULL;
+   gsize   length = 0;
+   GError * gerr = NULL;
+   if (!g_file_get_contents(filename, &contents, &length, &gerr)) {
+      f0printf(ferr(), "Error reading %s: %s\n", filename, gerr->message);
+      g_error_free(gerr);
+      return false;
+   }
+
+   Call_Site * sites = g_new0(Call_Site, TRACE_RING_CALL_SITES);
+   GArray * records = g_array_new(false, false, sizeof(Trace_Record));
+   const char * pos = contents;
+   const char * end = contents + length;
+
+   Trace_File_Header header;
+   if (!take_bytes(&pos, end, &header, sizeof(header)) ||
+         memcmp(header.marker, TRACE_RING_FILE_MARKER, sizeof(header.marker)) != 0)
+   {
+      f0printf(ferr(), "%s is not a trace ring file\n", filename);
+      goto bye;
+   }
+   if (header.version != TRACE_RING_FILE_VERSION || header.record_size != sizeof(Trace_Record)) {
+      f0printf(ferr(), "%s was written by an incompatible version of ddcutil\n", filename);
+      goto bye;
+   }
+
+   for (int ndx = 0; ndx < header.call_site_ct; ndx++) {
+      Trace_File_Call_Site fsite;
+      if (!take_bytes(&pos, end, &fsite, sizeof(fsite)) ||
+            fsite.call_site_id >= TRACE_RING_CALL_SITES)
+         goto invalid;
+      Call_Site * site = &sites[fsite.call_site_id];
+      // a duplicate call site replaces the previous one
+      free((char *) site->funcname);
+      free((char *) site->filename);
+      free(site->format);
+      site->state    = CALL_SITE_READY;
+      site->lineno   = fsite.lineno;
+      site->funcname = take_string(&pos, end, fsite.funcname_len);
+      site->filename = take_string(&pos, end, fsite.filename_len);
+      site->format   = take_string(&pos, end, fsite.format_len);
+      if (!site->funcname || !site->filename || !site->format)
+         goto invalid;
+   }
+
+   f0printf(fout(), "Trace ring file %s: %d threads, %d call sites\n",
+                    filename, header.ring_ct, header.call_site_ct);
+   for (int ndx = 0; ndx < header.ring_ct; ndx++) {
+      Trace_File_Ring fring;
+      if (!take_bytes(&pos, end, &fring, sizeof(fring)) ||
+            end - pos < (uint64_t) fring.record_ct * sizeof(Trace_Record))
+         goto invalid;
+      g_array_append_vals(records, pos, fring.record_ct);
+      pos += fring.record_ct * sizeof(Trace_Record);
+      f0printf(fout(), "   Thread %7u: %u records retained, %"PRIu64" overwritten\n",
+                       fring.thread_id, fring.record_ct, fring.recorded_ct - fring.record_ct);
+   }
+   f0printf(fout(), "\n");
+
+   g_array_sort(records, compare_record_timestamps);
+   GString * msg = g_string_new(NULL);
+   for (int ndx = 0; ndx < records->len; ndx++) {
+      Trace_Record * rec = &g_array_index(records, Trace_Record, ndx);
+      g_string_truncate(msg, 0);
+      Call_Site * site = (rec->call_site_id < TRACE_RING_CALL_SITES &&
+                          sites[rec->call_site_id].state == CALL_SITE_READY)
+                                 ? &sites[rec->call_site_id] : NULL;
+      if (site)
+         format_record(rec, site->format, msg);
+      else
+         g_string_append_printf(msg, "Unknown call site %d", rec->call_site_id);
+      uint64_t isecs   = rec->timestamp / (1000 * 1000 * 1000);
+      uint64_t imillis = rec->timestamp / (1000 * 1000);
+      f0printf(fout(), "[%7u][%3"PRIu64".%03"PRIu64"](%-30s) %s\n",
+                       rec->thread_id, isecs, imillis - (isecs*1000),
+                       (site) ? site->funcname : "", msg->str);
+   }
+   g_string_free(msg, true);
+   ok = true;
+   goto bye;
+
+invalid:
+   f0printf(ferr(), "Invalid or truncated trace ring file %s\n", filename);
+bye:
+   for (int ndx = 0; ndx < TRACE_RING_CALL_SITES; ndx++) {
+      free((char *) sites[ndx].funcname);
+      free((char *) sites[ndx].filename);
+      free(sites[ndx].format);
+   }
+   free(sites);
+   g_array_free(records, true);
+   g_free(contents);
+   return ok;
+}
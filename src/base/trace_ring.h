@@ -0,0 +1,33 @@
+/** \file trace_ring.h
+ *
+ *  Low overhead recording of trace messages as binary records in
+ *  per-thread ring buffers, for later decoding
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef TRACE_RING_H_
+#define TRACE_RING_H_
+
+/** \cond */
+#include <stdarg.h>
+#include <stdbool.h>
+/** \endcond */
+
+#include "base/status_code_mgt.h"
+
+extern bool trace_ring_enabled;   // record trace messages instead of writing them
+
+void         trace_ring_enable(const char * filename);
+char *       trace_ring_file_name();
+void         trace_ring_record(
+                const char * funcname,
+                int          lineno,
+                const char * filename,
+                const char * format,
+                va_list      args);
+Status_Errno trace_ring_dump(const char * filename);
+bool         trace_ring_decode_file(const char * filename);
+
+#endif /* TRACE_RING_H_ */
@@ -22,8 +22,10 @@
 #include "base/parms.h"
 #include "base/dynamic_sleep.h"
 #include "base/execution_stats.h"
+#include "base/last_io_event.h"
 #include "base/sleep.h"
 #include "base/thread_sleep_data.h"
+#include "base/timeline.h"
 
 // Experimental suppression of sleeps after reads
 static bool sleep_suppression_enabled = DEFAULT_SLEEP_LESS;
@@ -52,6 +54,20 @@ bool is_deferred_sleep_enabled() {
 }
 
 
+// Reduce sleeps by the time since the last I/O on the display
+static bool idle_aware_sleep_enabled = DEFAULT_IDLE_AWARE_SLEEP;
+
+bool enable_idle_aware_sleep(bool enable) {
+   bool old = idle_aware_sleep_enabled;
+   idle_aware_sleep_enabled = enable;
+   return old;
+}
+
+bool is_idle_aware_sleep_enabled() {
+   return idle_aware_sleep_enabled;
+}
+
+
 
 
 /* Two multipliers are applied to the sleep time determined from the
@@ -74,10 +90,11 @@ bool is_deferred_sleep_enabled() {
  *  The time is further adjusted by the sleep factor and sleep multiplier
  *  currently in effect.
  *
+ *  If idle aware sleep is enabled, the sleep is shortened by the time
+ *  that has already elapsed since the last I/O on the display, and
+ *  skipped entirely if that time exceeds the required sleep.
+ *
  *  \todo
- *  Take into account the time since the last monitor return in the
- *  current thread.
- *  \tod
  *  Take into account per-display error statistics.  Would require
  *  error statistics be maintained on a per-display basis, either
  *  in the display reference or display handle.
@@ -266,6 +283,20 @@ void tuned_sleep_with_tracex(
 
       record_sleep_event(event_type);
 
+      // The display only needs the interval since its last I/O, not since now
+      int sleep_time_millis = (int) adjusted_sleep_time_millis;
+      uint64_t last_io_nanos = (idle_aware_sleep_enabled && io_mode == DDCA_IO_I2C)
+                                  ? get_last_io_finish_time(dh->fd)
+                                  : 0;
+      if (last_io_nanos > 0) {
+         int idle_millis = (cur_realtime_nanosec() - last_io_nanos) / (1000*1000);
+         int remaining_millis = MAX(sleep_time_millis - idle_millis, 0);
+         DBGMSF(debug, "sleep_time_millis=%d, idle_millis=%d, remaining_millis=%d",
+                       sleep_time_millis, idle_millis, remaining_millis);
+         record_sleep_reduction(sleep_time_millis, remaining_millis);
+         sleep_time_millis = remaining_millis;
+      }
+
       char msg_buf[100];
       const char * evname = sleep_event_name(event_type);
       if (msg)
@@ -274,14 +305,16 @@ void tuned_sleep_with_tracex(
          g_snprintf(msg_buf, 100, "Event_type: %s", evname);
 
       if (deferrable_sleep) {
-         uint64_t new_deferred_time = cur_realtime_nanosec() + (1000 *1000) * (int) adjusted_sleep_time_millis;
+         uint64_t new_deferred_time = cur_realtime_nanosec() + (1000 *1000) * (uint64_t) sleep_time_millis;
          if (new_deferred_time > dh->dref->next_i2c_io_after) {
             DBGMSF(debug, "Setting deferred sleep");
             dh->dref->next_i2c_io_after = new_deferred_time;
          }
       }
-      else {
-         sleep_millis_with_tracex(adjusted_sleep_time_millis, func, lineno, filename, msg_buf);
+      else if (sleep_time_millis > 0) {
+         uint64_t sleep_start = cur_realtime_nanosec();
+         sleep_millis_with_tracex(sleep_time_millis, func, lineno, filename, msg_buf);
+         timeline_record_span(TL_SLEEP, evname, sleep_start, cur_realtime_nanosec(), 0);
       }
    }   // !suppress
 
@@ -311,6 +344,7 @@ void check_deferred_sleep(Display_Handle * dh, const char * func, int lineno, co
       DBGMSF(debug, "Sleeping for %d milliseconds", sleep_time);
       // sleep_millis_with_tracex(sleep_time, func, lineno, filename, "deferred");
       sleep_millis_with_tracex(sleep_time, __func__, __LINE__, __FILE__, "deferred");
+      timeline_record_span(TL_SLEEP, "deferred", curtime, cur_realtime_nanosec(), 0);
    }
 }
 
@@ -23,6 +23,9 @@ bool is_sleep_suppression_enabled();
 bool enable_deferred_sleep(bool enable);
 bool is_deferred_sleep_enabled();
 
+bool enable_idle_aware_sleep(bool enable);
+bool is_idle_aware_sleep_enabled();
+
 
 // Perform tuned sleep
 void tuned_sleep_with_tracex(
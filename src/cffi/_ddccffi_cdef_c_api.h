@@ -289,6 +289,16 @@ ddca_get_any_vcp_value_using_explicit_type(
        DDCA_Vcp_Value_Type_Parm    call_type,
        DDCA_Any_Vcp_Value **       valrec_loc);
 
+DDCA_Status
+ddca_get_any_vcp_value_using_implicit_type(
+       DDCA_Display_Handle         ddca_dh,
+       DDCA_Vcp_Feature_Code       feature_code,
+       DDCA_Any_Vcp_Value **       valrec_loc);
+
+void
+ddca_free_any_vcp_value(
+       DDCA_Any_Vcp_Value *        valrec);
+
 DDCA_Status
 ddca_get_formatted_vcp_value(
        DDCA_Display_Handle *       ddca_dh,
@@ -683,6 +683,11 @@ def convert_to_python(s):
     elif type.kind == 'primitive':
         return int(s)
 
+def table_bytes(valrec):
+    # single copy from the C buffer, rather than building a list of ints
+    return ffi.buffer(valrec.val.t.bytes, valrec.val.t.bytect)[:]
+
+
 class Display_Handle(object):
 
     @classmethod
@@ -789,12 +794,42 @@ class Display_Handle(object):
                         valrec.val.c_nc.sh, 
                         valrec.val.c_nc.sl )
        else:
-           # bytestring = ??
-           bytestring = None
-           retval = Table_Vcp_Value(valrec.opcode, bytestring)
+           retval = Table_Vcp_Value(valrec.opcode, table_bytes(valrec))
        return retval
 
 
+    def get_vcp_values(self, feature_codes):
+       """Reads multiple feature values.
+
+       All reads are performed before any Python value objects are built.
+       CFFI releases the GIL for the duration of each library call, so
+       other threads can drive other displays meanwhile.
+
+       Returns a dictionary mapping each feature code to a
+       Non_Table_Vcp_Value or Table_Vcp_Value, or None if the read failed.
+       """
+       ct = len(feature_codes)
+       pvalrecs = ffi.new("DDCA_Any_Vcp_Value *[]", ct)
+       statuses = [0] * ct
+       for ndx in range(ct):
+          statuses[ndx] = lib.ddca_get_any_vcp_value_using_implicit_type(
+                             self.c_dh, feature_codes[ndx], pvalrecs + ndx)
+
+       result = {}
+       for ndx in range(ct):
+          valrec = pvalrecs[ndx]
+          if statuses[ndx] != 0 or valrec == ffi.NULL:
+             result[feature_codes[ndx]] = None
+             continue
+          if valrec.value_type == lib.DDCA_NON_TABLE_VCP_VALUE:
+             v = valrec.val.c_nc
+             result[feature_codes[ndx]] = Non_Table_Vcp_Value(valrec.opcode, v.mh, v.ml, v.sh, v.sl)
+          else:
+             result[feature_codes[ndx]] = Table_Vcp_Value(valrec.opcode, table_bytes(valrec))
+          lib.ddca_free_any_vcp_value(valrec)
+       return result
+
+
     def get_formatted_vcp_value(self, feature_code):
        ps = ffi.new("char **", init=ffi.NULL)
        rc = lib.ddca_get_formatted_vcp_value(self.c_dh, feature_code, ps)
@@ -875,7 +910,7 @@ class Table_Vcp_Value(Vcp_Value):
         self.bytestring = bytestring
         
     def __repr__(self):
-        result = "[Vcp_Value: Feature 0x%02x, type=TABLE, bytes=???" % (self.opcode)
+        result = "[Vcp_Value: Feature 0x%02x, type=TABLE, bytect=%d]" % (self.opcode, len(self.bytestring))
         return result
       
               
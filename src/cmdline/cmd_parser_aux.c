@@ -53,6 +53,7 @@ static Cmd_Desc cmdinfo[] = {
 #endif
    {CMDID_PROBE,        "probe",          5,  0,       0},
    {CMDID_SAVE_SETTINGS,"scs",            3,  0,       0},
+   {CMDID_TRACE_DECODE, "trace-decode",   5,  1,       1},
 };
 static int cmdct = sizeof(cmdinfo)/sizeof(Cmd_Desc);
 
@@ -335,6 +336,7 @@ char * commands_list_help =
 #ifdef ENABLE_ENVCMDS
        "   interrogate                             Report everything possible\n"
 #endif
+       "   trace-decode <filename>                 Format trace records written using --trace-ring\n"
 #ifdef USE_USB
        "   chkusbmon                               Check if USB device is monitor (for UDEV)\n"
 #endif
@@ -180,10 +180,12 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    gboolean enable_udf_flag = false;
 #ifdef USE_USB
    gboolean enable_usb_flag = false;
+   gboolean usb_hidraw_flag = false;
 #endif
    gboolean timeout_i2c_io_flag = false;
    gboolean reduce_sleeps_flag  = DEFAULT_SLEEP_LESS;
    gboolean deferred_sleep_flag = false;
+   gboolean idle_aware_sleep_flag = DEFAULT_IDLE_AWARE_SLEEP;
    gboolean per_thread_stats_flag = false;
    gboolean dsa_flag       = false;
    gboolean f1_flag        = false;
@@ -196,6 +198,12 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    gboolean x52_no_fifo_flag  = false;
    gboolean enable_cc_flag = false;
    gboolean ignore_cc_flag = false;
+   gboolean enable_cd_flag = false;
+   gboolean disable_process_locks_flag = false;
+   gboolean disable_adaptive_retry_flag = false;
+   gboolean full_initial_checks_flag = false;
+   gboolean fixed_i2c_strategy_flag = false;
+   gboolean enable_value_cache_flag = false;
    char *   mfg_id_work    = NULL;
    char *   modelwork      = NULL;
    char *   snwork         = NULL;
@@ -211,8 +219,13 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    gint     dispwork       = -1;
    char *   maxtrywork      = NULL;
    gint     edid_read_size_work = -1;
+   gint     process_lock_wait_work = -1;
+   gint     i2c_read_deadline_work = -1;
+   gint     value_cache_ttl_work = -1;
    gint     i1_work = -1;
    char *   failsim_fn_work = NULL;
+   char *   trace_ring_fn_work = NULL;
+   char *   timeline_fn_work = NULL;
    // gboolean enable_failsim_flag = false;
    char *   sleep_multiplier_work = NULL;
 
@@ -280,6 +293,8 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
 
       {"nousb",   '\0', G_OPTION_FLAG_REVERSE,
                                G_OPTION_ARG_NONE, &enable_usb_flag,  "Do not detect USB devices", NULL},
+      {"usb-hidraw", '\0', G_OPTION_FLAG_NONE,
+                               G_OPTION_ARG_NONE, &usb_hidraw_flag,  "Use hidraw for USB monitor feature reports", NULL},
 #endif
       {"mccs",    '\0', 0, G_OPTION_ARG_STRING,   &mccswork,         "MCCS version",            "major.minor" },
       {"timeout-i2c-io",'\0', 0, G_OPTION_ARG_NONE, &timeout_i2c_io_flag, "Wrap I2C IO in timeout",  NULL},
@@ -298,6 +313,10 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
                   '\0', 0, G_OPTION_ARG_NONE,     &enable_cc_flag,   "Enable cached capabilities",   NULL},
       {"disable-capabilities-cache", '\0', G_OPTION_FLAG_REVERSE,
                            G_OPTION_ARG_NONE, &enable_cc_flag,   "Disable cached capabilities (default)",   NULL},
+      {"enable-displays-cache",
+                  '\0', 0, G_OPTION_ARG_NONE,     &enable_cd_flag,   "Enable cached display detection",   NULL},
+      {"disable-displays-cache", '\0', G_OPTION_FLAG_REVERSE,
+                           G_OPTION_ARG_NONE, &enable_cd_flag,   "Disable cached display detection (default)",   NULL},
 
  //     {"ignore-capabilities-cache",
  //                              '\0', 0, G_OPTION_ARG_NONE,     &ignore_cc_flag,   "Ignore cached capabilities string",   NULL},
@@ -321,12 +340,40 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
 //                               G_OPTION_ARG_NONE,  &reduce_sleeps_flag, "Do not eliminate any sleeps (default)",  NULL},
 
       {"lazy-sleep",  '\0', 0, G_OPTION_ARG_NONE, &deferred_sleep_flag, "Delay sleeps if possible",  NULL},
+      {"idle-aware-sleep",'\0', 0, G_OPTION_ARG_NONE, &idle_aware_sleep_flag,
+                                  "Shorten sleeps by time since last display I/O",  NULL},
+      {"disable-idle-aware-sleep",'\0',G_OPTION_FLAG_REVERSE,
+                                  G_OPTION_ARG_NONE, &idle_aware_sleep_flag, "Always sleep the full time (default)",  NULL},
 //    {"defer-sleeps",'\0', 0, G_OPTION_ARG_NONE, &deferred_sleep_flag, "Delay sleeps if possible",  NULL},
 
       {"dynamic-sleep-adjustment",'\0', 0, G_OPTION_ARG_NONE, &dsa_flag, "Enable dynamic sleep adjustment",  NULL},
       {"dsa",                     '\0', 0, G_OPTION_ARG_NONE, &dsa_flag, "Enable dynamic sleep adjustment",  NULL},
       {"edid-read-size",
                       '\0', 0, G_OPTION_ARG_INT,         &edid_read_size_work, "Number of EDID bytes to read", "128,256" },
+      {"process-lock-wait",
+                      '\0', 0, G_OPTION_ARG_INT,         &process_lock_wait_work,
+                                                 "Max wait for a display in use by another process", "millisec" },
+      {"i2c-read-deadline",
+                      '\0', 0, G_OPTION_ARG_INT,         &i2c_read_deadline_work,
+                                                 "Max time for a DDC read, also set as I2C adapter timeout", "millisec" },
+      {"disable-process-locks",
+                      '\0', 0, G_OPTION_ARG_NONE,        &disable_process_locks_flag,
+                                                 "Do not lock displays against use by other processes", NULL},
+      {"disable-adaptive-retry",
+                      '\0', 0, G_OPTION_ARG_NONE,        &disable_adaptive_retry_flag,
+                                                 "Always allow the maximum number of tries", NULL},
+      {"full-initial-checks",
+                      '\0', 0, G_OPTION_ARG_NONE,        &full_initial_checks_flag,
+                                                 "Fully check DDC communication even for known monitors", NULL},
+      {"fixed-i2c-strategy",
+                      '\0', 0, G_OPTION_ARG_NONE,        &fixed_i2c_strategy_flag,
+                                                 "Use the default I2C IO strategy for all buses", NULL},
+      {"enable-value-cache",
+                      '\0', 0, G_OPTION_ARG_NONE,        &enable_value_cache_flag,
+                                                 "Reuse recently read feature values", NULL},
+      {"value-cache-ttl",
+                      '\0', 0, G_OPTION_ARG_INT,         &value_cache_ttl_work,
+                                                 "Time for which a read feature value is reused", "millisec" },
       {NULL},
    };
 
@@ -341,6 +388,8 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
       {"ts",         '\0', 0, G_OPTION_ARG_NONE,         &timestamp_trace_flag, "Prepend trace msgs with elapsed time",  NULL},
       {"thread-id",  '\0', 0, G_OPTION_ARG_NONE,         &thread_id_trace_flag, "Prepend trace msgs with thread id",  NULL},
       {"tid",        '\0', 0, G_OPTION_ARG_NONE,         &thread_id_trace_flag, "Prepend trace msgs with thread id",  NULL},
+      {"trace-ring", '\0', 0, G_OPTION_ARG_FILENAME,     &trace_ring_fn_work,   "Record trace msgs in binary form, written to file at exit", "file name"},
+      {"timeline",   '\0', 0, G_OPTION_ARG_FILENAME,     &timeline_fn_work,     "Record timeline of DDC operations, sleeps, retries in Chrome trace format", "file name"},
       {"debug-parse",'\0', 0,  G_OPTION_ARG_NONE,        &debug_parse_flag,     "Report parsed command",    NULL},
       {"failsim",    '\0', 0,  G_OPTION_ARG_FILENAME,    &failsim_fn_work,      "Enable simulation", "control file name"},
 
@@ -485,11 +534,13 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    SET_CMDFLAG(CMD_FLAG_ENABLE_UDF,        enable_udf_flag);
 #ifdef USE_USB
    SET_CMDFLAG(CMD_FLAG_ENABLE_USB,        enable_usb_flag);
+   SET_CMDFLAG(CMD_FLAG_USB_HIDRAW,        usb_hidraw_flag);
 #endif
    SET_CMDFLAG(CMD_FLAG_TIMEOUT_I2C_IO,    timeout_i2c_io_flag);
    SET_CMDFLAG(CMD_FLAG_REDUCE_SLEEPS,     reduce_sleeps_flag);
    SET_CMDFLAG(CMD_FLAG_DSA,               dsa_flag);
    SET_CMDFLAG(CMD_FLAG_DEFER_SLEEPS,      deferred_sleep_flag);
+   SET_CMDFLAG(CMD_FLAG_IDLE_AWARE_SLEEP,  idle_aware_sleep_flag);
    SET_CMDFLAG(CMD_FLAG_F1,                f1_flag);
    SET_CMDFLAG(CMD_FLAG_F2,                f2_flag);
    SET_CMDFLAG(CMD_FLAG_F3,                f3_flag);
@@ -500,6 +551,12 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    SET_CMDFLAG(CMD_FLAG_PER_THREAD_STATS,  per_thread_stats_flag);
    SET_CMDFLAG(CMD_FLAG_IGNORE_CACHED_CAPABILITIES , ignore_cc_flag);
    SET_CMDFLAG(CMD_FLAG_ENABLE_CACHED_CAPABILITIES , enable_cc_flag);
+   SET_CMDFLAG(CMD_FLAG_ENABLE_CACHED_DISPLAYS,      enable_cd_flag);
+   SET_CMDFLAG(CMD_FLAG_DISABLE_PROCESS_LOCKS,       disable_process_locks_flag);
+   SET_CMDFLAG(CMD_FLAG_DISABLE_ADAPTIVE_RETRY,      disable_adaptive_retry_flag);
+   SET_CMDFLAG(CMD_FLAG_FULL_INITIAL_CHECKS,         full_initial_checks_flag);
+   SET_CMDFLAG(CMD_FLAG_FIXED_I2C_STRATEGY,          fixed_i2c_strategy_flag);
+   SET_CMDFLAG(CMD_FLAG_ENABLE_VALUE_CACHE,          enable_value_cache_flag);
 
    if (failsim_fn_work) {
 #ifdef ENABLE_FAILSIM
@@ -703,6 +760,27 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    else
       parsed_cmd->edid_read_size = edid_read_size_work;
 
+   if (process_lock_wait_work < -1) {
+      fprintf(stderr, "Invalid process lock wait: %d\n", process_lock_wait_work);
+      ok = false;
+   }
+   else
+      parsed_cmd->process_lock_wait_millisec = process_lock_wait_work;
+
+   if (i2c_read_deadline_work < -1 || i2c_read_deadline_work == 0) {
+      fprintf(stderr, "Invalid I2C read deadline: %d\n", i2c_read_deadline_work);
+      ok = false;
+   }
+   else
+      parsed_cmd->i2c_read_deadline_millisec = i2c_read_deadline_work;
+
+   if (value_cache_ttl_work < -1 || value_cache_ttl_work == 0) {
+      fprintf(stderr, "Invalid value cache time to live: %d\n", value_cache_ttl_work);
+      ok = false;
+   }
+   else
+      parsed_cmd->value_cache_ttl_millisec = value_cache_ttl_work;
+
 #ifdef COMMA_DELIMITED_TRACE
    if (tracework) {
        bool saved_debug = debug;
@@ -779,6 +857,8 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    if (trace_filenames) {
       parsed_cmd->traced_files = trace_filenames;
    }
+   parsed_cmd->trace_ring_fn = trace_ring_fn_work;
+   parsed_cmd->timeline_fn   = timeline_fn_work;
 
    int rest_ct = 0;
    // don't pull debug into the if clause, need rest_ct to be set
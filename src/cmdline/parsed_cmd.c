@@ -46,6 +46,7 @@ Value_Name_Table cmd_id_table = {
       VNT(CMDID_CHKUSBMON     ,  "chkusbmon"),
       VNT(CMDID_PROBE         ,  "probe"),
       VNT(CMDID_SAVE_SETTINGS ,  "save settings"),
+      VNT(CMDID_TRACE_DECODE  ,  "trace-decode"),
       VNT_END
 };
 
@@ -102,6 +103,9 @@ Parsed_Cmd *  new_parsed_cmd() {
    // parsed_cmd->output_level = OL_DEFAULT;
    parsed_cmd->output_level = DDCA_OL_NORMAL;
    parsed_cmd->edid_read_size = -1;   // if set, values are >= 0
+   parsed_cmd->process_lock_wait_millisec = -1;   // if set, values are >= 0
+   parsed_cmd->i2c_read_deadline_millisec = -1;   // if set, values are >= 0
+   parsed_cmd->value_cache_ttl_millisec = -1;     // if set, values are > 0
    parsed_cmd->i1 = -1;               // if set, values are >= 0
    // parsed_cmd->nodetect = true;
    parsed_cmd->flags |= CMD_FLAG_NODETECT;
@@ -130,6 +134,8 @@ void free_parsed_cmd(Parsed_Cmd * parsed_cmd) {
    free(parsed_cmd->fref);
    ntsa_free(parsed_cmd->traced_files, true);
    ntsa_free(parsed_cmd->traced_functions, true);
+   free(parsed_cmd->trace_ring_fn);
+   free(parsed_cmd->timeline_fn);
    g_array_free(parsed_cmd->setvcp_values, true);
 
    parsed_cmd->marker[3] = 'x';
@@ -206,12 +212,27 @@ void dbgrpt_parsed_cmd(Parsed_Cmd * parsed_cmd, int depth) {
          rpt_bool("show unsupported",  NULL, parsed_cmd->flags & CMD_FLAG_SHOW_UNSUPPORTED,         d1);
       rpt_bool("enable udf",        NULL, parsed_cmd->flags & CMD_FLAG_ENABLE_UDF,               d1);
       rpt_bool("enable usb",        NULL, parsed_cmd->flags & CMD_FLAG_ENABLE_USB,               d1);
+      rpt_bool("usb hidraw",        NULL, parsed_cmd->flags & CMD_FLAG_USB_HIDRAW,               d1);
       rpt_bool("timestamp prefix:", NULL, parsed_cmd->flags & CMD_FLAG_TIMESTAMP_TRACE,          d1);
       rpt_bool("thread id prefix:", NULL, parsed_cmd->flags & CMD_FLAG_THREAD_ID_TRACE,          d1);
+      rpt_str("trace ring file:",   NULL, parsed_cmd->trace_ring_fn,                             d1);
+      rpt_str("timeline file:",     NULL, parsed_cmd->timeline_fn,                               d1);
       rpt_bool("enable cached capabilities:",
                                     NULL, parsed_cmd->flags & CMD_FLAG_ENABLE_CACHED_CAPABILITIES, d1);
       rpt_bool("ignore cached capabilities:",
                                     NULL, parsed_cmd->flags & CMD_FLAG_IGNORE_CACHED_CAPABILITIES, d1);
+      rpt_bool("enable cached displays:",
+                                    NULL, parsed_cmd->flags & CMD_FLAG_ENABLE_CACHED_DISPLAYS, d1);
+      rpt_bool("disable process locks:",
+                                    NULL, parsed_cmd->flags & CMD_FLAG_DISABLE_PROCESS_LOCKS,  d1);
+      rpt_bool("disable adaptive retry:",
+                                    NULL, parsed_cmd->flags & CMD_FLAG_DISABLE_ADAPTIVE_RETRY, d1);
+      rpt_bool("full initial checks:",
+                                    NULL, parsed_cmd->flags & CMD_FLAG_FULL_INITIAL_CHECKS,    d1);
+      rpt_bool("fixed i2c strategy:",
+                                    NULL, parsed_cmd->flags & CMD_FLAG_FIXED_I2C_STRATEGY,     d1);
+      rpt_bool("enable value cache:",
+                                    NULL, parsed_cmd->flags & CMD_FLAG_ENABLE_VALUE_CACHE,     d1);
    // rpt_bool("clear persistent cache:",
    //                                 NULL, parsed_cmd->flags & CMD_FLAG_CLEAR_PERSISTENT_CACHE, d1);
       rpt_str ("MCCS version spec", NULL, format_vspec(parsed_cmd->mccs_vspec),                  d1);
@@ -227,6 +248,7 @@ void dbgrpt_parsed_cmd(Parsed_Cmd * parsed_cmd, int depth) {
       rpt_bool("timeout I2C IO:",   NULL, parsed_cmd->flags & CMD_FLAG_TIMEOUT_I2C_IO,          d1);
       rpt_bool("reduce sleeps:",    NULL, parsed_cmd->flags & CMD_FLAG_REDUCE_SLEEPS,           d1);
       rpt_bool("defer sleeps:",     NULL, parsed_cmd->flags & CMD_FLAG_DEFER_SLEEPS,            d1);
+      rpt_bool("idle aware sleep:", NULL, parsed_cmd->flags & CMD_FLAG_IDLE_AWARE_SLEEP,        d1);
       rpt_bool("dynamic_sleep_adjustment:", NULL, parsed_cmd->flags & CMD_FLAG_DSA,             d1);
       rpt_bool("per_thread_stats:", NULL, parsed_cmd->flags & CMD_FLAG_PER_THREAD_STATS,        d1);
       rpt_bool("x52 not fifo:",     NULL, parsed_cmd->flags & CMD_FLAG_X52_NO_FIFO,             d1);
@@ -239,6 +261,12 @@ void dbgrpt_parsed_cmd(Parsed_Cmd * parsed_cmd, int depth) {
                          elem->feature_value);
       }
       rpt_int( "edid_read_size:",   NULL, parsed_cmd->edid_read_size,                d1);
+      rpt_int( "process lock wait (millisec):",
+                                    NULL, parsed_cmd->process_lock_wait_millisec,    d1);
+      rpt_int( "i2c read deadline (millisec):",
+                                    NULL, parsed_cmd->i2c_read_deadline_millisec,    d1);
+      rpt_int( "value cache ttl (millisec):",
+                                    NULL, parsed_cmd->value_cache_ttl_millisec,      d1);
       rpt_int( "i1",                NULL, parsed_cmd->i1,                            d1);
       rpt_bool("f1",                NULL, parsed_cmd->flags & CMD_FLAG_F1,           d1);
       rpt_bool("f2",                NULL, parsed_cmd->flags & CMD_FLAG_F2,           d1);
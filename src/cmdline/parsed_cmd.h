@@ -38,6 +38,7 @@ typedef enum {
    CMDID_CHKUSBMON     =   0x4000,
    CMDID_PROBE         =   0x8000,
    CMDID_SAVE_SETTINGS = 0x010000,
+   CMDID_TRACE_DECODE  = 0x020000,
 } Cmd_Id_Type;
 
 typedef enum {
@@ -73,6 +74,14 @@ typedef enum {
    CMD_FLAG_IGNORE_CACHED_CAPABILITIES = 0x0400000000,
    CMD_FLAG_ENABLE_CACHED_CAPABILITIES = 0x0800000000,
 // CMD_FLAG_CLEAR_PERSISTENT_CACHE  = 0x1000000000,
+   CMD_FLAG_USB_HIDRAW       = 0x2000000000,
+   CMD_FLAG_ENABLE_CACHED_DISPLAYS = 0x4000000000,
+   CMD_FLAG_DISABLE_PROCESS_LOCKS  = 0x8000000000,
+   CMD_FLAG_DISABLE_ADAPTIVE_RETRY = 0x10000000000,
+   CMD_FLAG_FULL_INITIAL_CHECKS    = 0x20000000000,
+   CMD_FLAG_FIXED_I2C_STRATEGY     = 0x40000000000,
+   CMD_FLAG_ENABLE_VALUE_CACHE     = 0x80000000000,
+   CMD_FLAG_IDLE_AWARE_SLEEP       = 0x100000000000,
 } Parsed_Cmd_Flags;
 
 typedef
@@ -105,12 +114,17 @@ struct {
    DDCA_Trace_Group       traced_groups;
    gchar **               traced_files;
    gchar **               traced_functions;
+   char *                 trace_ring_fn;
+   char *                 timeline_fn;
    DDCA_Output_Level      output_level;
    uint16_t               max_tries[3];
    float                  sleep_multiplier;
    DDCA_MCCS_Version_Spec mccs_vspec;
 // DDCA_MCCS_Version_Id   mccs_version_id;
    int                    edid_read_size;
+   int                    process_lock_wait_millisec;
+   int                    i2c_read_deadline_millisec;
+   int                    value_cache_ttl_millisec;
    uint64_t               flags;      // Parsed_Cmd_Flags
    int                    i1;         // available for temporary use
 } Parsed_Cmd;
@@ -17,19 +17,32 @@
 #include "base/parms.h"
 #include "base/thread_retry_data.h"
 #include "base/thread_sleep_data.h"
+#include "base/timeline.h"
+#include "base/trace_ring.h"
 #include "base/tuned_sleep.h"
 
 #include "vcp/persistent_capabilities.h"
 
 #include "dynvcp/dyn_feature_files.h"
 
+#include "i2c/i2c_bus_core.h"
 #include "i2c/i2c_execute.h"
+#include "i2c/i2c_read_deadline.h"
 #include "i2c/i2c_strategy_dispatcher.h"
 
+#ifdef USE_USB
+#include "usb/usb_displays.h"
+#endif
+
 #include "ddc/ddc_displays.h"
+#include "ddc/ddc_display_lock.h"
+#include "ddc/ddc_displays_cache.h"
+#include "ddc/ddc_known_monitors.h"
+#include "ddc/ddc_retry_policy.h"
 #include "ddc/ddc_services.h"
 #include "ddc/ddc_try_stats.h"
 #include "ddc/ddc_vcp.h"
+#include "ddc/ddc_vcp_value_cache.h"
 
 #include "ddc/common_init.h"
 
@@ -42,6 +55,10 @@ init_tracing(Parsed_Cmd * parsed_cmd)
        dbgtrc_show_time = true;                           // extern in core.h
     if (parsed_cmd->flags & CMD_FLAG_THREAD_ID_TRACE)     // timestamps on debug and trace messages?
        dbgtrc_show_thread_id = true;                      // extern in core.h
+    if (parsed_cmd->trace_ring_fn)                        // record trace messages in binary form?
+       trace_ring_enable(parsed_cmd->trace_ring_fn);
+    if (parsed_cmd->timeline_fn)                          // record timeline of DDC operations?
+       timeline_enable(parsed_cmd->timeline_fn);
     report_freed_exceptions = parsed_cmd->flags & CMD_FLAG_REPORT_FREED_EXCP;   // extern in core.h
     set_trace_levels(parsed_cmd->traced_groups);
     if (parsed_cmd->traced_functions) {
@@ -118,11 +135,13 @@ void init_performance_options(Parsed_Cmd * parsed_cmd)
 {
    enable_sleep_suppression( parsed_cmd->flags & CMD_FLAG_REDUCE_SLEEPS );
    enable_deferred_sleep( parsed_cmd->flags & CMD_FLAG_DEFER_SLEEPS);
+   enable_idle_aware_sleep( parsed_cmd->flags & CMD_FLAG_IDLE_AWARE_SLEEP);
 
    int threshold = DISPLAY_CHECK_ASYNC_NEVER;
    if (parsed_cmd->flags & CMD_FLAG_ASYNC) {
       threshold = DISPLAY_CHECK_ASYNC_THRESHOLD_STANDARD;
       ddc_set_async_threshold(threshold);
+      i2c_set_bus_check_async_threshold(I2C_BUS_CHECK_ASYNC_THRESHOLD_STANDARD);
    }
 
    if (parsed_cmd->sleep_multiplier != 0 && parsed_cmd->sleep_multiplier != 1) {
@@ -138,6 +157,15 @@ void init_performance_options(Parsed_Cmd * parsed_cmd)
    if (parsed_cmd->flags & CMD_FLAG_TIMEOUT_I2C_IO) {
       set_i2c_fileio_use_timeout(true);
    }
+
+   enable_process_display_locks( !(parsed_cmd->flags & CMD_FLAG_DISABLE_PROCESS_LOCKS) );
+   enable_adaptive_retry_budgets( !(parsed_cmd->flags & CMD_FLAG_DISABLE_ADAPTIVE_RETRY) );
+   if (parsed_cmd->process_lock_wait_millisec >= 0)
+      set_process_lock_wait_millisec(parsed_cmd->process_lock_wait_millisec);
+   if (parsed_cmd->i2c_read_deadline_millisec > 0)
+      i2c_set_read_deadline_millisec(parsed_cmd->i2c_read_deadline_millisec);
+   if (parsed_cmd->value_cache_ttl_millisec > 0)
+      ddc_set_vcp_value_cache_ttl_millisec(parsed_cmd->value_cache_ttl_millisec);
 }
 
 
@@ -158,7 +186,7 @@ submaster_initializer(Parsed_Cmd * parsed_cmd) {
 
     init_ddc_services();   // n. initializes start timestamp
     // overrides setting in init_ddc_services():
-    i2c_set_io_strategy(DEFAULT_I2C_IO_STRATEGY);
+    i2c_reset_io_strategy();
     ddc_set_verify_setvcp(parsed_cmd->flags & CMD_FLAG_VERIFY);
 
     set_output_level(parsed_cmd->output_level);
@@ -172,11 +200,16 @@ submaster_initializer(Parsed_Cmd * parsed_cmd) {
  #ifdef USE_USB
        DDCA_Status rc = ddc_enable_usb_display_detection( parsed_cmd->flags & CMD_FLAG_ENABLE_USB );
        assert (rc == DDCRC_OK);
+       usb_enable_hidraw_io( parsed_cmd->flags & CMD_FLAG_USB_HIDRAW );
  #endif
 
     init_performance_options(parsed_cmd);
 
     enable_capabilities_cache(parsed_cmd->flags & CMD_FLAG_ENABLE_CACHED_CAPABILITIES);
+    enable_displays_cache(parsed_cmd->flags & CMD_FLAG_ENABLE_CACHED_DISPLAYS);
+    enable_full_initial_checks(parsed_cmd->flags & CMD_FLAG_FULL_INITIAL_CHECKS);
+    i2c_enable_strategy_learning(!(parsed_cmd->flags & CMD_FLAG_FIXED_I2C_STRATEGY));
+    ddc_enable_vcp_value_cache(parsed_cmd->flags & CMD_FLAG_ENABLE_VALUE_CACHE);
 
    ok = true;
 
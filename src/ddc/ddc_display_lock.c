@@ -3,7 +3,7 @@
  *  opened simultaneously from multiple threads.
  */
 
-// Copyright (C) 2018-2019 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2018-2021 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 /*
@@ -21,14 +21,18 @@
  */
 
 #include <assert.h>
-
+#include <errno.h>
 #include <glib-2.0/glib.h>
 #include <string.h>
+#include <sys/file.h>
+#include <unistd.h>
 
 #include "util/report_util.h"
 #include "util/string_util.h"
 
 #include "base/displays.h"
+#include "base/linux_errno.h"
+#include "base/parms.h"
 #include "base/status_code_mgt.h"
 
 #include "ddc/ddc_display_lock.h"
@@ -37,6 +41,14 @@
 #include "ddcutil_status_codes.h"
 
 
+/** Thread waiting to lock a display. */
+typedef struct {
+   GThread *    thread;
+   bool         granted;                  // lock has been granted
+   GCond        cond;                     // signalled when granted
+} Display_Lock_Waiter;
+
+
 #define DISTINCT_DISPLAY_DESC_MARKER "DDSC"
 typedef struct {
    char         marker[4];
@@ -46,8 +58,9 @@ typedef struct {
    char *       edid_model_name;
    char *       edid_serial_ascii;
 #endif
-   GMutex       display_mutex;
-   GThread *    display_mutex_thread;     // thread owning mutex
+   GMutex       state_mutex;              // protects fields that follow
+   GThread *    owner;                    // thread holding the lock
+   GQueue       waiters;                  // FIFO queue of Display_Lock_Waiter *
 } Distinct_Display_Desc;
 
 
@@ -100,41 +113,74 @@ bool display_desc_matches(Distinct_Display_Desc * ddesc, Display_Ref * dref) {
 }
 
 
-static GPtrArray * display_descriptors = NULL;  // array of Distinct_Display_Desc *
+static GPtrArray *  display_descriptors = NULL;  // array of Distinct_Display_Desc *, in creation order
+static GHashTable * display_descriptors_by_path = NULL;  // DDCA_IO_Path * -> Distinct_Display_Desc *
 static GMutex descriptors_mutex;                // single threads access to display_descriptors
-static GMutex master_display_lock_mutex;
+
+// Maximum wait for a display locked by another thread, in milliseconds.
+// Negative value means wait indefinitely.  The setting is per-thread.
+static int    default_display_lock_wait_millisec = -1;
+static GPrivate display_lock_wait_key = G_PRIVATE_INIT(g_free);
 
 
 void init_ddc_display_lock(void) {
    display_descriptors= g_ptr_array_new();
+   display_descriptors_by_path = g_hash_table_new(dpath_hash, dpath_hash_equal);
+}
+
+
+/** Sets the maximum time #lock_distinct_display() waits on the current thread
+ *  for a display locked by another thread, when **DDISP_WAIT** is set.
+ *
+ *  \param  millisec  maximum wait, a negative value means wait indefinitely
+ *  \return prior value
+ */
+int set_display_lock_wait_millisec(int millisec) {
+   int * setting = g_private_get(&display_lock_wait_key);
+   if (!setting) {
+      setting = g_new(int, 1);
+      *setting = default_display_lock_wait_millisec;
+      g_private_set(&display_lock_wait_key, setting);
+   }
+   int old = *setting;
+   *setting = millisec;
+   return old;
+}
+
+
+/** Returns the maximum time #lock_distinct_display() waits on the current thread.
+ *
+ *  \return maximum wait in milliseconds, a negative value means wait indefinitely
+ */
+int get_display_lock_wait_millisec() {
+   int * setting = g_private_get(&display_lock_wait_key);
+   return (setting) ? *setting : default_display_lock_wait_millisec;
 }
 
-// must be called when lock not held by current thread, o.w. deadlock
+
 char * distinct_display_ref_repr_t(Distinct_Display_Ref id) {
    static GPrivate  repr_key = G_PRIVATE_INIT(g_free);
    char * buf = get_thread_fixed_buffer(&repr_key, 100);
-   g_mutex_lock(&descriptors_mutex);
    Distinct_Display_Desc * ref = (Distinct_Display_Desc *) id;
    assert(memcmp(ref->marker, DISTINCT_DISPLAY_DESC_MARKER, 4) == 0);
-   g_snprintf(buf, 100, "Distinct_Display_Ref[%s]", dpath_repr_t(&ref->io_path));
-   g_mutex_unlock(&descriptors_mutex);
+   g_snprintf(buf, 100, "Distinct_Display_Ref[%s]", dpath_repr_t(&ref->io_path));   // io_path is immutable
    return buf;
 }
 
+
 Distinct_Display_Ref get_distinct_display_ref(Display_Ref * dref) {
    bool debug = false;
    DBGMSF(debug, "Starting. dref=%s", dref_repr_t(dref));
 
-   void * result = NULL;
    g_mutex_lock(&descriptors_mutex);
-
-   for (int ndx=0; ndx < display_descriptors->len; ndx++) {
+   Distinct_Display_Desc * result = g_hash_table_lookup(display_descriptors_by_path, &dref->io_path);
+#ifdef TOO_MANY_EDGE_CASES
+   for (int ndx=0; !result && ndx < display_descriptors->len; ndx++) {
       Distinct_Display_Desc * cur = g_ptr_array_index(display_descriptors, ndx);
-      if (display_desc_matches(cur, dref) ) {
+      if (display_desc_matches(cur, dref) )
          result = cur;
-         break;
-      }
    }
+#endif
    if (!result) {
       Distinct_Display_Desc * new_desc = calloc(1, sizeof(Distinct_Display_Desc));
       memcpy(new_desc->marker, DISTINCT_DISPLAY_DESC_MARKER, 4);
@@ -144,8 +190,10 @@ Distinct_Display_Ref get_distinct_display_ref(Display_Ref * dref) {
       new_desc->edid_model_name   = strdup(dref->pedid->model_name);
       new_desc->edid_serial_ascii = strdup(dref->pedid->serial_ascii);
 #endif
-      g_mutex_init(&new_desc->display_mutex);
+      g_mutex_init(&new_desc->state_mutex);
+      g_queue_init(&new_desc->waiters);
       g_ptr_array_add(display_descriptors, new_desc);
+      g_hash_table_insert(display_descriptors_by_path, &new_desc->io_path, new_desc);
       result = new_desc;
    }
 
@@ -156,13 +204,30 @@ Distinct_Display_Ref get_distinct_display_ref(Display_Ref * dref) {
 }
 
 
+// The following functions must be called with ddesc->state_mutex held
+
+/* Grants the lock to the thread at the head of the wait queue, if any. */
+static void grant_to_waiters(Distinct_Display_Desc * ddesc) {
+   Display_Lock_Waiter * waiter;
+   if (!ddesc->owner && (waiter = g_queue_pop_head(&ddesc->waiters)) ) {
+      ddesc->owner = waiter->thread;
+      waiter->granted = true;
+      g_cond_signal(&waiter->cond);
+   }
+}
+
+
 /** Locks a distinct display.
+ *
+ *  Threads waiting for a display are granted the lock in the order in which
+ *  they began waiting.
  *
  *  \param  id                 distinct display identifier
- *  \param  flags              if **DDISP_WAIT** set, wait for locking
+ *  \param  flags              **DDISP_WAIT**: wait for locking, for at most
+ *                             the time set by #set_display_lock_wait_millisec()
  *  \retval DDCRC_OK           success
  *  \retval DDCRC_LOCKED       locking failed, display already locked by another
- *                             thread and DDISP_WAIT not set
+ *                             thread and DDISP_WAIT not set, or wait timed out
  *  \retval DDCRC_ALREADY_OPEN display already locked in current thread
  */
 DDCA_Status
@@ -172,33 +237,45 @@ lock_distinct_display(
 {
    DDCA_Status ddcrc = 0;
    bool debug = false;
-   DBGMSF(debug, "Starting. id=%p -> %s", id, distinct_display_ref_repr_t(id));
+   DBGMSF(debug, "Starting. id=%p -> %s, flags=0x%02x", id, distinct_display_ref_repr_t(id), flags);
 
    Distinct_Display_Desc * ddesc = (Distinct_Display_Desc *) id;
    // TODO:  If this function is exposed in API, change assert to returning illegal argument status code
    assert(memcmp(ddesc->marker, DISTINCT_DISPLAY_DESC_MARKER, 4) == 0);
-   bool self_thread = false;
-   g_mutex_lock(&master_display_lock_mutex);  //wrong - will hold lock during wait
-   if (ddesc->display_mutex_thread == g_thread_self() )
-      self_thread = true;
-   g_mutex_unlock(&master_display_lock_mutex);
-   if (self_thread) {
+   GThread * self = g_thread_self();
+
+   g_mutex_lock(&ddesc->state_mutex);
+   if (ddesc->owner == self) {
       DBGMSG("Attempting to lock display already locked by current thread");
       ddcrc = DDCRC_ALREADY_OPEN;    // poor
    }
+   else if (g_queue_is_empty(&ddesc->waiters) && !ddesc->owner) {
+      ddesc->owner = self;
+   }
+   else if ( !(flags & DDISP_WAIT) ) {
+      ddcrc = DDCRC_LOCKED;
+   }
    else {
-      bool locked = true;
-      if (flags & DDISP_WAIT) {
-         g_mutex_lock(&ddesc->display_mutex);
+      int wait_millisec = get_display_lock_wait_millisec();
+      gint64 end_time = g_get_monotonic_time() + (gint64) wait_millisec * 1000;
+      Display_Lock_Waiter waiter = {.thread = self, .granted = false};
+      g_cond_init(&waiter.cond);
+      g_queue_push_tail(&ddesc->waiters, &waiter);
+      while (!waiter.granted) {
+         if (wait_millisec < 0)
+            g_cond_wait(&waiter.cond, &ddesc->state_mutex);
+         else if (!g_cond_wait_until(&waiter.cond, &ddesc->state_mutex, end_time))
+            break;
       }
-      else {
-         locked = g_mutex_trylock(&ddesc->display_mutex);
-         if (!locked)
-            ddcrc = DDCRC_LOCKED;
+      if (!waiter.granted) {
+         DBGMSF(debug, "Wait timed out after %d milliseconds", wait_millisec);
+         g_queue_remove(&ddesc->waiters, &waiter);
+         ddcrc = DDCRC_LOCKED;
       }
-      if (locked)
-         ddesc->display_mutex_thread = g_thread_self();
+      g_cond_clear(&waiter.cond);
    }
+   g_mutex_unlock(&ddesc->state_mutex);
+
    // need a new DDC status code
    DBGMSF(debug, "Done.     id=%p -> %s, Returning: %s",
                  id,distinct_display_ref_repr_t(id),  psc_desc(ddcrc));
@@ -206,6 +283,12 @@ lock_distinct_display(
 }
 
 
+/** Releases a lock acquired by #lock_distinct_display() on the current thread.
+ *
+ *  \param  id                 distinct display identifier
+ *  \retval DDCRC_OK           success
+ *  \retval DDCRC_LOCKED       display not locked by the current thread
+ */
 DDCA_Status unlock_distinct_display(Distinct_Display_Ref id) {
    bool debug = false;
    DBGMSF(debug, "Starting. id=%p -> %s", id, distinct_display_ref_repr_t(id));
@@ -213,39 +296,120 @@ DDCA_Status unlock_distinct_display(Distinct_Display_Ref id) {
    Distinct_Display_Desc * ddesc = (Distinct_Display_Desc *) id;
    // TODO:  If this function is exposed in API, change assert to returning illegal argument status code
    assert(memcmp(ddesc->marker, DISTINCT_DISPLAY_DESC_MARKER, 4) == 0);
-   g_mutex_lock(&master_display_lock_mutex);
-   if (ddesc->display_mutex_thread != g_thread_self()) {
-      DBGMSG("Attempting to unlock display lock owned by different thread");
-      ddcrc = DDCRC_LOCKED;
+   GThread * self = g_thread_self();
+   g_mutex_lock(&ddesc->state_mutex);
+   if (ddesc->owner == self) {
+      ddesc->owner = NULL;
+      grant_to_waiters(ddesc);
    }
    else {
-      ddesc->display_mutex_thread = NULL;
-      g_mutex_unlock(&ddesc->display_mutex);
+      DBGMSG("Attempting to unlock display lock owned by different thread");
+      ddcrc = DDCRC_LOCKED;
    }
-   g_mutex_unlock(&master_display_lock_mutex);
+   g_mutex_unlock(&ddesc->state_mutex);
    DBGMSF(debug, "Done.     id=%p -> %s, Returning %s",
                  id, distinct_display_ref_repr_t(id), psc_desc(ddcrc));
    return ddcrc;
 }
 
 
+//
+// Cross-process locking
+//
+// Display locks serialize access only among threads of the current process.
+// Other processes using ddcutil or libddcutil are excluded by an advisory
+// flock() on the open device file, which is released when it is closed.
+//
+
+static bool process_locks_enabled = true;
+static int  process_lock_wait_millisec = PROCESS_LOCK_WAIT_MILLISEC_DEFAULT;
+
+
+/** Enables or disables locking of display devices against other processes.
+ *
+ *  \param  onoff  new setting
+ *  \return prior setting
+ */
+bool enable_process_display_locks(bool onoff) {
+   bool old = process_locks_enabled;
+   process_locks_enabled = onoff;
+   return old;
+}
+
+
+/** Sets the maximum time #lock_display_device() waits for a device locked
+ *  by another process.
+ *
+ *  \param  millisec  maximum wait, a negative value means wait indefinitely
+ *  \return prior value
+ */
+int set_process_lock_wait_millisec(int millisec) {
+   int old = process_lock_wait_millisec;
+   process_lock_wait_millisec = millisec;
+   return old;
+}
+
+
+/** Locks an open display device against use by other processes.
+ *
+ *  \param  fd        file descriptor of open /dev/i2c-N or /dev/usb/hiddevN
+ *  \retval DDCRC_OK      success, or locking not enabled
+ *  \retval DDCRC_LOCKED  device locked by another process for longer than the
+ *                        time set by #set_process_lock_wait_millisec()
+ *
+ *  \remark
+ *  Failures other than contention, e.g. a file system that does not support
+ *  flock(), are not reported as errors, since the lock is only advisory.
+ */
+DDCA_Status lock_display_device(int fd) {
+   bool debug = false;
+   DDCA_Status ddcrc = 0;
+   if (!process_locks_enabled)
+      goto bye;
+
+   if (process_lock_wait_millisec < 0) {
+      int rc;
+      do {
+         rc = flock(fd, LOCK_EX);
+      } while (rc < 0 && errno == EINTR);
+      if (rc < 0)
+         DBGMSF(debug, "flock(%d) failed, errno=%s", fd, linux_errno_desc(errno));
+      goto bye;
+   }
+
+   gint64 end_time = g_get_monotonic_time() + (gint64) process_lock_wait_millisec * 1000;
+   while (flock(fd, LOCK_EX|LOCK_NB) < 0) {
+      int errsv = errno;
+      if (errsv != EWOULDBLOCK && errsv != EINTR) {
+         DBGMSF(debug, "flock(%d) failed, errno=%s", fd, linux_errno_desc(errsv));
+         break;
+      }
+      if (g_get_monotonic_time() >= end_time) {
+         ddcrc = DDCRC_LOCKED;
+         break;
+      }
+      usleep(PROCESS_LOCK_POLL_MILLISEC * 1000);
+   }
+
+bye:
+   DBGMSF(debug, "fd=%d, Returning %s", fd, psc_desc(ddcrc));
+   return ddcrc;
+}
+
+
 void dbgrpt_distinct_display_descriptors(int depth) {
    rpt_vstring(depth, "display_descriptors@%p", display_descriptors);
    g_mutex_lock(&descriptors_mutex);
    int d1 = depth+1;
    for (int ndx=0; ndx < display_descriptors->len; ndx++) {
       Distinct_Display_Desc * cur = g_ptr_array_index(display_descriptors, ndx);
-#ifdef TOO_MANY_EDGE_CASES
-      rpt_vstring(d1, "%2d - %p  %-28s - %-4s %-13s %-13s",
+      g_mutex_lock(&cur->state_mutex);
+      rpt_vstring(d1, "%2d - %p  %-28s  owner: %p, waiters: %d",
                        ndx, cur,
                        dpath_repr_t(&cur->io_path),
-                       cur->edid_mfg,
-                       cur->edid_model_name,
-                       cur->edid_serial_ascii);
-#endif
-      rpt_vstring(d1, "%2d - %p  %-28s",
-                       ndx, cur,
-                       dpath_repr_t(&cur->io_path) );
+                       cur->owner,
+                       g_queue_get_length(&cur->waiters) );
+      g_mutex_unlock(&cur->state_mutex);
    }
    g_mutex_unlock(&descriptors_mutex);
 }
@@ -1,7 +1,7 @@
 /* @file ddc_display_lock.h
  */
 
-// Copyright (C) 2018-2020 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2018-2021 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #ifndef DDC_DISPLAY_LOCK_H_
@@ -23,12 +23,19 @@ typedef void * Distinct_Display_Ref;
 
 void init_ddc_display_lock(void);
 
+int  set_display_lock_wait_millisec(int millisec);
+int  get_display_lock_wait_millisec();
+
 Distinct_Display_Ref get_distinct_display_ref(Display_Ref * dref);
 
 DDCA_Status lock_distinct_display(Distinct_Display_Ref id, Distinct_Display_Flags flags);
 
 DDCA_Status unlock_distinct_display(Distinct_Display_Ref id);
 
+bool enable_process_display_locks(bool onoff);
+int  set_process_lock_wait_millisec(int millisec);
+DDCA_Status lock_display_device(int fd);
+
 void dbgrpt_distinct_display_descriptors(int depth);
 
 #endif /* DDC_DISPLAY_LOCK_H_ */
@@ -24,6 +24,7 @@
 #include "util/string_util.h"
 #include "util/sysfs_util.h"
 #ifdef ENABLE_UDEV
+#include "util/udev_i2c_util.h"
 #include "util/udev_usb_util.h"
 #include "util/udev_util.h"
 #endif
@@ -37,8 +38,10 @@
 #include "base/rtti.h"
 
 #include "vcp/vcp_feature_codes.h"
+#include "vcp/vcp_feature_values.h"
 
 #include "i2c/i2c_bus_core.h"
+#include "i2c/i2c_sysfs.h"
 
 #ifdef USE_USB
 #include "usb/usb_displays.h"
@@ -52,6 +55,9 @@
 #include "ddc/ddc_vcp.h"
 #include "ddc/ddc_vcp_version.h"
 
+#include "ddc/ddc_displays_cache.h"
+#include "ddc/ddc_known_monitors.h"
+
 #include "ddc/ddc_displays.h"
 
 
@@ -86,6 +92,68 @@ value_bytes_zero_for_any_value(DDCA_Any_Vcp_Value * pvalrec) {
    return result;
 }
 
+
+/** Performs initial checks for a monitor model recorded as well behaved by
+ *  #ddc_set_known_monitor(), using a single read of feature x00 to confirm
+ *  that the display still responds as recorded.
+ *
+ *  \param dh  pointer to #Display_Handle for open monitor device
+ *  \return **true** if the display responded as recorded, in which case
+ *          the flags and VCP version in dh->dref are set
+ *
+ *  \remark
+ *  The unsupported feature indication flags are set before the read, so that
+ *  e.g. a DDC Null Response is accepted without retry and extended sleep.
+ *  If the display does not respond as recorded, its flags are restored, the
+ *  record is removed, and the caller performs full checks.
+ */
+static bool ddc_known_monitor_initial_checks(Display_Handle * dh) {
+   bool debug = false;
+   Display_Ref * dref = dh->dref;
+   Dref_Flags known_flags;
+   DDCA_MCCS_Version_Spec known_vspec;
+   if (!ddc_get_known_monitor(dref, &known_flags, &known_vspec))
+      return false;
+   DBGTRC(debug, TRACE_GROUP, "Starting. dh=%s, known flags: %s",
+                              dh_repr_t(dh), dref_basic_flags_t(known_flags));
+
+   Dref_Flags saved_flags = dref->flags;
+   dref->flags |= known_flags & ~DREF_DDC_COMMUNICATION_WORKING;
+
+   DDCA_Any_Vcp_Value * pvalrec = NULL;
+   Error_Info * ddc_excp = ddc_get_vcp_value(dh, 0x00, DDCA_NON_TABLE_VCP_VALUE, &pvalrec);
+   Public_Status_Code psc = ERRINFO_STATUS(ddc_excp);
+   if (ddc_excp)
+      errinfo_free(ddc_excp);
+   if (pvalrec)
+      free_single_vcp_value(pvalrec);
+
+   bool as_recorded = false;
+   if (known_flags & DREF_DDC_USES_DDC_FLAG_FOR_UNSUPPORTED)
+      as_recorded = (psc == DDCRC_REPORTED_UNSUPPORTED);
+   else if (known_flags & DREF_DDC_USES_NULL_RESPONSE_FOR_UNSUPPORTED)
+      as_recorded = (psc == DDCRC_NULL_RESPONSE || psc == DDCRC_ALL_RESPONSES_NULL);
+   else if (known_flags & DREF_DDC_USES_MH_ML_SH_SL_ZERO_FOR_UNSUPPORTED)
+      as_recorded = (psc == DDCRC_DETERMINED_UNSUPPORTED);
+   else if (known_flags & DREF_DDC_DOES_NOT_INDICATE_UNSUPPORTED)
+      as_recorded = (psc == 0);
+
+   if (as_recorded) {
+      dref->flags = saved_flags | known_flags |
+                    DREF_DDC_COMMUNICATION_CHECKED | DREF_DDC_NULL_RESPONSE_CHECKED;
+      if (vcp_version_eq(dref->vcp_version_xdf, DDCA_VSPEC_UNQUERIED))
+         dref->vcp_version_xdf = known_vspec;
+   }
+   else {
+      dref->flags = saved_flags;
+      ddc_forget_known_monitor(dref);
+   }
+
+   DBGTRC(debug, TRACE_GROUP, "Done. psc=%s, Returning: %s", psc_name(psc), sbool(as_recorded));
+   return as_recorded;
+}
+
+
 /** Collects initial monitor checks to perform them on a single open of the
  *  monitor device, and to avoid repeating them.
  *
@@ -94,6 +162,9 @@ value_bytes_zero_for_any_value(DDCA_Any_Vcp_Value * pvalrec) {
  *  - Checks if the monitor uses DDC Null Response to indicate invalid VCP code
  *  - Checks if the monitor uses mh=ml=sh=sl=0 to indicate invalid VCP code
  *
+ *  For a monitor model recorded as well behaved, the checks are replaced by
+ *  a single confirming read, see #ddc_known_monitor_initial_checks().
+ *
  *  \param dh  pointer to #Display_Handle for open monitor device
  *  \return **true** if DDC communication with the display succeeded, **false** otherwise.
  *
@@ -125,8 +196,16 @@ bool ddc_initial_checks_by_dh(Display_Handle * dh) {
                                  dref_basic_flags_t(dh->dref->flags));
 
    DDCA_Any_Vcp_Value * pvalrec;
+   bool full_checks_performed = false;
+
+   if (!(dh->dref->flags & DREF_DDC_COMMUNICATION_CHECKED) &&
+       dh->dref->io_path.io_mode == DDCA_IO_I2C)
+   {
+      ddc_known_monitor_initial_checks(dh);
+   }
 
    if (!(dh->dref->flags & DREF_DDC_COMMUNICATION_CHECKED)) {
+      full_checks_performed = true;
       Public_Status_Code psc = 0;
       Error_Info * ddc_excp = ddc_get_vcp_value(dh, 0x00, DDCA_NON_TABLE_VCP_VALUE, &pvalrec);
       psc = (ddc_excp) ? ddc_excp->status_code : 0;
@@ -231,6 +310,8 @@ bye:
       if ( vcp_version_eq(dh->dref->vcp_version_xdf, DDCA_VSPEC_UNQUERIED)) {
          set_vcp_version_xdf_by_dh(dh);
       }
+      if (full_checks_performed && dh->dref->io_path.io_mode == DDCA_IO_I2C)
+         ddc_set_known_monitor(dh->dref);
    }
    if (!communication_working && i2c_force_bus) {
       dh->dref->flags |= DREF_DDC_COMMUNICATION_WORKING;
@@ -1054,6 +1135,252 @@ get_display_ref_for_display_identifier(
 }
 
 
+//
+// Targeted lookup of a single display, without detecting all displays
+//
+
+/* Checks whether an EDID satisfies a DISP_ID_EDID or DISP_ID_MONSER
+ * display identifier.  Empty identifier fields match any value.
+ */
+static bool
+edid_matches_display_identifier(Parsed_Edid * edid, Display_Identifier * did) {
+   bool result = false;
+   if (did->id_type == DISP_ID_EDID) {
+      result = (memcmp(edid->bytes, did->edidbytes, 128) == 0);
+   }
+   else if (did->id_type == DISP_ID_MONSER) {
+      result = (strlen(did->mfg_id)       == 0 || streq(edid->mfg_id,       did->mfg_id))     &&
+               (strlen(did->model_name)   == 0 || streq(edid->model_name,   did->model_name)) &&
+               (strlen(did->serial_ascii) == 0 || streq(edid->serial_ascii, did->serial_ascii));
+   }
+   return result;
+}
+
+
+/* Creates a transient #Display_Ref for the monitor on a single I2C bus,
+ * probing only that bus and performing initial checks only on its monitor.
+ *
+ * If did is non-NULL, the EDID read from the bus must also satisfy it.
+ */
+static Status_Errno_DDC
+ddc_create_transient_bus_display_ref(
+      int                  busno,
+      Display_Identifier * did,
+      Call_Options         callopts,
+      Display_Ref **       dref_loc)
+{
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP, "Starting. busno=%d", busno);
+   FILE * outf = (callopts & CALLOPT_ERR_MSG) ? fout() : NULL;
+   Status_Errno_DDC result = DDCRC_INVALID_DISPLAY;
+   Display_Ref * dref = NULL;
+
+   I2C_Bus_Info * businfo = i2c_detect_single_bus(busno);
+   if (!businfo) {
+      f0printf(outf, "Bus /dev/i2c-%d not found\n", busno);
+   }
+   else if ( !(businfo->flags & I2C_BUS_ADDR_0X50) || !businfo->edid ) {
+      f0printf(outf, "No monitor detected on bus /dev/i2c-%d\n", busno);
+      i2c_free_bus_info(businfo);
+   }
+   else if (did && !edid_matches_display_identifier(businfo->edid, did)) {
+      DBGTRC(debug, TRACE_GROUP, "EDID read from bus does not match %s", did_repr(did));
+      i2c_free_bus_info(businfo);
+   }
+   else {
+      dref = create_bus_display_ref(busno);
+      dref->dispno = -1;     // should use some other value for unassigned vs invalid
+      dref->pedid = businfo->edid;
+      dref->mmid  = monitor_model_key_new(
+                       dref->pedid->mfg_id,
+                       dref->pedid->model_name,
+                       dref->pedid->product_code);
+      dref->detail = businfo;
+      dref->flags |= DREF_DDC_IS_MONITOR_CHECKED;
+      dref->flags |= DREF_DDC_IS_MONITOR;
+      dref->flags |= DREF_TRANSIENT;
+      if (ddc_initial_checks_by_dref(dref)) {
+         result = DDCRC_OK;
+      }
+      else {
+         f0printf(outf, "DDC communication failed for monitor on bus /dev/i2c-%d\n", busno);
+         free_display_ref(dref);
+         i2c_free_bus_info(businfo);
+         dref = NULL;
+      }
+   }
+
+   *dref_loc = dref;
+   DBGTRC(debug, TRACE_GROUP, "Done. busno=%d, *dref_loc=%s, returning %s",
+                              busno, dref_repr_t(dref), psc_desc(result));
+   return result;
+}
+
+
+/* Searches the EDIDs exposed by DRM connectors in /sys for one matching
+ * a DISP_ID_EDID or DISP_ID_MONSER identifier.  No I2C bus I/O is performed.
+ *
+ * Returns:  bus number of the matching display, -1 if none found
+ */
+static int
+find_busno_by_sysfs_edid(Display_Identifier * did) {
+   bool debug = false;
+   int result = -1;
+#ifdef ENABLE_UDEV
+   Byte_Value_Array buses = get_i2c_device_numbers_using_udev(false);
+#else
+   Byte_Value_Array buses = get_i2c_devices_by_existence_test();
+#endif
+   for (int ndx = 0; ndx < bva_length(buses) && result < 0; ndx++) {
+      int busno = bva_get(buses, ndx);
+      I2C_Sys_Info * info = get_i2c_sys_info(busno, -1);
+      if (info) {
+         GByteArray * edid_bytes = NULL;
+         if (info->connector)
+            RPT2_ATTR_EDID(-1, &edid_bytes, "/sys/class/drm", info->connector, "edid");
+         if (edid_bytes) {
+            if (edid_bytes->len >= 128) {
+               Parsed_Edid * edid = create_parsed_edid(edid_bytes->data);
+               if (edid) {
+                  if (edid_matches_display_identifier(edid, did))
+                     result = busno;
+                  free_parsed_edid(edid);
+               }
+            }
+            g_byte_array_free(edid_bytes, true);
+         }
+         free_i2c_sys_info(info);
+      }
+   }
+   bva_free(buses);
+   DBGTRC(debug, TRACE_GROUP, "did=%s, returning %d", did_repr(did), result);
+   return result;
+}
+
+
+#ifdef USE_USB
+/* Creates a transient #Display_Ref for a USB connected monitor.
+ * USB monitors are enumerated, but initial checks are performed only
+ * on the monitor requested.
+ */
+static Status_Errno_DDC
+ddc_create_transient_usb_display_ref(
+      int                  usb_bus,
+      int                  usb_device,
+      Display_Ref **       dref_loc)
+{
+   bool debug = false;
+   Status_Errno_DDC result = DDCRC_INVALID_DISPLAY;
+   Display_Ref * dref = NULL;
+   GPtrArray * usb_monitors = get_usb_monitor_list();
+   for (int ndx = 0; ndx < usb_monitors->len && !dref; ndx++) {
+      Usb_Monitor_Info * curmon = g_ptr_array_index(usb_monitors, ndx);
+      assert(memcmp(curmon->marker, USB_MONITOR_INFO_MARKER, 4) == 0);
+      if (curmon->hiddev_devinfo->busnum == usb_bus &&
+          curmon->hiddev_devinfo->devnum == usb_device)
+      {
+         dref = create_usb_display_ref(
+                   curmon->hiddev_devinfo->busnum,
+                   curmon->hiddev_devinfo->devnum,
+                   curmon->hiddev_device_name);
+         dref->dispno = -1;
+         dref->pedid = curmon->edid;
+         if (dref->pedid)
+            dref->mmid  = monitor_model_key_new(
+                             dref->pedid->mfg_id,
+                             dref->pedid->model_name,
+                             dref->pedid->product_code);
+         else
+            dref->mmid = monitor_model_key_new("UNK", "UNK", 0);
+         dref->detail = curmon;
+         dref->flags |= DREF_DDC_IS_MONITOR_CHECKED;
+         dref->flags |= DREF_DDC_IS_MONITOR;
+         dref->flags |= DREF_TRANSIENT;
+         if (ddc_initial_checks_by_dref(dref))
+            result = DDCRC_OK;
+         else {
+            free_display_ref(dref);
+            dref = NULL;
+         }
+      }
+   }
+   *dref_loc = dref;
+   DBGTRC(debug, TRACE_GROUP, "usb_bus=%d, usb_device=%d, returning %s",
+                              usb_bus, usb_device, psc_desc(result));
+   return result;
+}
+#endif
+
+
+/** Locates a single display without detecting and checking every
+ *  display on the system.
+ *
+ *  - DISP_ID_BUSNO: only the specified bus is probed
+ *  - DISP_ID_EDID, DISP_ID_MONSER: the EDIDs in /sys are searched, and
+ *    only the bus with the matching EDID is probed
+ *  - DISP_ID_USB: only the specified USB monitor is checked
+ *
+ *  Other identifier types, e.g. display number, are meaningful only
+ *  relative to the full list of displays.
+ *
+ *  \param  did       display identifier
+ *  \param  callopts  CALLOPT_ERR_MSG to report why a display is invalid
+ *  \param  dref_loc  where to return a transient #Display_Ref
+ *  \retval DDCRC_OK               display found and DDC communication works
+ *  \retval DDCRC_INVALID_DISPLAY  display not found or DDC communication failed
+ *  \retval DDCRC_UNIMPLEMENTED    identifier cannot be resolved without full
+ *                                 display detection
+ *
+ *  \remark
+ *  The returned #Display_Ref has flag DREF_TRANSIENT set, and should be
+ *  freed by the caller when no longer needed.
+ */
+Status_Errno_DDC
+ddc_find_transient_display_ref(
+      Display_Identifier * did,
+      Call_Options         callopts,
+      Display_Ref **       dref_loc)
+{
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP, "Starting. did=%s", did_repr(did));
+   Status_Errno_DDC result = DDCRC_UNIMPLEMENTED;
+   *dref_loc = NULL;
+
+   switch(did->id_type) {
+   case DISP_ID_BUSNO:
+      result = ddc_create_transient_bus_display_ref(did->busno, NULL, callopts, dref_loc);
+      break;
+   case DISP_ID_EDID:
+   case DISP_ID_MONSER:
+   {
+      // If not found, EDIDs may simply not be exposed in /sys by the video driver,
+      // so leave it to full detection to determine that there is no such display.
+      int busno = find_busno_by_sysfs_edid(did);
+      if (busno >= 0)
+         result = ddc_create_transient_bus_display_ref(busno, did, callopts & ~CALLOPT_ERR_MSG, dref_loc);
+      if (result != DDCRC_OK)
+         result = DDCRC_UNIMPLEMENTED;
+      break;
+   }
+   case DISP_ID_USB:
+#ifdef USE_USB
+      if (ddc_is_usb_display_detection_enabled()) {
+         result = ddc_create_transient_usb_display_ref(did->usb_bus, did->usb_device, dref_loc);
+         if (result != DDCRC_OK && (callopts & CALLOPT_ERR_MSG))
+            f0printf(ferr(), "Display not found\n");
+      }
+#endif
+      break;
+   default:
+      break;
+   }
+
+   DBGTRC(debug, TRACE_GROUP, "Done. *dref_loc=%s, returning %s",
+                              dref_repr_t(*dref_loc), psc_desc(result));
+   return result;
+}
+
+
 /** Detects all connected displays by querying the I2C and USB subsystems.
  *
  * \return array of #Display_Ref
@@ -1084,6 +1411,7 @@ ddc_detect_all_displays() {
          dref->detail = businfo;
          dref->flags |= DREF_DDC_IS_MONITOR_CHECKED;
          dref->flags |= DREF_DDC_IS_MONITOR;
+         ddc_apply_cached_display_state(dref);
          g_ptr_array_add(display_list, dref);
       }
    }
@@ -1123,12 +1451,20 @@ ddc_detect_all_displays() {
    if (olev == DDCA_OL_VERBOSE)
       set_output_level(DDCA_OL_NORMAL);
 
-   DBGMSF(debug, "display_list->len=%d, async_threshold=%d",
-                 display_list->len, async_threshold);
-   if (display_list->len >= async_threshold)
-      async_scan(display_list);
+   // displays whose initial checks were restored from the displays cache need not be checked
+   GPtrArray * unchecked_displays = g_ptr_array_new();
+   for (int ndx = 0; ndx < display_list->len; ndx++) {
+      Display_Ref * dref = g_ptr_array_index(display_list, ndx);
+      if (!(dref->flags & DREF_DDC_COMMUNICATION_CHECKED))
+         g_ptr_array_add(unchecked_displays, dref);
+   }
+   DBGMSF(debug, "display_list->len=%d, unchecked_displays->len=%d, async_threshold=%d",
+                 display_list->len, unchecked_displays->len, async_threshold);
+   if (unchecked_displays->len >= async_threshold)
+      async_scan(unchecked_displays);
    else
-      non_async_scan(display_list);
+      non_async_scan(unchecked_displays);
+   g_ptr_array_free(unchecked_displays, true);
 
    if (olev == DDCA_OL_VERBOSE)
       set_output_level(olev);
@@ -1152,6 +1488,9 @@ ddc_detect_all_displays() {
    if (check_phantom_displays)      // for testing
       filter_phantom_displays(display_list);
 
+   if (is_displays_cache_enabled() && !ddc_displays_cache_restored())
+      ddc_save_displays_cache(display_list);
+
    // if (debug) {
    //    DBGMSG("Displays detected:");
    //    report_display_recs(display_list, 1);
@@ -1170,7 +1509,8 @@ ddc_ensure_displays_detected() {
    bool debug = false;
    DBGMSF(debug, "Starting.");
    if (!all_displays) {
-      i2c_detect_buses();
+      if (!ddc_restore_displays_cache())
+         i2c_detect_buses();
       all_displays = ddc_detect_all_displays();
    }
    DBGMSF(debug, "all_displays has %d displays", all_displays->len);
@@ -1239,6 +1579,9 @@ init_ddc_displays() {
    RTTI_ADD_FUNC(filter_phantom_displays);
    RTTI_ADD_FUNC(ddc_initial_checks_by_dh);
    RTTI_ADD_FUNC(ddc_initial_checks_by_dref);
+   RTTI_ADD_FUNC(ddc_create_transient_bus_display_ref);
+   RTTI_ADD_FUNC(ddc_find_transient_display_ref);
+   RTTI_ADD_FUNC(find_busno_by_sysfs_edid);
    RTTI_ADD_FUNC(is_phantom_display);
    RTTI_ADD_FUNC(non_async_scan);
    RTTI_ADD_FUNC(threaded_initial_checks_by_dref);
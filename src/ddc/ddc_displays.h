@@ -47,6 +47,12 @@ get_display_ref_for_display_identifier(
    Display_Identifier* pdid,
    Call_Options        callopts);
 
+Status_Errno_DDC
+ddc_find_transient_display_ref(
+   Display_Identifier* did,
+   Call_Options        callopts,
+   Display_Ref **      dref_loc);
+
 void
 ddc_dbgrpt_display_ref(Display_Ref * drec, int depth);
 
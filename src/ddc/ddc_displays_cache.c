@@ -0,0 +1,457 @@
+/** \file ddc_displays_cache.c
+ *
+ *  Persistent cache of display detection results.
+ *
+ *  Display detection probes every I2C bus, reads each EDID, and performs
+ *  initial DDC checks on each display.  For short lived invocations of
+ *  ddcutil, this can take much longer than the command itself.
+ *
+ *  When enabled, the results of full detection are saved in a cache file.
+ *  On a subsequent invocation each cached bus is revalidated by comparing
+ *  its DRM connector and the hash of the EDID exposed in /sys with the
+ *  cached values.  If every bus matches, the cached results are used and
+ *  no I2C bus I/O is performed.  Otherwise full detection is performed
+ *  and the cache is rewritten.
+ *
+ *  Cache file format, one bus per line:
+ *
+ *      bus:<busno>:<connector>:<edid hash>:<bus flags>:<functionality>:<dref flags>:<vcp version>
+ *
+ *  preceded by line "strategy:<i2c io strategy id>".
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "config.h"
+
+/** \cond */
+#include <assert.h>
+#include <errno.h>
+#include <glib-2.0/glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+/** \endcond */
+
+#include "public/ddcutil_status_codes.h"
+
+#include "util/data_structures.h"
+#include "util/edid.h"
+#include "util/error_info.h"
+#include "util/file_util.h"
+#include "util/report_util.h"
+#include "util/string_util.h"
+#include "util/sysfs_util.h"
+#ifdef ENABLE_UDEV
+#include "util/udev_i2c_util.h"
+#endif
+#include "util/xdg_util.h"
+
+#include "base/core.h"
+#include "base/displays.h"
+#include "base/rtti.h"
+#include "base/vcp_version.h"
+
+#include "i2c/i2c_bus_core.h"
+#include "i2c/i2c_strategy_dispatcher.h"
+#include "i2c/i2c_sysfs.h"
+
+
+#include "ddc/ddc_displays_cache.h"
+
+
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDC;
+
+// Dref_Flags bits determined by initial checks, which are saved in the cache
+#define CACHED_DREF_FLAGS  ( DREF_DDC_COMMUNICATION_CHECKED                 | \
+                             DREF_DDC_COMMUNICATION_WORKING                 | \
+                             DREF_DDC_NULL_RESPONSE_CHECKED                 | \
+                             DREF_DDC_USES_NULL_RESPONSE_FOR_UNSUPPORTED    | \
+                             DREF_DDC_USES_MH_ML_SH_SL_ZERO_FOR_UNSUPPORTED | \
+                             DREF_DDC_USES_DDC_FLAG_FOR_UNSUPPORTED         | \
+                             DREF_DDC_DOES_NOT_INDICATE_UNSUPPORTED )
+
+/** Cached detection results for one I2C bus */
+typedef struct {
+   int                    busno;
+   char *                 connector;       ///< DRM connector name, "-" if none
+   uint32_t               edid_hash;       ///< 0 if no EDID
+   uint16_t               bus_flags;       ///< I2C_BUS_* flags
+   unsigned long          functionality;   ///< I2C functionality flags
+   Dref_Flags             dref_flags;      ///< DREF_DDC_* flags set by initial checks
+   DDCA_MCCS_Version_Spec vcp_version;
+} Cached_Bus_Rec;
+
+
+static bool        displays_cache_enabled = false;
+static bool        displays_cache_restored = false;
+static GPtrArray * cached_bus_recs = NULL;    // array of Cached_Bus_Rec *, valid iff restored
+
+
+static void free_cached_bus_rec(gpointer data) {
+   Cached_Bus_Rec * rec = data;
+   if (rec) {
+      free(rec->connector);
+      free(rec);
+   }
+}
+
+
+/* caller is responsible for freeing returned value */
+char * get_displays_cache_file_name() {
+   return xdg_cache_home_file("ddcutil", "displays");
+}
+
+
+static void delete_displays_cache_file() {
+   bool debug = false;
+   char * fn = get_displays_cache_file_name();
+   if (regular_file_exists(fn)) {
+      DBGMSF(debug, "Deleting file: %s", fn);
+      if (unlink(fn) < 0) {
+         // should never occur
+         fprintf(fout(), "Unexpected error deleting file %s: %s\n",
+                         fn, strerror(errno));
+      }
+   }
+   free(fn);
+}
+
+
+/** Enables or disables the display detection cache.
+ *  Disabling the cache deletes the cache file.
+ *
+ *  \param  onoff  true/false
+ *  \return prior value
+ */
+bool enable_displays_cache(bool onoff) {
+   bool debug = false;
+   DBGMSF(debug, "onoff=%s", sbool(onoff));
+   bool old = displays_cache_enabled;
+   displays_cache_enabled = onoff;
+   if (!onoff)
+      delete_displays_cache_file();
+   return old;
+}
+
+
+bool is_displays_cache_enabled() {
+   return displays_cache_enabled;
+}
+
+
+//
+// Load and save
+//
+
+static Error_Info *
+load_displays_cache_file(GPtrArray * recs, int * strategy_loc) {
+   bool debug = false;
+   char * fn = get_displays_cache_file_name();
+   DBGTRC(debug, TRACE_GROUP, "Starting. fn=%s", fn);
+
+   *strategy_loc = -1;
+   GPtrArray * linearray = g_ptr_array_new_with_free_func(g_free);
+   Error_Info * errs = file_getlines_errinfo(fn, linearray);
+   if (!errs) {
+      for (int ndx = 0; ndx < linearray->len && !errs; ndx++) {
+         char * aline = g_ptr_array_index(linearray, ndx);
+         if (strlen(aline) == 0 || aline[0] == '#')
+            continue;
+         Null_Terminated_String_Array pieces = strsplit(aline, ":");
+         int ct = ntsa_length(pieces);
+         if (ct == 2 && streq(pieces[0], "strategy")) {
+            if (!str_to_int(pieces[1], strategy_loc, 10))
+               errs = errinfo_new2(DDCRC_BAD_DATA, __func__, "Line %d, invalid strategy: %s", ndx+1, aline);
+         }
+         else if (ct == 8 && streq(pieces[0], "bus")) {
+            Cached_Bus_Rec * rec = calloc(1, sizeof(Cached_Bus_Rec));
+            int bus_flags, dref_flags, vmajor, vminor;
+            bool ok = str_to_int(pieces[1], &rec->busno, 10)                          &&
+                      sscanf(pieces[3], "%x",  &rec->edid_hash)      == 1             &&
+                      str_to_int(pieces[4], &bus_flags, 16)                           &&
+                      sscanf(pieces[5], "%lx", &rec->functionality) == 1             &&
+                      str_to_int(pieces[6], &dref_flags, 16)                          &&
+                      sscanf(pieces[7], "%d.%d", &vmajor, &vminor)    == 2;
+            rec->connector = strdup(pieces[2]);
+            if (ok) {
+               rec->bus_flags     = bus_flags;
+               rec->dref_flags    = dref_flags & CACHED_DREF_FLAGS;
+               rec->vcp_version.major = vmajor;
+               rec->vcp_version.minor = vminor;
+               g_ptr_array_add(recs, rec);
+            }
+            else {
+               free_cached_bus_rec(rec);
+               errs = errinfo_new2(DDCRC_BAD_DATA, __func__, "Line %d, invalid bus record: %s", ndx+1, aline);
+            }
+         }
+         else {
+            errs = errinfo_new2(DDCRC_BAD_DATA, __func__, "Line %d, unrecognized: %s", ndx+1, aline);
+         }
+         ntsa_free(pieces, true);
+      }
+   }
+   g_ptr_array_free(linearray, true);
+   free(fn);
+
+   DBGTRC(debug, TRACE_GROUP, "Done. Loaded %d records. Returning: %s", recs->len, errinfo_summary(errs));
+   return errs;
+}
+
+
+/** Saves the detection results for all I2C buses in the cache file.
+ *
+ *  \param  display_list  #GPtrArray of #Display_Ref for all detected displays
+ */
+void ddc_save_displays_cache(GPtrArray * display_list) {
+   bool debug = false;
+   char * fn = get_displays_cache_file_name();
+   DBGTRC(debug, TRACE_GROUP, "Starting. displays_cache_enabled=%s, fn=%s",
+                              sbool(displays_cache_enabled), fn);
+   if (!displays_cache_enabled || !i2c_buses)
+      goto bye;
+
+   FILE * fp = NULL;
+   fopen_mkdir(fn, "w", ferr(), &fp);
+   if (!fp)
+      goto bye;     // error reported by fopen_mkdir()
+
+   fprintf(fp, "# ddcutil display detection cache, do not edit\n");
+   fprintf(fp, "strategy:%d\n", i2c_get_io_strategy_id());
+   for (int ndx = 0; ndx < i2c_buses->len; ndx++) {
+      I2C_Bus_Info * businfo = g_ptr_array_index(i2c_buses, ndx);
+
+      Display_Ref * dref = NULL;
+      for (int dndx = 0; dndx < display_list->len && !dref; dndx++) {
+         Display_Ref * cur = g_ptr_array_index(display_list, dndx);
+         if (cur->io_path.io_mode == DDCA_IO_I2C && cur->io_path.path.i2c_busno == businfo->busno)
+            dref = cur;
+      }
+
+      I2C_Sys_Info * sysinfo = get_i2c_sys_info(businfo->busno, -1);
+      char * connector = (sysinfo && sysinfo->connector) ? sysinfo->connector : "-";
+      uint32_t edid_hash = (businfo->edid) ? edid_fnv1a_hash(businfo->edid->bytes) : 0;
+      DDCA_MCCS_Version_Spec vspec = (dref) ? dref->vcp_version_xdf : DDCA_VSPEC_UNQUERIED;
+      int ct = fprintf(fp, "bus:%d:%s:%08x:%04x:%lx:%04x:%d.%d\n",
+                           businfo->busno,
+                           connector,
+                           edid_hash,
+                           businfo->flags,
+                           businfo->functionality,
+                           (dref) ? (dref->flags & CACHED_DREF_FLAGS) : 0,
+                           vspec.major, vspec.minor);
+      if (sysinfo)
+         free_i2c_sys_info(sysinfo);
+      if (ct < 0) {
+         SEVEREMSG("Error writing to file %s:%s", fn, strerror(errno) );
+         break;
+      }
+   }
+   fclose(fp);
+
+bye:
+   free(fn);
+   DBGTRC(debug, TRACE_GROUP, "Done");
+}
+
+
+//
+// Revalidation
+//
+
+/* Checks a cached bus record against the current state of /sys.
+ * If valid and the bus has a monitor, returns the EDID read from /sys.
+ */
+static bool
+revalidate_bus_rec(Cached_Bus_Rec * rec, Parsed_Edid ** edid_loc) {
+   bool debug = false;
+   bool ok = false;
+   *edid_loc = NULL;
+
+   I2C_Sys_Info * sysinfo = get_i2c_sys_info(rec->busno, -1);
+   char * connector = (sysinfo && sysinfo->connector) ? sysinfo->connector : "-";
+   if (!streq(connector, rec->connector)) {
+      DBGTRC(debug, TRACE_GROUP, "busno=%d, connector changed: %s -> %s", rec->busno, rec->connector, connector);
+      goto bye;
+   }
+
+   GByteArray * edid_bytes = NULL;
+   if (!streq(connector, "-"))
+      RPT2_ATTR_EDID(-1, &edid_bytes, "/sys/class/drm", connector, "edid");
+   bool has_edid = edid_bytes && edid_bytes->len >= 128;
+
+   if (rec->edid_hash == 0) {
+      // No monitor on bus at time of detection.  If the bus has no DRM connector
+      // there is no cheap way to tell whether one has since been connected, so
+      // accept it, as does full detection of a bus that has no EDID.
+      ok = !has_edid;
+   }
+   else if (has_edid) {
+      char * status = NULL;
+      RPT2_ATTR_TEXT(-1, &status, "/sys/class/drm", connector, "status");
+      if (status && streq(status, "connected") &&
+          edid_fnv1a_hash(edid_bytes->data) == rec->edid_hash)
+      {
+         *edid_loc = create_parsed_edid(edid_bytes->data);
+         ok = (*edid_loc != NULL);
+      }
+      free(status);
+   }
+   if (edid_bytes)
+      g_byte_array_free(edid_bytes, true);
+
+bye:
+   if (sysinfo)
+      free_i2c_sys_info(sysinfo);
+   DBGTRC(debug, TRACE_GROUP, "busno=%d, returning %s", rec->busno, sbool(ok));
+   return ok;
+}
+
+
+/** Attempts to initialize the I2C bus list from the display detection cache.
+ *
+ *  The cache is used only if the set of I2C buses and the I2C IO strategy
+ *  are unchanged, and every bus revalidates against /sys.
+ *
+ *  \return true if the I2C bus list was restored from the cache,
+ *          false if full detection must be performed
+ */
+bool ddc_restore_displays_cache() {
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP, "Starting. displays_cache_enabled=%s", sbool(displays_cache_enabled));
+
+   displays_cache_restored = false;
+   if (cached_bus_recs) {      // left from prior detection
+      g_ptr_array_free(cached_bus_recs, true);
+      cached_bus_recs = NULL;
+   }
+   if (!displays_cache_enabled || i2c_buses)
+      goto bye;
+
+   GPtrArray * recs = g_ptr_array_new_with_free_func(free_cached_bus_rec);
+   int strategy = -1;
+   Error_Info * errs = load_displays_cache_file(recs, &strategy);
+   if (errs) {
+      if (ERRINFO_STATUS(errs) == -ENOENT)
+         errinfo_free(errs);
+      else
+         ERRINFO_FREE_WITH_REPORT(errs, debug || IS_TRACING());
+      g_ptr_array_free(recs, true);
+      goto bye;
+   }
+
+   bool ok = (strategy == i2c_get_io_strategy_id());
+   if (!ok)
+      DBGTRC(debug, TRACE_GROUP, "I2C IO strategy changed");
+
+   if (ok) {
+#ifdef ENABLE_UDEV
+      Byte_Value_Array cur_buses = get_i2c_device_numbers_using_udev(false);
+#else
+      Byte_Value_Array cur_buses = get_i2c_devices_by_existence_test();
+#endif
+      ok = (bva_length(cur_buses) == recs->len);
+      for (int ndx = 0; ndx < recs->len && ok; ndx++) {
+         Cached_Bus_Rec * rec = g_ptr_array_index(recs, ndx);
+         ok = (bva_get(cur_buses, ndx) == rec->busno);
+      }
+      bva_free(cur_buses);
+      if (!ok)
+         DBGTRC(debug, TRACE_GROUP, "Set of I2C buses changed");
+   }
+
+   GPtrArray * buses = NULL;
+   if (ok) {
+      buses = g_ptr_array_sized_new(recs->len);
+      g_ptr_array_set_free_func(buses, i2c_free_bus_info_gdestroy);
+      for (int ndx = 0; ndx < recs->len && ok; ndx++) {
+         Cached_Bus_Rec * rec = g_ptr_array_index(recs, ndx);
+         Parsed_Edid * edid = NULL;
+         ok = revalidate_bus_rec(rec, &edid);
+         if (ok) {
+            I2C_Bus_Info * businfo = i2c_new_bus_info(rec->busno);
+            businfo->flags         = rec->bus_flags;
+            businfo->functionality = rec->functionality;
+            businfo->edid          = edid;
+            if (!edid)
+               businfo->flags &= ~I2C_BUS_ADDR_0X50;
+            g_ptr_array_add(buses, businfo);
+         }
+      }
+   }
+
+   if (ok) {
+      i2c_buses = buses;
+      cached_bus_recs = recs;
+      displays_cache_restored = true;
+   }
+   else {
+      if (buses)
+         g_ptr_array_free(buses, true);
+      g_ptr_array_free(recs, true);
+   }
+
+bye:
+   DBGTRC(debug, TRACE_GROUP, "Done. Returning %s", sbool(displays_cache_restored));
+   return displays_cache_restored;
+}
+
+
+/** Indicates whether the current I2C bus list was restored from the cache. */
+bool ddc_displays_cache_restored() {
+   return displays_cache_restored;
+}
+
+
+/** Sets the results of initial checks for an I2C display from the cache,
+ *  so that the checks need not be performed.
+ *
+ *  \param  dref  display reference
+ *  \return true if cached state was applied, false if the display
+ *          must be checked
+ */
+bool ddc_apply_cached_display_state(Display_Ref * dref) {
+   bool debug = false;
+   bool result = false;
+   if (displays_cache_restored && dref->io_path.io_mode == DDCA_IO_I2C) {
+      for (int ndx = 0; ndx < cached_bus_recs->len; ndx++) {
+         Cached_Bus_Rec * rec = g_ptr_array_index(cached_bus_recs, ndx);
+         if (rec->busno == dref->io_path.path.i2c_busno) {
+            if (rec->dref_flags & DREF_DDC_COMMUNICATION_CHECKED) {
+               dref->flags |= rec->dref_flags;
+               dref->vcp_version_xdf = rec->vcp_version;
+               result = true;
+            }
+            break;
+         }
+      }
+   }
+   DBGTRC(debug, TRACE_GROUP, "dref=%s, returning %s", dref_repr_t(dref), sbool(result));
+   return result;
+}
+
+
+void dbgrpt_displays_cache(int depth) {
+   rpt_vstring(depth, "displays_cache_enabled:   %s", sbool(displays_cache_enabled));
+   rpt_vstring(depth, "displays_cache_restored:  %s", sbool(displays_cache_restored));
+   if (cached_bus_recs) {
+      for (int ndx = 0; ndx < cached_bus_recs->len; ndx++) {
+         Cached_Bus_Rec * rec = g_ptr_array_index(cached_bus_recs, ndx);
+         rpt_vstring(depth+1, "bus %d: connector=%s, edid_hash=0x%08x, dref_flags=0x%04x, vcp version=%d.%d",
+                              rec->busno, rec->connector, rec->edid_hash, rec->dref_flags,
+                              rec->vcp_version.major, rec->vcp_version.minor);
+      }
+   }
+}
+
+
+void init_ddc_displays_cache() {
+   RTTI_ADD_FUNC(load_displays_cache_file);
+   RTTI_ADD_FUNC(ddc_save_displays_cache);
+   RTTI_ADD_FUNC(revalidate_bus_rec);
+   RTTI_ADD_FUNC(ddc_restore_displays_cache);
+   RTTI_ADD_FUNC(ddc_apply_cached_display_state);
+}
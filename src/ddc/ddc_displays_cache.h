@@ -0,0 +1,29 @@
+/** \file ddc_displays_cache.h
+ *
+ *  Persistent cache of display detection results
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_DISPLAYS_CACHE_H_
+#define DDC_DISPLAYS_CACHE_H_
+
+/** \cond */
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+/** \endcond */
+
+#include "base/displays.h"
+
+bool   enable_displays_cache(bool onoff);
+bool   is_displays_cache_enabled();
+char * get_displays_cache_file_name();
+bool   ddc_restore_displays_cache();
+bool   ddc_displays_cache_restored();
+bool   ddc_apply_cached_display_state(Display_Ref * dref);
+void   ddc_save_displays_cache(GPtrArray * display_list);
+void   dbgrpt_displays_cache(int depth);
+void   init_ddc_displays_cache();
+
+#endif /* DDC_DISPLAYS_CACHE_H_ */
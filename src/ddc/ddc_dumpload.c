@@ -178,6 +178,12 @@ create_dumpload_data_from_g_ptr_array(
             }
             else if (streq(s0, "EDID") || streq(s0, "EDIDSTR")) {
                STRLCPY(data->edidstr, s1, sizeof(data->edidstr));
+               // also retain the bytes, so the data can be written out again
+               Byte * ba = NULL;
+               int bytect = hhs_to_byte_array(s1, &ba);
+               if (bytect == 128)
+                  memcpy(data->edidbytes, ba, 128);
+               free(ba);
             }
             else if (streq(s0, "MFG_ID")) {
                memcpy(data->mfg_id, s1, sizeof(data->mfg_id));
@@ -203,10 +209,21 @@ create_dumpload_data_from_g_ptr_array(
                   valid_data = false;
                }
             }
-            else if (streq(s0, "TIMESTAMP_TEXT")   ||
-                     streq(s0, "TIMESTAMP_MILLIS")
-
-                    ) {
+            else if (streq(s0, "TIMESTAMP_TEXT")) {
+               // format written by format_timestamp(), local time
+               struct tm tm = {0};
+               ct = sscanf(s1, "%4d%2d%2d-%2d%2d%2d",
+                               &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                               &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
+               if (ct == 6) {
+                  tm.tm_year -= 1900;
+                  tm.tm_mon  -= 1;
+                  tm.tm_isdst = -1;
+                  data->timestamp_millis = mktime(&tm);
+               }
+               // otherwise just recognize valid field
+            }
+            else if (streq(s0, "TIMESTAMP_MILLIS")) {
                // do nothing, just recognize valid field
             }
             else if (streq(s0, "VCP")) {
@@ -802,11 +819,23 @@ convert_dumpload_data_to_string_array(Dumpload_Data * data) {
    for (int ndx=0; ndx < data->vcp_values->len; ndx++) {
       // n. get_formatted_value_for_feature_table_entry() also has code for table type values
       DDCA_Any_Vcp_Value * vrec = vcp_value_set_get(data->vcp_values,ndx);
-      char buf[200];
-      snprintf(buf, 200, "VCP %02X %5d",
-                         vrec->opcode,
-                         VALREC_CUR_VAL(vrec));
-      g_ptr_array_add(strings, strdup(buf));
+      if (vrec->value_type == DDCA_TABLE_VCP_VALUE) {
+         // table values are written as a hex string, as expected by
+         // create_dumpload_data_from_g_ptr_array()
+         char * hs = hexstring2(vrec->val.t.bytes, vrec->val.t.bytect,
+                                NULL /* no separator */,
+                                true /* uppercase */,
+                                NULL, 0);
+         g_ptr_array_add(strings, g_strdup_printf("VCP %02X %s", vrec->opcode, hs));
+         free(hs);
+      }
+      else {
+         char buf[200];
+         snprintf(buf, 200, "VCP %02X %5d",
+                            vrec->opcode,
+                            VALREC_CUR_VAL(vrec));
+         g_ptr_array_add(strings, strdup(buf));
+      }
    }
    return strings;
 }
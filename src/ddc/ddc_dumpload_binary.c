@@ -0,0 +1,513 @@
+/** \file ddc_dumpload_binary.c
+ *
+ * Compact binary container for DUMPVCP/LOADVCP profile data.
+ *
+ * A binary profile store holds the profiles of any number of monitors.
+ * Unlike the line oriented text form, loading a profile requires neither
+ * tokenizing nor hex conversion.  The section for a particular monitor
+ * is located using a fixed width index sorted by EDID hash.
+ *
+ * Layout (all integers little-endian):
+ *
+ *    Header (16 bytes):
+ *       magic[8]        "DDCPROF\0"
+ *       uint16          format version
+ *       uint16          reserved
+ *       uint32          section count
+ *    Index (48 bytes per section, sorted by EDID hash):
+ *       char[4]         mfg_id
+ *       char[14]        model
+ *       char[14]        serial_ascii
+ *       uint16          product_code
+ *       uint16          reserved
+ *       uint32          EDID hash
+ *       uint32          section offset
+ *       uint32          section length
+ *    Section:
+ *       int64           timestamp
+ *       Byte[128]       EDID
+ *       Byte, Byte      VCP version major, minor
+ *       uint16          number of feature records
+ *       feature records, each 4 bytes:
+ *          Byte         feature code
+ *          Byte         DDCA_Vcp_Value_Type
+ *          uint16       current value (non-table) or byte count (table)
+ *       table values are stored inline following their feature record
+ *
+ * The binary form holds exactly the information in the text form,
+ * so the two convert losslessly to each other by way of #Dumpload_Data.
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "config.h"
+
+/** \cond */
+#include <assert.h>
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/data_structures.h"
+#include "util/edid.h"
+#include "util/error_info.h"
+#include "util/report_util.h"
+#include "util/string_util.h"
+/** \endcond */
+
+#include "base/core.h"
+#include "base/ddc_errno.h"
+#include "base/rtti.h"
+
+#include "vcp/vcp_feature_values.h"
+
+#include "ddc/ddc_dumpload.h"
+
+#include "ddc/ddc_dumpload_binary.h"
+
+
+// Default trace class for this file
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDC;
+
+#define HEADER_SIZE          16
+#define INDEX_ENTRY_SIZE     48
+#define SECTION_FIXED_SIZE  140
+#define FEATURE_RECORD_SIZE   4
+
+
+//
+// Little-endian integer encoding
+//
+
+static inline void put_u16(Byte * p, uint16_t v) {
+   p[0] = v & 0xff;
+   p[1] = (v >> 8) & 0xff;
+}
+
+static inline void put_u32(Byte * p, uint32_t v) {
+   for (int ndx = 0; ndx < 4; ndx++)
+      p[ndx] = (v >> (8*ndx)) & 0xff;
+}
+
+static inline void put_u64(Byte * p, uint64_t v) {
+   for (int ndx = 0; ndx < 8; ndx++)
+      p[ndx] = (v >> (8*ndx)) & 0xff;
+}
+
+static inline uint16_t get_u16(const Byte * p) {
+   return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t get_u32(const Byte * p) {
+   uint32_t v = 0;
+   for (int ndx = 3; ndx >= 0; ndx--)
+      v = (v << 8) | p[ndx];
+   return v;
+}
+
+static inline uint64_t get_u64(const Byte * p) {
+   uint64_t v = 0;
+   for (int ndx = 7; ndx >= 0; ndx--)
+      v = (v << 8) | p[ndx];
+   return v;
+}
+
+
+/** Checks whether a byte sequence starts with the binary profile store
+ *  signature.
+ *
+ *  \param  bytes   pointer to bytes
+ *  \param  bytect  number of bytes
+ *  \return true/false
+ */
+bool
+is_dumpload_binary(const Byte * bytes, int bytect) {
+   return (bytect >= HEADER_SIZE &&
+           memcmp(bytes, DUMPLOAD_BINARY_MAGIC, DUMPLOAD_BINARY_MAGIC_LEN) == 0);
+}
+
+
+static void
+append_section(Buffer * buf, Dumpload_Data * data) {
+   Byte fixed[SECTION_FIXED_SIZE];
+   put_u64(fixed, (uint64_t) data->timestamp_millis);
+   memcpy(fixed+8, data->edidbytes, 128);
+   fixed[136] = data->vcp_version.major;
+   fixed[137] = data->vcp_version.minor;
+   int value_ct = (data->vcp_values) ? vcp_value_set_size(data->vcp_values) : 0;
+   put_u16(fixed+138, value_ct);
+   buffer_append(buf, fixed, SECTION_FIXED_SIZE);
+
+   for (int ndx = 0; ndx < value_ct; ndx++) {
+      DDCA_Any_Vcp_Value * vrec = vcp_value_set_get(data->vcp_values, ndx);
+      Byte rec[FEATURE_RECORD_SIZE];
+      rec[0] = vrec->opcode;
+      rec[1] = vrec->value_type;
+      if (vrec->value_type == DDCA_TABLE_VCP_VALUE) {
+         put_u16(rec+2, vrec->val.t.bytect);
+         buffer_append(buf, rec, FEATURE_RECORD_SIZE);
+         buffer_append(buf, vrec->val.t.bytes, vrec->val.t.bytect);
+      }
+      else {
+         put_u16(rec+2, VALREC_CUR_VAL(vrec));
+         buffer_append(buf, rec, FEATURE_RECORD_SIZE);
+      }
+   }
+}
+
+
+typedef struct {
+   Dumpload_Data * data;
+   uint32_t        edid_hash;
+} Section_Sort_Key;
+
+static int
+compare_section_sort_keys(const void * a, const void * b) {
+   const Section_Sort_Key * k1 = a;
+   const Section_Sort_Key * k2 = b;
+   if (k1->edid_hash < k2->edid_hash)
+      return -1;
+   return (k1->edid_hash > k2->edid_hash) ? 1 : 0;
+}
+
+
+/** Converts one or more #Dumpload_Data structs to a binary profile store.
+ *
+ *  \param  profiles    array of pointers to #Dumpload_Data
+ *  \param  profile_ct  number of profiles
+ *  \return newly allocated #Buffer, caller is responsible for freeing
+ */
+Buffer *
+dumpload_data_to_binary(Dumpload_Data ** profiles, int profile_ct) {
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP, "Starting. profile_ct=%d", profile_ct);
+
+   Section_Sort_Key * keys = calloc(profile_ct, sizeof(Section_Sort_Key));
+   for (int ndx = 0; ndx < profile_ct; ndx++) {
+      keys[ndx].data      = profiles[ndx];
+      keys[ndx].edid_hash = edid_fnv1a_hash(profiles[ndx]->edidbytes);
+   }
+   qsort(keys, profile_ct, sizeof(Section_Sort_Key), compare_section_sort_keys);
+
+   int data_start = HEADER_SIZE + profile_ct * INDEX_ENTRY_SIZE;
+   Buffer * buf = buffer_new(data_start + profile_ct * 256, __func__);
+   buffer_set_size_increment(buf, 4096);
+
+   Byte header[HEADER_SIZE] = {0};
+   memcpy(header, DUMPLOAD_BINARY_MAGIC, DUMPLOAD_BINARY_MAGIC_LEN);
+   put_u16(header+8, DUMPLOAD_BINARY_VERSION);
+   put_u32(header+12, profile_ct);
+   buffer_append(buf, header, HEADER_SIZE);
+
+   // reserve space for the index, filled in as sections are appended
+   Byte empty_entry[INDEX_ENTRY_SIZE] = {0};
+   for (int ndx = 0; ndx < profile_ct; ndx++)
+      buffer_append(buf, empty_entry, INDEX_ENTRY_SIZE);
+
+   for (int ndx = 0; ndx < profile_ct; ndx++) {
+      Dumpload_Data * data = keys[ndx].data;
+      int section_start = buf->len;
+      append_section(buf, data);
+
+      Byte * entry = buf->bytes + HEADER_SIZE + ndx * INDEX_ENTRY_SIZE;
+      memcpy(entry,    data->mfg_id,       4);
+      memcpy(entry+4,  data->model,        14);
+      memcpy(entry+18, data->serial_ascii, 14);
+      put_u16(entry+32, data->product_code);
+      put_u32(entry+36, keys[ndx].edid_hash);
+      put_u32(entry+40, section_start);
+      put_u32(entry+44, buf->len - section_start);
+   }
+   free(keys);
+
+   DBGTRC(debug, TRACE_GROUP, "Done. Returning buffer of length %d", buf->len);
+   return buf;
+}
+
+
+static Error_Info *
+validate_header(const Byte * bytes, int bytect, int * section_ct_loc) {
+   *section_ct_loc = 0;
+   if (!is_dumpload_binary(bytes, bytect))
+      return errinfo_new2(DDCRC_BAD_DATA, __func__, "Not a binary profile store");
+   uint16_t version = get_u16(bytes+8);
+   if (version != DUMPLOAD_BINARY_VERSION)
+      return errinfo_new2(DDCRC_BAD_DATA, __func__,
+                          "Unsupported binary profile store version: %d", version);
+   uint32_t section_ct = get_u32(bytes+12);
+   if ((uint64_t) HEADER_SIZE + (uint64_t) section_ct * INDEX_ENTRY_SIZE > bytect)
+      return errinfo_new2(DDCRC_BAD_DATA, __func__,
+                          "Truncated index, section count = %u", section_ct);
+   *section_ct_loc = section_ct;
+   return NULL;
+}
+
+
+static void
+decode_index_entry(const Byte * p, Dumpload_Binary_Index_Entry * entry) {
+   memcpy(entry->mfg_id,       p,    4);
+   memcpy(entry->model,        p+4,  14);
+   memcpy(entry->serial_ascii, p+18, 14);
+   entry->mfg_id[3]        = '\0';
+   entry->model[13]        = '\0';
+   entry->serial_ascii[13] = '\0';
+   entry->product_code     = get_u16(p+32);
+   entry->edid_hash        = get_u32(p+36);
+   entry->section_offset   = get_u32(p+40);
+   entry->section_length   = get_u32(p+44);
+}
+
+
+/** Decodes the section index of a binary profile store.
+ *
+ *  \param  bytes         start of store
+ *  \param  bytect        length of store
+ *  \param  entries_loc   where to return newly allocated array of index entries,
+ *                        caller is responsible for freeing
+ *  \param  entry_ct_loc  where to return number of entries
+ *  \return NULL if success, #Error_Info if invalid data
+ */
+Error_Info *
+dumpload_binary_get_index(
+      const Byte *                   bytes,
+      int                            bytect,
+      Dumpload_Binary_Index_Entry ** entries_loc,
+      int *                          entry_ct_loc)
+{
+   *entries_loc  = NULL;
+   *entry_ct_loc = 0;
+   int section_ct = 0;
+   Error_Info * err = validate_header(bytes, bytect, &section_ct);
+   if (!err) {
+      Dumpload_Binary_Index_Entry * entries =
+            calloc(section_ct, sizeof(Dumpload_Binary_Index_Entry));
+      for (int ndx = 0; ndx < section_ct; ndx++)
+         decode_index_entry(bytes + HEADER_SIZE + ndx*INDEX_ENTRY_SIZE, &entries[ndx]);
+      *entries_loc  = entries;
+      *entry_ct_loc = section_ct;
+   }
+   return err;
+}
+
+
+/** Locates the section of a binary profile store for a particular monitor.
+ *
+ *  The index is binary searched on EDID hash.  Since hashes can collide,
+ *  the EDID stored in each candidate section is compared as well.
+ *
+ *  \param  bytes            start of store
+ *  \param  bytect           length of store
+ *  \param  edidbytes        128 byte EDID of monitor
+ *  \param  section_ndx_loc  where to return section number, -1 if not found
+ *  \return NULL if success (including not found), #Error_Info if invalid data
+ */
+Error_Info *
+dumpload_binary_find_section(
+      const Byte *  bytes,
+      int           bytect,
+      const Byte *  edidbytes,
+      int *         section_ndx_loc)
+{
+   bool debug = false;
+   *section_ndx_loc = -1;
+   int section_ct = 0;
+   Error_Info * err = validate_header(bytes, bytect, &section_ct);
+   if (err)
+      goto bye;
+
+   uint32_t hash = edid_fnv1a_hash(edidbytes);
+   int lo = 0;
+   int hi = section_ct;
+   while (lo < hi) {
+      int mid = lo + (hi - lo)/2;
+      if (get_u32(bytes + HEADER_SIZE + mid*INDEX_ENTRY_SIZE + 36) < hash)
+         lo = mid+1;
+      else
+         hi = mid;
+   }
+
+   for (int ndx = lo; ndx < section_ct; ndx++) {
+      const Byte * entry = bytes + HEADER_SIZE + ndx*INDEX_ENTRY_SIZE;
+      if (get_u32(entry+36) != hash)
+         break;
+      uint32_t offset = get_u32(entry+40);
+      if ((uint64_t) offset + SECTION_FIXED_SIZE > bytect) {
+         err = errinfo_new2(DDCRC_BAD_DATA, __func__,
+                            "Section %d offset %u beyond end of data", ndx, offset);
+         break;
+      }
+      if (memcmp(bytes + offset + 8, edidbytes, 128) == 0) {
+         *section_ndx_loc = ndx;
+         break;
+      }
+   }
+
+bye:
+   DBGTRC(debug, TRACE_GROUP, "Returning: %s, *section_ndx_loc=%d",
+                              errinfo_summary(err), *section_ndx_loc);
+   return err;
+}
+
+
+#define ADD_DATA_ERROR(_fmt, ...) \
+      errinfo_add_cause(  \
+         errs,            \
+         errinfo_new2(    \
+            DDCRC_BAD_DATA, __func__, \
+            "Section %d: " _fmt, section_ndx, ##__VA_ARGS__) )
+
+
+/** Converts one section of a binary profile store to a #Dumpload_Data struct.
+ *
+ *  \param  bytes              start of store
+ *  \param  bytect             length of store
+ *  \param  section_ndx        section number
+ *  \param  dumpload_data_loc  where to return newly allocated #Dumpload_Data,
+ *                             NULL if error
+ *  \return NULL if success, #Error_Info if invalid data
+ */
+Error_Info *
+create_dumpload_data_from_binary(
+      const Byte *     bytes,
+      int              bytect,
+      int              section_ndx,
+      Dumpload_Data ** dumpload_data_loc)
+{
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP, "Starting. bytect=%d, section_ndx=%d", bytect, section_ndx);
+   *dumpload_data_loc = NULL;
+
+   int section_ct = 0;
+   Error_Info * err = validate_header(bytes, bytect, &section_ct);
+   if (err)
+      goto bye;
+   if (section_ndx < 0 || section_ndx >= section_ct) {
+      err = errinfo_new2(DDCRC_ARG, __func__, "Invalid section number: %d", section_ndx);
+      goto bye;
+   }
+
+   Dumpload_Binary_Index_Entry entry;
+   decode_index_entry(bytes + HEADER_SIZE + section_ndx*INDEX_ENTRY_SIZE, &entry);
+   if ( entry.section_length < SECTION_FIXED_SIZE ||
+        (uint64_t) entry.section_offset + entry.section_length > bytect)
+   {
+      err = errinfo_new2(DDCRC_BAD_DATA, __func__,
+                         "Section %d: invalid offset %u or length %u",
+                         section_ndx, entry.section_offset, entry.section_length);
+      goto bye;
+   }
+
+   Error_Info * errs = errinfo_new(DDCRC_BAD_DATA, __func__);
+   const Byte * section = bytes + entry.section_offset;
+   const Byte * end     = section + entry.section_length;
+
+   Dumpload_Data * data = calloc(1, sizeof(Dumpload_Data));
+   memcpy(data->mfg_id,       entry.mfg_id,       sizeof(data->mfg_id));
+   memcpy(data->model,        entry.model,        sizeof(data->model));
+   memcpy(data->serial_ascii, entry.serial_ascii, sizeof(data->serial_ascii));
+   data->product_code     = entry.product_code;
+   data->timestamp_millis = (time_t) get_u64(section);
+   memcpy(data->edidbytes, section+8, 128);
+   hexstring2(data->edidbytes, 128,
+              NULL /* no separator */,
+              true /* uppercase */,
+              data->edidstr, sizeof(data->edidstr));
+   data->vcp_version.major = section[136];
+   data->vcp_version.minor = section[137];
+   int value_ct = get_u16(section+138);
+   data->vcp_values = vcp_value_set_new(value_ct);
+
+   const Byte * p = section + SECTION_FIXED_SIZE;
+   for (int ndx = 0; ndx < value_ct; ndx++) {
+      if (p + FEATURE_RECORD_SIZE > end) {
+         ADD_DATA_ERROR("Truncated feature record %d", ndx);
+         break;
+      }
+      Byte     feature_id = p[0];
+      Byte     value_type = p[1];
+      uint16_t value      = get_u16(p+2);
+      p += FEATURE_RECORD_SIZE;
+
+      DDCA_Any_Vcp_Value * valrec = NULL;
+      if (value_type == DDCA_TABLE_VCP_VALUE) {
+         if (p + value > end) {
+            ADD_DATA_ERROR("Truncated table value for feature 0x%02x", feature_id);
+            break;
+         }
+         valrec = create_table_vcp_value_by_bytes(feature_id, (Byte*) p, value);
+         p += value;
+      }
+      else if (value_type == DDCA_NON_TABLE_VCP_VALUE) {
+         valrec = create_cont_vcp_value(
+                     feature_id,
+                     0,   // max_val, unused for LOADVCP
+                     value);
+      }
+      else {
+         ADD_DATA_ERROR("Invalid value type %d for feature 0x%02x", value_type, feature_id);
+         break;
+      }
+      vcp_value_set_add(data->vcp_values, valrec);
+      data->vcp_value_ct++;
+   }
+
+   if (errs->cause_ct == 0) {
+      errinfo_free(errs);
+      *dumpload_data_loc = data;
+   }
+   else {
+      free_dumpload_data(data);
+      err = errs;
+   }
+
+bye:
+   DBGTRC(debug, TRACE_GROUP, "Returning: %s, *dumpload_data_loc=%p",
+                              errinfo_summary(err), *dumpload_data_loc);
+   return err;
+}
+
+#undef ADD_DATA_ERROR
+
+
+/** Converts every section of a binary profile store to a #Dumpload_Data struct.
+ *
+ *  \param  bytes                    start of store
+ *  \param  bytect                   length of store
+ *  \param  dumpload_data_array_loc  where to return a newly allocated GPtrArray of
+ *                                   #Dumpload_Data, in index order
+ *  \return NULL if success, #Error_Info if invalid data
+ */
+Error_Info *
+create_dumpload_data_array_from_binary(
+      const Byte *  bytes,
+      int           bytect,
+      GPtrArray **  dumpload_data_array_loc)
+{
+   *dumpload_data_array_loc = NULL;
+   int section_ct = 0;
+   Error_Info * err = validate_header(bytes, bytect, &section_ct);
+   if (!err) {
+      GPtrArray * profiles = g_ptr_array_sized_new(section_ct);
+      g_ptr_array_set_free_func(profiles, (GDestroyNotify) free_dumpload_data);
+      for (int ndx = 0; ndx < section_ct && !err; ndx++) {
+         Dumpload_Data * data = NULL;
+         err = create_dumpload_data_from_binary(bytes, bytect, ndx, &data);
+         if (data)
+            g_ptr_array_add(profiles, data);
+      }
+      if (err)
+         g_ptr_array_free(profiles, true);
+      else
+         *dumpload_data_array_loc = profiles;
+   }
+   return err;
+}
+
+
+void init_ddc_dumpload_binary() {
+   RTTI_ADD_FUNC(dumpload_data_to_binary);
+   RTTI_ADD_FUNC(dumpload_binary_find_section);
+   RTTI_ADD_FUNC(create_dumpload_data_from_binary);
+}
@@ -0,0 +1,88 @@
+/** \file ddc_dumpload_binary.h
+ *
+ * Compact binary container for DUMPVCP/LOADVCP profile data.
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_DUMPLOAD_BINARY_H_
+#define DDC_DUMPLOAD_BINARY_H_
+
+/** \cond */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "util/coredefs.h"
+#include "util/data_structures.h"
+#include "util/error_info.h"
+/** \endcond */
+
+#include "ddc/ddc_dumpload.h"
+
+/** Leading bytes of a binary profile store. */
+#define DUMPLOAD_BINARY_MAGIC        "DDCPROF"    // 7 chars + trailing '\0'
+#define DUMPLOAD_BINARY_MAGIC_LEN    8
+#define DUMPLOAD_BINARY_VERSION      1
+
+/** Conventional file name suffix for binary profile stores */
+#define DUMPLOAD_BINARY_SUFFIX       ".vcpb"
+
+/** Section index entry, as decoded from a binary profile store.
+ *
+ *  The index is sorted by **edid_hash**, so that the section for a
+ *  given monitor can be located by binary search without touching
+ *  the section data of any other monitor.
+ */
+typedef
+struct {
+   char      mfg_id[4];         ///< 3 character manufacturer id
+   char      model[14];         ///< model name
+   char      serial_ascii[14];  ///< serial number string
+   uint16_t  product_code;      ///< numeric product code
+   uint32_t  edid_hash;         ///< hash of 128 byte EDID
+   uint32_t  section_offset;    ///< offset of section from start of store
+   uint32_t  section_length;    ///< section length in bytes
+} Dumpload_Binary_Index_Entry;
+
+bool
+is_dumpload_binary(
+      const Byte *     bytes,
+      int              bytect);
+
+Buffer *
+dumpload_data_to_binary(
+      Dumpload_Data ** profiles,
+      int              profile_ct);
+
+Error_Info *
+dumpload_binary_get_index(
+      const Byte *     bytes,
+      int              bytect,
+      Dumpload_Binary_Index_Entry ** entries_loc,
+      int *            entry_ct_loc);
+
+Error_Info *
+dumpload_binary_find_section(
+      const Byte *     bytes,
+      int              bytect,
+      const Byte *     edidbytes,
+      int *            section_ndx_loc);
+
+Error_Info *
+create_dumpload_data_from_binary(
+      const Byte *     bytes,
+      int              bytect,
+      int              section_ndx,
+      Dumpload_Data ** dumpload_data_loc);
+
+Error_Info *
+create_dumpload_data_array_from_binary(
+      const Byte *     bytes,
+      int              bytect,
+      GPtrArray **     dumpload_data_array_loc);
+
+void
+init_ddc_dumpload_binary();
+
+#endif /* DDC_DUMPLOAD_BINARY_H_ */
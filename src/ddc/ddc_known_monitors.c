@@ -0,0 +1,288 @@
+/** \file ddc_known_monitors.c
+ *
+ *  Persistent record of monitor models whose initial checks succeeded.
+ *
+ *  Initial checks read feature x00, with full retry and sleeps, to determine
+ *  whether DDC communication works and how the monitor indicates that a
+ *  feature is unsupported, then read feature xDF to determine the VCP version.
+ *  The results depend only on the monitor model, so they are recorded here,
+ *  keyed by #DDCA_Monitor_Model_Key and EDID checksum.  For a recorded
+ *  monitor, initial checks perform a single read of feature x00 to confirm
+ *  that the monitor still responds as recorded.
+ *
+ *  File format, one monitor per line:
+ *
+ *      <edid checksum>:<dref flags>:<vcp version>:<monitor model string>
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/** \cond */
+#include <assert.h>
+#include <errno.h>
+#include <glib-2.0/glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/** \endcond */
+
+#include "public/ddcutil_status_codes.h"
+
+#include "util/error_info.h"
+#include "util/file_util.h"
+#include "util/report_util.h"
+#include "util/string_util.h"
+#include "util/xdg_util.h"
+
+#include "base/core.h"
+#include "base/displays.h"
+#include "base/monitor_model_key.h"
+#include "base/rtti.h"
+#include "base/vcp_version.h"
+
+#include "ddc/ddc_known_monitors.h"
+
+
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDC;
+
+// Dref_Flags bits determined by initial checks that are recorded
+#define KNOWN_MONITOR_FLAGS  ( DREF_DDC_COMMUNICATION_WORKING                 | \
+                               DREF_DDC_USES_NULL_RESPONSE_FOR_UNSUPPORTED    | \
+                               DREF_DDC_USES_MH_ML_SH_SL_ZERO_FOR_UNSUPPORTED | \
+                               DREF_DDC_USES_DDC_FLAG_FOR_UNSUPPORTED         | \
+                               DREF_DDC_DOES_NOT_INDICATE_UNSUPPORTED )
+
+/** Recorded initial check results for one monitor model */
+typedef struct {
+   Dref_Flags             dref_flags;
+   DDCA_MCCS_Version_Spec vcp_version;
+} Known_Monitor_Rec;
+
+static bool         full_initial_checks = false;
+static GHashTable * known_monitors = NULL;   // "<checksum>:<model string>" -> Known_Monitor_Rec *
+static GMutex       known_monitors_mutex;
+
+
+/** Forces full initial checks, even for monitors recorded as well behaved.
+ *  Results of full checks continue to be recorded.
+ *
+ *  \param  onoff  new setting
+ *  \return prior setting
+ */
+bool enable_full_initial_checks(bool onoff) {
+   bool old = full_initial_checks;
+   full_initial_checks = onoff;
+   return old;
+}
+
+
+/** Reports whether full initial checks are forced */
+bool is_full_initial_checks_enabled() {
+   return full_initial_checks;
+}
+
+
+/** Returns the name of the known monitors file.
+ *  Caller is responsible for freeing.
+ */
+char * get_known_monitors_file_name() {
+   return xdg_cache_home_file("ddcutil", "known_monitors");
+}
+
+
+// Returns NULL if the display has no EDID
+static char * known_monitor_key(Display_Ref * dref) {
+   if (!dref->pedid || !dref->mmid)
+      return NULL;
+   return g_strdup_printf("%02x:%s", dref->pedid->bytes[127], monitor_model_string(dref->mmid));
+}
+
+
+// Must be called with known_monitors_mutex held
+static void load_known_monitors_file() {
+   bool debug = false;
+   known_monitors = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+
+   char * fn = get_known_monitors_file_name();
+   DBGTRC(debug, TRACE_GROUP, "Starting. fn=%s", fn);
+   GPtrArray * linearray = g_ptr_array_new_with_free_func(g_free);
+   Error_Info * errs = file_getlines_errinfo(fn, linearray);
+   if (!errs) {
+      for (int ndx = 0; ndx < linearray->len; ndx++) {
+         char * aline = g_ptr_array_index(linearray, ndx);
+         if (strlen(aline) == 0 || aline[0] == '#')
+            continue;
+         // the model string may itself contain colons
+         char ** pieces = g_strsplit(aline, ":", 4);
+         int checksum, dref_flags, vmajor, vminor;
+         if (ntsa_length(pieces) == 4                          &&
+             str_to_int(pieces[0], &checksum,   16)            &&
+             str_to_int(pieces[1], &dref_flags, 16)            &&
+             sscanf(pieces[2], "%d.%d", &vmajor, &vminor) == 2)
+         {
+            Known_Monitor_Rec * rec = g_new0(Known_Monitor_Rec, 1);
+            rec->dref_flags = dref_flags & KNOWN_MONITOR_FLAGS;
+            rec->vcp_version.major = vmajor;
+            rec->vcp_version.minor = vminor;
+            g_hash_table_insert(known_monitors,
+                                g_strdup_printf("%02x:%s", checksum, pieces[3]), rec);
+         }
+         else {
+            DBGTRC(debug, TRACE_GROUP, "Line %d, invalid: %s", ndx+1, aline);
+         }
+         g_strfreev(pieces);
+      }
+   }
+   else if (ERRINFO_STATUS(errs) == -ENOENT) {
+      errinfo_free(errs);
+   }
+   else {
+      ERRINFO_FREE_WITH_REPORT(errs, debug || IS_TRACING());
+   }
+   g_ptr_array_free(linearray, true);
+   free(fn);
+   DBGTRC(debug, TRACE_GROUP, "Done. Loaded %d monitors", g_hash_table_size(known_monitors));
+}
+
+
+// Must be called with known_monitors_mutex held
+static void save_known_monitors_file() {
+   bool debug = false;
+   char * fn = get_known_monitors_file_name();
+   DBGTRC(debug, TRACE_GROUP, "Starting. fn=%s", fn);
+   FILE * fp = NULL;
+   fopen_mkdir(fn, "w", ferr(), &fp);
+   if (fp) {
+      GHashTableIter iter;
+      gpointer key, value;
+      g_hash_table_iter_init(&iter, known_monitors);
+      while (g_hash_table_iter_next(&iter, &key, &value)) {
+         char * colon = strchr((char *) key, ':');
+         Known_Monitor_Rec * rec = value;
+         fprintf(fp, "%.*s:%04x:%d.%d:%s\n", (int) (colon - (char *) key), (char *) key,
+                     rec->dref_flags, rec->vcp_version.major, rec->vcp_version.minor, colon+1);
+      }
+      fclose(fp);
+   }
+   free(fn);
+   DBGTRC(debug, TRACE_GROUP, "Done");
+}
+
+
+/** Looks up the recorded initial check results for a display's monitor model.
+ *
+ *  \param  dref       display reference
+ *  \param  flags_loc  where to return the recorded #Dref_Flags bits
+ *  \param  vspec_loc  where to return the recorded VCP version
+ *  \return true if the monitor is recorded and full checks are not forced
+ */
+bool ddc_get_known_monitor(
+      Display_Ref *            dref,
+      Dref_Flags *             flags_loc,
+      DDCA_MCCS_Version_Spec * vspec_loc)
+{
+   bool debug = false;
+   bool found = false;
+   char * key = known_monitor_key(dref);
+   if (key && !full_initial_checks) {
+      g_mutex_lock(&known_monitors_mutex);
+      if (!known_monitors)
+         load_known_monitors_file();
+      Known_Monitor_Rec * rec = g_hash_table_lookup(known_monitors, key);
+      if (rec) {
+         *flags_loc = rec->dref_flags;
+         *vspec_loc = rec->vcp_version;
+         found = true;
+      }
+      g_mutex_unlock(&known_monitors_mutex);
+   }
+   DBGTRC(debug, TRACE_GROUP, "dref=%s, key=%s, Returning %s",
+                              dref_repr_t(dref), key, sbool(found));
+   free(key);
+   return found;
+}
+
+
+/** Records the initial check results for a display's monitor model.
+ *
+ *  The results are recorded only if DDC communication works and exactly one
+ *  means of indicating unsupported features was determined.
+ *
+ *  \param  dref       display reference, initial checks completed
+ */
+void ddc_set_known_monitor(Display_Ref * dref) {
+   bool debug = false;
+   Dref_Flags flags = dref->flags & KNOWN_MONITOR_FLAGS;
+   Dref_Flags unsupported_flags = flags & ~DREF_DDC_COMMUNICATION_WORKING;
+   bool well_behaved = (flags & DREF_DDC_COMMUNICATION_WORKING)                   &&
+                       unsupported_flags != 0                                     &&
+                       (unsupported_flags & (unsupported_flags-1)) == 0           &&
+                       !vcp_version_eq(dref->vcp_version_xdf, DDCA_VSPEC_UNQUERIED);
+   char * key = known_monitor_key(dref);
+   DBGTRC(debug, TRACE_GROUP, "dref=%s, key=%s, well_behaved=%s",
+                              dref_repr_t(dref), key, sbool(well_behaved));
+   if (key && well_behaved) {
+      g_mutex_lock(&known_monitors_mutex);
+      if (!known_monitors)
+         load_known_monitors_file();
+      Known_Monitor_Rec * rec = g_hash_table_lookup(known_monitors, key);
+      if (!rec || rec->dref_flags != flags || !vcp_version_eq(rec->vcp_version, dref->vcp_version_xdf)) {
+         rec = g_new0(Known_Monitor_Rec, 1);
+         rec->dref_flags  = flags;
+         rec->vcp_version = dref->vcp_version_xdf;
+         g_hash_table_replace(known_monitors, key, rec);
+         key = NULL;                    // now owned by hash table
+         save_known_monitors_file();
+      }
+      g_mutex_unlock(&known_monitors_mutex);
+   }
+   free(key);
+}
+
+
+/** Removes the record for a display's monitor model, e.g. because the
+ *  monitor did not respond as recorded.
+ *
+ *  \param  dref       display reference
+ */
+void ddc_forget_known_monitor(Display_Ref * dref) {
+   bool debug = false;
+   char * key = known_monitor_key(dref);
+   DBGTRC(debug, TRACE_GROUP, "dref=%s, key=%s", dref_repr_t(dref), key);
+   if (key) {
+      g_mutex_lock(&known_monitors_mutex);
+      if (known_monitors && g_hash_table_remove(known_monitors, key))
+         save_known_monitors_file();
+      g_mutex_unlock(&known_monitors_mutex);
+      free(key);
+   }
+}
+
+
+void dbgrpt_known_monitors(int depth) {
+   g_mutex_lock(&known_monitors_mutex);
+   if (!known_monitors)
+      rpt_label(depth, "Known monitors not loaded");
+   else {
+      rpt_vstring(depth, "Known monitors: %d", g_hash_table_size(known_monitors));
+      GHashTableIter iter;
+      gpointer key, value;
+      g_hash_table_iter_init(&iter, known_monitors);
+      while (g_hash_table_iter_next(&iter, &key, &value)) {
+         Known_Monitor_Rec * rec = value;
+         rpt_vstring(depth+1, "%s -> %s, vcp version %s", (char *) key,
+                              dref_basic_flags_t(rec->dref_flags), format_vspec(rec->vcp_version));
+      }
+   }
+   g_mutex_unlock(&known_monitors_mutex);
+}
+
+
+void init_ddc_known_monitors() {
+   RTTI_ADD_FUNC(load_known_monitors_file);
+   RTTI_ADD_FUNC(save_known_monitors_file);
+   RTTI_ADD_FUNC(ddc_get_known_monitor);
+   RTTI_ADD_FUNC(ddc_set_known_monitor);
+   RTTI_ADD_FUNC(ddc_forget_known_monitor);
+}
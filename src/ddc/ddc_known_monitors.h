@@ -0,0 +1,29 @@
+/** \file ddc_known_monitors.h
+ *
+ *  Persistent record of monitor models whose initial checks succeeded
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_KNOWN_MONITORS_H_
+#define DDC_KNOWN_MONITORS_H_
+
+/** \cond */
+#include <stdbool.h>
+/** \endcond */
+
+#include "ddcutil_types.h"
+
+#include "base/displays.h"
+
+bool   enable_full_initial_checks(bool onoff);
+bool   is_full_initial_checks_enabled();
+char * get_known_monitors_file_name();
+bool   ddc_get_known_monitor(Display_Ref * dref, Dref_Flags * flags_loc, DDCA_MCCS_Version_Spec * vspec_loc);
+void   ddc_set_known_monitor(Display_Ref * dref);
+void   ddc_forget_known_monitor(Display_Ref * dref);
+void   dbgrpt_known_monitors(int depth);
+void   init_ddc_known_monitors();
+
+#endif /* DDC_KNOWN_MONITORS_H_ */
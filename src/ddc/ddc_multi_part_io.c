@@ -10,6 +10,7 @@
 /** \cond */
 #include <assert.h>
 #include <errno.h>
+#include <glib-2.0/glib.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,18 +18,21 @@
 
 #include "public/ddcutil_types.h"
 
+#include "util/report_util.h"
 #include "util/string_util.h"
 /** \endcond */
 
 #include "base/core.h"
 #include "base/ddc_errno.h"
 #include "base/ddc_packets.h"
+#include "base/displays.h"
 #include "base/execution_stats.h"
 #include "base/parms.h"
 #include "base/rtti.h"
 #include "base/tuned_sleep.h"
 
 #include "ddc/ddc_packet_io.h"
+#include "ddc/ddc_retry_policy.h"
 #include "ddc/ddc_try_stats.h"
 
 #include "ddc/ddc_multi_part_io.h"
@@ -38,29 +42,40 @@
 static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDC;
 
 
-/** Makes one attempt to read the entire capabilities string or table feature value
+/** Makes one attempt to read the entire capabilities string or table feature value,
+*  or the part of it beginning at an offset.
 *
 * @param  dh             display handle for open i2c or adl device
 * @param  request_type   DDC_PACKET_TYPE_CAPABILITIES_REQUEST or DDC_PACKET_TYPE_TABLE_REQD_REQUEST
 * @param  request_subtype  VCP feature code for table read, ignore for capabilities
 * @param  all_zero_response_ok  if true, an all zero response is not regarded
 *         as an error
+* @param  start_offset   offset at which to begin reading
+* @param  max_bytes      stop reading once this many bytes have been read, -1 for no limit
+* @param  fragment_func  if non-NULL, called with each fragment as it is read
+* @param  fragment_arg   passed to **fragment_func**
 * @param  accumulator    buffer in which to return result (already allocated)
 *
 * @return @Error_Info struct with error detail, NULL if no error
 */
 static Error_Info *
 try_multi_part_read(
-      Display_Handle * dh,
-      Byte             request_type,
-      Byte             request_subtype,
-      bool             all_zero_response_ok,
-      Buffer *         accumulator)
+      Display_Handle *         dh,
+      Byte                     request_type,
+      Byte                     request_subtype,
+      bool                     all_zero_response_ok,
+      int                      start_offset,
+      int                      max_bytes,
+      Multi_Part_Fragment_Func fragment_func,
+      void *                   fragment_arg,
+      Buffer *                 accumulator)
 {
    bool debug = false;
    DBGTRC(debug, TRACE_GROUP,
-          "Starting. request_type=0x%02x, request_subtype=x%02x, all_zero_response_ok=%s, accumulator=%p",
-          request_type, request_subtype, sbool(all_zero_response_ok), accumulator);
+          "Starting. request_type=0x%02x, request_subtype=x%02x, all_zero_response_ok=%s"
+          ", start_offset=%d, max_bytes=%d, accumulator=%p",
+          request_type, request_subtype, sbool(all_zero_response_ok),
+          start_offset, max_bytes, accumulator);
 
    const int MAX_FRAGMENT_SIZE = 32;
    const int readbuf_size = 6 + MAX_FRAGMENT_SIZE + 1;
@@ -73,10 +88,10 @@ try_multi_part_read(
    request_packet_ptr = create_ddc_multi_part_read_request_packet(
                            request_type,
                            request_subtype,
-                           0,
+                           start_offset,
                            "try_multi_part_read");
    buffer_set_length(accumulator,0);
-   int  cur_offset = 0;
+   int  cur_offset = start_offset;
    bool complete   = false;
    while (!complete && !excp) {         // loop over fragments
       DBGTRC(debug, DDCA_TRC_NONE, "Top of fragment loop");
@@ -138,7 +153,13 @@ try_multi_part_read(
          }
          else {
             buffer_append(accumulator, aux_data_ptr->bytes, fragment_size);
+            if (fragment_func)
+               fragment_func(request_subtype, cur_offset, aux_data_ptr->bytes, fragment_size, fragment_arg);
             cur_offset = cur_offset + fragment_size;
+            if (max_bytes >= 0 && accumulator->len >= max_bytes) {
+               buffer_set_length(accumulator, max_bytes);
+               complete = true;
+            }
             if ( IS_TRACING_BY_FUNC_OR_FILE() || debug ) {
                DBGMSG("Currently assembled fragment: |%.*s|", accumulator->len, accumulator->bytes);
                DBGMSG("cur_offset = %d", cur_offset);
@@ -157,13 +178,26 @@ try_multi_part_read(
 }
 
 
-/** Gets the DDC capabilities string for a monitor, performing retries if necessary.
- *  Also used for VCP features of type Table.
+/** Reads part of a capabilities string or table feature value, performing
+ *  retries if necessary.
+ *
+ *  If **fragment_func** is set, it is called with each fragment as it is
+ *  read, so the caller can process the value before it is complete.  If a
+ *  try fails, the fragments are delivered again by the next try, beginning
+ *  at **start_offset**.
+ *
+ *  Not all monitors support reads beginning at a non-zero offset.  If the
+ *  first fragment is returned for a different offset, the read is not
+ *  retried and DDCRC_MULTI_PART_READ_FRAGMENT is returned.
 *
 *  @param  dh                    handle of open display
 *  @param  request_type
 *  @param  request_subtype       VCP function code for table read, ignore for capabilities
 *  @param  all_zero_response_ok  if true, zero response is not an error
+*  @param  start_offset          offset at which to begin reading
+*  @param  max_bytes             maximum number of bytes to read, -1 for no limit
+*  @param  fragment_func         if non-NULL, called with each fragment read
+*  @param  fragment_arg          passed to **fragment_func**
 *  @param  buffer_loc            address at which to return newly allocated #Buffer in which
 *                                result is returned
 *
@@ -172,19 +206,29 @@ try_multi_part_read(
 *  @retval  #Ddc_Error containing status DDCRC_TRIES  maximum retries exceeded:
 */
 Error_Info *
-multi_part_read_with_retry(
-      Display_Handle * dh,
-      Byte             request_type,
-      Byte             request_subtype,   // VCP feature code for table read, ignore for capabilities
-      bool             all_zero_response_ok,
-      Buffer**         buffer_loc)
+multi_part_read_range_with_retry(
+      Display_Handle *         dh,
+      Byte                     request_type,
+      Byte                     request_subtype,
+      bool                     all_zero_response_ok,
+      int                      start_offset,
+      int                      max_bytes,
+      Multi_Part_Fragment_Func fragment_func,
+      void *                   fragment_arg,
+      Buffer**                 buffer_loc)
 {
    bool debug = false;
-   Retry_Op_Value max_multi_part_read_tries = try_data_get_maxtries2(MULTI_PART_READ_OP);
+   tds_set_current_display(&dh->dref->io_path);
+   Retry_Op_Value max_multi_part_read_tries = drp_get_maxtries(dh->dref, MULTI_PART_READ_OP);
+   bool known_unsupported = request_type == DDC_PACKET_TYPE_TABLE_READ_REQUEST &&
+                            drp_is_unsupported_feature(dh->dref, request_subtype);
+   if (known_unsupported)
+      max_multi_part_read_tries = 1;
    DBGTRC(debug, TRACE_GROUP,
           "Starting.  request_type=0x%02x, request_subtype=0x%02x, all_zero_response_ok=%s"
-          ", max_multi_part_read_tries=%d",
-          request_type, request_subtype, sbool(all_zero_response_ok), max_multi_part_read_tries);
+          ", start_offset=%d, max_bytes=%d, max_multi_part_read_tries=%d",
+          request_type, request_subtype, sbool(all_zero_response_ok),
+          start_offset, max_bytes, max_multi_part_read_tries);
 
 
    Public_Status_Code rc = -1;   // dummy value for first call of while loop
@@ -194,7 +238,9 @@ multi_part_read_with_retry(
 
    int tryctr = 0;
    bool can_retry = true;
-   Buffer * accumulator = buffer_new(2048, "multi part read buffer");
+   Buffer * accumulator = buffer_new( (max_bytes >= 0) ? max_bytes + MAX_DDC_DATA_SIZE : 2048,
+                                      "multi part read buffer");
+   buffer_set_size_increment(accumulator, 2048);     // LUTs can exceed the initial size
 
    while (tryctr < max_multi_part_read_tries && rc < 0 && can_retry) {
       DBGTRC(debug, DDCA_TRC_NONE,
@@ -206,11 +252,19 @@ multi_part_read_with_retry(
               request_type,
               request_subtype,
               all_zero_response_ok,
+              start_offset,
+              max_bytes,
+              fragment_func,
+              fragment_arg,
               accumulator);
       try_errors[tryctr] = ddc_excp;
       rc = (ddc_excp) ? ddc_excp->status_code : 0;
 
-      if (rc == DDCRC_NULL_RESPONSE || rc == DDCRC_ALL_RESPONSES_NULL) {
+      if (rc == DDCRC_MULTI_PART_READ_FRAGMENT && start_offset > 0 && accumulator->len == 0) {
+         // monitor does not support reading from an offset
+         can_retry = false;
+      }
+      else if (rc == DDCRC_NULL_RESPONSE || rc == DDCRC_ALL_RESPONSES_NULL) {
          // generally means this, but could conceivably indicate a protocol error.
          // try multiple times to ensure it's really unsupported?
 
@@ -271,6 +325,8 @@ multi_part_read_with_retry(
 
    // if counts for DDCRC_ALL_TRIES_ZERO?
    try_data_record_tries2(MULTI_PART_READ_OP, rc, tryctr);
+   if (!known_unsupported)
+      drp_record_tries(dh->dref, MULTI_PART_READ_OP, rc, tryctr);
 
    *buffer_loc = accumulator;
    DBGTRC(debug, TRACE_GROUP, "Returning: %s", errinfo_summary(ddc_excp));
@@ -278,62 +334,239 @@ multi_part_read_with_retry(
 }
 
 
-/** Makes one attempt to write an entire VCP Table value
+/** Gets the DDC capabilities string for a monitor, performing retries if necessary.
+ *  Also used for VCP features of type Table.
 *
-*   @param dh             display handle for open i2c or adl device
-*   @param vcp_code       VCP feature code
-*   @param value_to_set   Table feature value
+*  @param  dh                    handle of open display
+*  @param  request_type
+*  @param  request_subtype       VCP function code for table read, ignore for capabilities
+*  @param  all_zero_response_ok  if true, zero response is not an error
+*  @param  buffer_loc            address at which to return newly allocated #Buffer in which
+*                                result is returned
 *
-*   @return status code
+*  @retval  NULL    success
+*  @retval  #Ddc_Error containing status DDCRC_UNSUPPORTED does not support Capabilities Request
+*  @retval  #Ddc_Error containing status DDCRC_TRIES  maximum retries exceeded:
 */
-static Error_Info *
-try_multi_part_write(
+Error_Info *
+multi_part_read_with_retry(
       Display_Handle * dh,
-      Byte             vcp_code,
-      Buffer *         value_to_set)
+      Byte             request_type,
+      Byte             request_subtype,   // VCP feature code for table read, ignore for capabilities
+      bool             all_zero_response_ok,
+      Buffer**         buffer_loc)
 {
-   bool debug = false;
-   Byte request_type = DDC_PACKET_TYPE_TABLE_WRITE_REQUEST;
-   Byte request_subtype = vcp_code;
-   DBGTRC(debug, TRACE_GROUP,
-          "Starting. request_type=0x%02x, request_subtype=x%02x, accumulator=%p",
-          request_type, request_subtype, value_to_set);
+   return multi_part_read_range_with_retry(
+             dh, request_type, request_subtype, all_zero_response_ok,
+             0, -1, NULL, NULL, buffer_loc);
+}
 
-   Public_Status_Code psc = 0;
-   Error_Info * ddc_excp = NULL;
-   int MAX_FRAGMENT_SIZE = 32;
-   int max_fragment_size = MAX_FRAGMENT_SIZE - 4;    // hack
-   // const int writebbuf_size = 6 + MAX_FRAGMENT_SIZE + 1;
 
-   DDC_Packet * request_packet_ptr  = NULL;
-   int bytes_remaining = value_to_set->len;
-   int offset = 0;
-   while (bytes_remaining >= 0 && psc == 0) {
-      int bytect_to_write = (bytes_remaining <= max_fragment_size)
-                                    ? bytes_remaining
-                                    : max_fragment_size;
-      request_packet_ptr =  create_ddc_multi_part_write_request_packet(
+//
+// Table writes
+//
+
+/** Table write pacing for one display, adapted as fragments are written */
+typedef struct {
+   DDCA_IO_Path io_path;
+   int          fragment_size;          ///< data bytes per fragment
+   int          fragment_delay_millis;  ///< delay after each fragment
+   int          success_run;            ///< consecutive fragments written on the first try
+   int          fragment_retry_ct;      ///< fragment tries that failed
+} Table_Write_Pacing;
+
+static GHashTable * write_pacing_by_io_path = NULL;   // DDCA_IO_Path * -> Table_Write_Pacing *
+static GMutex       write_pacing_mutex;
+
+
+// Returns a copy of the current pacing for a display
+static Table_Write_Pacing get_write_pacing(DDCA_IO_Path io_path) {
+   g_mutex_lock(&write_pacing_mutex);
+   if (!write_pacing_by_io_path)
+      write_pacing_by_io_path = g_hash_table_new_full(dpath_hash, dpath_hash_equal, NULL, g_free);
+   Table_Write_Pacing * pacing = g_hash_table_lookup(write_pacing_by_io_path, &io_path);
+   if (!pacing) {
+      pacing = g_new0(Table_Write_Pacing, 1);
+      pacing->io_path = io_path;
+      pacing->fragment_size = MULTI_PART_WRITE_FRAGMENT_SIZE_MAX;
+      pacing->fragment_delay_millis = DDC_TIMEOUT_MILLIS_BETWEEN_CAP_TABLE_FRAGMENTS;
+      g_hash_table_insert(write_pacing_by_io_path, &pacing->io_path, pacing);
+   }
+   Table_Write_Pacing result = *pacing;
+   g_mutex_unlock(&write_pacing_mutex);
+   return result;
+}
+
+
+static void save_write_pacing(Table_Write_Pacing * pacing) {
+   g_mutex_lock(&write_pacing_mutex);
+   Table_Write_Pacing * saved = g_hash_table_lookup(write_pacing_by_io_path, &pacing->io_path);
+   assert(saved);
+   *saved = *pacing;
+   g_mutex_unlock(&write_pacing_mutex);
+}
+
+
+// Adjusts pacing after a fragment write try
+static void adapt_write_pacing(Table_Write_Pacing * pacing, bool ok, bool first_try) {
+   if (ok && first_try) {
+      if (++pacing->success_run >= MULTI_PART_WRITE_ADAPT_FRAGMENTS) {
+         pacing->success_run = 0;
+         pacing->fragment_delay_millis =
+               MAX(MULTI_PART_WRITE_DELAY_MILLIS_MIN, (pacing->fragment_delay_millis * 9) / 10);
+         pacing->fragment_size =
+               MIN(MULTI_PART_WRITE_FRAGMENT_SIZE_MAX, pacing->fragment_size * 2);
+      }
+   }
+   else if (!ok) {
+      pacing->success_run = 0;
+      pacing->fragment_retry_ct++;
+      pacing->fragment_delay_millis =
+            MIN(MULTI_PART_WRITE_DELAY_MILLIS_MAX, pacing->fragment_delay_millis * 2);
+   }
+}
+
+
+/** Writes one fragment of a VCP Table value, with retry.
+ *
+ *  The fragment size is halved after each second failed try, so the
+ *  number of bytes actually written may be less than requested.
+ *
+ *  @param  dh             display handle for open i2c device
+ *  @param  vcp_code       VCP feature code
+ *  @param  offset         offset of fragment in value
+ *  @param  bytes          bytes remaining to be written, beginning at **offset**
+ *  @param  bytect         number of bytes remaining, 0 to write the final empty fragment
+ *  @param  max_tries      maximum number of tries
+ *  @param  pacing         fragment size and delay, updated
+ *  @param  written_loc    where to return number of bytes written
+ *  @param  tryct_loc      where to return number of tries
+ *  @return NULL if success, pointer to #Error_Info if failure
+ */
+static Error_Info *
+write_table_fragment_with_retry(
+      Display_Handle *     dh,
+      Byte                 vcp_code,
+      int                  offset,
+      Byte *               bytes,
+      int                  bytect,
+      int                  max_tries,
+      Table_Write_Pacing * pacing,
+      int *                written_loc,
+      int *                tryct_loc)
+{
+   bool debug = false;
+   Error_Info * try_errors[MAX_MAX_TRIES];
+   Error_Info * ddc_excp = NULL;
+   int tryctr = 0;
+   int bytect_to_write = 0;
+   Public_Status_Code psc = -1;
+
+   while (tryctr < max_tries && psc < 0) {
+      if (tryctr > 0 && tryctr % 2 == 0)
+         pacing->fragment_size = MAX(MULTI_PART_WRITE_FRAGMENT_SIZE_MIN, pacing->fragment_size / 2);
+      bytect_to_write = MIN(bytect, pacing->fragment_size);
+      DDC_Packet * request_packet_ptr = create_ddc_multi_part_write_request_packet(
                    DDC_PACKET_TYPE_TABLE_WRITE_REQUEST,
-                   vcp_code,       // request_subtype,
+                   vcp_code,
                    offset,
-                   value_to_set->bytes+offset,
+                   bytes,
                    bytect_to_write,
                    __func__);
-      ddc_excp = ddc_write_only_with_retry(dh, request_packet_ptr);
-      psc = (ddc_excp) ? ddc_excp->status_code : 0;
+      try_errors[tryctr] = ddc_write_only(dh, request_packet_ptr);
       free_ddc_packet(request_packet_ptr);
-      assert( (!ddc_excp && psc == 0) || (ddc_excp && psc!=0) );
+      psc = ERRINFO_STATUS(try_errors[tryctr]);
+      adapt_write_pacing(pacing, psc == 0, tryctr == 0);
+      DBGTRC(debug, TRACE_GROUP, "offset=%d, bytect_to_write=%d, try %d: %s, next delay %d millisec",
+                                 offset, bytect_to_write, tryctr+1, psc_desc(psc),
+                                 pacing->fragment_delay_millis);
+      tryctr++;
+      // a successfully written final empty fragment is followed by the command sleep
+      if (bytect_to_write > 0 || psc < 0)
+         SPECIAL_TUNED_SLEEP_WITH_TRACE(dh, pacing->fragment_delay_millis, "table write fragment");
+   }
+
+   if (psc < 0) {
+      ddc_excp = errinfo_new_with_causes(DDCRC_RETRIES, try_errors, tryctr, __func__);
+      COUNT_STATUS_CODE(DDCRC_RETRIES);
+   }
+   else {
+      for (int ndx = 0; ndx < tryctr-1; ndx++)
+         ERRINFO_FREE_WITH_REPORT(try_errors[ndx], debug || IS_TRACING() || report_freed_exceptions);
+   }
+   try_data_record_tries2(MULTI_PART_WRITE_OP, psc, tryctr);
 
+   *written_loc = (psc == 0) ? bytect_to_write : 0;
+   *tryct_loc = tryctr;
+   return ddc_excp;
+}
+
+
+/** Writes a VCP table feature, retrying failed fragments, and reporting progress.
+ *
+ *  Each fragment is tried up to the maximum number of multi-part write tries.
+ *  A failed fragment is retried on its own, the write is not restarted.
+ *
+ *  The fragment size and the delay after each fragment are adapted for each
+ *  display.  They start at the maximum fragment size and the delay specified
+ *  by DDC/CI.  After each failed try the delay is doubled, and after each
+ *  second failed try of the same fragment its size is halved.  After a run of
+ *  fragments written on the first try, the delay is reduced and the size is
+ *  increased.
+ *
+ * @param  dh             display handle
+ * @param  vcp_code       VCP feature code to write
+ * @param  value_to_set   bytes of Table feature
+ * @param  progress_func  if non-NULL, called after each fragment is written
+ * @param  progress_arg   passed to **progress_func**
+ * @return  NULL if success, pointer to #Error_Info if failure
+ */
+Error_Info *
+multi_part_write_with_progress(
+     Display_Handle *         dh,
+     Byte                     vcp_code,
+     Buffer *                 value_to_set,
+     Multi_Part_Progress_Func progress_func,
+     void *                   progress_arg)
+{
+   tds_set_current_display(&dh->dref->io_path);
+   Retry_Op_Value max_fragment_tries = drp_get_maxtries(dh->dref, MULTI_PART_WRITE_OP);
+   bool debug = false;
+   if (IS_TRACING())
+      puts("");
+   DBGTRC(debug, TRACE_GROUP, "Starting. dh=%s, vcp_code=0x%02x, bytect=%d",
+                              dh_repr_t(dh), vcp_code, value_to_set->len);
+
+   Error_Info * ddc_excp = NULL;
+   Table_Write_Pacing pacing = get_write_pacing(dh->dref->io_path);
+   int max_tryct = 0;
+   int offset = 0;
+   bool done = false;
+   while (!done && !ddc_excp) {
+      int bytes_remaining = value_to_set->len - offset;
+      int written = 0;
+      int tryct = 0;
+      ddc_excp = write_table_fragment_with_retry(
+                    dh, vcp_code, offset, value_to_set->bytes+offset, bytes_remaining,
+                    max_fragment_tries, &pacing, &written, &tryct);
+      max_tryct = MAX(max_tryct, tryct);
       if (!ddc_excp) {
-         if (bytect_to_write == 0)   // if just wrote final empty segment to indicate done
-            break;
-         offset += bytect_to_write;
-         bytes_remaining -= bytect_to_write;
+         if (bytes_remaining == 0)    // just wrote final empty fragment to indicate done
+            done = true;
+         else {
+            offset += written;
+            if (progress_func)
+               progress_func(vcp_code, offset, value_to_set->len, progress_arg);
+         }
       }
    }
+   save_write_pacing(&pacing);
+   TUNED_SLEEP_WITH_TRACE(dh, SE_POST_WRITE, NULL);
 
-   DBGTRC(debug, TRACE_GROUP, "Done. Returning: %s", errinfo_summary(ddc_excp));
-   assert( (ddc_excp && psc<0) || (!ddc_excp && psc==0) );
+   Public_Status_Code rc = ERRINFO_STATUS(ddc_excp);
+   drp_record_tries(dh->dref, MULTI_PART_WRITE_OP, rc, max_tryct);
+
+   DBGTRC(debug, TRACE_GROUP, "Done.  Returning: %s", errinfo_summary(ddc_excp));
    return ddc_excp;
 }
 
@@ -351,57 +584,29 @@ multi_part_write_with_retry(
      Byte             vcp_code,
      Buffer *         value_to_set)
 {
-   Retry_Op_Value max_multi_part_write_tries = try_data_get_maxtries2(MULTI_PART_WRITE_OP);
-   bool debug = false;
-   if (IS_TRACING())
-      puts("");
-   DBGTRC(debug, TRACE_GROUP, "Starting. dh=%s, vcp_code=0x%02x",
-                              dh_repr_t(dh), vcp_code);
-
-   Public_Status_Code rc = -1;   // dummy value for first call of while loop
-   Error_Info * ddc_excp = NULL;
-
-   Error_Info *         try_errors[MAX_MAX_TRIES];
-
-   int tryctr = 0;
-   bool can_retry = true;
-
-   while (tryctr < max_multi_part_write_tries && rc < 0 && can_retry) {
-      DBGTRC(debug, TRACE_GROUP,
-             "Start of while loop. try_ctr=%d, max_multi_part_write_tries=%d",
-             tryctr, max_multi_part_write_tries);
-
-      ddc_excp = try_multi_part_write(
-              dh,
-              vcp_code,
-              value_to_set);
-      try_errors[tryctr] = ddc_excp;
-      rc = (ddc_excp) ? ddc_excp->status_code : 0;
-      assert( (ddc_excp && rc<0) || (!ddc_excp && rc==0) );
-
-      // TODO: What rc values set can_retry = false?
-
-      tryctr++;
-   }
-   assert( (ddc_excp && rc < 0) || (!ddc_excp && rc==0) );
+   return multi_part_write_with_progress(dh, vcp_code, value_to_set, NULL, NULL);
+}
 
-   if (rc < 0) {
-      if (can_retry)
-         rc = DDCRC_RETRIES;
-      ddc_excp= errinfo_new_with_causes(rc, try_errors, tryctr, __func__);
 
-      if (rc != try_errors[tryctr-1]->status_code)
-         COUNT_STATUS_CODE(rc);     // new status code, count it
-   }
-   else {
-      for (int ndx=0; ndx<tryctr; ndx++) {
-         // errinfo_free(try_errors[ndx]);
-         ERRINFO_FREE_WITH_REPORT(try_errors[ndx], debug || IS_TRACING() || report_freed_exceptions);
+/** Reports the table write pacing for each display to which a table has been written.
+ *
+ *  @param  depth  logical indentation depth
+ */
+void report_multi_part_write_pacing(int depth) {
+   g_mutex_lock(&write_pacing_mutex);
+   if (write_pacing_by_io_path && g_hash_table_size(write_pacing_by_io_path) > 0) {
+      rpt_label(depth, "Table write pacing:");
+      GHashTableIter iter;
+      gpointer value;
+      g_hash_table_iter_init(&iter, write_pacing_by_io_path);
+      while (g_hash_table_iter_next(&iter, NULL, &value)) {
+         Table_Write_Pacing * pacing = value;
+         rpt_vstring(depth+1, "%-16s fragment size: %2d, fragment delay: %3d millisec, failed fragment tries: %d",
+                              dpath_repr_t(&pacing->io_path), pacing->fragment_size,
+                              pacing->fragment_delay_millis, pacing->fragment_retry_ct);
       }
    }
-
-   DBGTRC(debug, TRACE_GROUP, "Done.  Returning: %s", errinfo_summary(ddc_excp));
-   return ddc_excp;
+   g_mutex_unlock(&write_pacing_mutex);
 }
 
 
@@ -409,6 +614,9 @@ static inline void init_ddc_multi_part_io_func_name_table() {
 #define ADD_FUNC(_NAME) rtti_func_name_table_add(_NAME, #_NAME);
    ADD_FUNC(try_multi_part_read);
    ADD_FUNC(multi_part_read_with_retry);
+   ADD_FUNC(multi_part_read_range_with_retry);
+   ADD_FUNC(write_table_fragment_with_retry);
+   ADD_FUNC(multi_part_write_with_progress);
 #undef ADD_FUNC
 }
 
@@ -21,6 +21,21 @@
 #include "base/status_code_mgt.h"
 
 
+/** Function called with each fragment of a multi-part read as it is read
+ *
+ *  \param  request_subtype  VCP feature code for table read, 0 for capabilities
+ *  \param  offset           offset of the fragment in the value
+ *  \param  bytes            fragment bytes, valid only for the duration of the call
+ *  \param  bytect           number of bytes in fragment
+ *  \param  arg              argument supplied by the caller of the read
+ */
+typedef void (*Multi_Part_Fragment_Func)(
+   Byte             request_subtype,
+   int              offset,
+   Byte *           bytes,
+   int              bytect,
+   void *           arg);
+
 Error_Info *
 multi_part_read_with_retry(
    Display_Handle * dh,
@@ -29,12 +44,48 @@ multi_part_read_with_retry(
    bool             all_zero_response_ok,
    Buffer**         ppbuffer);
 
+Error_Info *
+multi_part_read_range_with_retry(
+   Display_Handle *         dh,
+   Byte                     request_type,
+   Byte                     request_subtype,
+   bool                     all_zero_response_ok,
+   int                      start_offset,
+   int                      max_bytes,
+   Multi_Part_Fragment_Func fragment_func,
+   void *                   fragment_arg,
+   Buffer**                 ppbuffer);
+
 Error_Info *
 multi_part_write_with_retry(
      Display_Handle * dh,
      Byte             vcp_code,
      Buffer *         value_to_set);
 
+/** Function called after each fragment of a table write is written
+ *
+ *  \param  vcp_code       VCP feature code
+ *  \param  bytes_written  number of bytes written so far
+ *  \param  total_bytes    number of bytes in the value
+ *  \param  arg            argument supplied by the caller of the write
+ */
+typedef void (*Multi_Part_Progress_Func)(
+   Byte             vcp_code,
+   int              bytes_written,
+   int              total_bytes,
+   void *           arg);
+
+Error_Info *
+multi_part_write_with_progress(
+     Display_Handle *         dh,
+     Byte                     vcp_code,
+     Buffer *                 value_to_set,
+     Multi_Part_Progress_Func progress_func,
+     void *                   progress_arg);
+
+void
+report_multi_part_write_pacing(int depth);
+
 void
 init_ddc_multi_part_io();
 
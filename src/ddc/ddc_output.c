@@ -472,13 +472,55 @@ collect_raw_feature_set_values2_dfm(
    // DBGMSG("Inserting sleep() before first call to get_raw_value_for_feature_table_entry()");
    // sleep_millis_with_trace(DDC_TIMEOUT_MILLIS_DEFAULT, __func__, "initial");
    int ndx;
+
+#ifdef USE_USB
+   // For USB connected monitors, read the non-table values in a batch so that
+   // features located in the same HID report are retrieved by a single report
+   // read.  Features that the batch did not read are read individually below,
+   // once, which also takes care of reporting errors.
+   Parsed_Nontable_Vcp_Response ** usb_responses = NULL;
+   if (dh->dref->io_path.io_mode == DDCA_IO_USB && features_ct > 0) {
+      Byte *                          codes     = calloc(features_ct, sizeof(Byte));
+      int *                           positions = calloc(features_ct, sizeof(int));
+      Parsed_Nontable_Vcp_Response ** responses = calloc(features_ct, sizeof(Parsed_Nontable_Vcp_Response*));
+      Public_Status_Code *            statuses  = calloc(features_ct, sizeof(Public_Status_Code));
+      int nontable_ct = 0;
+      for (ndx = 0; ndx < features_ct; ndx++) {
+         Display_Feature_Metadata * dfm = dyn_get_feature_set_entry2(feature_set, ndx);
+         if (!(dfm->feature_flags & DDCA_TABLE)) {
+            codes[nontable_ct]     = dfm->feature_code;
+            positions[nontable_ct] = ndx;
+            nontable_ct++;
+         }
+      }
+      usb_get_nontable_vcp_values(dh, codes, nontable_ct, responses, statuses);
+      usb_responses = calloc(features_ct, sizeof(Parsed_Nontable_Vcp_Response*));
+      for (int rndx = 0; rndx < nontable_ct; rndx++)
+         usb_responses[positions[rndx]] = responses[rndx];
+      free(codes);
+      free(positions);
+      free(responses);
+      free(statuses);
+   }
+#endif
+
    for (ndx=0; ndx< features_ct; ndx++) {
       Display_Feature_Metadata * dfm = dyn_get_feature_set_entry2(feature_set, ndx);
       DBGMSF(debug,"ndx=%d, feature = 0x%02x", ndx, dfm->feature_code);
       DDCA_Any_Vcp_Value *  pvalrec;
       // DDCA_Feature_Metadata * ddca_meta = dfm_to_ddca_feature_metadata(dfm);
 
-      Error_Info *  cur_ddc_excp =
+      Error_Info *  cur_ddc_excp = NULL;
+#ifdef USE_USB
+      if (usb_responses && usb_responses[ndx]) {
+         Parsed_Nontable_Vcp_Response * resp = usb_responses[ndx];
+         pvalrec = create_nontable_vcp_value(dfm->feature_code, resp->mh, resp->ml, resp->sh, resp->sl);
+         free(resp);
+         usb_responses[ndx] = NULL;
+      }
+      else
+#endif
+      cur_ddc_excp =
             get_raw_value_for_feature_metadata(
                   dh,
                   dfm,    // ddca_meta,
@@ -506,6 +548,15 @@ collect_raw_feature_set_values2_dfm(
       }
    }
 
+#ifdef USE_USB
+   if (usb_responses) {
+      // entries remain if loop terminated early
+      for (ndx = 0; ndx < features_ct; ndx++)
+         free(usb_responses[ndx]);
+      free(usb_responses);
+   }
+#endif
+
    DBGMSF(debug, "Done.  Returning: %s", psc_desc(master_status_code));
    return master_status_code;
 }
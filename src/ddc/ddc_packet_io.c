@@ -37,6 +37,7 @@
 #include "base/rtti.h"
 #include "base/status_code_mgt.h"
 #include "base/tuned_sleep.h"
+#include "base/thread_display_stats.h"
 #include "base/thread_sleep_data.h"
 
 #include "i2c/i2c_bus_core.h"
@@ -47,6 +48,7 @@
 #endif
 
 #include "ddc/ddc_display_lock.h"
+#include "ddc/ddc_retry_policy.h"
 #include "ddc/ddc_try_stats.h"
 
 #include "ddc/ddc_packet_io.h"
@@ -93,7 +95,8 @@ bool is_ddc_null_message(Byte * packet) {
  *  \param  callopts        call option flags
  *  \param  dh_loc          address at which to return display handle
  *  \return status code     as from #i2c_open_bus(), #usb_open_hiddev_device()
- *  \retval DDCRC_LOCKED    display open in another thread
+ *  \retval DDCRC_LOCKED    display open in another thread, or device
+ *                          locked by another process, see #lock_display_device()
  *  \retval DDCRC_ALREADY_OPEN display already open in current thread
  *  \retval -EBUSY          from i2c_set_addr()
  *
@@ -114,6 +117,7 @@ ddc_open_display(
 
    Display_Handle * dh = NULL;
    DDCA_Status ddcrc = 0;
+   tds_set_current_display(&dref->io_path);
 
    Distinct_Display_Ref ddisp_ref = get_distinct_display_ref(dref);
    Distinct_Display_Flags ddisp_flags = DDISP_NONE;
@@ -144,8 +148,13 @@ ddc_open_display(
          else {
             // DBGMSF(debug, "Calling set_addr(0x37) for %s", dref_repr_t(dref));
             ddcrc =  i2c_set_addr(fd, 0x37, callopts);
+            if (ddcrc == 0) {
+               ddcrc = lock_display_device(fd);
+               if (ddcrc != 0 && (callopts & CALLOPT_ERR_MSG))
+                  f0printf(ferr(), "Device /dev/"I2C"-%d is in use by another process\n",
+                                   dref->io_path.path.i2c_busno);
+            }
             if (ddcrc != 0) {
-               assert(ddcrc < 0);
                close(fd);
             }
 
@@ -193,6 +202,11 @@ ddc_open_display(
          if (fd < 0) {
             ddcrc = fd;
          }
+         else if ( (ddcrc = lock_display_device(fd)) != 0) {
+            if (callopts & CALLOPT_ERR_MSG)
+               f0printf(ferr(), "Device %s is in use by another process\n", dref->usb_hiddev_name);
+            close(fd);
+         }
          else {
             dh = create_usb_display_handle_from_display_ref(fd, dref);
             dref->pedid = usb_get_parsed_edid_by_dh(dh);
@@ -285,6 +299,7 @@ ddc_close_display(Display_Handle * dh) {
    unlock_distinct_display(display_id);
 
    free_display_handle(dh);
+   tds_set_current_display(NULL);
    DBGTRC(debug, TRACE_GROUP, "Done. dref=%s  Returning: %s", dref_repr_t(dref), psc_desc(rc));
    return rc;
 }
@@ -456,6 +471,10 @@ DDCA_Status ddc_write_read_raw(
  *  \return pointer to #Error_Info struct if failure, NULL if success
  *  \remark
  *  Issue: positive ADL codes, need to handle?
+ *  \remark
+ *  A Get VCP response packet is built in the response storage of **dh**, and
+ *  is valid until the next exchange on the handle.  #free_ddc_packet() does
+ *  nothing for such a packet.
  */
 Error_Info *
 ddc_write_read(
@@ -471,7 +490,9 @@ ddc_write_read(
    bool debug = false;
    DBGTRC(debug, TRACE_GROUP, "Starting. dh=%s", dh_repr_t(dh) );
 
-   Byte * readbuf = calloc(1, max_read_bytes);
+   // large enough for any response, including capabilities and table fragments
+   Byte   readbuf[MAX_DDC_PACKET_INC_CHECKSUM] = {0};
+   assert(max_read_bytes <= sizeof(readbuf));
    int    bytes_received = max_read_bytes;
    DDCA_Status    psc;
    *response_packet_ptr_loc = NULL;
@@ -487,25 +508,36 @@ ddc_write_read(
    if (psc >= 0) {
        // readbuf[0] = 0x6e;
        // hex_dump(readbuf, bytes_received+1);
-       psc = create_ddc_typed_response_packet(
-              readbuf,
-              bytes_received,
-              expected_response_type,
-              expected_subtype,
-              __func__,
-              response_packet_ptr_loc);
+       if (expected_response_type == DDC_PACKET_TYPE_QUERY_VCP_RESPONSE) {
+          // by far the most frequent exchange, parse into the handle's storage
+          psc = init_ddc_getvcp_response_packet(
+                 &dh->response_storage,
+                 readbuf,
+                 bytes_received,
+                 expected_subtype,
+                 __func__,
+                 response_packet_ptr_loc);
+       }
+       else {
+          psc = create_ddc_typed_response_packet(
+                 readbuf,
+                 bytes_received,
+                 expected_response_type,
+                 expected_subtype,
+                 __func__,
+                 response_packet_ptr_loc);
+       }
        DBGTRC(debug, TRACE_GROUP,
-              "create_ddc_typed_response_packet() returned %s, *response_packet_ptr_loc=%p",
+              "Response packet creation returned %s, *response_packet_ptr_loc=%p",
               ddcrc_desc_t(psc), *response_packet_ptr_loc );
 
        if (psc != 0 && *response_packet_ptr_loc) {  // paranoid,  should never occur
-          free(*response_packet_ptr_loc);
+          free_ddc_packet(*response_packet_ptr_loc);
           *response_packet_ptr_loc = NULL;
        }
    }
    dsa_record_ddcrw_status_code(psc);
-
-   free(readbuf);    // or does response_packet_ptr_loc point into here?
+   i2c_record_ddc_exchange(dh->fd, psc);
 
    // already done:
    // if (rc != 0)
@@ -550,7 +582,10 @@ ddc_write_read(
  *\remark
  * Issue: positive ADL codes, need to handle?
  * \remark
- * The maximum number of tries is set in global variable max_write_read_exchange_tries.
+ * The maximum number of tries is the display's adaptive retry budget, see
+ * #drp_get_maxtries(), which never exceeds the global setting.
+ * A read of a feature the display has already reported as unsupported is
+ * not retried.
  */
 Error_Info *
 ddc_write_read_with_retry(
@@ -572,7 +607,8 @@ ddc_write_read_with_retry(
    // if (debug)
    //     dbgrpt_display_ref(dh->dref, 1);
 
-   bool retry_null_response = !(dh->dref->flags & DREF_DDC_USES_NULL_RESPONSE_FOR_UNSUPPORTED);
+   bool retry_null_response = !(dh->dref->flags & DREF_DDC_USES_NULL_RESPONSE_FOR_UNSUPPORTED) &&
+                              !drp_fail_fast_on_null_response(dh->dref);
 
    DDCA_Status  psc;
    bool read_bytewise = I2C_Read_Bytewise;   // normally set to DEFAULT_I2C_READ_BYTEWISE
@@ -581,14 +617,23 @@ ddc_write_read_with_retry(
    int  ddcrc_read_all_zero_ct = 0;
    int  ddcrc_null_response_ct = 0;
    int  ddcrc_null_response_max = (retry_null_response) ? 3 : 0;
+   int  ddcrc_stalled_ct = 0;
    bool sleep_multiplier_incremented = false;
    // ddcrc_null_response_max = 6;  // *** TEMP *** for testing
    DBGMSF(debug, "retry_null_response = %s, ddcrc_null_response_max = %d",
           sbool(retry_null_response), ddcrc_null_response_max);
+   tds_set_current_display(&dh->dref->io_path);
    Error_Info * try_errors[MAX_MAX_TRIES];
 
    // assert(max_write_read_exchange_tries > 0);   // to avoid clang warning
-   int max_tries = try_data_get_maxtries2(WRITE_READ_TRIES_OP);
+   int max_tries = drp_get_maxtries(dh->dref, WRITE_READ_TRIES_OP);
+   bool known_unsupported = expected_response_type == DDC_PACKET_TYPE_QUERY_VCP_RESPONSE &&
+                            drp_is_unsupported_feature(dh->dref, expected_subtype);
+   if (known_unsupported) {
+      DBGMSF(debug, "Feature 0x%02x known unsupported, not retrying", expected_subtype);
+      max_tries = 1;
+      ddcrc_null_response_max = 0;
+   }
    assert(max_tries >= 0);
    for (tryctr=0, psc=-999, retryable=true;
         tryctr < max_tries && psc < 0 && retryable;
@@ -658,6 +703,12 @@ ddc_write_read_with_retry(
                  // retryable = false;     // ??
                  break;
 
+            case (DDCRC_STALLED):
+                 // A stalled read costs the full read deadline.  Allow a single
+                 // retry, so a hung monitor does not stall the caller repeatedly.
+                 retryable = (++ddcrc_stalled_ct < 2);
+                 break;
+
             case (-EBADF):
                  // DBGMSG("EBADF");
                  retryable = false;
@@ -736,6 +787,8 @@ ddc_write_read_with_retry(
    }
 
    try_data_record_tries2(WRITE_READ_TRIES_OP, psc, tryctr);
+   if (!known_unsupported)     // shortened budget says nothing about the display
+      drp_record_tries(dh->dref, WRITE_READ_TRIES_OP, psc, tryctr);
 
    DBGTRC(debug, TRACE_GROUP, "Done.  Total Tries (tryctr): %d. Returning: %s", tryctr, errinfo_summary(ddc_excp));
    return ddc_excp;
@@ -781,12 +834,15 @@ ddc_i2c_write_only(
                            get_packet_start(request_packet_ptr)+1 );
    if (rc < 0)
       log_status_code(rc, __func__);
-   Sleep_Event_Type sleep_type =
-         (request_packet_ptr->type == DDC_PACKET_TYPE_SAVE_CURRENT_SETTINGS )
-            ? SE_POST_SAVE_SETTINGS
-            : SE_POST_WRITE;
-   // tuned_sleep_i2c_with_trace(sleep_type, __func__, NULL);
-   TUNED_SLEEP_WITH_TRACE(dh, sleep_type, NULL);
+   // table write fragments are paced by multi_part_write_with_progress()
+   if (request_packet_ptr->type != DDC_PACKET_TYPE_TABLE_WRITE_REQUEST) {
+      Sleep_Event_Type sleep_type =
+            (request_packet_ptr->type == DDC_PACKET_TYPE_SAVE_CURRENT_SETTINGS )
+               ? SE_POST_SAVE_SETTINGS
+               : SE_POST_WRITE;
+      // tuned_sleep_i2c_with_trace(sleep_type, __func__, NULL);
+      TUNED_SLEEP_WITH_TRACE(dh, sleep_type, NULL);
+   }
    DBGTRC(debug, TRACE_GROUP, "Done. rc=%s", psc_desc(rc) );
    return rc;
 }
@@ -846,7 +902,8 @@ ddc_write_only_with_retry(
    bool               retryable;
    Error_Info *       try_errors[MAX_MAX_TRIES];
 
-   int max_tries = try_data_get_maxtries2(WRITE_ONLY_TRIES_OP);
+   tds_set_current_display(&dh->dref->io_path);
+   int max_tries = drp_get_maxtries(dh->dref, WRITE_ONLY_TRIES_OP);
    assert(max_tries > 0);
    for (tryctr=0, psc=-999, retryable=true;
        tryctr < max_tries && psc < 0 && retryable;
@@ -896,6 +953,7 @@ ddc_write_only_with_retry(
    }
 
    try_data_record_tries2(WRITE_ONLY_TRIES_OP, psc, tryctr);
+   drp_record_tries(dh->dref, WRITE_ONLY_TRIES_OP, psc, tryctr);
 
    DBGTRC(debug, TRACE_GROUP, "Done.  Returning: %s", errinfo_summary(ddc_excp));
    return ddc_excp;
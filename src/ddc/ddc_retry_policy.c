@@ -0,0 +1,317 @@
+/** \file ddc_retry_policy.c
+ *
+ *  Adaptive per-display retry budgets.
+ *
+ *  The maximum number of tries for each #Retry_Operation is a global setting
+ *  (see ddc_try_stats.c).  Most monitors succeed on the first try, so the
+ *  full budget is only used when an operation is going to fail anyway,
+ *  and each failed try costs a full set of DDC sleeps.
+ *
+ *  For each display, the number of tries required by the most recent
+ *  operations of each type is recorded.  Once enough operations have been
+ *  seen, the retry budget for the display is reduced to the largest number
+ *  of tries recently required plus a margin.  If an operation exhausts its
+ *  budget, the budget returns to the global maximum until the failure ages
+ *  out of the recent history.  The budget never exceeds the global maximum.
+ *
+ *  In addition, retries are skipped:
+ *  - for DDC Null Responses, on a display whose most recent operations
+ *    have all ended in DDC Null Response
+ *  - for features the display has already reported as unsupported
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/** \cond */
+#include <assert.h>
+#include <glib-2.0/glib.h>
+#include <string.h>
+/** \endcond */
+
+#include "util/data_structures.h"
+#include "util/report_util.h"
+#include "util/string_util.h"
+
+#include "base/core.h"
+#include "base/ddc_errno.h"
+#include "base/displays.h"
+#include "base/rtti.h"
+#include "base/thread_retry_data.h"
+
+#include "ddc/ddc_try_stats.h"
+
+#include "ddc/ddc_retry_policy.h"
+
+
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDC;
+
+#define RECENT_TRIES_WINDOW      16  ///< number of recent operations remembered
+#define MIN_SAMPLES_FOR_BUDGET    8  ///< history required before budget is reduced
+#define BUDGET_MARGIN             2  ///< tries allowed beyond the most recently required
+#define NULL_RESPONSE_FAIL_FAST   3  ///< consecutive null responses before failing fast
+
+#define TRIES_EXHAUSTED           0  ///< recent_tries value for an operation that ran out of tries
+
+/** Recent history for one #Retry_Operation on one display */
+typedef struct {
+   Byte           recent_tries[RECENT_TRIES_WINDOW];  ///< circular, TRIES_EXHAUSTED for failure
+   int            recent_ct;                          ///< number of valid entries
+   int            recent_next;                        ///< next entry to overwrite
+   Retry_Op_Value last_budget;                        ///< last budget returned, 0 if none
+} Retry_Op_History;
+
+/** Retry policy state for one display */
+typedef struct {
+   DDCA_IO_Path      io_path;
+   Retry_Op_History  ops[RETRY_OP_COUNT];
+   int               consecutive_null_ct;   ///< successive write/read operations ending in null response
+   Bit_Set_256       unsupported_features;  ///< features reported as unsupported
+} Display_Retry_Policy;
+
+static bool         adaptive_budgets_enabled = true;
+static GHashTable * policies_by_path = NULL;   // DDCA_IO_Path * -> Display_Retry_Policy *
+static GMutex       policies_mutex;
+
+
+/** Enables or disables adaptive retry budgets.
+ *
+ *  When disabled, the global maxtries settings are used for every display.
+ *  The recent history of each display continues to be recorded.
+ *
+ *  \param  onoff  new setting
+ *  \return prior setting
+ */
+bool enable_adaptive_retry_budgets(bool onoff) {
+   bool old = adaptive_budgets_enabled;
+   adaptive_budgets_enabled = onoff;
+   return old;
+}
+
+
+/** Reports whether adaptive retry budgets are enabled. */
+bool is_adaptive_retry_budgets_enabled() {
+   return adaptive_budgets_enabled;
+}
+
+
+// Must be called with policies_mutex held
+static Display_Retry_Policy * find_policy(Display_Ref * dref, bool create) {
+   Display_Retry_Policy * pol = g_hash_table_lookup(policies_by_path, &dref->io_path);
+   if (!pol && create) {
+      pol = g_new0(Display_Retry_Policy, 1);
+      pol->io_path = dref->io_path;
+      g_hash_table_insert(policies_by_path, &pol->io_path, pol);
+   }
+   return pol;
+}
+
+
+// Must be called with policies_mutex held
+static Retry_Op_Value
+calc_budget(Retry_Op_History * hist, Retry_Op_Value global_maxtries) {
+   if (hist->recent_ct < MIN_SAMPLES_FOR_BUDGET)
+      return global_maxtries;
+
+   int most_tries = 0;
+   for (int ndx = 0; ndx < hist->recent_ct; ndx++) {
+      if (hist->recent_tries[ndx] == TRIES_EXHAUSTED)
+         return global_maxtries;
+      if (hist->recent_tries[ndx] > most_tries)
+         most_tries = hist->recent_tries[ndx];
+   }
+   return MIN(most_tries + BUDGET_MARGIN, global_maxtries);
+}
+
+
+/** Returns the maximum number of tries for an operation on a display.
+ *
+ *  \param  dref        display reference
+ *  \param  retry_type  operation type
+ *  \return maximum number of tries, never more than the global setting
+ */
+Retry_Op_Value drp_get_maxtries(Display_Ref * dref, Retry_Operation retry_type) {
+   bool debug = false;
+   Retry_Op_Value global_maxtries = try_data_get_maxtries2(retry_type);
+   Retry_Op_Value result = global_maxtries;
+   if (adaptive_budgets_enabled && dref) {
+      g_mutex_lock(&policies_mutex);
+      Display_Retry_Policy * pol = find_policy(dref, false);
+      if (pol) {
+         Retry_Op_History * hist = &pol->ops[retry_type];
+         result = calc_budget(hist, global_maxtries);
+         if (result != hist->last_budget && hist->last_budget != 0)
+            DBGTRC(debug, TRACE_GROUP | DDCA_TRC_RETRY, "%s, %s budget changed from %d to %d",
+                   dpath_repr_t(&dref->io_path), retry_type_name(retry_type),
+                   hist->last_budget, result);
+         hist->last_budget = result;
+      }
+      g_mutex_unlock(&policies_mutex);
+   }
+   DBGMSF(debug, "dref=%s, retry_type=%s, returning %d",
+                 dref_repr_t(dref), retry_type_name(retry_type), result);
+   return result;
+}
+
+
+/** Reports whether DDC Null Responses from a display should end a
+ *  write/read operation without retry, because the display's most recent
+ *  operations have all ended in DDC Null Response.
+ *
+ *  \param  dref  display reference
+ *  \return true if null responses should not be retried
+ */
+bool drp_fail_fast_on_null_response(Display_Ref * dref) {
+   bool result = false;
+   if (adaptive_budgets_enabled && dref) {
+      g_mutex_lock(&policies_mutex);
+      Display_Retry_Policy * pol = find_policy(dref, false);
+      result = pol && pol->consecutive_null_ct >= NULL_RESPONSE_FAIL_FAST;
+      g_mutex_unlock(&policies_mutex);
+   }
+   return result;
+}
+
+
+/** Reports whether a display has already reported a feature as unsupported,
+ *  in which case a failed read of the feature is not retried.
+ *
+ *  \param  dref          display reference
+ *  \param  feature_code  VCP feature code
+ *  \return true if the feature is known to be unsupported
+ */
+bool drp_is_unsupported_feature(Display_Ref * dref, Byte feature_code) {
+   bool result = false;
+   if (adaptive_budgets_enabled && dref) {
+      g_mutex_lock(&policies_mutex);
+      Display_Retry_Policy * pol = find_policy(dref, false);
+      result = pol && bs256_contains(pol->unsupported_features, feature_code);
+      g_mutex_unlock(&policies_mutex);
+   }
+   return result;
+}
+
+
+/** Records that a display reported a feature as unsupported, i.e. that
+ *  reading the feature returned DDCRC_REPORTED_UNSUPPORTED or
+ *  DDCRC_DETERMINED_UNSUPPORTED.
+ *
+ *  \param  dref          display reference
+ *  \param  feature_code  VCP feature code
+ */
+void drp_note_unsupported_feature(Display_Ref * dref, Byte feature_code) {
+   if (!dref)
+      return;
+   g_mutex_lock(&policies_mutex);
+   Display_Retry_Policy * pol = find_policy(dref, true);
+   pol->unsupported_features = bs256_add(pol->unsupported_features, feature_code);
+   g_mutex_unlock(&policies_mutex);
+}
+
+
+/** Records the outcome of a retryable operation on a display.
+ *
+ *  \param  dref        display reference
+ *  \param  retry_type  operation type
+ *  \param  ddcrc       final status code of the operation
+ *  \param  tryct       number of tries performed
+ *
+ *  \remark
+ *  Failures for reasons other than exhausting the tries say nothing about
+ *  the number of tries the display needs, and are not added to the history.
+ */
+void drp_record_tries(
+      Display_Ref *   dref,
+      Retry_Operation retry_type,
+      DDCA_Status     ddcrc,
+      int             tryct)
+{
+   bool debug = false;
+   DBGMSF(debug, "dref=%s, retry_type=%s, ddcrc=%s, tryct=%d",
+                 dref_repr_t(dref), retry_type_name(retry_type), psc_name(ddcrc), tryct);
+   if (!dref)
+      return;
+
+   g_mutex_lock(&policies_mutex);
+   Display_Retry_Policy * pol = find_policy(dref, true);
+   Retry_Op_History * hist = &pol->ops[retry_type];
+
+   int outcome = -1;
+   if (ddcrc == 0)
+      outcome = tryct;
+   else if (ddcrc == DDCRC_RETRIES || ddcrc == DDCRC_ALL_TRIES_ZERO)
+      outcome = TRIES_EXHAUSTED;
+   if (outcome >= 0) {
+      hist->recent_tries[hist->recent_next] = outcome;
+      hist->recent_next = (hist->recent_next + 1) % RECENT_TRIES_WINDOW;
+      if (hist->recent_ct < RECENT_TRIES_WINDOW)
+         hist->recent_ct++;
+   }
+
+   if (retry_type == WRITE_READ_TRIES_OP) {
+      if (ddcrc == DDCRC_NULL_RESPONSE || ddcrc == DDCRC_ALL_RESPONSES_NULL)
+         pol->consecutive_null_ct++;
+      else if (ddcrc == 0)
+         pol->consecutive_null_ct = 0;
+   }
+   g_mutex_unlock(&policies_mutex);
+}
+
+
+static void report_policy(Display_Retry_Policy * pol, int depth) {
+   int d1 = depth+1;
+   rpt_vstring(depth, "%s:", dpath_repr_t(&pol->io_path));
+   for (int retry_type = 0; retry_type < RETRY_OP_COUNT; retry_type++) {
+      Retry_Op_History * hist = &pol->ops[retry_type];
+      if (hist->recent_ct == 0)
+         continue;
+      int most_tries = 0;
+      int exhausted_ct = 0;
+      for (int ndx = 0; ndx < hist->recent_ct; ndx++) {
+         if (hist->recent_tries[ndx] == TRIES_EXHAUSTED)
+            exhausted_ct++;
+         else if (hist->recent_tries[ndx] > most_tries)
+            most_tries = hist->recent_tries[ndx];
+      }
+      Retry_Op_Value global_maxtries = try_data_get_maxtries2(retry_type);
+      rpt_vstring(d1, "%-30s recent: %2d, most tries: %2d, exhausted: %2d, budget: %2d of %2d",
+                      retry_type_description(retry_type),
+                      hist->recent_ct, most_tries, exhausted_ct,
+                      (adaptive_budgets_enabled) ? calc_budget(hist, global_maxtries) : global_maxtries,
+                      global_maxtries);
+   }
+   rpt_vstring(d1, "Consecutive DDC Null Responses: %d%s", pol->consecutive_null_ct,
+                   (pol->consecutive_null_ct >= NULL_RESPONSE_FAIL_FAST) ? " (failing fast)" : "");
+   if (bs256_count(pol->unsupported_features) > 0)
+      rpt_vstring(d1, "Known unsupported features: %s",
+                      bs256_to_string(pol->unsupported_features, "x", ", "));
+}
+
+
+/** Reports the retry policy of each display for which operations have been
+ *  recorded.
+ *
+ *  \param  depth  logical indentation depth
+ */
+void drp_report_all(int depth) {
+   rpt_vstring(depth, "Retry policy by display (adaptive budgets %s):",
+                      (adaptive_budgets_enabled) ? "enabled" : "disabled");
+   g_mutex_lock(&policies_mutex);
+   if (g_hash_table_size(policies_by_path) == 0) {
+      rpt_vstring(depth+1, "No operations recorded");
+   }
+   else {
+      GList * policies = g_hash_table_get_values(policies_by_path);
+      for (GList * cur = policies; cur; cur = cur->next)
+         report_policy(cur->data, depth+1);
+      g_list_free(policies);
+   }
+   g_mutex_unlock(&policies_mutex);
+   rpt_nl();
+}
+
+
+void init_ddc_retry_policy() {
+   policies_by_path = g_hash_table_new_full(dpath_hash, dpath_hash_equal, NULL, g_free);
+   RTTI_ADD_FUNC(drp_get_maxtries);
+}
@@ -0,0 +1,33 @@
+/** \file ddc_retry_policy.h
+ *
+ *  Adaptive per-display retry budgets
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_RETRY_POLICY_H_
+#define DDC_RETRY_POLICY_H_
+
+/** \cond */
+#include <stdbool.h>
+/** \endcond */
+
+#include "ddcutil_types.h"
+
+#include "base/core.h"
+#include "base/displays.h"
+#include "base/per_thread_data.h"
+
+bool           enable_adaptive_retry_budgets(bool onoff);
+bool           is_adaptive_retry_budgets_enabled();
+Retry_Op_Value drp_get_maxtries(Display_Ref * dref, Retry_Operation retry_type);
+bool           drp_fail_fast_on_null_response(Display_Ref * dref);
+bool           drp_is_unsupported_feature(Display_Ref * dref, Byte feature_code);
+void           drp_note_unsupported_feature(Display_Ref * dref, Byte feature_code);
+void           drp_record_tries(Display_Ref * dref, Retry_Operation retry_type,
+                                DDCA_Status ddcrc, int tryct);
+void           drp_report_all(int depth);
+void           init_ddc_retry_policy();
+
+#endif /* DDC_RETRY_POLICY_H_ */
@@ -20,6 +20,7 @@
 #include "base/rtti.h"
 #include "base/sleep.h"
 #include "base/tuned_sleep.h"
+#include "base/thread_display_stats.h"
 #include "base/thread_retry_data.h"
 #include "base/thread_sleep_data.h"
 
@@ -30,19 +31,26 @@
 #include "dynvcp/dyn_feature_files.h"
 
 #include "i2c/i2c_bus_core.h"
+#include "i2c/i2c_read_deadline.h"
 #include "i2c/i2c_strategy_dispatcher.h"
 #ifdef USE_USB
 #include "usb/usb_displays.h"
+#include "usb/usb_hidraw_vcp.h"
 #endif
 
 #include "ddc/ddc_display_lock.h"
 #include "ddc/ddc_displays.h"
+#include "ddc/ddc_displays_cache.h"
+#include "ddc/ddc_dumpload_binary.h"
+#include "ddc/ddc_known_monitors.h"
 #include "ddc/ddc_multi_part_io.h"
 #include "ddc/ddc_output.h"
 #include "ddc/ddc_packet_io.h"
 #include "ddc/ddc_read_capabilities.h"
+#include "ddc/ddc_retry_policy.h"
 #include "ddc/ddc_try_stats.h"
 #include "ddc/ddc_vcp.h"
+#include "ddc/ddc_vcp_value_cache.h"
 
 #include "ddc/ddc_services.h"
 
@@ -62,6 +70,8 @@ void ddc_reset_stats_main() {
    // ddc_reset_ddc_stats();
    try_data_reset2_all();
    reset_execution_stats();
+   tds_reset_all_threads();
+   ddc_reset_vcp_value_cache_stats();
 }
 
 
@@ -86,6 +96,10 @@ void ddc_report_stats_main(DDCA_Stats_Type stats, bool show_per_thread_stats, in
       // report_all_thread_retry_data(depth);
    }
 
+   if (stats & (DDCA_STATS_TRIES | DDCA_STATS_ERRORS)) {
+      report_all_display_stats(depth);   // try and error counts by display
+   }
+
    if (stats & DDCA_STATS_ERRORS) {
       report_all_status_counts(depth);   // error code counts
       rpt_nl();
@@ -105,6 +119,13 @@ void ddc_report_stats_main(DDCA_Stats_Type stats, bool show_per_thread_stats, in
 
       report_io_call_stats(depth);
       rpt_nl();
+      report_vcp_value_cache_stats(depth);
+      rpt_nl();
+      report_multi_part_write_pacing(depth);
+      report_i2c_bus_strategies(depth);
+      rpt_nl();
+      report_i2c_read_deadlines(depth);
+      rpt_nl();
       report_sleep_stats(depth);
       rpt_nl();
       report_elapsed_stats(depth);
@@ -151,12 +172,13 @@ void init_ddc_services() {
    DBGMSF(debug, "Executing");
 
    // i2c:
-   i2c_set_io_strategy(DEFAULT_I2C_IO_STRATEGY);
+   i2c_reset_io_strategy();
    init_i2c_bus_core();
 
    // usb
 #ifdef USE_USB
    init_usb_displays();
+   init_usb_hidraw_vcp();
 #endif
 
    // ddc:
@@ -167,11 +189,16 @@ void init_ddc_services() {
    init_dyn_feature_files();
    init_ddc_display_lock();
    init_ddc_displays();
+   init_ddc_displays_cache();
+   init_ddc_dumpload_binary();
+   init_ddc_known_monitors();
    init_ddc_output();
    init_ddc_packet_io();
    init_ddc_read_capabilities();
    init_ddc_multi_part_io();
+   init_ddc_retry_policy();
    init_ddc_vcp();
+   init_ddc_vcp_value_cache();
 
    // dbgrpt_rtti_func_name_table(1);
 }
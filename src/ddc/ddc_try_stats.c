@@ -22,8 +22,12 @@
 #include "base/ddc_errno.h"
 #include "base/parms.h"
 #include "base/per_thread_data.h"    // for retry_type_name()
+#include "base/thread_display_stats.h"
 #include "base/thread_retry_data.h"
 #include "base/thread_sleep_data.h"
+#include "base/timeline.h"
+
+#include "ddc/ddc_retry_policy.h"
 
 #include "ddc/ddc_try_stats.h"
 
@@ -309,7 +313,8 @@ static void record_failed_fatally2(Retry_Operation retry_type) {
  *
  *  @remark
  *  Also calls #trd_record_cur_thread_ties() to record the transaction status
- *  in the per-thread data structure.
+ *  in the per-thread data structure, and #tds_record_tries() to record it
+ *  for the display currently being accessed.
  */
 void try_data_record_tries2(Retry_Operation retry_type, DDCA_Status ddcrc, int tryct) {
    bool debug = false;
@@ -317,6 +322,8 @@ void try_data_record_tries2(Retry_Operation retry_type, DDCA_Status ddcrc, int t
                  retry_type, retry_type_name(retry_type), ddcrc, tryct);
 
    trd_record_cur_thread_tries(retry_type, ddcrc, tryct);
+   tds_record_tries(retry_type, ddcrc, tryct);
+   timeline_record_tries(retry_type_name(retry_type), tryct, ddcrc);
 
    Try_Data2 * stats_rec = &try_data[retry_type];
    bool locked_by_this_func = lock_if_unlocked();
@@ -489,5 +496,7 @@ void ddc_report_ddc_stats(int depth) {
    try_data_report2(WRITE_READ_TRIES_OP, depth);   //   ddc_report_write_read_stats(depth);
    try_data_report2(MULTI_PART_READ_OP,  depth);   //   ddc_report_multi_part_read_stats(depth);
    try_data_report2(MULTI_PART_WRITE_OP, depth);   //   ddc_report_multi_part_write_stats(depth);
+   rpt_nl();
+   drp_report_all(depth);
 }
 
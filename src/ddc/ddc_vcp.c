@@ -19,6 +19,7 @@
 #include "util/error_info.h"
 #include "util/report_util.h"
 #include "util/string_util.h"
+#include "util/timestamp.h"
 #include "util/utilrpt.h"
 /** \endcond */
 
@@ -27,6 +28,7 @@
 #include "base/displays.h"
 #include "base/rtti.h"
 #include "base/status_code_mgt.h"
+#include "base/timeline.h"
 
 #include "i2c/i2c_bus_core.h"
 
@@ -45,6 +47,8 @@
 
 #include "ddc/ddc_multi_part_io.h"
 #include "ddc/ddc_packet_io.h"
+#include "ddc/ddc_retry_policy.h"
+#include "ddc/ddc_vcp_value_cache.h"
 #include "ddc/ddc_vcp_version.h"
 
 #include "ddc/ddc_vcp.h"
@@ -57,6 +61,9 @@ static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDC;
 
 typedef struct {
    bool   verify_setvcp;
+   bool   force_value_refresh;
+   Multi_Part_Progress_Func table_write_progress_func;
+   void * table_write_progress_arg;
 } Thread_Vcp_Settings;
 
 static Thread_Vcp_Settings *  get_thread_vcp_settings() {
@@ -97,6 +104,7 @@ ddc_save_current_settings(
           "Invoking DDC Save Current Settings command. dh=%s", dh_repr_t(dh));
    Public_Status_Code psc = 0;
    Error_Info * ddc_excp = NULL;
+   uint64_t start_nanos = cur_realtime_nanosec();
 
    if (dh->dref->io_path.io_mode == DDCA_IO_USB) {
       // command line parser should block this case
@@ -115,6 +123,7 @@ ddc_save_current_settings(
       if (request_packet_ptr)
          free_ddc_packet(request_packet_ptr);
    }
+   timeline_record_span(TL_VCP, "save settings", start_nanos, cur_realtime_nanosec(), psc);
 
    DBGTRC(debug, TRACE_GROUP, "Returning %s", psc_desc(psc));
    if ( (debug||IS_TRACING()) && ddc_excp)
@@ -147,6 +156,8 @@ ddc_set_nontable_vcp_value(
           feature_code, new_value, dh_repr_t(dh) );
    Public_Status_Code psc = 0;
    Error_Info * ddc_excp = NULL;
+   uint64_t start_nanos = cur_realtime_nanosec();
+   int prior_feature = timeline_set_current_feature(feature_code);
 
    if (dh->dref->io_path.io_mode == DDCA_IO_USB) {
 #ifdef USE_USB
@@ -157,16 +168,17 @@ ddc_set_nontable_vcp_value(
    }
    else {
       DDC_Packet * request_packet_ptr =
-         create_ddc_setvcp_request_packet(feature_code, new_value, "set_vcp:request packet");
-      // DBGMSG("create_ddc_getvcp_request_packet returned packet_ptr=%p", request_packet_ptr);
+         init_ddc_setvcp_request_packet(
+               &dh->request_storage, feature_code, new_value, "set_vcp:request packet");
       // dump_packet(request_packet_ptr);
 
       ddc_excp = ddc_write_only_with_retry(dh, request_packet_ptr);
       psc = (ddc_excp) ? ddc_excp->status_code : 0;
-
-      if (request_packet_ptr)
-         free_ddc_packet(request_packet_ptr);
    }
+   // even a failed write may have changed the value
+   ddc_invalidate_cached_vcp_values(dh->dref->io_path);
+   timeline_record_span(TL_VCP, "setvcp", start_nanos, cur_realtime_nanosec(), psc);
+   timeline_set_current_feature(prior_feature);
 
    DBGTRC(debug, TRACE_GROUP, "Returning %s", psc_desc(psc));
    if ( psc==DDCRC_RETRIES && (debug || IS_TRACING()) )
@@ -183,7 +195,7 @@ ddc_set_nontable_vcp_value(
  *  \param  bytect        number of bytes
  *  \return NULL  if success
  *          DDCRC_UNIMPLEMENTED if io mode is USB
- *          #Error_Info from #multi_part_write_with_retry() otherwise
+ *          #Error_Info from #multi_part_write_with_progress() otherwise
  */
 Error_Info *
 set_table_vcp_value(
@@ -197,6 +209,8 @@ set_table_vcp_value(
                               feature_code, bytect);
    Public_Status_Code psc = 0;
    Error_Info * ddc_excp = NULL;
+   uint64_t start_nanos = cur_realtime_nanosec();
+   int prior_feature = timeline_set_current_feature(feature_code);
 
    if (dh->dref->io_path.io_mode == DDCA_IO_USB) {
 #ifdef USE_USB
@@ -210,11 +224,17 @@ set_table_vcp_value(
       // pointless wrapping in a Buffer just to unwrap
       Buffer * new_value = buffer_new_with_value(bytes, bytect, __func__);
 
-      ddc_excp = multi_part_write_with_retry(dh, feature_code, new_value);
+      Thread_Vcp_Settings * settings = get_thread_vcp_settings();
+      ddc_excp = multi_part_write_with_progress(dh, feature_code, new_value,
+                                                settings->table_write_progress_func,
+                                                settings->table_write_progress_arg);
       psc = (ddc_excp) ? ddc_excp->status_code : 0;
 
       buffer_free(new_value, __func__);
    }
+   ddc_invalidate_cached_vcp_values(dh->dref->io_path);
+   timeline_record_span(TL_VCP, "set table", start_nanos, cur_realtime_nanosec(), psc);
+   timeline_set_current_feature(prior_feature);
 
    DBGTRC(debug, TRACE_GROUP, "Returning: %s", psc_desc(psc));
    if ( (debug || IS_TRACING()) && psc == DDCRC_RETRIES )
@@ -252,6 +272,44 @@ bool ddc_get_verify_setvcp() {
 }
 
 
+/** Sets whether reads of non-table features on the current thread ignore
+ *  values in the VCP value cache.  The values read are still saved in the
+ *  cache, so subsequent reads on other threads see the refreshed value.
+ *
+ *  \param onoff  **true** to always read from the display
+ *  \return prior setting
+ */
+bool ddc_set_force_value_refresh(bool onoff) {
+   Thread_Vcp_Settings * settings = get_thread_vcp_settings();
+   bool old_value = settings->force_value_refresh;
+   settings->force_value_refresh = onoff;
+   return old_value;
+}
+
+
+/** Sets the function called on the current thread as each fragment of a
+ *  table feature value is written.
+ *
+ *  \param func  function to call, NULL for none
+ *  \param arg   argument passed to **func**
+ */
+void ddc_set_table_write_progress_func(Multi_Part_Progress_Func func, void * arg) {
+   Thread_Vcp_Settings * settings = get_thread_vcp_settings();
+   settings->table_write_progress_func = func;
+   settings->table_write_progress_arg  = arg;
+}
+
+
+/** Reports whether reads on the current thread ignore cached values.
+ *
+ *  \return **true** if reads always access the display
+ */
+bool ddc_get_force_value_refresh() {
+   Thread_Vcp_Settings * settings = get_thread_vcp_settings();
+   return settings->force_value_refresh;
+}
+
+
 static bool
 is_rereadable_feature(
       Display_Handle * dh,
@@ -515,41 +573,58 @@ value_bytes_zero(Parsed_Nontable_Vcp_Response * parsed_val) {
 #endif
 
 
-/** Gets the value for a non-table feature.
+/** Gets the value for a non-table feature into caller supplied storage.
  *
  *  \param  dh                 handle for open display
  *  \param  feature_code       VCP feature code
- *  \param  ppInterpretedCode  where to return parsed response
+ *  \param  parsed_response    where to return parsed response
  *  \return NULL if success, pointer to #Error_Info if failure
  *
- * It is the responsibility of the caller to free the parsed response.
+ *  The request and response packets are built in the packet storage of **dh**,
+ *  so no memory is allocated unless the read fails.
  *
- * The value pointed to by ppInterpretedCode is non-null iff the returned status code is 0.
+ *  If the VCP value cache is enabled, a cached value is returned if one is
+ *  current, unless #ddc_set_force_value_refresh() is in effect for the thread.
+ *
+ *  The contents of **parsed_response** are valid iff NULL is returned.
  */
 Error_Info *
-ddc_get_nontable_vcp_value(
+ddc_read_nontable_vcp_value(
        Display_Handle *               dh,
        DDCA_Vcp_Feature_Code          feature_code,
-       Parsed_Nontable_Vcp_Response** ppInterpretedCode)
+       Parsed_Nontable_Vcp_Response * parsed_response)
 {
    bool debug = false;
    DBGTRC(debug, TRACE_GROUP, "Starting. dh=%s, Reading feature 0x%02x", dh_repr_t(dh), feature_code);
 
    Public_Status_Code psc = 0;
    Error_Info * excp = NULL;
-   Parsed_Nontable_Vcp_Response * parsed_response = NULL;
-   *ppInterpretedCode = NULL;
 
-   Error_Info * mock_errinfo = mock_get_nontable_vcp_value(feature_code, ppInterpretedCode);
-   if (mock_errinfo || *ppInterpretedCode) {
+   Parsed_Nontable_Vcp_Response * mock_response = NULL;
+   Error_Info * mock_errinfo = mock_get_nontable_vcp_value(feature_code, &mock_response);
+   if (mock_errinfo || mock_response) {
       DBGMSF(debug, "Returning mock response for feature 0x%02x", feature_code);
+      if (mock_response) {
+         *parsed_response = *mock_response;
+         free(mock_response);
+      }
       return mock_errinfo;
    }
 
+   if (ddc_get_cached_vcp_value(dh->dref->io_path, feature_code,
+                                get_thread_vcp_settings()->force_value_refresh, parsed_response))
+   {
+      DBGTRC(debug, TRACE_GROUP, "Done.     Returning cached value for feature x%02x", feature_code);
+      return NULL;
+   }
+   uint64_t start_nanos = cur_realtime_nanosec();
+   int prior_feature = timeline_set_current_feature(feature_code);
+
    DDC_Packet * request_packet_ptr  = NULL;
    DDC_Packet * response_packet_ptr = NULL;
-   request_packet_ptr = create_ddc_getvcp_request_packet(
-                           feature_code, "ddc_get_nontable_vcp_value:request packet");
+   request_packet_ptr = init_ddc_getvcp_request_packet(
+                           &dh->request_storage,
+                           feature_code, "ddc_read_nontable_vcp_value:request packet");
    // dump_packet(request_packet_ptr);
 
    Byte expected_response_type = DDC_PACKET_TYPE_QUERY_VCP_RESPONSE;
@@ -562,6 +637,7 @@ ddc_get_nontable_vcp_value(
    //  N. response does not include initial destination address byte of DDC/CI spec
    int max_read_bytes = 11;
 
+   // response packet is built in dh->response_storage
    excp = ddc_write_read_with_retry(
            dh,
            request_packet_ptr,
@@ -582,8 +658,10 @@ ddc_get_nontable_vcp_value(
    if (!excp) {
       assert(response_packet_ptr);
       // dump_packet(response_packet_ptr);
-      psc = get_interpreted_vcp_code(response_packet_ptr, true /* make_copy */, &parsed_response);   // ???
+      Parsed_Nontable_Vcp_Response * interpreted = NULL;
+      psc = get_interpreted_vcp_code(response_packet_ptr, false /* make_copy */, &interpreted);
       if (psc == 0) {
+         *parsed_response = *interpreted;
 #ifdef NO_LONGER_NEEDED
          if (parsed_response->vcp_code != feature_code) {
             DBGMSG("!!! WTF! requested feature_code = 0x%02x, but code in response is 0x%02x",
@@ -613,33 +691,31 @@ ddc_get_nontable_vcp_value(
             psc = DDCRC_DETERMINED_UNSUPPORTED;
             excp = errinfo_new2(psc, __func__, "MH=ML=SH=SL=0");
          }
-
-         if (psc != 0) {
-            free(parsed_response);
-            parsed_response = NULL;
+         else {
+            ddc_save_cached_vcp_value(dh->dref->io_path, feature_code, parsed_response);
          }
+
+         if (psc == DDCRC_REPORTED_UNSUPPORTED || psc == DDCRC_DETERMINED_UNSUPPORTED)
+            drp_note_unsupported_feature(dh->dref, feature_code);
       }
       else {
          excp = errinfo_new(psc, __func__);
       }
    }
 
-   if (request_packet_ptr)
-      free_ddc_packet(request_packet_ptr);
-   if (response_packet_ptr)
-      free_ddc_packet(response_packet_ptr);
+   // no-ops for packets in the handle's storage, retained for other packet sources
+   free_ddc_packet(request_packet_ptr);
+   free_ddc_packet(response_packet_ptr);
+   timeline_record_span(TL_VCP, "getvcp", start_nanos, cur_realtime_nanosec(), ERRINFO_STATUS(excp));
+   timeline_set_current_feature(prior_feature);
 
-   // DBGMSG("excp = %s", errinfo_summary(excp));
-   // DBGMSG("parsed_response = %p", parsed_response);
-
-   assert( (!excp && parsed_response) || (excp && !parsed_response)); // needed to avoid clang warning
    if (debug || IS_TRACING() ) {
       if (excp) {
          DBGMSG("Done.     Error reading feature x%02x.  Returning exception: %s", feature_code, errinfo_summary(excp));
          // errinfo_report(excp, 1);
       }
       else {
-         DBGMSG("Done.     Success reading feature x%02x. *ppinterpreted_code=%p", feature_code, parsed_response);
+         DBGMSG("Done.     Success reading feature x%02x.", feature_code);
          DBGMSG("          mh=0x%02x, ml=0x%02x, sh=0x%02x, sl=0x%02x, max value=%d, cur value=%d",
                 parsed_response->mh, parsed_response->ml,
                 parsed_response->sh, parsed_response->sl,
@@ -647,51 +723,190 @@ ddc_get_nontable_vcp_value(
                 (parsed_response->sh<<8) | parsed_response->sl);
       }
    }
-   *ppInterpretedCode = parsed_response;
 
    return excp;
 }
 
 
-/** Gets the value of a table feature in a newly allocated Buffer struct.
+/** Gets the value for a non-table feature.
+ *
+ *  \param  dh                 handle for open display
+ *  \param  feature_code       VCP feature code
+ *  \param  ppInterpretedCode  where to return parsed response
+ *  \return NULL if success, pointer to #Error_Info if failure
+ *
+ * It is the responsibility of the caller to free the parsed response.
+ *
+ * The value pointed to by ppInterpretedCode is non-null iff the returned status code is 0.
+ */
+Error_Info *
+ddc_get_nontable_vcp_value(
+       Display_Handle *               dh,
+       DDCA_Vcp_Feature_Code          feature_code,
+       Parsed_Nontable_Vcp_Response** ppInterpretedCode)
+{
+   Parsed_Nontable_Vcp_Response response;
+   Error_Info * excp = ddc_read_nontable_vcp_value(dh, feature_code, &response);
+   *ppInterpretedCode = NULL;
+   if (!excp) {
+      *ppInterpretedCode = malloc(sizeof(Parsed_Nontable_Vcp_Response));
+      **ppInterpretedCode = response;
+   }
+   return excp;
+}
+
+
+// Passes on the part of a fragment that lies within a requested range
+typedef struct {
+   Multi_Part_Fragment_Func fragment_func;
+   void *                   fragment_arg;
+   int                      offset;
+   int                      max_bytes;
+} Fragment_Range_Filter;
+
+static void
+forward_fragment_in_range(
+      Byte   feature_code,
+      int    offset,
+      Byte * bytes,
+      int    bytect,
+      void * arg)
+{
+   Fragment_Range_Filter * filter = arg;
+   int start = MAX(offset, filter->offset);
+   int end   = offset + bytect;
+   if (filter->max_bytes >= 0)
+      end = MIN(end, filter->offset + filter->max_bytes);
+   if (start < end)
+      filter->fragment_func(feature_code, start, bytes + (start-offset), end-start, filter->fragment_arg);
+}
+
+
+// Returns the status code of the last try of a failed multi-part read,
+// rather than DDCRC_RETRIES if the read failed on its final try
+static Public_Status_Code last_try_status(Error_Info * ddc_excp) {
+   if (ddc_excp && ddc_excp->status_code == DDCRC_RETRIES && ddc_excp->cause_ct > 0)
+      return ddc_excp->causes[ddc_excp->cause_ct-1]->status_code;
+   return ERRINFO_STATUS(ddc_excp);
+}
+
+
+// Returns a newly allocated Buffer containing the requested range of a complete value
+static Buffer *
+table_value_range(Buffer * value, int offset, int max_bytes) {
+   int start = MIN(offset, value->len);
+   int end   = (max_bytes >= 0) ? MIN(value->len, start + max_bytes) : value->len;
+   return buffer_new_with_value(value->bytes + start, end - start, __func__);
+}
+
+
+/** Gets all or part of the value of a table feature in a newly allocated Buffer struct.
  *  It is the responsibility of the caller to free the Buffer.
  *
+ *  If **fragment_func** is set, it is called with each fragment of the value
+ *  as it is read, so the caller can process the value while the read continues.
+ *  If a try of the read fails, the fragments are delivered again.
+ *
+ *  If the monitor does not support reading from a non-zero offset, the entire
+ *  value is read and only the requested range is delivered and returned.
+ *
+ *  If the value cache is enabled, values of read-only table features are saved
+ *  for each monitor model, and reused unless #ddc_set_force_value_refresh() is
+ *  in effect for the thread.
+ *  A saved value is delivered to **fragment_func** in a single call.
+ *
  *  \param  dh              display handle
  *  \param  feature_code    VCP feature code
+ *  \param  offset          offset of first byte to read
+ *  \param  max_bytes       maximum number of bytes to read, -1 to read to the end
+ *  \param  fragment_func   if non-NULL, called with each fragment read
+ *  \param  fragment_arg    passed to **fragment_func**
  *  \param  pp_table_bytes  location at which to save address of newly allocated Buffer
  *  \return NULL if success, pointer to #Error_Info if failure
  */
 Error_Info *
-ddc_get_table_vcp_value(
-       Display_Handle *       dh,
-       Byte                   feature_code,
-       Buffer**               pp_table_bytes)
+ddc_read_table_vcp_value_range(
+       Display_Handle *         dh,
+       Byte                     feature_code,
+       int                      offset,
+       int                      max_bytes,
+       Multi_Part_Fragment_Func fragment_func,
+       void *                   fragment_arg,
+       Buffer**                 pp_table_bytes)
 {
    bool debug = false;
-   DBGTRC(debug, TRACE_GROUP, "Starting. Reading feature 0x%02x", feature_code);
+   DBGTRC(debug, TRACE_GROUP, "Starting. Reading feature 0x%02x, offset=%d, max_bytes=%d",
+                              feature_code, offset, max_bytes);
 
    Public_Status_Code psc = 0;
    Error_Info * ddc_excp = NULL;
    DDCA_Output_Level output_level = get_output_level();
    Buffer * paccumulator =  NULL;
+   *pp_table_bytes = NULL;
+   bool whole_value = (offset == 0 && max_bytes < 0);
+
+   Buffer * saved = ddc_get_cached_table_value(dh, feature_code,
+                                               get_thread_vcp_settings()->force_value_refresh);
+   if (saved) {
+      *pp_table_bytes = (whole_value) ? saved : table_value_range(saved, offset, max_bytes);
+      if (!whole_value)
+         buffer_free(saved, __func__);
+      if (fragment_func && (*pp_table_bytes)->len > 0)
+         fragment_func(feature_code, offset, (*pp_table_bytes)->bytes, (*pp_table_bytes)->len, fragment_arg);
+      DBGTRC(debug, TRACE_GROUP, "Done. Returning saved value, length %d", (*pp_table_bytes)->len);
+      return NULL;
+   }
+   uint64_t start_nanos = cur_realtime_nanosec();
+   int prior_feature = timeline_set_current_feature(feature_code);
 
-   ddc_excp = multi_part_read_with_retry(
+   // the last fragment read can extend beyond the requested range
+   Fragment_Range_Filter filter = {fragment_func, fragment_arg, offset, max_bytes};
+   ddc_excp = multi_part_read_range_with_retry(
             dh,
             DDC_PACKET_TYPE_TABLE_READ_REQUEST,
             feature_code,
             true,                      // all_zero_response_ok
+            offset,
+            max_bytes,
+            (fragment_func) ? forward_fragment_in_range : NULL,
+            &filter,
             &paccumulator);
    psc = (ddc_excp) ? ddc_excp->status_code : 0;
+
+   // the failure may have occurred on the final try, making psc DDCRC_RETRIES
+   if (last_try_status(ddc_excp) == DDCRC_MULTI_PART_READ_FRAGMENT && offset > 0) {
+      DBGTRC(debug, TRACE_GROUP, "Offset read unsupported, reading entire value");
+      errinfo_free(ddc_excp);
+      ddc_excp = multi_part_read_range_with_retry(
+               dh,
+               DDC_PACKET_TYPE_TABLE_READ_REQUEST,
+               feature_code,
+               true,                      // all_zero_response_ok
+               0,
+               -1,
+               (fragment_func) ? forward_fragment_in_range : NULL,
+               &filter,
+               &paccumulator);
+      psc = (ddc_excp) ? ddc_excp->status_code : 0;
+      whole_value = true;
+   }
    if (debug || psc != 0) {
       DBGTRC(debug, TRACE_GROUP,
-             "multi_part_read_with_retry() returned %s", psc_desc(psc));
+             "multi_part_read_range_with_retry() returned %s", psc_desc(psc));
    }
 
    if (psc == 0) {
-      *pp_table_bytes = paccumulator;
+      if (whole_value)
+         ddc_save_cached_table_value(dh, feature_code, paccumulator);
+      if (whole_value && (offset > 0 || max_bytes >= 0)) {
+         *pp_table_bytes = table_value_range(paccumulator, offset, max_bytes);
+         buffer_free(paccumulator, __func__);
+      }
+      else
+         *pp_table_bytes = paccumulator;
       if (output_level >= DDCA_OL_VERBOSE) {
          DBGMSG("Bytes returned on table read:");
-         dbgrpt_buffer(paccumulator, 1);
+         dbgrpt_buffer(*pp_table_bytes, 1);
       }
    }
    // lowest level at which this check can be done, multi_part_read_with_retry() doesn't
@@ -702,8 +917,11 @@ ddc_get_table_vcp_value(
       Error_Info * wrapped_exception = ddc_excp;
       ddc_excp = errinfo_new_with_cause2(
             DDCRC_DETERMINED_UNSUPPORTED, wrapped_exception, __func__, "DDC NULL Message");
+      drp_note_unsupported_feature(dh->dref, feature_code);
 
    }
+   timeline_record_span(TL_VCP, "get table", start_nanos, cur_realtime_nanosec(), ERRINFO_STATUS(ddc_excp));
+   timeline_set_current_feature(prior_feature);
 
    DBGTRC(debug, TRACE_GROUP,
           "Done. rc=%s, *pp_table_bytes=%p", psc_desc(psc), *pp_table_bytes);
@@ -712,6 +930,24 @@ ddc_get_table_vcp_value(
 }
 
 
+/** Gets the value of a table feature in a newly allocated Buffer struct.
+ *  It is the responsibility of the caller to free the Buffer.
+ *
+ *  \param  dh              display handle
+ *  \param  feature_code    VCP feature code
+ *  \param  pp_table_bytes  location at which to save address of newly allocated Buffer
+ *  \return NULL if success, pointer to #Error_Info if failure
+ */
+Error_Info *
+ddc_get_table_vcp_value(
+       Display_Handle *       dh,
+       Byte                   feature_code,
+       Buffer**               pp_table_bytes)
+{
+   return ddc_read_table_vcp_value_range(dh, feature_code, 0, -1, NULL, NULL, pp_table_bytes);
+}
+
+
 /** Gets the value of a VCP feature.
  *
  * \param  dh              handle for open display
@@ -779,20 +1015,22 @@ ddc_get_vcp_value(
       switch (call_type) {
 
       case (DDCA_NON_TABLE_VCP_VALUE):
-            ddc_excp = ddc_get_nontable_vcp_value(
+         {
+            Parsed_Nontable_Vcp_Response nontable_response;
+            ddc_excp = ddc_read_nontable_vcp_value(
                           dh,
                           feature_code,
-                          &parsed_nontable_response);
+                          &nontable_response);
             psc = (ddc_excp) ? ddc_excp->status_code : 0;
             if (!ddc_excp) {
                valrec = create_nontable_vcp_value(
                            feature_code,
-                           parsed_nontable_response->mh,
-                           parsed_nontable_response->ml,
-                           parsed_nontable_response->sh,
-                           parsed_nontable_response->sl);
-               free(parsed_nontable_response);
+                           nontable_response.mh,
+                           nontable_response.ml,
+                           nontable_response.sh,
+                           nontable_response.sl);
             }
+         }
             break;
 
       case (DDCA_TABLE_VCP_VALUE):
@@ -826,8 +1064,10 @@ ddc_get_vcp_value(
 
 static void init_ddc_vcp_func_name_table() {
 #define ADD_FUNC(_NAME) rtti_func_name_table_add(_NAME, #_NAME);
+   ADD_FUNC(ddc_read_nontable_vcp_value);
    ADD_FUNC(ddc_get_nontable_vcp_value);
    ADD_FUNC(ddc_get_table_vcp_value);
+   ADD_FUNC(ddc_read_table_vcp_value_range);
    ADD_FUNC(ddc_get_vcp_value);
 #undef ADD_FUNC
 }
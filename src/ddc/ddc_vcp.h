@@ -21,6 +21,8 @@
 #include "vcp/vcp_feature_codes.h"
 #include "vcp/vcp_feature_values.h"
 
+#include "ddc/ddc_multi_part_io.h"
+
 
 bool
 ddc_set_verify_setvcp(
@@ -29,6 +31,18 @@ ddc_set_verify_setvcp(
 bool
 ddc_get_verify_setvcp();
 
+bool
+ddc_set_force_value_refresh(
+      bool                      onoff);
+
+bool
+ddc_get_force_value_refresh();
+
+void
+ddc_set_table_write_progress_func(
+      Multi_Part_Progress_Func  func,
+      void *                    arg);
+
 Error_Info *
 ddc_save_current_settings(
       Display_Handle *          dh);
@@ -51,6 +65,22 @@ ddc_get_table_vcp_value(
       Byte                      feature_code,
       Buffer**                  table_bytes_loc);
 
+Error_Info *
+ddc_read_table_vcp_value_range(
+      Display_Handle *          dh,
+      Byte                      feature_code,
+      int                       offset,
+      int                       max_bytes,
+      Multi_Part_Fragment_Func  fragment_func,
+      void *                    fragment_arg,
+      Buffer**                  table_bytes_loc);
+
+Error_Info *
+ddc_read_nontable_vcp_value(
+      Display_Handle *          dh,
+      Byte                      feature_code,
+      Parsed_Nontable_Vcp_Response* parsed_response);
+
 Error_Info *
 ddc_get_nontable_vcp_value(
       Display_Handle *          dh,
@@ -0,0 +1,416 @@
+/** \file ddc_vcp_value_cache.c
+ *
+ *  Cache of non-table VCP feature values read from each display.
+ *
+ *  When enabled, a successfully read non-table value is saved, and a
+ *  subsequent read of the same feature on the same display within the
+ *  feature's time to live returns the saved value instead of performing
+ *  DDC IO.  The time to live is VCP_Feature_Table_Entry.cache_ttl_millisec,
+ *  or the default if not set for the feature.  Features marked
+ *  #VCP_CACHE_VOLATILE, and features not in the feature table, are
+ *  never cached.
+ *
+ *  Cached values for a display are discarded:
+ *  - when ddcutil writes any feature value to the display, since a write
+ *    may also change other features (e.g. a color preset)
+ *  - when feature x02 reports that a user control has changed a value
+ *  - when feature x52 reports that a specific feature has changed
+ *
+ *  The cache is disabled by default.
+ *
+ *  Separately, values of read-only table features are saved for each monitor
+ *  model, since they describe the model rather than its current settings.
+ *  They are reused for any display of the same model.  Like other cached
+ *  values, they are only saved and reused when the value cache is enabled.
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/** \cond */
+#include <assert.h>
+#include <glib-2.0/glib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/report_util.h"
+#include "util/timestamp.h"
+/** \endcond */
+
+#include "base/core.h"
+#include "base/displays.h"
+#include "base/monitor_model_key.h"
+#include "base/parms.h"
+#include "base/rtti.h"
+
+#include "vcp/vcp_feature_codes.h"
+
+#include "ddc/ddc_vcp_version.h"
+
+#include "ddc/ddc_vcp_value_cache.h"
+
+
+// Trace class for this file
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDC;
+
+/** Cached values and cache statistics for one display */
+typedef struct {
+   DDCA_IO_Path                  io_path;
+   uint64_t                      read_nanosec[256];   ///< time value was read, 0 if none cached
+   Parsed_Nontable_Vcp_Response  values[256];
+   int                           hit_ct;              ///< reads satisfied from the cache
+   int                           miss_ct;             ///< cacheable reads that performed DDC IO
+   int                           refresh_ct;          ///< reads that were forced to perform DDC IO
+   int                           uncacheable_ct;      ///< reads of volatile or unknown features
+   int                           invalidation_ct;     ///< times all values were discarded
+} Display_Value_Cache;
+
+static bool         value_cache_enabled = false;
+static int          default_ttl_millisec = VCP_VALUE_CACHE_TTL_MILLISEC_DEFAULT;
+static GHashTable * caches_by_io_path = NULL;     // DDCA_IO_Path * -> Display_Value_Cache *
+static GMutex       value_cache_mutex;
+
+static GHashTable * tables_by_model = NULL;       // "<model string>:<feature code>" -> Buffer *
+static int          table_hit_ct = 0;
+static int          table_miss_ct = 0;
+static GMutex       table_cache_mutex;
+
+
+/** Enables or disables the VCP value cache.
+ *  Disabling the cache discards all cached values.
+ *
+ *  \param  onoff  new setting
+ *  \return prior setting
+ */
+bool ddc_enable_vcp_value_cache(bool onoff) {
+   g_mutex_lock(&value_cache_mutex);
+   bool old = value_cache_enabled;
+   value_cache_enabled = onoff;
+   if (!onoff && caches_by_io_path) {
+      GHashTableIter iter;
+      gpointer value;
+      g_hash_table_iter_init(&iter, caches_by_io_path);
+      while (g_hash_table_iter_next(&iter, NULL, &value))
+         memset(((Display_Value_Cache *) value)->read_nanosec, 0, 256 * sizeof(uint64_t));
+   }
+   g_mutex_unlock(&value_cache_mutex);
+   return old;
+}
+
+
+/** Reports whether the VCP value cache is enabled */
+bool ddc_is_vcp_value_cache_enabled() {
+   return value_cache_enabled;
+}
+
+
+/** Sets the time to live of cached values for features that do not
+ *  specify their own.
+ *
+ *  \param  millisec  time to live in milliseconds
+ */
+void ddc_set_vcp_value_cache_ttl_millisec(int millisec) {
+   assert(millisec > 0);
+   default_ttl_millisec = millisec;
+}
+
+
+// Returns the time to live for a feature's cached value, -1 if the value is not cached
+static int feature_ttl_millisec(DDCA_Vcp_Feature_Code feature_code) {
+   VCP_Feature_Table_Entry * vfte = vcp_find_feature_by_hexid(feature_code);
+   if (!vfte || vfte->cache_ttl_millisec == VCP_CACHE_VOLATILE)
+      return -1;
+   return (vfte->cache_ttl_millisec == VCP_CACHE_TTL_DEFAULT) ? default_ttl_millisec
+                                                              : vfte->cache_ttl_millisec;
+}
+
+
+// Must be called with value_cache_mutex held
+static Display_Value_Cache * get_display_value_cache(DDCA_IO_Path io_path) {
+   if (!caches_by_io_path)
+      caches_by_io_path = g_hash_table_new_full(dpath_hash, dpath_hash_equal, NULL, g_free);
+   Display_Value_Cache * cache = g_hash_table_lookup(caches_by_io_path, &io_path);
+   if (!cache) {
+      cache = g_new0(Display_Value_Cache, 1);
+      cache->io_path = io_path;
+      g_hash_table_insert(caches_by_io_path, &cache->io_path, cache);
+   }
+   return cache;
+}
+
+
+/** Looks up the cached value of a non-table feature.
+ *
+ *  \param  io_path        display path
+ *  \param  feature_code   VCP feature code
+ *  \param  force_refresh  if true, do not use a cached value
+ *  \param  value_loc      where to return the cached value
+ *  \return true if a cached value was returned, false if the value must be read
+ */
+bool ddc_get_cached_vcp_value(
+      DDCA_IO_Path                   io_path,
+      DDCA_Vcp_Feature_Code          feature_code,
+      bool                           force_refresh,
+      Parsed_Nontable_Vcp_Response * value_loc)
+{
+   bool debug = false;
+   if (!value_cache_enabled)
+      return false;
+
+   bool found = false;
+   int ttl_millisec = feature_ttl_millisec(feature_code);
+   g_mutex_lock(&value_cache_mutex);
+   Display_Value_Cache * cache = get_display_value_cache(io_path);
+   if (ttl_millisec < 0)
+      cache->uncacheable_ct++;
+   else if (force_refresh)
+      cache->refresh_ct++;
+   else {
+      uint64_t read_nanosec = cache->read_nanosec[feature_code];
+      if (read_nanosec &&
+          cur_realtime_nanosec() - read_nanosec <= (uint64_t) ttl_millisec * 1000000)
+      {
+         *value_loc = cache->values[feature_code];
+         cache->hit_ct++;
+         found = true;
+      }
+      else {
+         cache->read_nanosec[feature_code] = 0;
+         cache->miss_ct++;
+      }
+   }
+   g_mutex_unlock(&value_cache_mutex);
+
+   DBGTRC(debug, TRACE_GROUP, "io_path=%s, feature_code=0x%02x, force_refresh=%s, Returning %s",
+                              dpath_repr_t(&io_path), feature_code, sbool(force_refresh), sbool(found));
+   return found;
+}
+
+
+/** Saves a non-table value read from a display.
+ *
+ *  A value of feature x02 indicating that a user control has changed a
+ *  value discards all cached values for the display.  A value of feature
+ *  x52 discards the cached value of the feature it identifies.
+ *
+ *  \param  io_path        display path
+ *  \param  feature_code   VCP feature code
+ *  \param  value          value read
+ */
+void ddc_save_cached_vcp_value(
+      DDCA_IO_Path                   io_path,
+      DDCA_Vcp_Feature_Code          feature_code,
+      Parsed_Nontable_Vcp_Response * value)
+{
+   bool debug = false;
+   if (!value_cache_enabled)
+      return;
+
+   if (feature_code == 0x02 && value->sl == 0x02) {
+      DBGTRC(debug, TRACE_GROUP, "io_path=%s, feature x02 reports new control values",
+                                 dpath_repr_t(&io_path));
+      ddc_invalidate_cached_vcp_values(io_path);
+   }
+   else if (feature_code == 0x52 && value->sl != 0x00) {
+      DBGTRC(debug, TRACE_GROUP, "io_path=%s, feature x52 reports feature 0x%02x changed",
+                                 dpath_repr_t(&io_path), value->sl);
+      ddc_invalidate_cached_vcp_value(io_path, value->sl);
+   }
+   else if (feature_ttl_millisec(feature_code) >= 0) {
+      g_mutex_lock(&value_cache_mutex);
+      Display_Value_Cache * cache = get_display_value_cache(io_path);
+      cache->values[feature_code] = *value;
+      cache->read_nanosec[feature_code] = cur_realtime_nanosec();
+      g_mutex_unlock(&value_cache_mutex);
+   }
+}
+
+
+/** Discards the cached value of one feature for a display.
+ *
+ *  \param  io_path        display path
+ *  \param  feature_code   VCP feature code
+ */
+void ddc_invalidate_cached_vcp_value(DDCA_IO_Path io_path, DDCA_Vcp_Feature_Code feature_code) {
+   g_mutex_lock(&value_cache_mutex);
+   if (caches_by_io_path) {
+      Display_Value_Cache * cache = g_hash_table_lookup(caches_by_io_path, &io_path);
+      if (cache)
+         cache->read_nanosec[feature_code] = 0;
+   }
+   g_mutex_unlock(&value_cache_mutex);
+}
+
+
+/** Discards all cached values for a display.
+ *
+ *  \param  io_path        display path
+ */
+void ddc_invalidate_cached_vcp_values(DDCA_IO_Path io_path) {
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP, "io_path=%s", dpath_repr_t(&io_path));
+   g_mutex_lock(&value_cache_mutex);
+   if (caches_by_io_path) {
+      Display_Value_Cache * cache = g_hash_table_lookup(caches_by_io_path, &io_path);
+      if (cache) {
+         memset(cache->read_nanosec, 0, 256 * sizeof(uint64_t));
+         cache->invalidation_ct++;
+      }
+   }
+   g_mutex_unlock(&value_cache_mutex);
+}
+
+
+//
+// Read-only table values
+//
+
+// Returns NULL if the value cache is disabled, the feature is not a read-only
+// table feature, or the display has no EDID
+static char * table_cache_key(Display_Handle * dh, DDCA_Vcp_Feature_Code feature_code) {
+   if (!value_cache_enabled || !dh->dref->mmid)
+      return NULL;
+   VCP_Feature_Table_Entry * vfte = vcp_find_feature_by_hexid(feature_code);
+   if (!vfte)
+      return NULL;
+   DDCA_Version_Feature_Flags flags =
+         get_version_sensitive_feature_flags(vfte, get_vcp_version_by_dh(dh));
+   if (!(flags & DDCA_RO) || !(flags & DDCA_TABLE))
+      return NULL;
+   return g_strdup_printf("%s:%02x", monitor_model_string(dh->dref->mmid), feature_code);
+}
+
+
+/** Looks up the saved value of a read-only table feature for the display's
+ *  monitor model.
+ *
+ *  \param  dh             display handle
+ *  \param  feature_code   VCP feature code
+ *  \param  force_refresh  if true, do not use a saved value
+ *  \return newly allocated copy of the saved value, NULL if none or if
+ *          the value cache is disabled
+ */
+Buffer * ddc_get_cached_table_value(
+      Display_Handle *      dh,
+      DDCA_Vcp_Feature_Code feature_code,
+      bool                  force_refresh)
+{
+   bool debug = false;
+   Buffer * result = NULL;
+   char * key = table_cache_key(dh, feature_code);
+   if (key) {
+      g_mutex_lock(&table_cache_mutex);
+      Buffer * saved = (tables_by_model && !force_refresh)
+                            ? g_hash_table_lookup(tables_by_model, key)
+                            : NULL;
+      if (saved) {
+         result = buffer_new_with_value(saved->bytes, saved->len, __func__);
+         table_hit_ct++;
+      }
+      else
+         table_miss_ct++;
+      g_mutex_unlock(&table_cache_mutex);
+   }
+   DBGTRC(debug, TRACE_GROUP, "dh=%s, feature_code=0x%02x, key=%s, Returning %p",
+                              dh_repr_t(dh), feature_code, key, result);
+   free(key);
+   return result;
+}
+
+
+static void free_saved_table(gpointer data) {
+   buffer_free((Buffer *) data, __func__);
+}
+
+
+/** Saves the value of a table feature for the display's monitor model,
+ *  if the feature is read-only and the value cache is enabled.
+ *
+ *  \param  dh             display handle
+ *  \param  feature_code   VCP feature code
+ *  \param  value          complete value read
+ */
+void ddc_save_cached_table_value(
+      Display_Handle *      dh,
+      DDCA_Vcp_Feature_Code feature_code,
+      Buffer *              value)
+{
+   char * key = table_cache_key(dh, feature_code);
+   if (key) {
+      g_mutex_lock(&table_cache_mutex);
+      if (!tables_by_model)
+         tables_by_model = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, free_saved_table);
+      g_hash_table_replace(tables_by_model, key,
+                           buffer_new_with_value(value->bytes, value->len, __func__));
+      g_mutex_unlock(&table_cache_mutex);
+   }
+}
+
+
+/** Resets the VCP value cache statistics.  Cached values are retained. */
+void ddc_reset_vcp_value_cache_stats() {
+   g_mutex_lock(&value_cache_mutex);
+   if (caches_by_io_path) {
+      GHashTableIter iter;
+      gpointer value;
+      g_hash_table_iter_init(&iter, caches_by_io_path);
+      while (g_hash_table_iter_next(&iter, NULL, &value)) {
+         Display_Value_Cache * cache = value;
+         cache->hit_ct = 0;
+         cache->miss_ct = 0;
+         cache->refresh_ct = 0;
+         cache->uncacheable_ct = 0;
+         cache->invalidation_ct = 0;
+      }
+   }
+   g_mutex_unlock(&value_cache_mutex);
+
+   g_mutex_lock(&table_cache_mutex);
+   table_hit_ct = 0;
+   table_miss_ct = 0;
+   g_mutex_unlock(&table_cache_mutex);
+}
+
+
+/** Reports VCP value cache hits and misses for each display.
+ *
+ *  \param  depth  logical indentation depth
+ */
+void report_vcp_value_cache_stats(int depth) {
+   g_mutex_lock(&table_cache_mutex);
+   rpt_vstring(depth, "Read-only table values saved by monitor model: %d, hits: %d, misses: %d",
+                      (tables_by_model) ? g_hash_table_size(tables_by_model) : 0,
+                      table_hit_ct, table_miss_ct);
+   g_mutex_unlock(&table_cache_mutex);
+
+   if (!value_cache_enabled) {
+      rpt_label(depth, "VCP value cache: disabled");
+      return;
+   }
+   rpt_vstring(depth, "VCP value cache (default time to live %d millisec):", default_ttl_millisec);
+   g_mutex_lock(&value_cache_mutex);
+   if (!caches_by_io_path || g_hash_table_size(caches_by_io_path) == 0)
+      rpt_label(depth+1, "No reads");
+   else {
+      GHashTableIter iter;
+      gpointer value;
+      g_hash_table_iter_init(&iter, caches_by_io_path);
+      while (g_hash_table_iter_next(&iter, NULL, &value)) {
+         Display_Value_Cache * cache = value;
+         rpt_vstring(depth+1, "%-16s hits: %4d, misses: %4d, forced refreshes: %4d, "
+                              "not cacheable: %4d, invalidations: %d",
+                              dpath_repr_t(&cache->io_path),
+                              cache->hit_ct, cache->miss_ct, cache->refresh_ct,
+                              cache->uncacheable_ct, cache->invalidation_ct);
+      }
+   }
+   g_mutex_unlock(&value_cache_mutex);
+}
+
+
+void init_ddc_vcp_value_cache() {
+   RTTI_ADD_FUNC(ddc_get_cached_vcp_value);
+   RTTI_ADD_FUNC(ddc_save_cached_vcp_value);
+   RTTI_ADD_FUNC(ddc_invalidate_cached_vcp_values);
+   RTTI_ADD_FUNC(ddc_get_cached_table_value);
+}
@@ -0,0 +1,50 @@
+/** \file ddc_vcp_value_cache.h
+ *
+ *  Cache of non-table VCP feature values read from each display,
+ *  and of read-only table feature values by monitor model
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_VCP_VALUE_CACHE_H_
+#define DDC_VCP_VALUE_CACHE_H_
+
+/** \cond */
+#include <stdbool.h>
+/** \endcond */
+
+#include "ddcutil_types.h"
+
+#include "util/data_structures.h"
+
+#include "base/ddc_packets.h"
+#include "base/displays.h"
+
+bool ddc_enable_vcp_value_cache(bool onoff);
+bool ddc_is_vcp_value_cache_enabled();
+void ddc_set_vcp_value_cache_ttl_millisec(int millisec);
+bool ddc_get_cached_vcp_value(
+        DDCA_IO_Path                   io_path,
+        DDCA_Vcp_Feature_Code          feature_code,
+        bool                           force_refresh,
+        Parsed_Nontable_Vcp_Response * value_loc);
+void ddc_save_cached_vcp_value(
+        DDCA_IO_Path                   io_path,
+        DDCA_Vcp_Feature_Code          feature_code,
+        Parsed_Nontable_Vcp_Response * value);
+void ddc_invalidate_cached_vcp_value(DDCA_IO_Path io_path, DDCA_Vcp_Feature_Code feature_code);
+void ddc_invalidate_cached_vcp_values(DDCA_IO_Path io_path);
+Buffer * ddc_get_cached_table_value(
+        Display_Handle *               dh,
+        DDCA_Vcp_Feature_Code          feature_code,
+        bool                           force_refresh);
+void ddc_save_cached_table_value(
+        Display_Handle *               dh,
+        DDCA_Vcp_Feature_Code          feature_code,
+        Buffer *                       value);
+void ddc_reset_vcp_value_cache_stats();
+void report_vcp_value_cache_stats(int depth);
+void init_ddc_vcp_value_cache();
+
+#endif /* DDC_VCP_VALUE_CACHE_H_ */
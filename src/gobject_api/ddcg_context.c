@@ -26,6 +26,7 @@
 
 #include "ddcg_structs.h"
 #include "gobject_api/ddcg_context.h"
+#include "gobject_api/ddcg_task_pool.h"
 #include "public/ddcutil_c_api.h"
 
 
@@ -306,3 +307,117 @@ ddcg_context_create_display_ref(
    }
    return ddcg_dref;
 }
+
+
+/**
+ * ddcg_context_detect_displays:
+ * @include_invalid:  if TRUE, displays that do not support DDC are included
+ * @error: (out):     location where to return #GError if error
+ *
+ * Returns references to the detected displays.
+ *
+ * Returns: (transfer full) (element-type DdcgDisplayRef): array of #DdcgDisplayRef
+ */
+GPtrArray *
+ddcg_context_detect_displays(
+      gboolean   include_invalid,
+      GError **  error)
+{
+   g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+   DDCA_Display_Info_List * dlist = NULL;
+   DDCA_Status ddct_status = ddca_get_display_info_list2(include_invalid, &dlist);
+   if (ddct_status != 0) {
+      g_set_error(error, _ddcg_error_quark(), ddct_status,
+                  "ddca_get_display_info_list2() returned ddct_status=%d", ddct_status);
+      return NULL;
+   }
+
+   GPtrArray * drefs = g_ptr_array_new_with_free_func(g_object_unref);
+   for (int ndx = 0; ndx < dlist->ct; ndx++) {
+      DdcgDisplayRef * ddcg_dref = ddcg_display_ref_new();
+      _ddcg_display_ref_set_ddct_object(ddcg_dref, dlist->info[ndx].dref);
+      g_ptr_array_add(drefs, ddcg_dref);
+   }
+   ddca_free_display_info_list(dlist);
+   return drefs;
+}
+
+
+static void
+detect_displays_thread(
+      GTask *        task,
+      gpointer       source_object,
+      gpointer       task_data,
+      GCancellable * cancellable)
+{
+   GError * error = NULL;
+   GPtrArray * drefs = ddcg_context_detect_displays(GPOINTER_TO_INT(task_data), &error);
+   if (drefs)
+      g_task_return_pointer(task, drefs, (GDestroyNotify) g_ptr_array_unref);
+   else
+      g_task_return_error(task, error);
+}
+
+
+/**
+ * ddcg_context_detect_displays_async:
+ * @include_invalid:  if TRUE, displays that do not support DDC are included
+ * @cancellable: (nullable):  optional #GCancellable
+ * @callback: (scope async):  called in the thread default #GMainContext
+ *                            of the caller when detection completes
+ * @user_data: (closure):     data passed to @callback
+ *
+ * Performs display detection on the internal thread pool.
+ * Call ddcg_context_detect_displays_finish() from @callback
+ * to obtain the result.
+ */
+void
+ddcg_context_detect_displays_async(
+      gboolean             include_invalid,
+      GCancellable *       cancellable,
+      GAsyncReadyCallback  callback,
+      gpointer             user_data)
+{
+   GTask * task = g_task_new(NULL, cancellable, callback, user_data);
+   g_task_set_source_tag(task, ddcg_context_detect_displays_async);
+   g_task_set_task_data(task, GINT_TO_POINTER(include_invalid), NULL);
+   _ddcg_task_pool_run(task, detect_displays_thread);
+   g_object_unref(task);
+}
+
+
+/**
+ * ddcg_context_detect_displays_finish:
+ * @result:         the #GAsyncResult passed to the callback
+ * @error: (out):   location where to return #GError if error
+ *
+ * Completes ddcg_context_detect_displays_async().
+ *
+ * Returns: (transfer full) (element-type DdcgDisplayRef): array of #DdcgDisplayRef
+ */
+GPtrArray *
+ddcg_context_detect_displays_finish(
+      GAsyncResult *  result,
+      GError **       error)
+{
+   g_return_val_if_fail( g_task_is_valid(result, NULL), NULL);
+   return g_task_propagate_pointer(G_TASK(result), error);
+}
+
+
+/**
+ * ddcg_context_set_async_max_threads:
+ * @max_threads:  maximum number of threads performing _async() operations
+ *
+ * Sets the size of the thread pool used by the _async() methods.
+ * Operations on the same display handle are serialized regardless.
+ * The default is 4.
+ */
+void
+ddcg_context_set_async_max_threads(
+      gint  max_threads)
+{
+   g_return_if_fail(max_threads > 0);
+   _ddcg_task_pool_set_max_threads(max_threads);
+}
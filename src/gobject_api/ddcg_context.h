@@ -27,7 +27,7 @@
 #include <stdbool.h>
 
 #include <glib-2.0/glib-object.h>
-// #include <gio/gio.h>
+#include <gio/gio.h>
 
 #include "public/ddcutil_types.h"
 #include "public/ddcutil_c_api.h"
@@ -149,6 +149,27 @@ ddcg_context_create_display_ref(
       DdcgDisplayIdentifier * ddcg_did,
       GError **               error);
 
+GPtrArray *
+ddcg_context_detect_displays(
+      gboolean                include_invalid,
+      GError **               error);
+
+void
+ddcg_context_detect_displays_async(
+      gboolean                include_invalid,
+      GCancellable *          cancellable,
+      GAsyncReadyCallback     callback,
+      gpointer                user_data);
+
+GPtrArray *
+ddcg_context_detect_displays_finish(
+      GAsyncResult *          result,
+      GError **               error);
+
+void
+ddcg_context_set_async_max_threads(
+      gint                    max_threads);
+
 #ifdef REF
 /**
  * Returns the ddcutil version as a struct of 3 8 bit integers.
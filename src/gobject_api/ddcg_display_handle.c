@@ -22,17 +22,20 @@
  */
 
 #include <errno.h>
+#include <stdlib.h>
 
 #include "public/ddcutil_c_api.h"
 #include "base/core.h"
 #include "base/ddc_errno.h"
 
 #include "gobject_api/ddcg_gobjects.h"
+#include "gobject_api/ddcg_task_pool.h"
 
 
 typedef struct {
    // whatever
    DDCA_Display_Handle ddct_dh;
+   GMutex              io_mutex;    // serializes operations issued from multiple threads
 } DdcgDisplayHandlePrivate;
 
 
@@ -51,13 +54,13 @@ G_DEFINE_TYPE_WITH_PRIVATE(DdcgDisplayHandle, ddcg_display_handle, G_TYPE_OBJECT
 static void ddcg_display_handle_class_init(DdcgDisplayHandleClass * cls);
 static void ddcg_display_handle_init(DdcgDisplayHandle * display_handle);
 #endif
-#ifdef UNUSED
 static void ddcg_display_handle_finalize(GObject * obj);
-#endif
 
 
 static void ddcg_display_handle_class_init(DdcgDisplayHandleClass * cls) {
    DBGMSG("Starting");
+   GObjectClass * object_class = G_OBJECT_CLASS(cls);
+   object_class->finalize = ddcg_display_handle_finalize;
 }
 
 
@@ -65,13 +68,17 @@ static void ddcg_display_handle_init(DdcgDisplayHandle * ddcg_dh) {
    DBGMSG("Starting");
    // initialize the instance
    ddcg_dh->priv = ddcg_display_handle_get_instance_private(ddcg_dh);
-
+   g_mutex_init(&ddcg_dh->priv->io_mutex);
 }
 
-#ifdef UNUSED
+
+// A queued or running _async() operation holds a reference to the
+// instance through its GTask, so finalize cannot run concurrently with it.
 static void ddcg_display_handle_finalize(GObject * obj) {
+   DdcgDisplayHandle * ddcg_dh = DDCG_DISPLAY_HANDLE(obj);
+   g_mutex_clear(&ddcg_dh->priv->io_mutex);
+   G_OBJECT_CLASS(ddcg_display_handle_parent_class)->finalize(obj);
 }
-#endif
 
 DdcgDisplayHandle * ddcg_display_handle_new(void) {
    return g_object_new(DDCG_TYPE_DISPLAY_HANDLE, NULL);
@@ -142,30 +149,41 @@ ddcg_display_handle_open(DdcgDisplayRef * ddcg_dref, GError ** error) {
  * ddcg_display_handle_close:
  * @ddcg_dh:        a #DdcgDisplayHandle indicating the device to close
  *
- * Closes a device
+ * Closes a device.  Operations subsequently performed on the handle,
+ * including _async() operations already queued, fail with DDCRC_ARG.
  *
- * Returns:  status code
+ * Returns:  status code, DDCRC_ARG if the handle is already closed
  */
 DdcgStatusCode
 ddcg_display_handle_close(DdcgDisplayHandle * ddcg_dh) {
-   DDCA_Status ddct_status  = ddca_close_display(ddcg_dh->priv->ddct_dh);
+   DDCA_Status ddct_status = DDCRC_ARG;
+   g_mutex_lock(&ddcg_dh->priv->io_mutex);
+   if (ddcg_dh->priv->ddct_dh) {
+      ddct_status = ddca_close_display(ddcg_dh->priv->ddct_dh);
+      ddcg_dh->priv->ddct_dh = NULL;
+   }
+   g_mutex_unlock(&ddcg_dh->priv->io_mutex);
    DdcgStatusCode ddcg_status = ddct_status;     // TODO: replace with function
    return ddcg_status;
 }
 
 
-/**
- * ddcg_display_handle_get_nontable_vcp_value:
- * @ddcg_dh:        a #DdcgDisplayHandle indicating the current instance
- * @feature_code:    VCP feature code
- * @error: (out):   location where to return pointer  #GEerror if error
- *
- * Retrieve a raw non-table VCP feature value
- *
- * Returns:  (transfer full): point to #DdcgContRespose
- */
-DdcgContResponse *
-ddcg_display_handle_get_nontable_vcp_value(
+// Checks that the display handle has not been closed, setting a GError if
+// it has.  Must be called with io_mutex held.
+static gboolean
+check_handle_open(DdcgDisplayHandle * ddcg_dh, GError ** error) {
+   if (!ddcg_dh->priv->ddct_dh) {
+      g_set_error(error, _ddcg_error_quark(), DDCRC_ARG, "Display handle is closed");
+      return FALSE;
+   }
+   return TRUE;
+}
+
+
+// Performs the actual read.  Called from both the synchronous and
+// asynchronous variants.
+static DdcgContResponse *
+get_nontable_vcp_value_locked(
                DdcgDisplayHandle *  ddcg_dh,
                DdcgFeatureCode      feature_code,
                GError **            error)
@@ -173,10 +191,16 @@ ddcg_display_handle_get_nontable_vcp_value(
    DdcgContResponse * ddcg_response = NULL;
    DDCA_Non_Table_Vcp_Value  ddct_response;
 
+   g_mutex_lock(&ddcg_dh->priv->io_mutex);
+   if (!check_handle_open(ddcg_dh, error)) {
+      g_mutex_unlock(&ddcg_dh->priv->io_mutex);
+      return NULL;
+   }
    DDCA_Status ddct_status =  ddca_get_non_table_vcp_value(
                   ddcg_dh->priv->ddct_dh,
                   feature_code,
                   &ddct_response);
+   g_mutex_unlock(&ddcg_dh->priv->io_mutex);
    // DBGMSG("ddct_status = %d", ddct_status);
    if (ddct_status == 0) {
       // allocate a new DdcgContResponse instance
@@ -201,8 +225,8 @@ ddcg_display_handle_get_nontable_vcp_value(
       // ddcg_cont_response_report(ddcg_response, 1);
    }
    else {
-      GQuark domain = g_quark_from_string("DDCTOOL_DDCG");
-      g_set_error(error,  domain, ddct_status, "ddct_get_nontable_vcp_value() returned ddct_status=%d", ddct_status);
+      g_set_error(error, _ddcg_error_quark(), ddct_status,
+                  "ddca_get_non_table_vcp_value() returned ddct_status=%d", ddct_status);
    }
 
    // DBGMSG("Returning ddcg_response=%p", ddcg_response);
@@ -210,6 +234,343 @@ ddcg_display_handle_get_nontable_vcp_value(
 }
 
 
+/**
+ * ddcg_display_handle_get_nontable_vcp_value:
+ * @ddcg_dh:        a #DdcgDisplayHandle indicating the current instance
+ * @feature_code:    VCP feature code
+ * @error: (out):   location where to return pointer  #GEerror if error
+ *
+ * Retrieve a raw non-table VCP feature value
+ *
+ * Returns:  (transfer full): point to #DdcgContRespose
+ */
+DdcgContResponse *
+ddcg_display_handle_get_nontable_vcp_value(
+               DdcgDisplayHandle *  ddcg_dh,
+               DdcgFeatureCode      feature_code,
+               GError **            error)
+{
+   g_return_val_if_fail( DDCG_IS_DISPLAY_HANDLE(ddcg_dh), NULL);
+   return get_nontable_vcp_value_locked(ddcg_dh, feature_code, error);
+}
+
+
+static void
+get_nontable_vcp_value_thread(
+      GTask *        task,
+      gpointer       source_object,
+      gpointer       task_data,
+      GCancellable * cancellable)
+{
+   GError * error = NULL;
+   DdcgFeatureCode feature_code = GPOINTER_TO_UINT(task_data);
+   DdcgContResponse * ddcg_response =
+         get_nontable_vcp_value_locked(DDCG_DISPLAY_HANDLE(source_object), feature_code, &error);
+   if (ddcg_response)
+      g_task_return_pointer(task, ddcg_response, g_object_unref);
+   else
+      g_task_return_error(task, error);
+}
+
+
+/**
+ * ddcg_display_handle_get_nontable_vcp_value_async:
+ * @ddcg_dh:        a #DdcgDisplayHandle indicating the current instance
+ * @feature_code:   VCP feature code
+ * @cancellable: (nullable):  optional #GCancellable
+ * @callback: (scope async):  called in the thread default #GMainContext
+ *                            of the caller when the operation completes
+ * @user_data: (closure):     data passed to @callback
+ *
+ * Asynchronously retrieves a raw non-table VCP feature value.
+ * The DDC exchange is performed on an internal thread pool.
+ * Call ddcg_display_handle_get_nontable_vcp_value_finish() from @callback
+ * to obtain the result.
+ */
+void
+ddcg_display_handle_get_nontable_vcp_value_async(
+      DdcgDisplayHandle *  ddcg_dh,
+      DdcgFeatureCode      feature_code,
+      GCancellable *       cancellable,
+      GAsyncReadyCallback  callback,
+      gpointer             user_data)
+{
+   g_return_if_fail( DDCG_IS_DISPLAY_HANDLE(ddcg_dh) );
+
+   GTask * task = g_task_new(ddcg_dh, cancellable, callback, user_data);
+   g_task_set_source_tag(task, ddcg_display_handle_get_nontable_vcp_value_async);
+   g_task_set_task_data(task, GUINT_TO_POINTER(feature_code), NULL);
+   _ddcg_task_pool_run(task, get_nontable_vcp_value_thread);
+   g_object_unref(task);
+}
+
+
+/**
+ * ddcg_display_handle_get_nontable_vcp_value_finish:
+ * @ddcg_dh:        a #DdcgDisplayHandle indicating the current instance
+ * @result:         the #GAsyncResult passed to the callback
+ * @error: (out):   location where to return #GError if error
+ *
+ * Completes ddcg_display_handle_get_nontable_vcp_value_async().
+ *
+ * Returns:  (transfer full): pointer to #DdcgContResponse, NULL if error
+ */
+DdcgContResponse *
+ddcg_display_handle_get_nontable_vcp_value_finish(
+      DdcgDisplayHandle *  ddcg_dh,
+      GAsyncResult *       result,
+      GError **            error)
+{
+   g_return_val_if_fail( g_task_is_valid(result, ddcg_dh), NULL);
+   return g_task_propagate_pointer(G_TASK(result), error);
+}
+
+
+// Performs the actual write.  Called from both the synchronous and
+// asynchronous variants.
+static gboolean
+set_nontable_vcp_value_locked(
+      DdcgDisplayHandle *  ddcg_dh,
+      DdcgFeatureCode      feature_code,
+      guint8               hi_byte,
+      guint8               lo_byte,
+      GError **            error)
+{
+   g_mutex_lock(&ddcg_dh->priv->io_mutex);
+   if (!check_handle_open(ddcg_dh, error)) {
+      g_mutex_unlock(&ddcg_dh->priv->io_mutex);
+      return FALSE;
+   }
+   DDCA_Status ddct_status = ddca_set_non_table_vcp_value(
+                  ddcg_dh->priv->ddct_dh,
+                  feature_code,
+                  hi_byte,
+                  lo_byte);
+   g_mutex_unlock(&ddcg_dh->priv->io_mutex);
+   if (ddct_status != 0) {
+      g_set_error(error, _ddcg_error_quark(), ddct_status,
+                  "ddca_set_non_table_vcp_value() returned ddct_status=%d", ddct_status);
+   }
+   return (ddct_status == 0);
+}
+
+
+/**
+ * ddcg_display_handle_set_nontable_vcp_value:
+ * @ddcg_dh:        a #DdcgDisplayHandle indicating the current instance
+ * @feature_code:   VCP feature code
+ * @hi_byte:        high byte of new value
+ * @lo_byte:        low byte of new value
+ * @error: (out):   location where to return #GError if error
+ *
+ * Sets a non-table VCP feature value
+ *
+ * Returns:  TRUE if success, FALSE if error
+ */
+gboolean
+ddcg_display_handle_set_nontable_vcp_value(
+      DdcgDisplayHandle *  ddcg_dh,
+      DdcgFeatureCode      feature_code,
+      guint8               hi_byte,
+      guint8               lo_byte,
+      GError **            error)
+{
+   g_return_val_if_fail( DDCG_IS_DISPLAY_HANDLE(ddcg_dh), FALSE);
+   return set_nontable_vcp_value_locked(ddcg_dh, feature_code, hi_byte, lo_byte, error);
+}
+
+
+static void
+set_nontable_vcp_value_thread(
+      GTask *        task,
+      gpointer       source_object,
+      gpointer       task_data,
+      GCancellable * cancellable)
+{
+   GError * error = NULL;
+   guint32 packed = GPOINTER_TO_UINT(task_data);     // feature code, hi byte, lo byte
+   gboolean ok = set_nontable_vcp_value_locked(
+                    DDCG_DISPLAY_HANDLE(source_object),
+                    (packed >> 16) & 0xff,
+                    (packed >>  8) & 0xff,
+                    packed & 0xff,
+                    &error);
+   if (ok)
+      g_task_return_boolean(task, TRUE);
+   else
+      g_task_return_error(task, error);
+}
+
+
+/**
+ * ddcg_display_handle_set_nontable_vcp_value_async:
+ * @ddcg_dh:        a #DdcgDisplayHandle indicating the current instance
+ * @feature_code:   VCP feature code
+ * @hi_byte:        high byte of new value
+ * @lo_byte:        low byte of new value
+ * @cancellable: (nullable):  optional #GCancellable
+ * @callback: (scope async):  called in the thread default #GMainContext
+ *                            of the caller when the operation completes
+ * @user_data: (closure):     data passed to @callback
+ *
+ * Asynchronously sets a non-table VCP feature value.
+ * Call ddcg_display_handle_set_nontable_vcp_value_finish() from @callback
+ * to obtain the result.
+ */
+void
+ddcg_display_handle_set_nontable_vcp_value_async(
+      DdcgDisplayHandle *  ddcg_dh,
+      DdcgFeatureCode      feature_code,
+      guint8               hi_byte,
+      guint8               lo_byte,
+      GCancellable *       cancellable,
+      GAsyncReadyCallback  callback,
+      gpointer             user_data)
+{
+   g_return_if_fail( DDCG_IS_DISPLAY_HANDLE(ddcg_dh) );
+
+   guint32 packed = feature_code << 16 | hi_byte << 8 | lo_byte;
+   GTask * task = g_task_new(ddcg_dh, cancellable, callback, user_data);
+   g_task_set_source_tag(task, ddcg_display_handle_set_nontable_vcp_value_async);
+   g_task_set_task_data(task, GUINT_TO_POINTER(packed), NULL);
+   _ddcg_task_pool_run(task, set_nontable_vcp_value_thread);
+   g_object_unref(task);
+}
+
+
+/**
+ * ddcg_display_handle_set_nontable_vcp_value_finish:
+ * @ddcg_dh:        a #DdcgDisplayHandle indicating the current instance
+ * @result:         the #GAsyncResult passed to the callback
+ * @error: (out):   location where to return #GError if error
+ *
+ * Completes ddcg_display_handle_set_nontable_vcp_value_async().
+ *
+ * Returns:  TRUE if success, FALSE if error
+ */
+gboolean
+ddcg_display_handle_set_nontable_vcp_value_finish(
+      DdcgDisplayHandle *  ddcg_dh,
+      GAsyncResult *       result,
+      GError **            error)
+{
+   g_return_val_if_fail( g_task_is_valid(result, ddcg_dh), FALSE);
+   return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+
+// Performs the actual capabilities read.  Called from both the synchronous
+// and asynchronous variants.
+static gchar *
+get_capabilities_string_locked(
+      DdcgDisplayHandle *  ddcg_dh,
+      GError **            error)
+{
+   char * caps = NULL;
+   g_mutex_lock(&ddcg_dh->priv->io_mutex);
+   if (!check_handle_open(ddcg_dh, error)) {
+      g_mutex_unlock(&ddcg_dh->priv->io_mutex);
+      return NULL;
+   }
+   DDCA_Status ddct_status = ddca_get_capabilities_string(ddcg_dh->priv->ddct_dh, &caps);
+   g_mutex_unlock(&ddcg_dh->priv->io_mutex);
+   gchar * result = NULL;
+   if (ddct_status == 0) {
+      result = g_strdup(caps);
+      free(caps);
+   }
+   else {
+      g_set_error(error, _ddcg_error_quark(), ddct_status,
+                  "ddca_get_capabilities_string() returned ddct_status=%d", ddct_status);
+   }
+   return result;
+}
+
+
+/**
+ * ddcg_display_handle_get_capabilities_string:
+ * @ddcg_dh:        a #DdcgDisplayHandle indicating the current instance
+ * @error: (out):   location where to return #GError if error
+ *
+ * Retrieves the display's capabilities string.
+ *
+ * Returns:  (transfer full): capabilities string, NULL if error
+ */
+gchar *
+ddcg_display_handle_get_capabilities_string(
+      DdcgDisplayHandle *  ddcg_dh,
+      GError **            error)
+{
+   g_return_val_if_fail( DDCG_IS_DISPLAY_HANDLE(ddcg_dh), NULL);
+   return get_capabilities_string_locked(ddcg_dh, error);
+}
+
+
+static void
+get_capabilities_string_thread(
+      GTask *        task,
+      gpointer       source_object,
+      gpointer       task_data,
+      GCancellable * cancellable)
+{
+   GError * error = NULL;
+   gchar * caps = get_capabilities_string_locked(DDCG_DISPLAY_HANDLE(source_object), &error);
+   if (caps)
+      g_task_return_pointer(task, caps, g_free);
+   else
+      g_task_return_error(task, error);
+}
+
+
+/**
+ * ddcg_display_handle_get_capabilities_string_async:
+ * @ddcg_dh:        a #DdcgDisplayHandle indicating the current instance
+ * @cancellable: (nullable):  optional #GCancellable
+ * @callback: (scope async):  called in the thread default #GMainContext
+ *                            of the caller when the operation completes
+ * @user_data: (closure):     data passed to @callback
+ *
+ * Asynchronously retrieves the display's capabilities string.
+ * Call ddcg_display_handle_get_capabilities_string_finish() from @callback
+ * to obtain the result.
+ */
+void
+ddcg_display_handle_get_capabilities_string_async(
+      DdcgDisplayHandle *  ddcg_dh,
+      GCancellable *       cancellable,
+      GAsyncReadyCallback  callback,
+      gpointer             user_data)
+{
+   g_return_if_fail( DDCG_IS_DISPLAY_HANDLE(ddcg_dh) );
+
+   GTask * task = g_task_new(ddcg_dh, cancellable, callback, user_data);
+   g_task_set_source_tag(task, ddcg_display_handle_get_capabilities_string_async);
+   _ddcg_task_pool_run(task, get_capabilities_string_thread);
+   g_object_unref(task);
+}
+
+
+/**
+ * ddcg_display_handle_get_capabilities_string_finish:
+ * @ddcg_dh:        a #DdcgDisplayHandle indicating the current instance
+ * @result:         the #GAsyncResult passed to the callback
+ * @error: (out):   location where to return #GError if error
+ *
+ * Completes ddcg_display_handle_get_capabilities_string_async().
+ *
+ * Returns:  (transfer full): capabilities string, NULL if error
+ */
+gchar *
+ddcg_display_handle_get_capabilities_string_finish(
+      DdcgDisplayHandle *  ddcg_dh,
+      GAsyncResult *       result,
+      GError **            error)
+{
+   g_return_val_if_fail( g_task_is_valid(result, ddcg_dh), NULL);
+   return g_task_propagate_pointer(G_TASK(result), error);
+}
+
+
 /**
  * ddcg_display_handle_repr:
  * @ddcg_dh:        a #DdcgDisplayHandle indicating the current instance
@@ -27,6 +27,7 @@
 
 #include <glib-object.h>
 // #include <glib-2.0/glib-object.h>   // make eclipse happy
+#include <gio/gio.h>
 
 #include "gobject_api/ddcg_types.h"
 
@@ -61,6 +62,62 @@ ddcg_display_handle_get_nontable_vcp_value(
       DdcgFeatureCode      feature_code,
       GError **            error);
 
+void
+ddcg_display_handle_get_nontable_vcp_value_async(
+      DdcgDisplayHandle *  ddcg_dh,
+      DdcgFeatureCode      feature_code,
+      GCancellable *       cancellable,
+      GAsyncReadyCallback  callback,
+      gpointer             user_data);
+
+DdcgContResponse *
+ddcg_display_handle_get_nontable_vcp_value_finish(
+      DdcgDisplayHandle *  ddcg_dh,
+      GAsyncResult *       result,
+      GError **            error);
+
+gboolean
+ddcg_display_handle_set_nontable_vcp_value(
+      DdcgDisplayHandle *  ddcg_dh,
+      DdcgFeatureCode      feature_code,
+      guint8               hi_byte,
+      guint8               lo_byte,
+      GError **            error);
+
+void
+ddcg_display_handle_set_nontable_vcp_value_async(
+      DdcgDisplayHandle *  ddcg_dh,
+      DdcgFeatureCode      feature_code,
+      guint8               hi_byte,
+      guint8               lo_byte,
+      GCancellable *       cancellable,
+      GAsyncReadyCallback  callback,
+      gpointer             user_data);
+
+gboolean
+ddcg_display_handle_set_nontable_vcp_value_finish(
+      DdcgDisplayHandle *  ddcg_dh,
+      GAsyncResult *       result,
+      GError **            error);
+
+gchar *
+ddcg_display_handle_get_capabilities_string(
+      DdcgDisplayHandle *  ddcg_dh,
+      GError **            error);
+
+void
+ddcg_display_handle_get_capabilities_string_async(
+      DdcgDisplayHandle *  ddcg_dh,
+      GCancellable *       cancellable,
+      GAsyncReadyCallback  callback,
+      gpointer             user_data);
+
+gchar *
+ddcg_display_handle_get_capabilities_string_finish(
+      DdcgDisplayHandle *  ddcg_dh,
+      GAsyncResult *       result,
+      GError **            error);
+
 gchar *
 ddcg_display_handle_repr(
       DdcgDisplayHandle *  ddcg_dh,
@@ -0,0 +1,138 @@
+/* ddcg_task_pool.c
+ *
+ * <copyright>
+ * Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ * </endcopyright>
+ */
+
+/* DDC operations block for the full DDC round trip, which may be seconds
+ * for a capabilities read.  The _async() methods of the GObject API run the
+ * blocking operation on a thread from the pool managed here.  The result is
+ * returned using g_task_return_*(), which dispatches the callback in the
+ * GMainContext that was the thread default when the GTask was created,
+ * i.e. the caller's context.
+ *
+ * A private pool is used rather than g_task_run_in_thread() so that the
+ * number of threads simultaneously performing DDC I/O is bounded
+ * independently of GIO's shared pool.
+ */
+
+#include <assert.h>
+
+#include "base/core.h"
+
+#include "gobject_api/ddcg_task_pool.h"
+
+
+typedef struct {
+   GTask *          task;
+   GTaskThreadFunc  task_func;
+} Ddcg_Pool_Item;
+
+
+static GThreadPool * task_pool = NULL;
+static gint          task_pool_max_threads = DDCG_TASK_POOL_DEFAULT_MAX_THREADS;
+G_LOCK_DEFINE_STATIC(task_pool_lock);
+
+
+static void
+task_pool_worker(gpointer data, gpointer user_data) {
+   Ddcg_Pool_Item * item = data;
+   GTask * task = item->task;
+
+   // honor cancellation that occurred while the item was queued
+   if (!g_task_return_error_if_cancelled(task)) {
+      item->task_func(task,
+                      g_task_get_source_object(task),
+                      g_task_get_task_data(task),
+                      g_task_get_cancellable(task));
+   }
+
+   g_object_unref(task);
+   g_free(item);
+}
+
+
+static GThreadPool *
+get_task_pool(void) {
+   G_LOCK(task_pool_lock);
+   if (!task_pool) {
+      GError * error = NULL;
+      task_pool = g_thread_pool_new(
+                     task_pool_worker,
+                     NULL,                   // user_data
+                     task_pool_max_threads,
+                     FALSE,                  // exclusive, threads created as needed
+                     &error);
+      if (error) {
+         // only possible when exclusive
+         SEVEREMSG("g_thread_pool_new() failed: %s", error->message);
+         g_error_free(error);
+      }
+   }
+   G_UNLOCK(task_pool_lock);
+   return task_pool;
+}
+
+
+/* Queues a task for execution on the DDC thread pool.
+ *
+ * @task:       task, a reference is taken for the duration of the operation
+ * @task_func:  blocking function to execute, which must complete the task
+ *              using g_task_return_*()
+ */
+void
+_ddcg_task_pool_run(GTask * task, GTaskThreadFunc task_func) {
+   Ddcg_Pool_Item * item = g_new0(Ddcg_Pool_Item, 1);
+   item->task      = g_object_ref(task);
+   item->task_func = task_func;
+
+   GError * error = NULL;
+   g_thread_pool_push(get_task_pool(), item, &error);
+   if (error) {
+      g_task_return_error(task, error);
+      g_object_unref(item->task);
+      g_free(item);
+   }
+}
+
+
+/* Sets the maximum number of threads performing DDC operations
+ * on behalf of _async() methods.
+ *
+ * @max_threads: maximum number of threads, must be > 0
+ */
+void
+_ddcg_task_pool_set_max_threads(gint max_threads) {
+   g_return_if_fail(max_threads > 0);
+
+   G_LOCK(task_pool_lock);
+   task_pool_max_threads = max_threads;
+   if (task_pool)
+      g_thread_pool_set_max_threads(task_pool, max_threads, NULL);
+   G_UNLOCK(task_pool_lock);
+}
+
+
+/* Error domain used for GErrors returned by the GObject API.
+ */
+GQuark
+_ddcg_error_quark(void) {
+   return g_quark_from_static_string("DDCTOOL_DDCG");
+}
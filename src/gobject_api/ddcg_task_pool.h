@@ -0,0 +1,51 @@
+/* ddcg_task_pool.h
+ *
+ * <copyright>
+ * Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ * </endcopyright>
+ */
+
+/* Bounded thread pool on which the blocking halves of the _async() methods
+ * execute.  Not part of the introspected API.
+ */
+
+#ifndef DDCG_TASK_POOL_H_
+#define DDCG_TASK_POOL_H_
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define DDCG_TASK_POOL_DEFAULT_MAX_THREADS  4
+
+void
+_ddcg_task_pool_run(
+      GTask *          task,
+      GTaskThreadFunc  task_func);
+
+void
+_ddcg_task_pool_set_max_threads(
+      gint             max_threads);
+
+GQuark
+_ddcg_error_quark(void);
+
+G_END_DECLS
+
+#endif /* DDCG_TASK_POOL_H_ */
@@ -12,7 +12,9 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <glib-2.0/glib.h>
+#include <i2c/i2c_read_deadline.h>
 #include <i2c/i2c_strategy_dispatcher.h>
+#include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/ioctl.h>
@@ -33,6 +35,7 @@
 #include "util/subprocess_util.h"
 #include "util/sysfs_i2c_util.h"
 #include "util/sysfs_util.h"
+#include "util/timestamp.h"
 #ifdef ENABLE_UDEV
 #include "util/udev_i2c_util.h"
 #endif
@@ -76,6 +79,9 @@ bool i2c_force_slave_addr_flag = false;
 
 bool i2c_force_bus = false;
 
+// Probe buses in parallel if at least this many buses
+static int bus_check_async_threshold = I2C_BUS_CHECK_ASYNC_THRESHOLD_DEFAULT;
+
 //
 // Basic I2C bus operations
 //
@@ -115,6 +121,8 @@ int i2c_open_bus(int busno, Byte callopts) {
    else {
       RECORD_IO_FINISH_NOW(fd, IE_OPEN);
       ptd_append_thread_description(filename);
+      i2c_strategy_register_fd(fd, busno);
+      i2c_apply_read_deadline(fd);
    }
 
    DBGTRC(debug, TRACE_GROUP, "Done.     busno=%d, Returning file descriptor: %d", busno, fd);
@@ -139,6 +147,7 @@ Status_Errno i2c_close_bus(int fd, Call_Options callopts) {
    Status_Errno result = 0;
    int rc = 0;
 
+   i2c_strategy_unregister_fd(fd);
    RECORD_IO_EVENTX(fd, IE_CLOSE, ( rc = close(fd) ) );
    assert( rc == 0 || rc == -1);   // per documentation
    int errsv = errno;
@@ -649,7 +658,7 @@ i2c_get_parsed_edid_by_fd(int fd, Parsed_Edid ** edid_ptr_loc)
  * @param busno I2C bus number
  * @return newly allocated #I2C_Bus_Info
  */
-static I2C_Bus_Info * i2c_new_bus_info(int busno) {
+I2C_Bus_Info * i2c_new_bus_info(int busno) {
    I2C_Bus_Info * businfo = calloc(1, sizeof(I2C_Bus_Info));
    memcpy(businfo->marker, I2C_BUS_INFO_MARKER, 4);
    businfo->busno = busno;
@@ -735,6 +744,7 @@ void i2c_check_bus(I2C_Bus_Info * bus_info) {
 
    if (!(bus_info->flags & I2C_BUS_PROBED)) {
       DBGMSF(debug, "Probing");
+      uint64_t probe_start = cur_realtime_nanosec();
       bus_info->flags |= I2C_BUS_PROBED;
       int fd = i2c_open_bus(bus_info->busno, CALLOPT_ERR_MSG);
       if (fd >= 0) {
@@ -762,6 +772,7 @@ void i2c_check_bus(I2C_Bus_Info * bus_info) {
           }
           i2c_close_bus(fd, CALLOPT_ERR_MSG);
       }
+      bus_info->probe_nanosec = cur_realtime_nanosec() - probe_start;
    }   // probing complete
 
    // DBGTRC(debug, TRACE_GROUP, "Done. flags=0x%02x", bus_info->flags );
@@ -825,6 +836,7 @@ void i2c_dbgrpt_bus_info(I2C_Bus_Info * bus_info, int depth) {
 #endif
       rpt_vstring(depth, "Address 0x37 present:    %s", sbool(bus_info->flags & I2C_BUS_ADDR_0X37));
       rpt_vstring(depth, "Address 0x50 present:    %s", sbool(bus_info->flags & I2C_BUS_ADDR_0X50));
+      rpt_vstring(depth, "Probe time (millisec):   %"PRIu64, bus_info->probe_nanosec/(1000*1000));
       // not useful and clutters the output
       // i2c_report_functionality_flags(bus_info->functionality, /* maxline */ 90, depth);
       if ( bus_info->flags & I2C_BUS_ADDR_0X50) {
@@ -975,30 +987,99 @@ Byte_Value_Array get_i2c_devices_by_existence_test() {
 }
 
 
+/** Sets the minimum number of I2C buses for which #i2c_detect_buses()
+ *  probes the buses in parallel.
+ *
+ *  @param threshold  bus count, I2C_BUS_CHECK_ASYNC_NEVER to always probe serially
+ */
+void i2c_set_bus_check_async_threshold(int threshold) {
+   bus_check_async_threshold = threshold;
+}
+
+
+// GFunc signature for GThreadPool
+static void threaded_check_bus(gpointer data, gpointer user_data) {
+   bool debug = false;
+   I2C_Bus_Info * businfo = data;
+   DBGTRC(debug, TRACE_GROUP, "Starting. busno=%d", businfo->busno);
+   i2c_check_bus(businfo);
+   DBGTRC(debug, TRACE_GROUP, "Done.     busno=%d", businfo->busno);
+}
+
+
+/** Probes each I2C bus on a bounded pool of threads.
+ *
+ *  Each thread fills in an #I2C_Bus_Info that has already been placed in
+ *  its final position, so the order of the buses does not depend on the
+ *  order in which probes complete.
+ *
+ *  @param  buses  #GPtrArray of #I2C_Bus_Info to probe
+ */
+static void i2c_async_check_buses(GPtrArray * buses) {
+   bool debug = false;
+   int max_threads = MIN(buses->len, I2C_BUS_CHECK_MAX_THREADS);
+   DBGTRC(debug, TRACE_GROUP, "Starting. bus count=%d, max_threads=%d", buses->len, max_threads);
+
+   GError * error = NULL;
+   GThreadPool * pool = g_thread_pool_new(threaded_check_bus, NULL, max_threads, true, &error);
+   if (!pool) {
+      DBGMSG("g_thread_pool_new() failed: %s. Probing serially.", error->message);
+      g_error_free(error);
+      for (int ndx = 0; ndx < buses->len; ndx++)
+         i2c_check_bus(g_ptr_array_index(buses, ndx));
+   }
+   else {
+      for (int ndx = 0; ndx < buses->len; ndx++)
+         g_thread_pool_push(pool, g_ptr_array_index(buses, ndx), NULL);
+      g_thread_pool_free(pool, false, /* wait */ true);
+   }
+   DBGTRC(debug, TRACE_GROUP, "Done");
+}
+
+
+/** Detects and probes all I2C buses, creating the internal array of
+ *  #I2C_Bus_Info.  If there are at least as many buses as the threshold
+ *  set by #i2c_set_bus_check_async_threshold(), buses are probed in parallel.
+ *
+ *  @return number of buses
+ */
 int i2c_detect_buses() {
    bool debug = false;
    DBGTRC(debug, DDCA_TRC_I2C, "Starting.  i2c_buses = %p", i2c_buses);
    if (!i2c_buses) {
+      uint64_t start_time = cur_realtime_nanosec();
       // only returns buses with valid name (arg=false)
 #ifdef ENABLE_UDEV
       Byte_Value_Array i2c_bus_bva = get_i2c_device_numbers_using_udev(false);
 #else
       Byte_Value_Array i2c_bus_bva = get_i2c_devices_by_existence_test();
 #endif
-      i2c_buses = g_ptr_array_sized_new(bva_length(i2c_bus_bva));
-      g_ptr_array_set_free_func(i2c_buses, i2c_free_bus_info_gdestroy);
+      GPtrArray * buses = g_ptr_array_sized_new(bva_length(i2c_bus_bva));
+      g_ptr_array_set_free_func(buses, i2c_free_bus_info_gdestroy);
       for (int ndx = 0; ndx < bva_length(i2c_bus_bva); ndx++) {
          int busno = bva_get(i2c_bus_bva, ndx);
-         DBGMSF(debug, "Checking busno = %d", busno);
          I2C_Bus_Info * businfo = i2c_new_bus_info(busno);
          businfo->flags = I2C_BUS_EXISTS | I2C_BUS_VALID_NAME_CHECKED | I2C_BUS_HAS_VALID_NAME;
-         i2c_check_bus(businfo);
-         // if (debug || IS_TRACING() )
-         //    i2c_dbgrpt_bus_info(businfo, 0);
-         DBGMSF(debug, "Valid bus: /dev/"I2C"-%d", busno);
-         g_ptr_array_add(i2c_buses, businfo);
+         g_ptr_array_add(buses, businfo);
       }
       bva_free(i2c_bus_bva);
+
+      DBGMSF(debug, "bus count=%d, bus_check_async_threshold=%d",
+                    buses->len, bus_check_async_threshold);
+      if (buses->len >= bus_check_async_threshold)
+         i2c_async_check_buses(buses);
+      else {
+         for (int ndx = 0; ndx < buses->len; ndx++) {
+            I2C_Bus_Info * businfo = g_ptr_array_index(buses, ndx);
+            DBGMSF(debug, "Checking busno = %d", businfo->busno);
+            i2c_check_bus(businfo);
+         }
+      }
+
+      // set only after all probes complete, since other threads examine i2c_buses
+      i2c_buses = buses;
+      DBGTRC(debug, DDCA_TRC_I2C, "Probed %d buses in %"PRIu64" millisec",
+                                  buses->len, (cur_realtime_nanosec() - start_time)/(1000*1000));
    }
    int result = i2c_buses->len;
    DBGTRC(debug, DDCA_TRC_I2C, "Returning: %d", result);
@@ -1218,6 +1299,8 @@ static void init_i2c_bus_core_func_name_table() {
    RTTI_ADD_FUNC(i2c_get_edid_bytes_using_i2c_layer);
    RTTI_ADD_FUNC(i2c_get_edid_bytes_directly);
    RTTI_ADD_FUNC(i2c_detect_buses);
+   RTTI_ADD_FUNC(i2c_async_check_buses);
+   RTTI_ADD_FUNC(threaded_check_bus);
    RTTI_ADD_FUNC(i2c_detect_single_bus);
    RTTI_ADD_FUNC(i2c_get_raw_edid_by_fd);
    RTTI_ADD_FUNC(i2c_get_parsed_edid_by_fd);
@@ -1227,5 +1310,7 @@ static void init_i2c_bus_core_func_name_table() {
 void init_i2c_bus_core() {
    init_i2c_bus_core_func_name_table();
    init_i2c_execute_func_name_table();
+   init_i2c_strategy_dispatcher();
+   init_i2c_read_deadline();
 }
 
@@ -70,6 +70,7 @@ struct {
    unsigned long    functionality;      ///< i2c bus functionality flags
    Parsed_Edid *    edid;               ///< parsed EDID, if slave address x50 active
    uint16_t         flags;              ///< I2C_BUS_* flags
+   uint64_t         probe_nanosec;      ///< elapsed time of bus probe
 } I2C_Bus_Info;
 
 void i2c_dbgrpt_bus_info(I2C_Bus_Info * bus_info, int depth);
@@ -81,10 +82,13 @@ int  i2c_device_count();           // simple /dev/i2c-n count, no side effects
 Byte_Value_Array get_i2c_devices_by_existence_test();
 
 // Bus inventory - detect and probe buses
+void i2c_set_bus_check_async_threshold(int threshold);
 int i2c_detect_buses();            // creates internal array of Bus_Info for I2C buses
 void i2c_discard_buses();
 I2C_Bus_Info * i2c_detect_single_bus(int busno);
+I2C_Bus_Info * i2c_new_bus_info(int busno);
 void i2c_free_bus_info(I2C_Bus_Info * bus_info);
+void i2c_free_bus_info_gdestroy(gpointer data);
 
 // Simple Bus_Info retrieval
 I2C_Bus_Info * i2c_get_bus_info_by_index(int busndx);
@@ -0,0 +1,227 @@
+/** \file i2c_read_deadline.c
+ *
+ *  Per bus read deadlines derived from observed DDC read times.
+ *
+ *  A DDC read normally completes in a few milliseconds, but a hung monitor
+ *  can stall a read for the full I2C adapter timeout.  For each bus the
+ *  times of recent successful reads are recorded, and the deadline is a
+ *  multiple of their 90th percentile, within limits.  Reads exceeding the
+ *  deadline are counted and reported.
+ *
+ *  A read that the driver reports as timed out, or that fails after
+ *  exceeding an explicitly configured deadline, is classified as
+ *  DDCRC_STALLED, which the retry logic does not retry repeatedly.  Other
+ *  failed reads, even if slow, keep their status code and retry budget.
+ *
+ *  A file descriptor for /dev/i2c-N does not support poll(), and an I2C
+ *  transfer in progress cannot be interrupted.  If a deadline is configured
+ *  explicitly, it is therefore also set as the I2C adapter timeout using
+ *  ioctl(I2C_TIMEOUT), so that the driver abandons the transfer.
+ */
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/** \cond */
+#include <assert.h>
+#include <errno.h>
+#include <glib-2.0/glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+/** \endcond */
+
+#include "util/report_util.h"
+
+#include "base/core.h"
+#include "base/ddc_errno.h"
+#include "base/parms.h"
+#include "base/rtti.h"
+
+#ifdef TARGET_BSD
+#include "bsd/i2c-dev.h"
+#else
+#include "i2c/wrap_i2c-dev.h"
+#endif
+
+#include "i2c/i2c_read_deadline.h"
+
+
+// Trace class for this file
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_I2C;
+
+#define READ_TIME_SAMPLE_CT 32      ///< number of recent read times kept per bus
+
+/** Read time history for one I2C bus */
+typedef struct {
+   int       busno;
+   uint32_t  read_microsec[READ_TIME_SAMPLE_CT];   ///< ring of successful read times
+   int       next_ndx;
+   int       sample_ct;
+   int       deadline_millisec;      ///< current deadline
+   int       late_ct;                ///< reads exceeding the deadline
+   int       stalled_ct;             ///< reads classified as DDCRC_STALLED
+} Read_Deadline_Rec;
+
+static int          configured_deadline_millisec = 0;   // 0 = not configured
+static GHashTable * deadlines_by_busno = NULL;          // busno -> Read_Deadline_Rec *
+static GMutex       deadlines_mutex;
+
+
+static int max_deadline_millisec() {
+   return (configured_deadline_millisec > 0) ? configured_deadline_millisec
+                                             : I2C_READ_DEADLINE_MILLISEC_DEFAULT;
+}
+
+
+/** Sets the maximum read deadline.  If set, it is also applied to the
+ *  I2C adapter when a bus is opened.
+ *
+ *  \param  millisec  deadline in milliseconds, 0 to use the default
+ */
+void i2c_set_read_deadline_millisec(int millisec) {
+   assert(millisec >= 0);
+   configured_deadline_millisec = millisec;
+}
+
+
+/** Applies the configured read deadline as the I2C adapter timeout.
+ *  Does nothing if no deadline has been configured.
+ *
+ *  \param  fd   Linux file descriptor for open /dev/i2c bus
+ */
+void i2c_apply_read_deadline(int fd) {
+   bool debug = false;
+   if (configured_deadline_millisec > 0) {
+      // I2C_TIMEOUT is in units of 10 milliseconds
+      int units = (configured_deadline_millisec + 9) / 10;
+      int rc = ioctl(fd, I2C_TIMEOUT, units);
+      int errsv = errno;
+      DBGTRC(debug, TRACE_GROUP, "fd=%d, ioctl(I2C_TIMEOUT, %d) returned %d, errno=%d",
+                                 fd, units, rc, (rc < 0) ? errsv : 0);
+   }
+}
+
+
+// Must be called with deadlines_mutex held
+static Read_Deadline_Rec * get_deadline_rec(int busno) {
+   if (!deadlines_by_busno)
+      deadlines_by_busno = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+   Read_Deadline_Rec * rec = g_hash_table_lookup(deadlines_by_busno, GINT_TO_POINTER(busno));
+   if (!rec) {
+      rec = g_new0(Read_Deadline_Rec, 1);
+      rec->busno = busno;
+      rec->deadline_millisec = max_deadline_millisec();
+      g_hash_table_insert(deadlines_by_busno, GINT_TO_POINTER(busno), rec);
+   }
+   return rec;
+}
+
+
+static int compare_uint32(const void * a, const void * b) {
+   uint32_t ua = *(const uint32_t *) a;
+   uint32_t ub = *(const uint32_t *) b;
+   return (ua > ub) - (ua < ub);
+}
+
+
+// Recalculates the deadline from the recorded read times
+static void recalc_deadline(Read_Deadline_Rec * rec) {
+   int ceiling = max_deadline_millisec();
+   if (rec->sample_ct < I2C_READ_DEADLINE_MIN_SAMPLES) {
+      rec->deadline_millisec = ceiling;
+   }
+   else {
+      uint32_t sorted[READ_TIME_SAMPLE_CT];
+      memcpy(sorted, rec->read_microsec, rec->sample_ct * sizeof(uint32_t));
+      qsort(sorted, rec->sample_ct, sizeof(uint32_t), compare_uint32);
+      uint32_t p90 = sorted[(rec->sample_ct * 9) / 10];
+      int deadline = (p90 * I2C_READ_DEADLINE_FACTOR + 999) / 1000;
+      rec->deadline_millisec = MIN(ceiling, MAX(I2C_READ_DEADLINE_MILLISEC_MIN, deadline));
+   }
+}
+
+
+/** Returns the current read deadline for a bus.
+ *
+ *  \param  busno  I2C bus number
+ *  \return deadline in milliseconds
+ */
+int i2c_get_read_deadline_millisec(int busno) {
+   g_mutex_lock(&deadlines_mutex);
+   int result = get_deadline_rec(busno)->deadline_millisec;
+   g_mutex_unlock(&deadlines_mutex);
+   return result;
+}
+
+
+/** Records the time taken by a DDC read and classifies a stalled read.
+ *
+ *  \param  busno            I2C bus number
+ *  \param  rc               status code of the read
+ *  \param  elapsed_nanosec  time taken by the read
+ *  \return **rc**, or DDCRC_STALLED if the read timed out or failed
+ *          after exceeding the configured deadline
+ */
+Status_Errno_DDC
+i2c_check_read_deadline(int busno, Status_Errno_DDC rc, uint64_t elapsed_nanosec) {
+   bool debug = false;
+   uint32_t elapsed_microsec = elapsed_nanosec / 1000;
+   g_mutex_lock(&deadlines_mutex);
+   Read_Deadline_Rec * rec = get_deadline_rec(busno);
+   bool late = elapsed_microsec > rec->deadline_millisec * 1000;
+   if (late)
+      rec->late_ct++;
+   if (rc == 0) {
+      rec->read_microsec[rec->next_ndx] = elapsed_microsec;
+      rec->next_ndx = (rec->next_ndx + 1) % READ_TIME_SAMPLE_CT;
+      if (rec->sample_ct < READ_TIME_SAMPLE_CT)
+         rec->sample_ct++;
+      recalc_deadline(rec);
+   }
+   else if ( rc == -ETIMEDOUT ||
+             (configured_deadline_millisec > 0 && elapsed_microsec > configured_deadline_millisec * 1000) )
+   {
+      rec->stalled_ct++;
+      DBGTRC(debug, TRACE_GROUP, "busno=%d, read failed with %s after %d microsec, deadline %d millisec",
+                                 busno, psc_desc(rc), elapsed_microsec, rec->deadline_millisec);
+      rc = DDCRC_STALLED;
+   }
+   g_mutex_unlock(&deadlines_mutex);
+   return rc;
+}
+
+
+static gint compare_busno(gconstpointer a, gconstpointer b) {
+   return GPOINTER_TO_INT(a) - GPOINTER_TO_INT(b);
+}
+
+
+/** Reports the read deadline and stalled read count for each bus used.
+ *
+ *  \param  depth  logical indentation depth
+ */
+void report_i2c_read_deadlines(int depth) {
+   rpt_vstring(depth, "I2C read deadlines (maximum %d millisec%s):",
+                      max_deadline_millisec(),
+                      (configured_deadline_millisec > 0) ? ", applied to adapter" : "");
+   g_mutex_lock(&deadlines_mutex);
+   if (!deadlines_by_busno || g_hash_table_size(deadlines_by_busno) == 0)
+      rpt_label(depth+1, "No reads");
+   else {
+      GList * keys = g_list_sort(g_hash_table_get_keys(deadlines_by_busno), compare_busno);
+      for (GList * cur = keys; cur; cur = cur->next) {
+         Read_Deadline_Rec * rec = g_hash_table_lookup(deadlines_by_busno, cur->data);
+         rpt_vstring(depth+1, "/dev/i2c-%-3d deadline: %4d millisec, samples: %2d, late reads: %d, stalled reads: %d",
+                              rec->busno, rec->deadline_millisec, rec->sample_ct,
+                              rec->late_ct, rec->stalled_ct);
+      }
+      g_list_free(keys);
+   }
+   g_mutex_unlock(&deadlines_mutex);
+}
+
+
+void init_i2c_read_deadline() {
+   RTTI_ADD_FUNC(i2c_apply_read_deadline);
+   RTTI_ADD_FUNC(i2c_check_read_deadline);
+}
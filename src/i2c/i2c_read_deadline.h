@@ -0,0 +1,25 @@
+/** \file i2c_read_deadline.h
+ *
+ *  Per bus read deadlines derived from observed DDC read times
+ */
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef I2C_READ_DEADLINE_H_
+#define I2C_READ_DEADLINE_H_
+
+/** \cond */
+#include <inttypes.h>
+#include <stdbool.h>
+/** \endcond */
+
+#include "base/status_code_mgt.h"
+
+void             i2c_set_read_deadline_millisec(int millisec);
+int              i2c_get_read_deadline_millisec(int busno);
+void             i2c_apply_read_deadline(int fd);
+Status_Errno_DDC i2c_check_read_deadline(int busno, Status_Errno_DDC rc, uint64_t elapsed_nanosec);
+void             report_i2c_read_deadlines(int depth);
+void             init_i2c_read_deadline();
+
+#endif /* I2C_READ_DEADLINE_H_ */
@@ -1,23 +1,47 @@
 /** \file i2c_strategy_dispatcher.c
  *
  *  Allows for alternative mechanisms to read and write to the IC2 bus.
+ *
+ *  The mechanism used for DDC exchanges is selected per I2C bus.  Starting
+ *  with the default strategy, if exchanges on a bus repeatedly fail the
+ *  alternative strategy is tried, then both strategies with the alternative
+ *  setting for single byte reads.  The first setting that succeeds is
+ *  recorded in a cache file, so that it is used from the start of
+ *  subsequent runs.  Per bus selection is not performed if a strategy
+ *  has been set explicitly using #i2c_set_io_strategy().
+ *
+ *  Cache file format, one bus per line:
+ *
+ *      <busno>:<fileio|ioctl>:<read bytewise 0|1>:<driver name>
  */
 // Copyright (C) 2014-2021 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 /** \cond */
 #include <assert.h>
+#include <errno.h>
+#include <glib-2.0/glib.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 /** \endcond */
 
+#include "util/error_info.h"
 #include "util/file_util.h"
+#include "util/report_util.h"
 #include "util/string_util.h"
+#include "util/sysfs_i2c_util.h"
+#include "util/timestamp.h"
+#include "util/xdg_util.h"
 
 #include "base/core.h"
+#include "base/ddc_errno.h"
 #include "base/parms.h"
+#include "base/rtti.h"
 #include "base/status_code_mgt.h"
 #include "base/last_io_event.h"
 
+#include "i2c_read_deadline.h"
 #include "i2c_strategy_dispatcher.h"
 
 // I2C_IO_Strategy_Id Default_I2c_Strategy = DEFAULT_I2C_IO_STRATEGY;
@@ -51,15 +75,10 @@ I2C_IO_Strategy i2c_ioctl_io_strategy = {
 
 
 static I2C_IO_Strategy * i2c_io_strategy = &i2c_file_io_strategy;  // current strategy
+static bool              i2c_io_strategy_explicit = false;           // set by i2c_set_io_strategy()
+static I2C_IO_Strategy * i2c_test_io_strategy = NULL;  // replaces the bus for DDC exchanges
 
-/** Sets an alternative I2C IO strategy.
- *
- * @param strategy_id  I2C IO strategy id
- * @return old strategy id
- */
-I2C_IO_Strategy_Id
-i2c_set_io_strategy(I2C_IO_Strategy_Id strategy_id) {
-   I2C_IO_Strategy_Id old = i2c_io_strategy->strategy_id;
+static void set_io_strategy(I2C_IO_Strategy_Id strategy_id) {
    switch (strategy_id) {
    case (I2C_IO_STRATEGY_FILEIO):
          i2c_io_strategy = &i2c_file_io_strategy;
@@ -68,12 +87,407 @@ i2c_set_io_strategy(I2C_IO_Strategy_Id strategy_id) {
          i2c_io_strategy= &i2c_ioctl_io_strategy;
          break;
    }
+}
+
+
+/** Sets an alternative I2C IO strategy, which is then used for all buses.
+ *  Strategies selected per bus, including those in the cache file,
+ *  are ignored.
+ *
+ * @param strategy_id  I2C IO strategy id
+ * @return old strategy id
+ */
+I2C_IO_Strategy_Id
+i2c_set_io_strategy(I2C_IO_Strategy_Id strategy_id) {
+   I2C_IO_Strategy_Id old = i2c_io_strategy->strategy_id;
+   set_io_strategy(strategy_id);
+   i2c_io_strategy_explicit = true;
    return old;
 }
 
 
+/** Restores the default I2C IO strategy, allowing the strategy to be
+ *  selected per bus.
+ */
+void
+i2c_reset_io_strategy() {
+   set_io_strategy(DEFAULT_I2C_IO_STRATEGY);
+   i2c_io_strategy_explicit = false;
+}
+
+
+/** Replaces the I2C bus for all DDC exchanges with the writer and reader
+ *  functions of a strategy supplied by the testing framework, e.g. to
+ *  simulate a display.  The strategy id of the strategy is not used.
+ *
+ * @param strategy  test strategy, NULL to restore normal operation
+ */
+void
+i2c_set_test_io_strategy(I2C_IO_Strategy * strategy) {
+   i2c_test_io_strategy = strategy;
+}
+
+
+/** Returns the id of the current I2C IO strategy.
+ *
+ * @return strategy id
+ */
+I2C_IO_Strategy_Id
+i2c_get_io_strategy_id() {
+   return i2c_io_strategy->strategy_id;
+}
+
+
+//
+// Per bus strategy selection
+//
+
+/** Strategy state for one I2C bus */
+typedef struct {
+   int                 busno;
+   char *              driver;            ///< driver name, may be NULL
+   bool                driver_checked;    ///< driver compared to driver of cached setting
+   int                 candidate_ndx;     ///< position in fallback sequence
+   I2C_IO_Strategy_Id  strategy_id;       ///< strategy used for DDC exchanges
+   bool                read_bytewise;     ///< use single byte reads for DDC exchanges
+   int                 failure_ct;        ///< consecutive failed DDC exchanges
+   bool                learned;           ///< current setting has succeeded
+   bool                exhausted;         ///< no setting succeeded, using default
+   bool                saved;             ///< current setting is in cache file
+} I2C_Bus_Strategy;
+
+#define I2C_STRATEGY_CANDIDATE_CT 4
+
+static bool         strategy_learning_enabled = true;
+static GHashTable * bus_strategies = NULL;    // busno -> I2C_Bus_Strategy *
+static GHashTable * busno_by_fd    = NULL;    // fd -> busno
+static GMutex       bus_strategies_mutex;
+
+
+/** Enables or disables selection of the I2C IO strategy per bus.
+ *  If disabled, the global strategy is used for all buses.
+ *
+ *  \param  onoff  new setting
+ *  \return prior setting
+ */
+bool i2c_enable_strategy_learning(bool onoff) {
+   bool old = strategy_learning_enabled;
+   strategy_learning_enabled = onoff;
+   return old;
+}
+
+
+/** Returns the name of the I2C strategy cache file.
+ *  Caller is responsible for freeing.
+ */
+char * i2c_get_strategy_cache_file_name() {
+   return xdg_cache_home_file("ddcutil", "i2c_strategies");
+}
+
+
+static I2C_IO_Strategy * strategy_by_id(I2C_IO_Strategy_Id id) {
+   return (id == I2C_IO_STRATEGY_IOCTL) ? &i2c_ioctl_io_strategy : &i2c_file_io_strategy;
+}
+
+
+// Candidate settings are the default strategy, the alternative strategy,
+// then both again with the alternative single byte read setting
+static void set_candidate(I2C_Bus_Strategy * bs, int candidate_ndx) {
+   I2C_IO_Strategy_Id default_id = i2c_io_strategy->strategy_id;
+   I2C_IO_Strategy_Id other_id   = (default_id == I2C_IO_STRATEGY_FILEIO)
+                                        ? I2C_IO_STRATEGY_IOCTL
+                                        : I2C_IO_STRATEGY_FILEIO;
+   bs->candidate_ndx = candidate_ndx;
+   bs->strategy_id   = (candidate_ndx & 0x01) ? other_id : default_id;
+   bs->read_bytewise = (candidate_ndx & 0x02) ? !I2C_Read_Bytewise : I2C_Read_Bytewise;
+   bs->failure_ct    = 0;
+   bs->learned       = false;
+   bs->saved         = false;
+}
+
+
+static void free_bus_strategy(void * data) {
+   I2C_Bus_Strategy * bs = data;
+   free(bs->driver);
+   free(bs);
+}
+
+
+// Must be called with bus_strategies_mutex held
+static void load_strategy_cache_file() {
+   bool debug = false;
+   bus_strategies = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, free_bus_strategy);
+
+   char * fn = i2c_get_strategy_cache_file_name();
+   DBGTRC(debug, TRACE_GROUP, "Starting. fn=%s", fn);
+   GPtrArray * linearray = g_ptr_array_new_with_free_func(g_free);
+   Error_Info * errs = file_getlines_errinfo(fn, linearray);
+   if (!errs) {
+      for (int ndx = 0; ndx < linearray->len; ndx++) {
+         char * aline = g_ptr_array_index(linearray, ndx);
+         if (strlen(aline) == 0 || aline[0] == '#')
+            continue;
+         char ** pieces = g_strsplit(aline, ":", 4);
+         int busno;
+         if (ntsa_length(pieces) == 4                                       &&
+             str_to_int(pieces[0], &busno, 10)                              &&
+             (streq(pieces[1], "fileio") || streq(pieces[1], "ioctl"))     &&
+             (streq(pieces[2], "0") || streq(pieces[2], "1")) )
+         {
+            I2C_Bus_Strategy * bs = calloc(1, sizeof(I2C_Bus_Strategy));
+            bs->busno         = busno;
+            bs->driver        = (strlen(pieces[3]) > 0) ? strdup(pieces[3]) : NULL;
+            bs->strategy_id   = streq(pieces[1], "ioctl") ? I2C_IO_STRATEGY_IOCTL : I2C_IO_STRATEGY_FILEIO;
+            bs->read_bytewise = streq(pieces[2], "1");
+            bs->learned       = true;
+            bs->saved         = true;
+            g_hash_table_replace(bus_strategies, GINT_TO_POINTER(busno), bs);
+         }
+         else {
+            DBGTRC(debug, TRACE_GROUP, "Line %d, invalid: %s", ndx+1, aline);
+         }
+         g_strfreev(pieces);
+      }
+   }
+   else if (ERRINFO_STATUS(errs) == -ENOENT) {
+      errinfo_free(errs);
+   }
+   else {
+      ERRINFO_FREE_WITH_REPORT(errs, debug || IS_TRACING());
+   }
+   g_ptr_array_free(linearray, true);
+   free(fn);
+   DBGTRC(debug, TRACE_GROUP, "Done. Loaded %d buses", g_hash_table_size(bus_strategies));
+}
+
+
+// Must be called with bus_strategies_mutex held
+static void save_strategy_cache_file() {
+   bool debug = false;
+   char * fn = i2c_get_strategy_cache_file_name();
+   DBGTRC(debug, TRACE_GROUP, "Starting. fn=%s", fn);
+   FILE * fp = NULL;
+   fopen_mkdir(fn, "w", ferr(), &fp);
+   if (fp) {
+      GHashTableIter iter;
+      gpointer key, value;
+      g_hash_table_iter_init(&iter, bus_strategies);
+      while (g_hash_table_iter_next(&iter, &key, &value)) {
+         I2C_Bus_Strategy * bs = value;
+         if (bs->learned) {
+            fprintf(fp, "%d:%s:%d:%s\n",
+                        bs->busno,
+                        (bs->strategy_id == I2C_IO_STRATEGY_IOCTL) ? "ioctl" : "fileio",
+                        bs->read_bytewise,
+                        (bs->driver) ? bs->driver : "");
+            bs->saved = true;
+         }
+      }
+      fclose(fp);
+   }
+   free(fn);
+   DBGTRC(debug, TRACE_GROUP, "Done");
+}
+
+
+// Must be called with bus_strategies_mutex held
+static I2C_Bus_Strategy * get_bus_strategy(int busno) {
+   bool debug = false;
+   if (!bus_strategies)
+      load_strategy_cache_file();
+   I2C_Bus_Strategy * bs = g_hash_table_lookup(bus_strategies, GINT_TO_POINTER(busno));
+   if (!bs) {
+      bs = calloc(1, sizeof(I2C_Bus_Strategy));
+      bs->busno = busno;
+      bs->driver = get_i2c_device_sysfs_driver(busno);
+      bs->driver_checked = true;
+      set_candidate(bs, 0);
+      g_hash_table_replace(bus_strategies, GINT_TO_POINTER(busno), bs);
+   }
+   else if (!bs->driver_checked) {
+      // the cached setting applies only if the bus is still driven by the same driver
+      char * driver = get_i2c_device_sysfs_driver(busno);
+      if ( !(driver && bs->driver && streq(driver, bs->driver)) && (driver || bs->driver) ) {
+         DBGTRC(debug, TRACE_GROUP, "busno=%d, driver changed from %s to %s, discarding cached setting",
+                                    busno, bs->driver, driver);
+         set_candidate(bs, 0);
+      }
+      free(bs->driver);
+      bs->driver = driver;
+      bs->driver_checked = true;
+   }
+   return bs;
+}
+
+
+/** Notes the I2C bus number of an open file descriptor, so that the
+ *  strategy selected for the bus is used for DDC exchanges on the descriptor.
+ *
+ *  \param  fd     Linux file descriptor for open /dev/i2c bus
+ *  \param  busno  I2C bus number
+ */
+void i2c_strategy_register_fd(int fd, int busno) {
+   g_mutex_lock(&bus_strategies_mutex);
+   if (!busno_by_fd)
+      busno_by_fd = g_hash_table_new(g_direct_hash, g_direct_equal);
+   g_hash_table_replace(busno_by_fd, GINT_TO_POINTER(fd), GINT_TO_POINTER(busno));
+   get_bus_strategy(busno);    // look up driver now rather than during IO
+   g_mutex_unlock(&bus_strategies_mutex);
+}
+
+
+/** Forgets the bus number of a file descriptor that is being closed.
+ *
+ *  \param  fd     Linux file descriptor
+ */
+void i2c_strategy_unregister_fd(int fd) {
+   g_mutex_lock(&bus_strategies_mutex);
+   if (busno_by_fd)
+      g_hash_table_remove(busno_by_fd, GINT_TO_POINTER(fd));
+   g_mutex_unlock(&bus_strategies_mutex);
+}
+
+
+// Must be called with bus_strategies_mutex held
+static I2C_Bus_Strategy * bus_strategy_for_fd(int fd) {
+   gpointer busno;
+   if (busno_by_fd && g_hash_table_lookup_extended(busno_by_fd, GINT_TO_POINTER(fd), NULL, &busno))
+      return get_bus_strategy(GPOINTER_TO_INT(busno));
+   return NULL;
+}
+
+
+// Returns the strategy to use for an operation, and possibly replaces the
+// single byte read setting.  Only DDC exchanges (slave address 0x37) are affected.
+// Also returns the bus number of fd for a DDC exchange, -1 if not known.
+static I2C_IO_Strategy *
+select_strategy(int fd, Byte slave_address, bool * read_bytewise_loc, int * busno_loc) {
+   I2C_IO_Strategy * strategy = i2c_io_strategy;
+   *busno_loc = -1;
+   if (slave_address == 0x37 && i2c_test_io_strategy)
+      strategy = i2c_test_io_strategy;
+   else if (slave_address == 0x37) {
+      g_mutex_lock(&bus_strategies_mutex);
+      I2C_Bus_Strategy * bs = bus_strategy_for_fd(fd);
+      if (bs) {
+         *busno_loc = bs->busno;
+         if (strategy_learning_enabled && !i2c_io_strategy_explicit && !bs->exhausted) {
+            strategy = strategy_by_id(bs->strategy_id);
+            if (read_bytewise_loc)
+               *read_bytewise_loc = bs->read_bytewise;
+         }
+      }
+      g_mutex_unlock(&bus_strategies_mutex);
+   }
+   return strategy;
+}
+
+
+// Status codes that may indicate the strategy does not work with the bus driver.
+// Errors in the response data, e.g. an invalid checksum, occur transiently
+// with any strategy and are not counted.
+static bool is_strategy_failure(Status_Errno_DDC psc) {
+   return psc == -EIO       ||
+          psc == -ENXIO     ||
+          psc == -EREMOTEIO ||
+          psc == -ETIMEDOUT ||
+          psc == DDCRC_STALLED ||
+          psc == DDCRC_READ_ALL_ZERO;
+}
+
+
+/** Records the outcome of a DDC write/read exchange, advancing to the next
+ *  candidate strategy for the bus if the current one repeatedly fails.
+ *
+ *  \param  fd     Linux file descriptor for open /dev/i2c bus
+ *  \param  psc    status code of the exchange
+ *
+ *  \remark
+ *  A DDC Null Response shows that communication works, but only a
+ *  successful exchange causes a setting to be learned and saved.
+ */
+void i2c_record_ddc_exchange(int fd, Status_Errno_DDC psc) {
+   bool debug = false;
+   if (!strategy_learning_enabled || i2c_io_strategy_explicit)
+      return;
+   g_mutex_lock(&bus_strategies_mutex);
+   I2C_Bus_Strategy * bs = bus_strategy_for_fd(fd);
+   if (bs) {
+      if (psc == DDCRC_NULL_RESPONSE) {
+         bs->failure_ct = 0;
+      }
+      else if (psc == 0) {
+         bs->failure_ct = 0;
+         if (!bs->learned) {
+            DBGTRC(debug, TRACE_GROUP, "busno=%d, learned strategy %s, read_bytewise=%s",
+                   bs->busno, strategy_by_id(bs->strategy_id)->i2c_writer_name, sbool(bs->read_bytewise));
+            bs->learned   = true;
+            bs->exhausted = false;
+         }
+         if (!bs->saved)
+            save_strategy_cache_file();
+      }
+      else if (is_strategy_failure(psc)) {
+         bs->failure_ct++;
+         if (bs->learned) {
+            if (bs->failure_ct >= I2C_STRATEGY_RELEARN_FAILURES) {
+               DBGTRC(debug, TRACE_GROUP, "busno=%d, learned strategy failing, relearning", bs->busno);
+               set_candidate(bs, 0);
+            }
+         }
+         else if (!bs->exhausted && bs->failure_ct >= I2C_STRATEGY_FALLBACK_FAILURES) {
+            if (bs->candidate_ndx+1 < I2C_STRATEGY_CANDIDATE_CT)
+               set_candidate(bs, bs->candidate_ndx+1);
+            else {
+               set_candidate(bs, 0);
+               bs->exhausted = true;
+            }
+            DBGTRC(debug, TRACE_GROUP, "busno=%d, psc=%s, trying candidate %d, exhausted=%s",
+                   bs->busno, psc_desc(psc), bs->candidate_ndx, sbool(bs->exhausted));
+         }
+      }
+   }
+   g_mutex_unlock(&bus_strategies_mutex);
+}
+
+
+static gint compare_busno(gconstpointer a, gconstpointer b) {
+   return GPOINTER_TO_INT(a) - GPOINTER_TO_INT(b);
+}
+
+
+/** Reports the I2C IO strategy selected for each bus used.
+ *
+ *  \param  depth  logical indentation depth
+ */
+void report_i2c_bus_strategies(int depth) {
+   rpt_vstring(depth, "I2C IO strategy by bus (default: %s, per bus selection %s):",
+                      i2c_io_strategy->i2c_writer_name,
+                      (strategy_learning_enabled && !i2c_io_strategy_explicit) ? "enabled" : "disabled");
+   g_mutex_lock(&bus_strategies_mutex);
+   if (!bus_strategies || g_hash_table_size(bus_strategies) == 0)
+      rpt_label(depth+1, "No buses used");
+   else {
+      GList * keys = g_list_sort(g_hash_table_get_keys(bus_strategies), compare_busno);
+      for (GList * cur = keys; cur; cur = cur->next) {
+         I2C_Bus_Strategy * bs = g_hash_table_lookup(bus_strategies, cur->data);
+         I2C_IO_Strategy * strategy = (bs->exhausted) ? i2c_io_strategy : strategy_by_id(bs->strategy_id);
+         char * state = (bs->exhausted) ? "no setting succeeded, using default"
+                      : (bs->learned)   ? "learned"
+                      :                   "probing";
+         rpt_vstring(depth+1, "/dev/i2c-%-3d driver: %-10s  %s, %s, read bytewise: %-5s  %s",
+                              bs->busno, (bs->driver) ? bs->driver : "unknown",
+                              strategy->i2c_writer_name, strategy->i2c_reader_name,
+                              sbool(bs->read_bytewise), state);
+      }
+      g_list_free(keys);
+   }
+   g_mutex_unlock(&bus_strategies_mutex);
+}
+
+
 /** Writes to the I2C bus, using the function specified in the
- * currently active strategy.
+ * strategy selected for the bus, or else the currently active strategy.
  *
  * @param   fd              Linux file descriptor for open /dev/i2c bus
  * @param   slave_address   slave address to write to
@@ -98,9 +512,11 @@ Status_Errno_DDC invoke_i2c_writer(
                  hexstring_t(bytes_to_write, bytect));
 
    Status_Errno_DDC rc;
+   int busno;
+   I2C_IO_Strategy * strategy = select_strategy(fd, slave_address, NULL, &busno);
    RECORD_IO_EVENT(
       IE_WRITE,
-      ( rc = i2c_io_strategy->i2c_writer(fd, slave_address, bytect, bytes_to_write ) )
+      ( rc = strategy->i2c_writer(fd, slave_address, bytect, bytes_to_write ) )
      );
    assert (rc <= 0);
    RECORD_IO_FINISH_NOW(fd, IE_WRITE);
@@ -111,7 +527,10 @@ Status_Errno_DDC invoke_i2c_writer(
 
 
 /** Reads from the I2C bus, using the function specified in the
- *  currently active strategy.
+ *  strategy selected for the bus, or else the currently active strategy.
+ *  For a DDC exchange, the single byte read setting selected for the bus
+ *  replaces **read_bytewise**, and a read that times out or fails after
+ *  exceeding the configured read deadline is reported as DDCRC_STALLED.
  *
  *  @param   fd              Linux file descriptor for open /dev/i2c bus
  *  @param   slave_address   I2C slave address to read from
@@ -143,7 +562,13 @@ Status_Errno_DDC invoke_i2c_reader(
      //    IE_READ,
      //    ( rc = i2c_io_strategy->i2c_reader(fd, bytect, readbuf) )
      //   );
-     rc = i2c_io_strategy->i2c_reader(fd, slave_address, read_bytewise, bytect, readbuf);
+     int busno;
+     I2C_IO_Strategy * strategy = select_strategy(fd, slave_address, &read_bytewise, &busno);
+     uint64_t start_nanosec = cur_realtime_nanosec();
+     rc = strategy->i2c_reader(fd, slave_address, read_bytewise, bytect, readbuf);
+     RECORD_IO_FINISH_NOW(fd, IE_READ);
+     if (busno >= 0)
+        rc = i2c_check_read_deadline(busno, rc, cur_realtime_nanosec() - start_nanosec);
      assert (rc <= 0);
 
      if (rc == 0) {
@@ -178,5 +603,9 @@ Status_Errno_DDC invoke_single_byte_i2c_reader(
 #endif
 
 
-
-
+void init_i2c_strategy_dispatcher() {
+   RTTI_ADD_FUNC(load_strategy_cache_file);
+   RTTI_ADD_FUNC(save_strategy_cache_file);
+   RTTI_ADD_FUNC(get_bus_strategy);
+   RTTI_ADD_FUNC(i2c_record_ddc_exchange);
+}
@@ -33,6 +33,19 @@ typedef struct {
 I2C_IO_Strategy_Id
 i2c_set_io_strategy(I2C_IO_Strategy_Id strategy_id);
 
+void
+i2c_reset_io_strategy();
+
+I2C_IO_Strategy_Id
+i2c_get_io_strategy_id();
+
+bool   i2c_enable_strategy_learning(bool onoff);
+char * i2c_get_strategy_cache_file_name();
+void   i2c_strategy_register_fd(int fd, int busno);
+void   i2c_strategy_unregister_fd(int fd);
+void   i2c_record_ddc_exchange(int fd, Status_Errno_DDC psc);
+void   report_i2c_bus_strategies(int depth);
+
 // quick and dirty for use in testing framework
 // extern I2C_IO_Strategy Default_I2c_Strategy;
 extern bool I2C_Read_Bytewise;
@@ -41,6 +54,9 @@ extern bool EDID_Read_Bytewise;
 extern bool EDID_Write_Before_Read;
 extern int  EDID_Read_Size;
 
+// for use in testing framework, e.g. to simulate a display
+void   i2c_set_test_io_strategy(I2C_IO_Strategy * strategy);
+
 
 Status_Errno_DDC
 invoke_i2c_writer(
@@ -66,4 +82,6 @@ invoke_single_byte_i2c_reader(
        Byte *     readbuf);
 #endif
 
+void   init_i2c_strategy_dispatcher();
+
 #endif /* I2C_STRATEGY_DISPATCHER_H_ */
@@ -24,6 +24,8 @@
 #include "base/per_thread_data.h"
 #include "base/thread_retry_data.h"
 #include "base/thread_sleep_data.h"
+#include "base/timeline.h"
+#include "base/trace_ring.h"
 #include "base/tuned_sleep.h"
 
 #include "cmdline/cmd_parser.h"
@@ -37,6 +39,7 @@
 #include "ddc/ddc_services.h"
 #include "ddc/ddc_try_stats.h"
 #include "ddc/ddc_vcp.h"
+#include "ddc/ddc_vcp_value_cache.h"
 #include "ddc/ddc_watch_displays.h"
 
 #include "ddc/common_init.h"
@@ -546,6 +549,18 @@ ddca_is_verify_enabled() {
    return ddc_get_verify_setvcp();
 }
 
+
+bool
+ddca_enable_value_cache(bool onoff) {
+   return ddc_enable_vcp_value_cache(onoff);
+}
+
+
+bool
+ddca_force_value_refresh(bool onoff) {
+   return ddc_set_force_value_refresh(onoff);
+}
+
 #ifdef NOT_NEEDED
 void ddca_lock_default_sleep_multiplier() {
    lock_default_sleep_multiplier();
@@ -569,6 +584,16 @@ ddca_is_sleep_suppression_enabled() {
    return is_sleep_suppression_enabled();
 }
 
+bool
+ddca_enable_idle_aware_sleep(bool newval) {
+   return enable_idle_aware_sleep(newval);
+}
+
+bool
+ddca_is_idle_aware_sleep_enabled() {
+   return is_idle_aware_sleep_enabled();
+}
+
 
 double
 ddca_set_default_sleep_multiplier(double multiplier)
@@ -682,6 +707,34 @@ ddca_set_trace_options(DDCA_Trace_Options  options) {
 }
 
 
+void
+ddca_enable_trace_ring(const char * filename) {
+   trace_ring_enable(filename);
+}
+
+
+DDCA_Status
+ddca_dump_trace_ring() {
+   if (!trace_ring_enabled)
+      return DDCRC_INVALID_OPERATION;
+   return trace_ring_dump(NULL);
+}
+
+
+void
+ddca_enable_timeline(const char * filename) {
+   timeline_enable(filename);
+}
+
+
+DDCA_Status
+ddca_write_timeline() {
+   if (!timeline_enabled)
+      return DDCRC_INVALID_OPERATION;
+   return timeline_write(NULL);
+}
+
+
 //
 // Statistics
 //
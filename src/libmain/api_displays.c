@@ -18,6 +18,7 @@
 #include "public/ddcutil_status_codes.h"
 #include "public/ddcutil_c_api.h"
 
+#include "ddc/ddc_display_lock.h"
 #include "ddc/ddc_displays.h"
 #include "ddc/ddc_packet_io.h"
 #include "ddc/ddc_vcp_version.h"
@@ -396,6 +397,14 @@ ddca_open_display2(
 }
 
 
+int
+ddca_set_open_display_wait_millisec(
+      int                   millisec)
+{
+   return set_display_lock_wait_millisec(millisec);
+}
+
+
 DDCA_Status
 ddca_close_display(DDCA_Display_Handle ddca_dh) {
    bool debug = false;
@@ -86,20 +86,19 @@ ddca_get_non_table_vcp_value(
    assert(valrec);
    WITH_DH(ddca_dh,  {
        Error_Info * ddc_excp = NULL;
-       Parsed_Nontable_Vcp_Response * code_info;
-       ddc_excp = ddc_get_nontable_vcp_value(
+       Parsed_Nontable_Vcp_Response code_info;
+       ddc_excp = ddc_read_nontable_vcp_value(
                      dh,
                      feature_code,
                      &code_info);
 
        if (!ddc_excp) {
-          valrec->mh = code_info->mh;
-          valrec->ml = code_info->ml;;
-          valrec->sh = code_info->sh;
-          valrec->sl = code_info->sl;
+          valrec->mh = code_info.mh;
+          valrec->ml = code_info.ml;
+          valrec->sh = code_info.sh;
+          valrec->sl = code_info.sl;
           // DBGMSG("valrec:  mh=0x%02x, ml=0x%02x, sh=0x%02x, sl=0x%02x",
           //        valrec->mh, valrec->ml, valrec->sh, valrec->sl);
-          free(code_info);
        }
        else {
           psc = ddc_excp->status_code;
@@ -111,6 +110,20 @@ ddca_get_non_table_vcp_value(
 }
 
 
+// Returns a newly allocated DDCA_Table_Vcp_Value with a copy of the bytes in a Buffer
+static DDCA_Table_Vcp_Value *
+table_vcp_value_from_buffer(Buffer * buffer) {
+   int len = buffer->len;
+   DDCA_Table_Vcp_Value * tv = calloc(1,sizeof(DDCA_Table_Vcp_Value));
+   tv->bytect = len;
+   if (len > 0) {
+      tv->bytes = malloc(len);
+      memcpy(tv->bytes, buffer->bytes, len);
+   }
+   return tv;
+}
+
+
 // untested
 DDCA_Status
 ddca_get_table_vcp_value(
@@ -129,15 +142,7 @@ ddca_get_table_vcp_value(
          errinfo_free(ddc_excp);
          if (psc == 0) {
             assert(p_table_bytes);  // avoid coverity warning
-            int len = p_table_bytes->len;
-            DDCA_Table_Vcp_Value * tv = calloc(1,sizeof(DDCA_Table_Vcp_Value));
-            tv->bytect = len;
-            if (len > 0) {
-               tv->bytes = malloc(len);
-               memcpy(tv->bytes, p_table_bytes->bytes, len);
-            }
-            *table_value_loc = tv;
-
+            *table_value_loc = table_vcp_value_from_buffer(p_table_bytes);
             buffer_free(p_table_bytes, __func__);
          }
          assert( (psc==0 && *table_value_loc) || (psc!=0 && !*table_value_loc));
@@ -146,6 +151,42 @@ ddca_get_table_vcp_value(
 }
 
 
+DDCA_Status
+ddca_get_table_vcp_value_range(
+      DDCA_Display_Handle      ddca_dh,
+      DDCA_Vcp_Feature_Code    feature_code,
+      int                      offset,
+      int                      max_bytes,
+      DDCA_Table_Fragment_Func fragment_func,
+      void *                   context,
+      DDCA_Table_Vcp_Value **  table_value_loc)
+{
+   WITH_DH(ddca_dh,
+      {
+         assert(table_value_loc);
+         *table_value_loc = NULL;
+         // the offset field of a table read request is 16 bits
+         if (offset < 0 || offset > 0xffff || max_bytes < -1 || max_bytes > 0xffff)
+            psc = DDCRC_ARG;
+         else {
+            Buffer * p_table_bytes = NULL;
+            Error_Info * ddc_excp = ddc_read_table_vcp_value_range(
+                  dh, feature_code, offset, max_bytes, fragment_func, context, &p_table_bytes);
+            psc = (ddc_excp) ? ddc_excp->status_code : 0;
+            save_thread_error_detail(error_info_to_ddca_detail(ddc_excp));
+            errinfo_free(ddc_excp);
+            if (psc == 0) {
+               assert(p_table_bytes);
+               *table_value_loc = table_vcp_value_from_buffer(p_table_bytes);
+               buffer_free(p_table_bytes, __func__);
+            }
+         }
+         assert( (psc==0 && *table_value_loc) || (psc!=0 && !*table_value_loc));
+      }
+   );
+}
+
+
 static
 DDCA_Status
 ddca_get_vcp_value(
@@ -826,6 +867,15 @@ ddca_set_table_vcp_value_verify(
     return rc;
 }
 
+void
+ddca_set_table_write_progress_func(
+      DDCA_Table_Write_Progress_Func progress_func,
+      void *                         context)
+{
+   ddc_set_table_write_progress_func(progress_func, context);
+}
+
+
 DDCA_Status
 ddca_set_table_vcp_value(
       DDCA_Display_Handle     ddca_dh,
@@ -230,6 +230,34 @@ ddca_enable_verify(
 bool
 ddca_is_verify_enabled(void);
 
+/** Controls whether recently read values of non-table features are reused
+ *  instead of being read again from the display.
+ *
+ * \param[in] onoff true/false
+ * \return  prior value
+ *
+ * \remark
+ * Cached values are discarded when the library writes to the display, and
+ * when features x02 or x52 report a change.  Features whose values change
+ * independently, e.g. x02, x52, xc0, are always read from the display.
+ * The cache is disabled by default.
+ */
+bool
+ddca_enable_value_cache(
+      bool onoff);
+
+/** Controls whether reads of non-table features on the current thread
+ *  ignore cached values.  Values read still replace cached values.
+ *
+ * \param[in] onoff true/false
+ * \return  prior value
+ *
+ * \remark This setting is thread-specific.
+ */
+bool
+ddca_force_value_refresh(
+      bool onoff);
+
 
 /** Sets the sleep multiplier factor to be used for new threads.
  *
@@ -434,6 +462,46 @@ ddca_trace_group_name_to_value(char * name);
 void
 ddca_set_trace_options(DDCA_Trace_Options  options);
 
+/** Records trace messages in binary form in a ring buffer for each thread,
+ *  instead of writing them.  The records are written to a file when the
+ *  program exits or crashes, or when #ddca_dump_trace_ring() is called.
+ *  Use command "ddcutil trace-decode" to format them.
+ *
+ *  \param[in] filename  name of file to which records are written
+ */
+void
+ddca_enable_trace_ring(const char * filename);
+
+/** Writes the trace records of all threads to the file specified
+ *  by #ddca_enable_trace_ring().
+ *
+ *  \retval  0                        success
+ *  \retval  DDCRC_INVALID_OPERATION  trace ring not enabled
+ *  \retval  -errno                   error writing file
+ */
+DDCA_Status
+ddca_dump_trace_ring();
+
+/** Records each I/O call, protocol sleep, retryable operation outcome, and
+ *  feature read or write with its start and end times, thread, display, and
+ *  feature code.  The timeline is written in Chrome trace event format when
+ *  the program exits, or when #ddca_write_timeline() is called.
+ *
+ *  \param[in] filename  name of file to which the timeline is written
+ */
+void
+ddca_enable_timeline(const char * filename);
+
+/** Writes the timeline recorded so far to the file specified
+ *  by #ddca_enable_timeline().
+ *
+ *  \retval  0                        success
+ *  \retval  DDCRC_INVALID_OPERATION  timeline not enabled
+ *  \retval  -errno                   error writing file
+ */
+DDCA_Status
+ddca_write_timeline();
+
 
 //
 // Performance Options
@@ -445,6 +513,23 @@ ddca_enable_sleep_suppression(bool newval); ;
 bool
 ddca_is_sleep_suppression_enabled();
 
+/** Controls whether protocol sleeps are shortened by the time the display
+ *  has already been idle since its last I/O.
+ *
+ *  \param[in] newval  true for idle aware sleeps, false to always sleep the full time
+ *  \return    previous setting
+ */
+bool
+ddca_enable_idle_aware_sleep(bool newval);
+
+/** Reports whether protocol sleeps are shortened by the time the display
+ *  has already been idle.
+ *
+ *  \return current setting
+ */
+bool
+ddca_is_idle_aware_sleep_enabled();
+
 
 //
 // Statistics and Diagnostics
@@ -792,7 +877,9 @@ ddca_dbgrpt_display_ref(
  * @param[out] ddca_dh_loc  where to return display handle
  * @return     status code
  *
- * Fails if display is already opened by another thread.
+ * Fails with DDCRC_LOCKED if the display is already open in another thread,
+ * or if its device is locked by another process, e.g. another instance of
+ * ddcutil, for longer than 5 seconds.
  * \ingroup api_display_spec
  */
 DDCA_Status
@@ -801,6 +888,22 @@ ddca_open_display2(
       bool                  wait,
       DDCA_Display_Handle * ddca_dh_loc);
 
+/** Sets the maximum time that #ddca_open_display2() with **wait** set
+ *  waits on the current thread for a display open in another thread.
+ *  If the wait times out, #ddca_open_display2() returns DDCRC_LOCKED.
+ *
+ * @param[in] millisec  maximum wait, a negative value means wait indefinitely
+ * @return    prior value
+ *
+ * The setting is thread specific.  Threads waiting for the same display
+ * open it in the order in which they began waiting.
+ *
+ * \ingroup api_display_spec
+ */
+int
+ddca_set_open_display_wait_millisec(
+      int                   millisec);
+
 /** Close an open display
  * @param[in]  ddca_dh   display handle, if NULL do nothing
  * @retval     DDCRC_OK  close succeeded, or ddca_dh == NULL
@@ -1489,6 +1592,40 @@ ddca_get_table_vcp_value(
        DDCA_Vcp_Feature_Code   feature_code,
        DDCA_Table_Vcp_Value ** table_value_loc);
 
+/** Gets all or part of the value of a table VCP feature, optionally
+ *  delivering each fragment as it is read.
+ *
+ * @param[in]  ddca_dh         display handle
+ * @param[in]  feature_code    VCP feature code
+ * @param[in]  offset          offset of first byte to read, 0..0xffff
+ * @param[in]  max_bytes       maximum number of bytes to read, 0..0xffff,
+ *                             -1 to read to the end
+ * @param[in]  fragment_func   if non-NULL, called with each fragment as it is read
+ * @param[in]  context         passed to **fragment_func**
+ * @param[out] table_value_loc address at which to return the value read
+ * @return status code, DDCRC_ARG if **offset** or **max_bytes** is out of range
+ *
+ * @remark
+ * If a read fails and is retried, fragments are delivered again
+ * beginning at **offset**.
+ * @remark
+ * If the monitor does not support reading from an offset, the entire value
+ * is read, and only the requested range is delivered and returned.
+ * @remark
+ * If the value cache is enabled (see #ddca_enable_value_cache()), values of
+ * read-only table features are saved for each monitor model and reused,
+ * unless #ddca_force_value_refresh() is in effect.
+ */
+DDCA_Status
+ddca_get_table_vcp_value_range(
+       DDCA_Display_Handle      ddca_dh,
+       DDCA_Vcp_Feature_Code    feature_code,
+       int                      offset,
+       int                      max_bytes,
+       DDCA_Table_Fragment_Func fragment_func,
+       void *                   context,
+       DDCA_Table_Vcp_Value **  table_value_loc);
+
 /** Gets the value of a VCP feature of any type.
  *
  * @param[in]  ddca_dh       display handle
@@ -1630,6 +1767,22 @@ ddca_set_non_table_vcp_value(
       uint8_t                  lo_byte
      );
 
+/** Sets a function to be called as each fragment of a table VCP value
+ *  is written by #ddca_set_table_vcp_value() or #ddca_set_table_vcp_value_verify().
+ *
+ * @param[in]  progress_func  function to call, NULL for none
+ * @param[in]  context        passed to **progress_func**
+ *
+ * @remark
+ * A fragment that fails is retried by itself, so the number of bytes
+ * written increases monotonically.
+ * @remark This setting is thread-specific.
+ */
+void
+ddca_set_table_write_progress_func(
+      DDCA_Table_Write_Progress_Func progress_func,
+      void *                         context);
+
 /** Sets a Table VCP value.
  *
  *  \param[in]   ddca_dh             display handle
@@ -527,6 +527,34 @@ typedef struct {
    uint8_t*  bytes;        /**< Bytes of the value */
 } DDCA_Table_Vcp_Value;
 
+/** Called with each fragment of a table VCP value as it is read.
+ *
+ *  @param feature_code  VCP feature code
+ *  @param offset        offset of the fragment within the value
+ *  @param bytes         fragment bytes, valid only for the duration of the call
+ *  @param bytect        number of bytes in the fragment
+ *  @param context       pointer supplied by the caller of the read
+ */
+typedef void (*DDCA_Table_Fragment_Func)(
+      DDCA_Vcp_Feature_Code feature_code,
+      int                   offset,
+      uint8_t *             bytes,
+      int                   bytect,
+      void *                context);
+
+/** Called after each fragment of a table VCP value is written.
+ *
+ *  @param feature_code   VCP feature code
+ *  @param bytes_written  number of bytes written so far
+ *  @param total_bytes    number of bytes in the value
+ *  @param context        pointer supplied when the function was set
+ */
+typedef void (*DDCA_Table_Write_Progress_Func)(
+      DDCA_Vcp_Feature_Code feature_code,
+      int                   bytes_written,
+      int                   total_bytes,
+      void *                context);
+
 
 /** Stores a VCP feature value of any type */
 typedef struct {
@@ -25,6 +25,7 @@
 // #include <fileobject.h>
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "base/core.h"
@@ -45,13 +46,24 @@
          throw_exception_from_status_code(rc); \
    } while(0);
 
+// Releases the GIL for the duration of a (possibly lengthy) DDC operation,
+// so that other Python threads, e.g. ones driving other monitors, can run.
+// The operation must not touch Python objects.
+#define WITHOUT_GIL(impl) \
+   do { \
+      Py_BEGIN_ALLOW_THREADS    \
+      impl;                     \
+      Py_END_ALLOW_THREADS      \
+   } while(0)
+
 
 //
 // Convert ddcutil status codes to exceptions
 //
 
-static DDCA_Status ddcutil_error_status = 0;
-static char error_msg[256];
+// Thread specific, since the GIL is released during DDC operations
+static __thread DDCA_Status ddcutil_error_status = 0;
+static __thread char error_msg[256];
 static PyObject * PyExc_DDCUtilError = NULL;
 
 
@@ -306,7 +318,8 @@ void        ddcs_report_display_ref(DDCS_Display_Ref dref, int depth) {
 
 DDCS_Display_Handle ddcs_open_display(DDCS_Display_Ref dref) {
    DDCS_Display_Handle result = NULL;
-   DDCA_Status rc = ddca_open_display(dref, &result);
+   DDCA_Status rc = 0;
+   WITHOUT_GIL( rc = ddca_open_display(dref, &result) );
    clear_exception();
    if (rc != 0)
       throw_exception_from_status_code(rc);
@@ -315,7 +328,8 @@ DDCS_Display_Handle ddcs_open_display(DDCS_Display_Ref dref) {
 
 void ddcs_close_display(DDCS_Display_Handle dh) {
    clear_exception();
-   DDCA_Status rc = ddca_close_display(dh);
+   DDCA_Status rc = 0;
+   WITHOUT_GIL( rc = ddca_close_display(dh) );
    if (rc != 0)
       throw_exception_from_status_code(rc);
 }
@@ -359,7 +373,8 @@ unsigned long ddcs_get_feature_info_by_display(
 char * ddcs_get_capabilities_string(DDCS_Display_Handle dh){
    clear_exception();
    char * result = NULL;
-   DDCA_Status  rc = ddca_get_capabilities_string(dh, &result);
+   DDCA_Status  rc = 0;
+   WITHOUT_GIL( rc = ddca_get_capabilities_string(dh, &result) );
    if (rc != 0)
       throw_exception_from_status_code(rc);
    return result;
@@ -377,7 +392,8 @@ DDCS_Non_Table_Value_Response ddcs_get_nontable_vcp_value(
 
    clear_exception();
    DDCA_Non_Table_Vcp_Value resp = {0};
-   DDCA_Status  rc = ddca_get_non_table_vcp_value(dh, feature_code, &resp);
+   DDCA_Status  rc = 0;
+   WITHOUT_GIL( rc = ddca_get_non_table_vcp_value(dh, feature_code, &resp) );
    if (rc != 0)
       throw_exception_from_status_code(rc);
    DDCS_Non_Table_Value_Response result;
@@ -400,16 +416,107 @@ void ddcs_set_nontable_vcp_value(
                int                  new_value)
 {
    clear_exception();
-   DDCA_Status  rc = ddca_set_continuous_vcp_value(dh, feature_code, new_value);
+   DDCA_Status  rc = 0;
+   WITHOUT_GIL( rc = ddca_set_continuous_vcp_value(dh, feature_code, new_value) );
    if (rc != 0)
       throw_exception_from_status_code(rc);
 }
 
 
+// Converts a single value read by ddcs_get_vcp_values() to a Python object.
+// Non-table values become a (cur_value, max_value) tuple, table values
+// a bytes object, created with a single copy of the value bytes.
+static PyObject * vcp_value_to_python(DDCA_Any_Vcp_Value * valrec) {
+   PyObject * result = NULL;
+   if (valrec->value_type == DDCA_TABLE_VCP_VALUE) {
+      result = PyBytes_FromStringAndSize(
+                  (const char *) valrec->val.t.bytes,
+                  valrec->val.t.bytect);
+   }
+   else {
+      result = Py_BuildValue("(ii)", VALREC_CUR_VAL(valrec), VALREC_MAX_VAL(valrec));
+   }
+   return result;
+}
+
+
+/** Reads multiple VCP feature values in a single call.
+ *
+ *  The GIL is released once for the entire batch, rather than once per
+ *  feature, and no Python objects are created until all reads complete.
+ *
+ *  @param dh             display handle
+ *  @param feature_codes  Python sequence of feature codes
+ *  @return dictionary mapping each feature code to its value: a
+ *          (cur_value, max_value) tuple for non-table features, a bytes
+ *          object for table features, or None if the read failed.
+ *          NULL with a Python exception set if the argument is invalid
+ *          or a Python object cannot be created.
+ */
+PyObject * ddcs_get_vcp_values(
+               DDCS_Display_Handle dh,
+               PyObject *          feature_codes)
+{
+   clear_exception();
+   PyObject * seq = PySequence_Fast(feature_codes, "feature_codes must be a sequence");
+   if (!seq)
+      return NULL;
+
+   Py_ssize_t ct = PySequence_Fast_GET_SIZE(seq);
+   DDCA_Vcp_Feature_Code * codes   = calloc(ct, sizeof(DDCA_Vcp_Feature_Code));
+   DDCA_Any_Vcp_Value **   valrecs = calloc(ct, sizeof(DDCA_Any_Vcp_Value *));
+   for (Py_ssize_t ndx = 0; ndx < ct; ndx++) {
+      long code = PyLong_AsLong(PySequence_Fast_GET_ITEM(seq, ndx));
+      if ( (code == -1 && PyErr_Occurred()) || code < 0 || code > 255) {
+         if (!PyErr_Occurred())
+            PyErr_Format(PyExc_ValueError, "Invalid feature code: %ld", code);
+         free(codes);
+         free(valrecs);
+         Py_DECREF(seq);
+         return NULL;
+      }
+      codes[ndx] = code;
+   }
+   Py_DECREF(seq);
+
+   Py_BEGIN_ALLOW_THREADS
+   for (Py_ssize_t ndx = 0; ndx < ct; ndx++) {
+      DDCA_Status rc = ddca_get_any_vcp_value_using_implicit_type(dh, codes[ndx], &valrecs[ndx]);
+      if (rc != 0)
+         valrecs[ndx] = NULL;
+      if (rc == DDCRC_ARG) {    // invalid display handle, no point continuing
+         throw_exception_from_status_code(rc);
+         break;
+      }
+   }
+   Py_END_ALLOW_THREADS
+
+   PyObject * result = (ddcutil_error_status) ? NULL : PyDict_New();
+   for (Py_ssize_t ndx = 0; ndx < ct; ndx++) {
+      if (result) {
+         PyObject * key   = PyLong_FromLong(codes[ndx]);
+         PyObject * value = (valrecs[ndx]) ? vcp_value_to_python(valrecs[ndx]) : Py_None;
+         if (value == Py_None)
+            Py_INCREF(Py_None);
+         if (!key || !value || PyDict_SetItem(result, key, value) < 0)
+            Py_CLEAR(result);      // Python exception is already set
+         Py_XDECREF(key);
+         Py_XDECREF(value);
+      }
+      if (valrecs[ndx])
+         ddca_free_any_vcp_value(valrecs[ndx]);
+   }
+   free(codes);
+   free(valrecs);
+   return result;
+}
+
+
 char * ddcs_get_profile_related_values(DDCS_Display_Handle dh){
    clear_exception();
    char * result = NULL;
-   DDCA_Status  rc = ddca_get_profile_related_values(dh, &result);
+   DDCA_Status  rc = 0;
+   WITHOUT_GIL( rc = ddca_get_profile_related_values(dh, &result) );
    if (rc != 0)
       throw_exception_from_status_code(rc);
    return result;
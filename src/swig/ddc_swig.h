@@ -214,6 +214,10 @@ void ddcs_set_nontable_vcp_value(
                DDCA_Vcp_Feature_Code        feature_code,
                int                     new_value);
 
+PyObject * ddcs_get_vcp_values(
+               DDCS_Display_Handle     dh,
+               PyObject *              feature_codes);
+
 char * ddcs_get_profile_related_values(DDCS_Display_Handle dh);
 
 void ddcs_set_profile_related_values(char * profile_values_string);
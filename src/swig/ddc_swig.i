@@ -324,6 +324,15 @@ void ddcs_set_nontable_vcp_value(
                DDCS_VCP_Feature_Code   feature_code,
                int                     new_value);
 
+%feature("docstring",
+"Reads multiple VCP feature values with a single call.\n"
+"Returns a dict mapping each feature code to a (cur_value, max_value)\n"
+"tuple for non-table features, bytes for table features, or None if\n"
+"the feature could not be read.") ddcs_get_vcp_values;
+PyObject * ddcs_get_vcp_values(
+               DDCS_Display_Handle     dh,
+               PyObject *              feature_codes);
+
 char * ddcs_get_profile_related_values(DDCS_Display_Handle dh);
 
 void ddcs_set_profile_related_values(char * profile_values_string);
@@ -60,6 +60,9 @@ def test1():
    caps  = ddcs_get_capabilities_string(dh)
    print( "Capabilities: %s" % caps )
 
+   vals = ddcs_get_vcp_values(dh, [0x10, 0x12, 0x14, 0x60])
+   print( "Batch read: %s" % vals )
+
    profile_vals = ddcs_get_profile_related_values(dh)
    print( "Profile related values: %s" % profile_vals  )
 
@@ -0,0 +1,167 @@
+/** \file ddc_dumpload_tests.c
+ *
+ *  Checks that converting dumpvcp data from text form to a binary profile
+ *  store and back loses nothing.  No monitor is required.
+ *
+ *  Each profile is parsed from text, a store is built from all the profiles,
+ *  and each profile is then recovered from the store.  The recovered profile
+ *  must produce the same text as the original.  Profiles are compared in
+ *  their text form since that is the form users see, and it includes every
+ *  field that dumpvcp records.
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/** \cond */
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <string.h>
+/** \endcond */
+
+#include "util/error_info.h"
+#include "util/report_util.h"
+#include "util/string_util.h"
+
+#include "base/core.h"
+#include "base/status_code_mgt.h"
+
+#include "ddc/ddc_dumpload.h"
+#include "ddc/ddc_dumpload_binary.h"
+
+#include "test/ddc/ddc_dumpload_tests.h"
+
+
+// 128 byte EDIDs, differing only in serial number
+#define TEST_EDID_1 \
+   "00FFFFFFFFFFFF0010ACA04001000000141E0104000000000000000000000000" \
+   "0000000000000000000000000000000000000000000000000000000000000000" \
+   "0000000000000000000000000000000000000000000000000000000000000000" \
+   "0000000000000000000000000000000000000000000000000000000000000032"
+#define TEST_EDID_2 \
+   "00FFFFFFFFFFFF0010ACA04002000000141E0104000000000000000000000000" \
+   "0000000000000000000000000000000000000000000000000000000000000000" \
+   "0000000000000000000000000000000000000000000000000000000000000000" \
+   "0000000000000000000000000000000000000000000000000000000000000031"
+
+// Profiles in the text form written by dumpvcp, NULL terminated
+static char * test_profile_1[] = {
+   "TIMESTAMP_TEXT 20210315-101520",
+   "MFG_ID  DEL",
+   "MODEL   DELL U3011",
+   "PRODUCT_CODE  16544",
+   "SN      ABC123",
+   "EDID    " TEST_EDID_1,
+   "VCP_VERSION 2.0",
+   "VCP 10    50",
+   "VCP 12    75",
+   "VCP 14     5",
+   "VCP 74 0102030405060708",        // table feature
+   NULL
+};
+
+static char * test_profile_2[] = {
+   "TIMESTAMP_TEXT 20210401-235959",
+   "MFG_ID  DEL",
+   "MODEL   DELL U3011",
+   "PRODUCT_CODE  16544",
+   "SN      ABC124",
+   "EDID    " TEST_EDID_2,
+   "VCP_VERSION 2.1",
+   "VCP 10     0",
+   "VCP 60    15",
+   NULL
+};
+
+static char ** test_profiles[] = {test_profile_1, test_profile_2};
+#define TEST_PROFILE_CT  2
+
+
+static Dumpload_Data *
+parse_test_profile(char ** lines) {
+   GPtrArray * garray = g_ptr_array_new();
+   for (int ndx = 0; lines[ndx]; ndx++)
+      g_ptr_array_add(garray, g_strdup(lines[ndx]));
+   Dumpload_Data * data = NULL;
+   Error_Info * err = create_dumpload_data_from_g_ptr_array(garray, &data);
+   g_ptr_array_set_free_func(garray, g_free);
+   g_ptr_array_free(garray, true);
+   if (err) {
+      rpt_vstring(1, "Error parsing test profile: %s", errinfo_summary(err));
+      errinfo_free(err);
+   }
+   return data;
+}
+
+
+// Returns true if the two profiles have the same text form
+static bool
+same_text_form(Dumpload_Data * expected, Dumpload_Data * actual, int depth) {
+   GPtrArray * expected_lines = convert_dumpload_data_to_string_array(expected);
+   GPtrArray * actual_lines   = convert_dumpload_data_to_string_array(actual);
+   bool same = expected_lines->len == actual_lines->len;
+   for (int ndx = 0; ndx < MAX(expected_lines->len, actual_lines->len); ndx++) {
+      char * e = (ndx < expected_lines->len) ? g_ptr_array_index(expected_lines, ndx) : "";
+      char * a = (ndx < actual_lines->len)   ? g_ptr_array_index(actual_lines, ndx)   : "";
+      if (!streq(e, a)) {
+         rpt_vstring(depth, "expected: %s", e);
+         rpt_vstring(depth, "actual:   %s", a);
+         same = false;
+      }
+   }
+   g_ptr_array_free(expected_lines, true);
+   g_ptr_array_free(actual_lines, true);
+   return same;
+}
+
+
+/** Converts the test profiles to a binary profile store and back,
+ *  reporting any differences.
+ *
+ *  \return true if every profile was recovered unchanged
+ */
+bool run_dumpload_round_trip_tests() {
+   bool ok = true;
+   Dumpload_Data * profiles[TEST_PROFILE_CT] = {NULL};
+   for (int ndx = 0; ndx < TEST_PROFILE_CT; ndx++) {
+      profiles[ndx] = parse_test_profile(test_profiles[ndx]);
+      if (!profiles[ndx])
+         ok = false;
+   }
+
+   if (ok) {
+      Buffer * buf = dumpload_data_to_binary(profiles, TEST_PROFILE_CT);
+      rpt_vstring(0, "Binary profile store: %d profiles, %d bytes", TEST_PROFILE_CT, buf->len);
+      if (!is_dumpload_binary(buf->bytes, buf->len)) {
+         rpt_vstring(1, "Not recognized as a binary profile store");
+         ok = false;
+      }
+
+      for (int ndx = 0; ok && ndx < TEST_PROFILE_CT; ndx++) {
+         int section_ndx = -1;
+         Dumpload_Data * recovered = NULL;
+         Error_Info * err = dumpload_binary_find_section(
+                               buf->bytes, buf->len, profiles[ndx]->edidbytes, &section_ndx);
+         if (!err)
+            err = create_dumpload_data_from_binary(buf->bytes, buf->len, section_ndx, &recovered);
+         bool passed = !err && same_text_form(profiles[ndx], recovered, 2);
+         rpt_vstring(1, "Profile %d, section %d: %s",
+                        ndx+1, section_ndx, (passed) ? "passed" : "FAILED");
+         if (err) {
+            rpt_vstring(2, "%s", errinfo_summary(err));
+            errinfo_free(err);
+         }
+         if (recovered)
+            free_dumpload_data(recovered);
+         ok = ok && passed;
+      }
+      buffer_free(buf, __func__);
+   }
+
+   for (int ndx = 0; ndx < TEST_PROFILE_CT; ndx++) {
+      if (profiles[ndx])
+         free_dumpload_data(profiles[ndx]);
+   }
+   rpt_vstring(0, "Text/binary round trip %s", (ok) ? "passed" : "FAILED");
+   return ok;
+}
@@ -0,0 +1,16 @@
+/** \file ddc_dumpload_tests.h
+ *
+ *  Checks the conversion of dumpvcp data between text and binary form
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_DUMPLOAD_TESTS_H_
+#define DDC_DUMPLOAD_TESTS_H_
+
+#include <stdbool.h>
+
+bool run_dumpload_round_trip_tests();
+
+#endif /* DDC_DUMPLOAD_TESTS_H_ */
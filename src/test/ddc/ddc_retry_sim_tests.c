@@ -0,0 +1,397 @@
+/** \file ddc_retry_sim_tests.c
+ *
+ *  Replays failure profiles against a simulated display, to measure how the
+ *  retry, sleep, and multi-part read logic behave when DDC communication
+ *  fails.  No monitor is required.
+ *
+ *  The simulated display replaces the I2C bus for DDC exchanges.  It answers
+ *  Get VCP Feature and Capabilities requests, and records the values of
+ *  Set VCP Feature requests.  Failures are injected by failsim, using the
+ *  control file line format of option --failsim, for functions
+ *  sim_ddc_writer() and sim_ddc_reader().  For the reader, the simulated
+ *  status code determines what the display returns:
+ *
+ *  - DDCRC_NULL_RESPONSE:  a DDC Null Message
+ *  - DDCRC_DDC_DATA:       the correct response with an invalid checksum
+ *  - DDCRC_READ_ALL_ZERO:  all zero bytes
+ *  - any other value:      returned as the status of the read, e.g. base:EBUSY
+ *
+ *  Since failsim counts calls, the number of tries used by each scenario
+ *  is deterministic and is checked exactly.  Elapsed time depends on the
+ *  load of the system, so it is only reported, along with the time expected
+ *  with the default sleep settings scaled by the sleep multiplier.  Each
+ *  scenario uses its own simulated bus number, so the adaptive retry budgets
+ *  learned in one scenario do not affect another.
+ *
+ *  Requires failsim, i.e. configure option --enable-failsim.
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "config.h"
+
+/** \cond */
+#include <assert.h>
+#include <fcntl.h>
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+/** \endcond */
+
+#include "util/data_structures.h"
+#include "util/error_info.h"
+#include "util/failsim.h"
+#include "util/report_util.h"
+#include "util/timestamp.h"
+
+#include "base/core.h"
+#include "base/ddc_errno.h"
+#include "base/ddc_packets.h"
+#include "base/displays.h"
+#include "base/status_code_mgt.h"
+#include "base/thread_sleep_data.h"
+
+#include "i2c/i2c_strategy_dispatcher.h"
+
+#include "ddc/ddc_multi_part_io.h"
+#include "ddc/ddc_vcp.h"
+
+#include "test/ddc/ddc_retry_sim_tests.h"
+
+
+#ifdef ENABLE_FAILSIM
+
+#define SIM_BUSNO_BASE  200     ///< simulated bus numbers, unlikely to exist
+#define SIM_FEATURE     0x10    ///< feature read and written by scenarios
+#define SIM_MAX_VALUE   100
+
+// 173 bytes, read in 6 fragments and a terminating empty fragment
+static const char * sim_capabilities =
+   "(prot(monitor)type(lcd)model(SIMULATED)cmds(01 02 03 0C E3 F3)"
+   "vcp(02 04 05 08 10 12 14(05 08 0B) 16 18 1A 60(0F 11) AC AE B2 B6 C6 C8 C9 D6(01 04) DF)"
+   "mswhql(1)mccs_ver(2.1))";
+
+/** State of the simulated display */
+typedef struct {
+   Byte     last_request[MAX_DDC_PACKET_INC_CHECKSUM];  ///< as written, starting with source address
+   int      last_request_len;
+   uint16_t values[256];
+   int      write_ct;                                   ///< calls of sim_ddc_writer()
+} Simulated_Display;
+
+static Simulated_Display sim;
+
+
+//
+// Simulated display
+//
+
+// Called by invoke_i2c_writer() in place of the bus writer.
+// N.b. failsim control lines refer to this function by name
+Status_Errno_DDC
+sim_ddc_writer(
+      int    fd,
+      Byte   slave_address,
+      int    bytect,
+      Byte * bytes_to_write)
+{
+   sim.write_ct++;
+   Failsim_Result fsim = fsim_check_failure(__FILE__, __func__);
+   if (fsim.force_failure)
+      return fsim.failure_value;
+
+   assert(bytect >= 3 && bytect <= sizeof(sim.last_request));
+   memcpy(sim.last_request, bytes_to_write, bytect);
+   sim.last_request_len = bytect;
+   if (bytes_to_write[2] == DDC_PACKET_TYPE_SET_VCP_REQUEST)
+      sim.values[bytes_to_write[3]] = bytes_to_write[4] << 8 | bytes_to_write[5];
+   return 0;
+}
+
+
+// Fills readbuf with a response as read from the bus:
+// source address, length, data bytes, checksum, then zeros
+static void
+set_sim_response(Byte * readbuf, int bytect, Byte * data, int datact) {
+   assert(datact + 3 <= bytect);
+   Byte packet[MAX_DDC_PACKET_INC_CHECKSUM];
+   packet[0] = 0x6f;             // implicit destination address, as in fill_ddc_response_packet()
+   packet[1] = 0x6e;
+   packet[2] = 0x80 | datact;
+   memcpy(packet+3, data, datact);
+   packet[3+datact] = ddc_checksum(packet, 3+datact, true);
+   memset(readbuf, 0, bytect);
+   memcpy(readbuf, packet+1, datact+3);
+}
+
+
+Status_Errno_DDC
+sim_ddc_reader(
+      int    fd,
+      Byte   slave_address,
+      bool   read_bytewise,
+      int    bytect,
+      Byte * readbuf)
+{
+   Byte data[MAX_DDC_DATA_SIZE];
+   int  datact = 0;            // DDC Null Message unless a request is recognized
+   Byte request_type = sim.last_request[2];
+
+   if (request_type == DDC_PACKET_TYPE_QUERY_VCP_REQUEST) {
+      Byte feature_code = sim.last_request[3];
+      data[0] = DDC_PACKET_TYPE_QUERY_VCP_RESPONSE;
+      data[1] = 0x00;          // result code: no error
+      data[2] = feature_code;
+      data[3] = 0x00;          // type code: set parameter
+      data[4] = SIM_MAX_VALUE >> 8;
+      data[5] = SIM_MAX_VALUE & 0xff;
+      data[6] = sim.values[feature_code] >> 8;
+      data[7] = sim.values[feature_code] & 0xff;
+      datact = 8;
+   }
+   else if (request_type == DDC_PACKET_TYPE_CAPABILITIES_REQUEST) {
+      int offset = sim.last_request[3] << 8 | sim.last_request[4];
+      int fragment_size = MIN((int) strlen(sim_capabilities) - offset, MAX_DDC_CAPABILITIES_FRAGMENT_SIZE);
+      fragment_size = MAX(fragment_size, 0);
+      data[0] = DDC_PACKET_TYPE_CAPABILITIES_RESPONSE;
+      data[1] = offset >> 8;
+      data[2] = offset & 0xff;
+      memcpy(data+3, sim_capabilities+offset, fragment_size);
+      datact = 3 + fragment_size;
+   }
+
+   bool bad_checksum = false;
+   Failsim_Result fsim = fsim_check_failure(__FILE__, __func__);
+   if (fsim.force_failure) {
+      switch(fsim.failure_value) {
+      case DDCRC_NULL_RESPONSE:
+         datact = 0;
+         break;
+      case DDCRC_DDC_DATA:
+         bad_checksum = true;
+         break;
+      case DDCRC_READ_ALL_ZERO:
+         memset(readbuf, 0, bytect);
+         return 0;
+      default:
+         return fsim.failure_value;
+      }
+   }
+
+   set_sim_response(readbuf, bytect, data, datact);
+   if (bad_checksum)
+      readbuf[2+datact] ^= 0xff;
+   return 0;
+}
+
+
+static I2C_IO_Strategy sim_io_strategy = {
+      I2C_IO_STRATEGY_FILEIO,        // not used for a test strategy
+      sim_ddc_writer,
+      sim_ddc_reader,
+      "sim_ddc_writer",
+      "sim_ddc_reader"
+};
+
+
+//
+// Scenarios
+//
+
+typedef enum {
+   SIM_OP_GETVCP,
+   SIM_OP_SETVCP,
+   SIM_OP_CAPABILITIES
+} Sim_Operation;
+
+static char * sim_operation_names[] = {"getvcp", "setvcp", "capabilities"};
+
+/** Describes a failure profile, the operations to perform, and the expected outcome */
+typedef struct {
+   char *        name;
+   Sim_Operation op;
+   char *        profile[5];          ///< failsim control lines, NULL terminated
+   int           op_ct;               ///< number of operations
+   int           expected_ok_ct;      ///< operations that succeed
+   int           expected_tries;      ///< calls of sim_ddc_writer()
+   int           expected_millis;     ///< typical elapsed time, default sleep settings, reported only
+} Sim_Scenario;
+
+static Sim_Scenario sim_scenarios[] = {
+   {"no failures",
+         SIM_OP_GETVCP, {NULL},
+         10, 10, 10, 750},
+   {"bursts of 2 null responses",
+         SIM_OP_GETVCP, {"sim_ddc_reader DDCRC_NULL_RESPONSE 2",
+                         "sim_ddc_reader DDCRC_NULL_RESPONSE 3",
+                         "sim_ddc_reader DDCRC_NULL_RESPONSE 7",
+                         "sim_ddc_reader DDCRC_NULL_RESPONSE 8",
+                         NULL},
+         10, 10, 14, 1500},
+   {"burst of 3 null responses",
+         SIM_OP_GETVCP, {"sim_ddc_reader DDCRC_NULL_RESPONSE 2",
+                         "sim_ddc_reader DDCRC_NULL_RESPONSE 3",
+                         "sim_ddc_reader DDCRC_NULL_RESPONSE 4",
+                         NULL},
+         10,  9, 12, 1150},
+   {"checksum error every 4th read",
+         SIM_OP_GETVCP, {"sim_ddc_reader DDCRC_DDC_DATA *4", NULL},
+         10, 10, 13, 1000},
+   {"EBUSY on 2 writes",
+         SIM_OP_GETVCP, {"sim_ddc_writer base:EBUSY 3",
+                         "sim_ddc_writer base:EBUSY 4",
+                         NULL},
+         10, 10, 12,  750},
+   {"EBUSY every 3rd write",
+         SIM_OP_SETVCP, {"sim_ddc_writer base:EBUSY *3", NULL},
+         10, 10, 14, 1050},
+   {"checksum error in fragment",
+         SIM_OP_CAPABILITIES, {"sim_ddc_reader DDCRC_DDC_DATA 3", NULL},
+          2,  2, 15, 2200},
+   {"all zero fragment",
+         SIM_OP_CAPABILITIES, {"sim_ddc_reader DDCRC_READ_ALL_ZERO 10", NULL},
+          2,  2, 15, 2200},
+};
+static const int sim_scenario_ct = sizeof(sim_scenarios)/sizeof(Sim_Scenario);
+
+
+// Performs one operation.  Returns the status code of the operation, and
+// sets *correct_loc to whether a successful operation gave the right result.
+static DDCA_Status
+run_sim_operation(Display_Handle * dh, Sim_Operation op, int opndx, bool * correct_loc) {
+   Error_Info * excp = NULL;
+   *correct_loc = false;
+   switch(op) {
+   case SIM_OP_GETVCP:
+      {
+         Parsed_Nontable_Vcp_Response response;
+         excp = ddc_read_nontable_vcp_value(dh, SIM_FEATURE, &response);
+         *correct_loc = !excp && response.cur_value == sim.values[SIM_FEATURE]
+                              && response.max_value == SIM_MAX_VALUE;
+      }
+      break;
+   case SIM_OP_SETVCP:
+      excp = ddc_set_nontable_vcp_value(dh, SIM_FEATURE, opndx+1);
+      *correct_loc = !excp && sim.values[SIM_FEATURE] == opndx+1;
+      break;
+   case SIM_OP_CAPABILITIES:
+      {
+         Buffer * buf = NULL;
+         excp = multi_part_read_with_retry(
+                   dh, DDC_PACKET_TYPE_CAPABILITIES_REQUEST, 0x00, false, &buf);
+         *correct_loc = !excp && buf->len == strlen(sim_capabilities) &&
+                        memcmp(buf->bytes, sim_capabilities, buf->len) == 0;
+         if (buf)
+            buffer_free(buf, __func__);
+      }
+      break;
+   }
+   DDCA_Status psc = ERRINFO_STATUS(excp);
+   errinfo_free(excp);
+   return psc;
+}
+
+
+static bool
+load_sim_profile(char ** profile) {
+   fsim_clear_error_table();
+   bool ok = true;
+   if (profile[0]) {
+      GPtrArray * lines = g_ptr_array_new();
+      for (int ndx = 0; profile[ndx]; ndx++)
+         g_ptr_array_add(lines, profile[ndx]);
+      ok = fsim_load_control_from_gptrarray(lines);
+      g_ptr_array_free(lines, true);
+   }
+   return ok;
+}
+
+
+static bool
+run_sim_scenario(Sim_Scenario * scenario, int busno, int depth) {
+   memset(&sim, 0, sizeof(sim));
+   sim.values[SIM_FEATURE] = SIM_MAX_VALUE/2;
+   if (!load_sim_profile(scenario->profile)) {
+      rpt_vstring(depth, "%-32s invalid failure profile", scenario->name);
+      return false;
+   }
+
+   int fd = open("/dev/null", O_RDWR);      // a real descriptor, for per-fd IO records
+   Display_Ref * dref = create_bus_display_ref(busno);
+   dref->flags |= DREF_TRANSIENT;
+   Display_Handle * dh = create_bus_display_handle_from_display_ref(fd, dref);
+
+   int ok_ct = 0;
+   int incorrect_ct = 0;
+   DDCA_Status last_failure = 0;
+   uint64_t start_nanos = cur_realtime_nanosec();
+   for (int opndx = 0; opndx < scenario->op_ct; opndx++) {
+      bool correct;
+      DDCA_Status psc = run_sim_operation(dh, scenario->op, opndx, &correct);
+      if (psc == 0) {
+         ok_ct++;
+         if (!correct)
+            incorrect_ct++;
+      }
+      else
+         last_failure = psc;
+   }
+   int elapsed_millis = (cur_realtime_nanosec() - start_nanos) / (1000*1000);
+   int expected_millis = scenario->expected_millis * MAX(tsd_get_default_sleep_multiplier_factor(), 1.0);
+
+   free_display_handle(dh);
+   free_display_ref(dref);
+   close(fd);
+   fsim_clear_error_table();
+
+   bool passed = ok_ct        == scenario->expected_ok_ct &&
+                 incorrect_ct == 0 &&
+                 sim.write_ct == scenario->expected_tries;
+   rpt_vstring(depth, "%-32s %-12s ok %2d/%2d  tries %3d/%3d  %5d/%5d ms  %s",
+                      scenario->name, sim_operation_names[scenario->op],
+                      ok_ct, scenario->expected_ok_ct,
+                      sim.write_ct, scenario->expected_tries,
+                      elapsed_millis, expected_millis,
+                      (passed) ? "passed" : "FAILED");
+   if (incorrect_ct > 0)
+      rpt_vstring(depth+1, "%d successful operations returned incorrect results", incorrect_ct);
+   if (last_failure != 0)
+      rpt_vstring(depth+1, "Last failure: %s", psc_desc(last_failure));
+   return passed;
+}
+
+
+/** Runs each failure profile scenario against the simulated display.
+ *
+ *  For each scenario, reports the operations that succeeded, the number of
+ *  tries, and the elapsed time, each with its expected value.  A scenario
+ *  passes if the operation and try counts are as expected.
+ *
+ *  \return true if all scenarios passed
+ */
+bool run_retry_sim_tests() {
+   fsim_set_name_to_number_funcs(
+         status_name_to_modulated_number,
+         status_name_to_unmodulated_number);
+   bool saved_failure_reports = fsim_enable_failure_reports(false);
+   bool saved_force_refresh   = ddc_set_force_value_refresh(true);
+   i2c_set_test_io_strategy(&sim_io_strategy);
+
+   rpt_vstring(0, "%-32s %-12s ok actual/expected, tries actual/expected, elapsed actual/expected",
+                  "Scenario", "Operation");
+   int passed_ct = 0;
+   for (int ndx = 0; ndx < sim_scenario_ct; ndx++) {
+      if (run_sim_scenario(&sim_scenarios[ndx], SIM_BUSNO_BASE+ndx, 1))
+         passed_ct++;
+   }
+   rpt_vstring(0, "%d of %d scenarios passed", passed_ct, sim_scenario_ct);
+
+   i2c_set_test_io_strategy(NULL);
+   ddc_set_force_value_refresh(saved_force_refresh);
+   fsim_enable_failure_reports(saved_failure_reports);
+   return passed_ct == sim_scenario_ct;
+}
+#endif
@@ -0,0 +1,16 @@
+/** \file ddc_retry_sim_tests.h
+ *
+ *  Replays failure profiles against a simulated display
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_RETRY_SIM_TESTS_H_
+#define DDC_RETRY_SIM_TESTS_H_
+
+#include <stdbool.h>
+
+bool run_retry_sim_tests();
+
+#endif /* DDC_RETRY_SIM_TESTS_H_ */
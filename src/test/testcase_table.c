@@ -24,6 +24,8 @@
 #include <config.h>
 
 #include "ddc/ddc_capabilities_tests.h"
+#include "ddc/ddc_dumpload_tests.h"
+#include "ddc/ddc_retry_sim_tests.h"
 #include "ddc/ddc_vcp_tests.h"
 #include "i2c/i2c_edid_tests.h"
 
@@ -33,7 +35,11 @@ Testcase_Descriptor testcase_catalog[] = {
       {"get_luminosity_sample_code",        DisplayRefBus,  NULL, get_luminosity_sample_code, NULL, NULL},
       {"get_luminosity_using_single_ioctl", DisplayRefBus,  NULL, get_luminosity_using_single_ioctl, NULL, NULL},
       {"demo_nvidia_bug_sample_code",       DisplayRefBus,  NULL, demo_nvidia_bug_sample_code, NULL, NULL},
-      {"demo_p2411_problem",                DisplayRefBus,  NULL, demo_p2411_problem, NULL, NULL}
+      {"demo_p2411_problem",                DisplayRefBus,  NULL, demo_p2411_problem, NULL, NULL},
+      {"dumpload_round_trip",               DisplayRefNone, run_dumpload_round_trip_tests, NULL, NULL, NULL},
+#ifdef ENABLE_FAILSIM
+      {"retry_sim_scenarios",               DisplayRefNone, run_retry_sim_tests, NULL, NULL, NULL}
+#endif
 };
 int testcase_catalog_ct = sizeof(testcase_catalog)/sizeof(Testcase_Descriptor);
 
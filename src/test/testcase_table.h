@@ -29,7 +29,7 @@
 // type of display reference required/supported by the command
 typedef enum {DisplayRefNone, DisplayRefAny, DisplayRefBus, DisplayRefAdl} DisplayRefType;
 
-typedef void (*NoArgFunction)();
+typedef bool (*NoArgFunction)();
 typedef void (*BusArgFunction)(int busno);
 typedef void (*AdlArgFunction)(int iAdapterIndex, int iDisplayIndex);
 typedef void (*DisplayRefArgFunction)(Display_Ref * dref);
@@ -85,7 +85,7 @@ bool execute_testcase(int testnum, Display_Identifier* pdid) {
          switch (pDesc->drefType) {
 
          case DisplayRefNone:
-            pDesc->fp_noarg();
+            ok = pDesc->fp_noarg();
             break;
 
          case DisplayRefBus:
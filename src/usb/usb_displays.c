@@ -49,6 +49,7 @@ static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_USB;  // may be unused if all dia
 
 // Global variables
 static GPtrArray * usb_monitors = NULL;    // array of Usb_Monitor_Info
+static bool        usb_hidraw_io_enabled = false;   // default for newly detected monitors
 
 
 #define HID_USAGE_PAGE_MASK   0xffff0000
@@ -111,6 +112,9 @@ dbgrpt_usb_monitor_info(Usb_Monitor_Info * moninfo, int depth) {
    rpt_vstring(d1, "%-20s:    %s",     "hiddev_device_name",  moninfo->hiddev_device_name);
    rpt_vstring(d1, "%-20s:    %p",     "edid",                moninfo->edid);
    rpt_vstring(d1, "%-20s:    %p",     "hiddev_devinfo",      moninfo->hiddev_devinfo);
+   rpt_vstring(d1, "%-20s:    %s",     "use_hidraw",          sbool(moninfo->use_hidraw));
+   if (moninfo->hidraw_dev)
+      dbgrpt_usb_hidraw_device(moninfo->hidraw_dev, d1);
    rpt_title("Non-empty vcp_codes entries:", d1);
    int feature_code;
    for (feature_code = 0; feature_code < 256; feature_code++) {
@@ -475,6 +479,14 @@ get_usb_monitor_list() {
          // n. no free function set
          g_ptr_array_free(vcp_reports, true);
 
+         if (usb_hidraw_io_enabled) {
+            moninfo->hidraw_dev = usb_hidraw_open_monitor(moninfo->hiddev_devinfo->busnum,
+                                                          moninfo->hiddev_devinfo->devnum);
+            moninfo->use_hidraw = (moninfo->hidraw_dev != NULL);
+            if (!moninfo->hidraw_dev && ol >= DDCA_OL_VERBOSE)
+               f0printf(fout(), "hidraw device unavailable for %s, using hiddev\n", hiddev_fn);
+         }
+
          g_ptr_array_add(usb_monitors, moninfo);
 
  close:
@@ -501,6 +513,27 @@ get_usb_monitor_list() {
 
 
 
+/** Sets whether monitors detected subsequently exchange feature reports
+ *  using hidraw instead of hiddev.
+ *
+ *  \param onoff  true/false
+ */
+void
+usb_enable_hidraw_io(bool onoff) {
+   usb_hidraw_io_enabled = onoff;
+}
+
+
+/** Reports whether hidraw is used by default for USB connected monitors.
+ *
+ *  \return true/false
+ */
+bool
+usb_is_hidraw_io_enabled() {
+   return usb_hidraw_io_enabled;
+}
+
+
 //
 // Functions to find Usb_Monitor_Info for a display
 //
@@ -551,6 +584,28 @@ usb_find_monitor_by_dh(Display_Handle * dh) {
 }
 
 
+/** Selects whether feature reports for a single monitor are exchanged
+ *  using hidraw or hiddev.  The hidraw device is opened if necessary.
+ *
+ *  \param  dh     display handle for USB connected monitor
+ *  \param  onoff  true to use hidraw, false to use hiddev
+ *  \return true if hidraw is now in use for the monitor
+ */
+bool
+usb_set_hidraw_io_by_dh(Display_Handle * dh, bool onoff) {
+   bool debug = false;
+   Usb_Monitor_Info * moninfo = usb_find_monitor_by_dh(dh);
+   assert(moninfo);
+   if (onoff && !moninfo->hidraw_dev)
+      moninfo->hidraw_dev = usb_hidraw_open_monitor(moninfo->hiddev_devinfo->busnum,
+                                                    moninfo->hiddev_devinfo->devnum);
+   moninfo->use_hidraw = onoff && moninfo->hidraw_dev;
+   DBGTRC(debug, TRACE_GROUP, "dh=%s, onoff=%s, returning %s",
+                              dh_repr_t(dh), sbool(onoff), sbool(moninfo->use_hidraw));
+   return moninfo->use_hidraw;
+}
+
+
 #ifdef APPARENTLY_UNUSED
 char * get_hiddev_devname_by_dref(Display_Ref * dref) {
    Usb_Monitor_Info * moninfo = usb_find_monitor_by_dref(dref);
@@ -746,6 +801,7 @@ check_usb_monitor( char * device_name ) {
 void
 init_usb_displays() {
    rtti_func_name_table_add(get_usb_monitor_list, "get_usb_monitor_list");
+   rtti_func_name_table_add(usb_set_hidraw_io_by_dh, "usb_set_hidraw_io_by_dh");
    rtti_func_name_table_add(avoid_device_by_usb_interfaces_property_string,
                             "avoid_device_by_usb_interfaces_property_string");
    rtti_func_name_table_add(is_possible_monitor_by_hiddev_name,
@@ -21,6 +21,7 @@
 #include "vcp/vcp_feature_values.h"
 
 #include "usb/usb_base.h"
+#include "usb/usb_hidraw_vcp.h"
 
 
 bool check_usb_monitor( char * device_name );
@@ -63,6 +64,8 @@ typedef struct usb_monitor_info {
    struct hiddev_devinfo *  hiddev_devinfo;
    // a flagrant waste of space, avoid premature optimization
    GPtrArray *              vcp_codes[256];   // array of Usb_Monitor_Vcp_Rec *
+   Usb_Hidraw_Device *      hidraw_dev;       // NULL if hidraw device not opened
+   bool                     use_hidraw;       // prefer hidraw to hiddev for feature reports
 } Usb_Monitor_Info;
 
 void        dbgrpt_usb_monitor_info(Usb_Monitor_Info * moninfo, int depth);
@@ -70,6 +73,9 @@ Usb_Monitor_Info *
             usb_find_monitor_by_dh(Display_Handle * dh);
 bool        is_possible_monitor_by_hiddev_name(const char * hiddev_name);
 GPtrArray * get_usb_monitor_list();
+void        usb_enable_hidraw_io(bool onoff);
+bool        usb_is_hidraw_io_enabled();
+bool        usb_set_hidraw_io_by_dh(Display_Handle * dh, bool onoff);
 void        init_usb_displays();
 
 #endif /* USB_DISPLAYS_H_ */
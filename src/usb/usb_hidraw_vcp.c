@@ -0,0 +1,523 @@
+/** \file usb_hidraw_vcp.c
+ *
+ * Get and set VCP feature values for USB connected monitors by exchanging
+ * raw feature reports over the hidraw interface.
+ *
+ * The hiddev interface transfers one report per HIDIOCGREPORT/HIDIOCSREPORT
+ * call, but requires additional ioctl() calls to locate and extract each
+ * usage.  Using hidraw, the report descriptor is parsed once, when the
+ * monitor is detected, and the position of each VCP feature within its
+ * feature report is recorded.  Thereafter a value is read with a single
+ * HIDIOCGFEATURE call, and the bits extracted directly from the report.
+ *
+ * Report exchanges on a device are serialized by a per-device lock, so
+ * that multiple threads can use the same device.
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/** \cond */
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <glib-2.0/glib.h>
+#include <linux/hidraw.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+/** \endcond */
+
+#include "util/report_util.h"
+#include "util/string_util.h"
+#include "util/udev_usb_util.h"
+
+#include "usb_util/hid_report_descriptor.h"
+#include "usb_util/hidraw_util.h"
+
+#include "base/core.h"
+#include "base/ddc_errno.h"
+#include "base/execution_stats.h"
+#include "base/linux_errno.h"
+#include "base/rtti.h"
+
+#include "usb/usb_hidraw_vcp.h"
+
+
+// Trace class for this file
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_USB;
+
+#define HID_UP_MONITOR_VESA_PAGE   0x0082
+
+// Maximum feature report size, including report id byte
+#define MAX_HIDRAW_REPORT_LEN      4096
+
+
+//
+// Build feature locators from the report descriptor
+//
+
+/* Records the locators for the VCP features in a single parsed report.
+ * Fields are laid out consecutively, starting at bit 0 of the report data.
+ * A report longer than MAX_HIDRAW_REPORT_LEN is ignored.
+ */
+static void
+add_report_locators(
+      Usb_Hidraw_Device * hdev,
+      Parsed_Hid_Report * rpt)
+{
+   bool debug = false;
+   if (rpt->report_type != HID_REPORT_TYPE_FEATURE || !rpt->hid_fields)
+      return;
+
+   int bit_offset = 0;
+   Usb_Hidraw_Vcp_Locator * report_locators[256] = {NULL};
+   int                      report_locator_ct = 0;
+
+   for (int fndx = 0; fndx < rpt->hid_fields->len; fndx++) {
+      Parsed_Hid_Field * f = g_ptr_array_index(rpt->hid_fields, fndx);
+      bool usable = !(f->item_flags & HID_FIELD_CONSTANT) &&
+                     (f->item_flags & HID_FIELD_VARIABLE);
+      for (int undx = 0; undx < f->report_count; undx++) {
+         uint32_t usage = 0;
+         if (f->extended_usages && f->extended_usages->len > 0) {
+            int ndx = (undx < f->extended_usages->len) ? undx : f->extended_usages->len-1;
+            usage = g_array_index(f->extended_usages, uint32_t, ndx);
+         }
+         else if (f->max_extended_usage > f->min_extended_usage) {
+            usage = f->min_extended_usage + undx;
+            if (usage > f->max_extended_usage)
+               usage = f->max_extended_usage;
+         }
+         Byte vcp_code = usage & 0xff;
+         if (usable &&
+             (usage >> 16) == HID_UP_MONITOR_VESA_PAGE &&
+             vcp_code != 0 &&
+             f->report_size <= 32 &&
+             !hdev->locators[vcp_code])      // first occurrence is used
+         {
+            Usb_Hidraw_Vcp_Locator * loc = calloc(1, sizeof(Usb_Hidraw_Vcp_Locator));
+            loc->vcp_code        = vcp_code;
+            loc->report_id       = rpt->report_id;
+            loc->bit_offset      = bit_offset;
+            loc->bit_size        = f->report_size;
+            loc->logical_minimum = f->logical_minimum;
+            loc->logical_maximum = f->logical_maximum;
+            hdev->locators[vcp_code] = loc;
+            report_locators[report_locator_ct++] = loc;
+         }
+         bit_offset += f->report_size;
+         if (bit_offset > 8 * MAX_HIDRAW_REPORT_LEN)    // too long, avoid overflow
+            break;
+      }
+      if (bit_offset > 8 * MAX_HIDRAW_REPORT_LEN)
+         break;
+   }
+
+   // hidraw always reserves the first byte of the buffer for the report id,
+   // even for unnumbered reports (report id 0)
+   int report_len = 1 + (bit_offset + 7) / 8;
+   if (report_len > MAX_HIDRAW_REPORT_LEN) {
+      DBGMSF(debug, "report_id=0x%02x, report_len=%d exceeds %d, ignoring report",
+                    rpt->report_id, report_len, MAX_HIDRAW_REPORT_LEN);
+      for (int ndx = 0; ndx < report_locator_ct; ndx++) {
+         hdev->locators[report_locators[ndx]->vcp_code] = NULL;
+         free(report_locators[ndx]);
+      }
+      return;
+   }
+   for (int ndx = 0; ndx < report_locator_ct; ndx++)
+      report_locators[ndx]->report_len = report_len;
+
+   DBGMSF(debug, "report_id=0x%02x, report_len=%d, %d VCP features",
+                 rpt->report_id, report_len, report_locator_ct);
+}
+
+
+static void
+add_collection_locators(
+      Usb_Hidraw_Device *     hdev,
+      Parsed_Hid_Collection * col)
+{
+   if (col->reports) {
+      for (int ndx = 0; ndx < col->reports->len; ndx++)
+         add_report_locators(hdev, g_ptr_array_index(col->reports, ndx));
+   }
+   if (col->child_collections) {
+      for (int ndx = 0; ndx < col->child_collections->len; ndx++)
+         add_collection_locators(hdev, g_ptr_array_index(col->child_collections, ndx));
+   }
+}
+
+
+static bool
+build_locators(Usb_Hidraw_Device * hdev) {
+   bool debug = false;
+   bool ok = false;
+   int desc_size = 0;
+   if (ioctl(hdev->fd, HIDIOCGRDESCSIZE, &desc_size) < 0) {
+      REPORT_IOCTL_ERROR("HIDIOCGRDESCSIZE", errno);
+      goto bye;
+   }
+   struct hidraw_report_descriptor rpt_desc = {0};
+   rpt_desc.size = desc_size;
+   if (ioctl(hdev->fd, HIDIOCGRDESC, &rpt_desc) < 0) {
+      REPORT_IOCTL_ERROR("HIDIOCGRDESC", errno);
+      goto bye;
+   }
+
+   Parsed_Hid_Descriptor * phd = parse_hid_report_desc(rpt_desc.value, rpt_desc.size);
+   if (phd) {
+      Parsed_Hid_Collection * col = get_monitor_application_collection(phd);
+      if (col) {
+         add_collection_locators(hdev, col);
+         for (int ndx = 0; ndx < 256 && !ok; ndx++)
+            ok = (hdev->locators[ndx] != NULL);
+      }
+      free_parsed_hid_descriptor(phd);
+   }
+
+bye:
+   DBGMSF(debug, "hidraw_devname=%s, returning %s", hdev->hidraw_devname, sbool(ok));
+   return ok;
+}
+
+
+//
+// Device open and close
+//
+
+/* Finds the hidraw device for a USB device. */
+static char *
+find_hidraw_devname(int busnum, int devnum) {
+   char * result = NULL;
+   GPtrArray * hidraw_names = get_hidraw_device_names_using_filesys();
+   for (int ndx = 0; ndx < hidraw_names->len && !result; ndx++) {
+      char * devname = g_ptr_array_index(hidraw_names, ndx);
+      Usb_Detailed_Device_Summary * devsum =
+            lookup_udev_usb_device_by_devname(devname, /* verbose = */ false);
+      if (devsum) {
+         int cur_busnum = 0;
+         int cur_devnum = 0;
+         if ( str_to_int(devsum->busnum_s, &cur_busnum, 10) &&
+              str_to_int(devsum->devnum_s, &cur_devnum, 10) &&
+              cur_busnum == busnum && cur_devnum == devnum )
+         {
+            result = strdup(devname);
+         }
+         free_usb_detailed_device_summary(devsum);
+      }
+   }
+   g_ptr_array_free(hidraw_names, true);
+   return result;
+}
+
+
+/** Opens the hidraw device for a USB connected monitor and determines
+ *  the location of each VCP feature within the device's feature reports.
+ *
+ *  The device remains open until #usb_hidraw_close_monitor() is called.
+ *
+ *  \param  busnum  USB bus number
+ *  \param  devnum  USB device number
+ *  \return newly allocated #Usb_Hidraw_Device,
+ *          NULL if no usable hidraw device
+ */
+Usb_Hidraw_Device *
+usb_hidraw_open_monitor(int busnum, int devnum) {
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP, "Starting. busnum=%d, devnum=%d", busnum, devnum);
+
+   Usb_Hidraw_Device * hdev = NULL;
+   char * devname = find_hidraw_devname(busnum, devnum);
+   if (devname) {
+      int fd = -1;
+      RECORD_IO_EVENT(IE_OPEN, ( fd = open(devname, O_RDWR) ) );
+      if (fd < 0) {
+         DBGTRC(debug, TRACE_GROUP, "Open failed for %s: %s", devname, linux_errno_desc(errno));
+         free(devname);
+      }
+      else {
+         hdev = calloc(1, sizeof(Usb_Hidraw_Device));
+         memcpy(hdev->marker, USB_HIDRAW_DEVICE_MARKER, 4);
+         hdev->hidraw_devname = devname;
+         hdev->fd = fd;
+         g_mutex_init(&hdev->lock);
+         if (!build_locators(hdev)) {
+            usb_hidraw_close_monitor(hdev);
+            hdev = NULL;
+         }
+      }
+   }
+
+   DBGTRC(debug, TRACE_GROUP, "Returning %p", hdev);
+   if (hdev && (debug || IS_TRACING()))
+      dbgrpt_usb_hidraw_device(hdev, 1);
+   return hdev;
+}
+
+
+/** Closes a #Usb_Hidraw_Device and releases its resources.
+ *
+ *  \param  hdev  pointer to #Usb_Hidraw_Device, may be NULL
+ */
+void
+usb_hidraw_close_monitor(Usb_Hidraw_Device * hdev) {
+   if (hdev) {
+      assert(memcmp(hdev->marker, USB_HIDRAW_DEVICE_MARKER, 4) == 0);
+      if (hdev->fd >= 0)
+         RECORD_IO_EVENT(IE_CLOSE, ( close(hdev->fd) ) );
+      for (int ndx = 0; ndx < 256; ndx++)
+         free(hdev->locators[ndx]);
+      g_mutex_clear(&hdev->lock);
+      free(hdev->hidraw_devname);
+      hdev->marker[3] = 'x';
+      free(hdev);
+   }
+}
+
+
+void
+dbgrpt_usb_hidraw_device(Usb_Hidraw_Device * hdev, int depth) {
+   int d1 = depth+1;
+   int d2 = depth+2;
+   rpt_structure_loc("Usb_Hidraw_Device", hdev, depth);
+   rpt_vstring(d1, "%-20s:    %s", "hidraw_devname", hdev->hidraw_devname);
+   rpt_vstring(d1, "%-20s:    %d", "fd",             hdev->fd);
+   rpt_title("Feature locators:", d1);
+   for (int ndx = 0; ndx < 256; ndx++) {
+      Usb_Hidraw_Vcp_Locator * loc = hdev->locators[ndx];
+      if (loc)
+         rpt_vstring(d2, "0x%02x: report_id=0x%02x, report_len=%d, bit_offset=%d, bit_size=%d, logical max=%d",
+                         loc->vcp_code, loc->report_id, loc->report_len,
+                         loc->bit_offset, loc->bit_size, loc->logical_maximum);
+   }
+}
+
+
+/** Indicates whether a feature can be accessed using hidraw.
+ *
+ *  \param  hdev          pointer to #Usb_Hidraw_Device
+ *  \param  feature_code  VCP feature code
+ *  \return true/false
+ */
+bool
+usb_hidraw_has_feature(Usb_Hidraw_Device * hdev, Byte feature_code) {
+   return hdev && hdev->locators[feature_code];
+}
+
+
+//
+// Report exchange and bit extraction
+//
+
+static __s32
+extract_value(const Byte * data, Usb_Hidraw_Vcp_Locator * loc) {
+   uint32_t v = 0;
+   for (int bit = 0; bit < loc->bit_size; bit++) {
+      int pos = loc->bit_offset + bit;
+      if (data[pos/8] & (1 << (pos%8)))
+         v |= (1u << bit);
+   }
+   // sign extend if the field can hold negative values
+   if (loc->logical_minimum < 0 && loc->bit_size < 32 && (v & (1u << (loc->bit_size-1))))
+      v |= ~0u << loc->bit_size;
+   return (__s32) v;
+}
+
+
+static void
+insert_value(Byte * data, Usb_Hidraw_Vcp_Locator * loc, __s32 value) {
+   for (int bit = 0; bit < loc->bit_size; bit++) {
+      int pos = loc->bit_offset + bit;
+      if ( (uint32_t) value & (1u << bit) )
+         data[pos/8] |=  (1 << (pos%8));
+      else
+         data[pos/8] &= ~(1 << (pos%8));
+   }
+}
+
+
+/* Reads a feature report.  Must be called with the device lock held.
+ *
+ * If the report length returned does not match the length computed from
+ * the report descriptor, the locators for the report are presumed to be
+ * wrong and the report is rejected.
+ *
+ * Returns:  status code
+ */
+static Public_Status_Code
+get_feature_report(Usb_Hidraw_Device * hdev, Usb_Hidraw_Vcp_Locator * loc, Byte * buf) {
+   assert(loc->report_len <= MAX_HIDRAW_REPORT_LEN);
+   buf[0] = loc->report_id;
+   int rc = 0;
+   RECORD_IO_EVENT(IE_HIDRAW_REPORT,
+                   ( rc = ioctl(hdev->fd, HIDIOCGFEATURE(loc->report_len), buf) ) );
+   Public_Status_Code psc = 0;
+   if (rc < 0) {
+      psc = -errno;
+      REPORT_IOCTL_ERROR("HIDIOCGFEATURE", errno);
+   }
+   else if (rc != loc->report_len) {
+      DBGMSG("Report 0x%02x: expected %d bytes, received %d",
+             loc->report_id, loc->report_len, rc);
+      psc = DDCRC_BAD_DATA;
+   }
+   return psc;
+}
+
+
+// Report data within the report buffer, following the report id byte
+#define REPORT_DATA(_loc, _buf)  ( (_buf) + 1 )
+
+
+/** Reads a non-table VCP feature value using hidraw.
+ *
+ *  \param  hdev          pointer to #Usb_Hidraw_Device
+ *  \param  feature_code  VCP feature code
+ *  \param  maxval        where to return maximum value
+ *  \param  curval        where to return current value
+ *  \return status code, DDCRC_REPORTED_UNSUPPORTED if the feature was
+ *          not found in the report descriptor
+ */
+Public_Status_Code
+usb_hidraw_get_nontable_vcp_value(
+      Usb_Hidraw_Device * hdev,
+      Byte                feature_code,
+      __s32 *             maxval,
+      __s32 *             curval)
+{
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP, "Starting. hidraw_devname=%s, feature_code=0x%02x",
+                              hdev->hidraw_devname, feature_code);
+   *maxval = 0;
+   *curval = 0;
+   Public_Status_Code psc = DDCRC_REPORTED_UNSUPPORTED;
+   Usb_Hidraw_Vcp_Locator * loc = hdev->locators[feature_code];
+   if (loc) {
+      Byte buf[MAX_HIDRAW_REPORT_LEN];
+      g_mutex_lock(&hdev->lock);
+      psc = get_feature_report(hdev, loc, buf);
+      g_mutex_unlock(&hdev->lock);
+      if (psc == 0) {
+         *curval = extract_value(REPORT_DATA(loc, buf), loc);
+         *maxval = loc->logical_maximum;
+      }
+   }
+   DBGTRC(debug, TRACE_GROUP, "Returning %s, maxval=%d, curval=%d", psc_desc(psc), *maxval, *curval);
+   return psc;
+}
+
+
+/** Reads multiple non-table VCP feature values using hidraw.
+ *  Each distinct feature report is read only once.
+ *
+ *  \param  hdev           pointer to #Usb_Hidraw_Device
+ *  \param  feature_codes  array of feature codes
+ *  \param  feature_ct     number of feature codes
+ *  \param  maxvals        array where to return maximum values
+ *  \param  curvals        array where to return current values
+ *  \param  statuses       array where to return status code for each feature
+ *  \return number of features successfully read
+ */
+int
+usb_hidraw_get_nontable_vcp_values(
+      Usb_Hidraw_Device * hdev,
+      Byte *              feature_codes,
+      int                 feature_ct,
+      __s32 *             maxvals,
+      __s32 *             curvals,
+      Public_Status_Code* statuses)
+{
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP, "Starting. hidraw_devname=%s, feature_ct=%d",
+                              hdev->hidraw_devname, feature_ct);
+
+   // report buffers, indexed by report id
+   Byte *             report_bufs[256]   = {NULL};
+   Public_Status_Code report_status[256] = {0};
+   int ok_ct = 0;
+
+   g_mutex_lock(&hdev->lock);
+   for (int ndx = 0; ndx < feature_ct; ndx++) {
+      maxvals[ndx] = 0;
+      curvals[ndx] = 0;
+      Usb_Hidraw_Vcp_Locator * loc = hdev->locators[feature_codes[ndx]];
+      if (!loc) {
+         statuses[ndx] = DDCRC_REPORTED_UNSUPPORTED;
+         continue;
+      }
+      if (!report_bufs[loc->report_id]) {
+         report_bufs[loc->report_id] = calloc(1, loc->report_len);
+         report_status[loc->report_id] = get_feature_report(hdev, loc, report_bufs[loc->report_id]);
+      }
+      statuses[ndx] = report_status[loc->report_id];
+      if (statuses[ndx] == 0) {
+         curvals[ndx] = extract_value(REPORT_DATA(loc, report_bufs[loc->report_id]), loc);
+         maxvals[ndx] = loc->logical_maximum;
+         ok_ct++;
+      }
+   }
+   g_mutex_unlock(&hdev->lock);
+
+   for (int ndx = 0; ndx < 256; ndx++)
+      free(report_bufs[ndx]);
+
+   DBGTRC(debug, TRACE_GROUP, "Returning %d", ok_ct);
+   return ok_ct;
+}
+
+
+/** Sets a non-table VCP feature value using hidraw.
+ *
+ *  The current contents of the feature report are read first, so that
+ *  other values in the same report are written back unchanged.
+ *
+ *  \param  hdev          pointer to #Usb_Hidraw_Device
+ *  \param  feature_code  VCP feature code
+ *  \param  new_value     value to set
+ *  \return status code, DDCRC_REPORTED_UNSUPPORTED if the feature was
+ *          not found in the report descriptor
+ */
+Public_Status_Code
+usb_hidraw_set_nontable_vcp_value(
+      Usb_Hidraw_Device * hdev,
+      Byte                feature_code,
+      __s32               new_value)
+{
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP, "Starting. hidraw_devname=%s, feature_code=0x%02x, new_value=%d",
+                              hdev->hidraw_devname, feature_code, new_value);
+   Public_Status_Code psc = DDCRC_REPORTED_UNSUPPORTED;
+   Usb_Hidraw_Vcp_Locator * loc = hdev->locators[feature_code];
+   if (loc) {
+      Byte buf[MAX_HIDRAW_REPORT_LEN];
+      g_mutex_lock(&hdev->lock);
+      psc = get_feature_report(hdev, loc, buf);
+      if (psc == 0) {
+         assert(loc->report_len <= MAX_HIDRAW_REPORT_LEN);
+         insert_value(REPORT_DATA(loc, buf), loc, new_value);
+         buf[0] = loc->report_id;
+         int rc = 0;
+         RECORD_IO_EVENT(IE_HIDRAW_REPORT,
+                         ( rc = ioctl(hdev->fd, HIDIOCSFEATURE(loc->report_len), buf) ) );
+         if (rc < 0) {
+            psc = -errno;
+            REPORT_IOCTL_ERROR("HIDIOCSFEATURE", errno);
+         }
+      }
+      g_mutex_unlock(&hdev->lock);
+   }
+   DBGTRC(debug, TRACE_GROUP, "Returning %s", psc_desc(psc));
+   return psc;
+}
+
+
+void
+init_usb_hidraw_vcp() {
+   RTTI_ADD_FUNC(usb_hidraw_open_monitor);
+   RTTI_ADD_FUNC(usb_hidraw_get_nontable_vcp_value);
+   RTTI_ADD_FUNC(usb_hidraw_get_nontable_vcp_values);
+   RTTI_ADD_FUNC(usb_hidraw_set_nontable_vcp_value);
+}
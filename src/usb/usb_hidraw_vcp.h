@@ -0,0 +1,93 @@
+/** \file usb_hidraw_vcp.h
+ *
+ * Get and set VCP feature values for USB connected monitors by exchanging
+ * raw feature reports over the hidraw interface.
+ */
+
+// Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef USB_HIDRAW_VCP_H_
+#define USB_HIDRAW_VCP_H_
+
+/** \cond */
+#include <glib-2.0/glib.h>
+#include <linux/types.h>
+#include <stdbool.h>
+/** \endcond */
+
+#include "util/coredefs.h"
+
+#include "base/core.h"
+
+
+/** Location of a VCP feature value within a HID feature report,
+ *  as derived from the device's report descriptor.
+ */
+typedef struct {
+   Byte      vcp_code;
+   Byte      report_id;          ///< 0 if the device does not use report ids
+   int       report_len;         ///< report length in bytes, always including report id byte
+   int       bit_offset;         ///< offset of value from start of report data
+   int       bit_size;           ///< size of value in bits
+   __s32     logical_minimum;
+   __s32     logical_maximum;
+} Usb_Hidraw_Vcp_Locator;
+
+
+/** Describes an open hidraw device for a USB connected monitor. */
+#define USB_HIDRAW_DEVICE_MARKER "UHRD"
+typedef struct {
+   char                     marker[4];
+   char *                   hidraw_devname;
+   int                      fd;
+   GMutex                   lock;             ///< serializes report exchanges on the device
+   Usb_Hidraw_Vcp_Locator * locators[256];    ///< indexed by VCP feature code
+} Usb_Hidraw_Device;
+
+
+Usb_Hidraw_Device *
+usb_hidraw_open_monitor(
+      int                 busnum,
+      int                 devnum);
+
+void
+usb_hidraw_close_monitor(
+      Usb_Hidraw_Device * hdev);
+
+void
+dbgrpt_usb_hidraw_device(
+      Usb_Hidraw_Device * hdev,
+      int                 depth);
+
+bool
+usb_hidraw_has_feature(
+      Usb_Hidraw_Device * hdev,
+      Byte                feature_code);
+
+Public_Status_Code
+usb_hidraw_get_nontable_vcp_value(
+      Usb_Hidraw_Device * hdev,
+      Byte                feature_code,
+      __s32 *             maxval,
+      __s32 *             curval);
+
+int
+usb_hidraw_get_nontable_vcp_values(
+      Usb_Hidraw_Device * hdev,
+      Byte *              feature_codes,
+      int                 feature_ct,
+      __s32 *             maxvals,
+      __s32 *             curvals,
+      Public_Status_Code* statuses);
+
+Public_Status_Code
+usb_hidraw_set_nontable_vcp_value(
+      Usb_Hidraw_Device * hdev,
+      Byte                feature_code,
+      __s32               new_value);
+
+void
+init_usb_hidraw_vcp();
+
+#endif /* USB_HIDRAW_VCP_H_ */
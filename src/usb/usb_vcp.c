@@ -29,6 +29,7 @@
 #include "base/linux_errno.h"
 
 #include "usb/usb_displays.h"
+#include "usb/usb_hidraw_vcp.h"
 
 #include "usb/usb_vcp.h"
 
@@ -190,7 +191,9 @@ set_control_value(int fd,
       REPORT_IOCTL_ERROR("HIDIOCSUSAGE", errno);
       goto bye;
    }
-   if (ioctl(fd, HIDIOCSREPORT, &rinfo) < 0) {
+   int rc = 0;
+   RECORD_IO_EVENT(IE_HIDDEV_REPORT, ( rc = ioctl(fd, HIDIOCSREPORT, &rinfo) ) );
+   if (rc < 0) {
       result = -errno;
       REPORT_IOCTL_ERROR("HIDIOCGUSAGE", errno);
       goto bye;
@@ -263,7 +266,9 @@ set_usage_value_by_report_type_and_ucode(
          .report_id   = uref.report_id
    };
 
-   if (ioctl(fd, HIDIOCSREPORT, &rinfo) < 0) {
+   int rc = 0;
+   RECORD_IO_EVENT(IE_HIDDEV_REPORT, ( rc = ioctl(fd, HIDIOCSREPORT, &rinfo) ) );
+   if (rc < 0) {
       psc = -errno;
       REPORT_IOCTL_ERROR("HIDIOCSREPORT", errno);
       goto bye;
@@ -280,7 +285,37 @@ bye:
 // Get and set based on a Usb_Monitor_Vcp_Rec
 //
 
-/* Gets the current value of a usage, as identified by a Usb_Monitor_Vcp_Rec
+/* Reads the report containing a usage from the device into hiddev's
+ * copy of the report, using the report info cached in a Usb_Monitor_Vcp_Rec.
+ *
+ * Arguments:
+ *    fd      file descriptor for open hiddev device
+ *    vcprec  pointer to a Usb_Monitor_Vcp_Rec identifying the report
+ *
+ * Returns:  status code
+ */
+static Public_Status_Code
+usb_refresh_report_by_vcprec(
+      int                   fd,
+      Usb_Monitor_Vcp_Rec * vcprec)
+{
+   assert(vcprec->rinfo->report_type == vcprec->report_type);
+   assert(vcprec->rinfo->report_type == HID_REPORT_TYPE_FEATURE ||
+          vcprec->rinfo->report_type == HID_REPORT_TYPE_INPUT);   // *** CG19 ***
+   assert(vcprec->rinfo->report_id   == vcprec->report_id);
+
+   int rc = 0;
+   RECORD_IO_EVENT(IE_HIDDEV_REPORT,
+                   ( rc = hiddev_get_report(fd, vcprec->rinfo, CALLOPT_ERR_MSG) ) );   // |CALLOPT_ERR_ABORT);
+   return (rc < 0) ? rc : 0;
+}
+
+
+/* Extracts the value of a usage from hiddev's copy of its report.
+ * The report must have already been read using usb_refresh_report_by_vcprec().
+ *
+ * The field locators and the logical maximum were saved when the monitor
+ * was detected, so no HIDIOCGFIELDINFO call or usage code lookup is needed.
  *
  * Arguments:
  *    fd      file descriptor for open hiddev device
@@ -289,37 +324,15 @@ bye:
  *    curval  address at which to return the current value of the usage
  *
  * Returns:  status code
- *
- * Calls to this function are valid only for Feature or Input reports.
  */
-Public_Status_Code
-usb_get_usage_value_by_vcprec(
+static Public_Status_Code
+usb_get_usage_value_from_report(
       int                   fd,
       Usb_Monitor_Vcp_Rec * vcprec,
       __s32 *               maxval,
       __s32 *               curval)
 {
    bool debug = false;
-   DBGMSF(debug, "Starting. fd=%d, vcprec=%p", fd, vcprec);
-   Public_Status_Code psc = 0;
-   int rc;
-
-   assert(vcprec->rinfo->report_type == vcprec->report_type);
-   assert(vcprec->rinfo->report_type == HID_REPORT_TYPE_FEATURE ||
-          vcprec->rinfo->report_type == HID_REPORT_TYPE_INPUT);   // *** CG19 ***
-   assert(vcprec->rinfo->report_id   == vcprec->report_id);
-
-   DBGMSF(debug, "report_type=%d (%s), report_id=%d, field_index=%d, usage_index=%d",
-                 vcprec->report_type,
-                 hiddev_report_type_name(vcprec->report_type),
-                 vcprec->report_id,
-                 vcprec->field_index,
-                 vcprec->usage_index);
-   rc = hiddev_get_report(fd, vcprec->rinfo, CALLOPT_ERR_MSG);   // |CALLOPT_ERR_ABORT);
-   if (rc < 0) {
-      psc = rc;
-      goto bye;
-   }
 
    __s32 maxval1 = vcprec->finfo->logical_maximum;
    __s32 maxval2 = vcprec->finfo->physical_maximum;
@@ -331,28 +344,51 @@ usb_get_usage_value_by_vcprec(
    }
 
    struct hiddev_usage_ref * uref = vcprec->uref;
-#ifdef DISABLE
-   uref->report_type = vcprec->report_type;
-   uref->report_id   = vcprec->report_id;
-   uref->field_index = vcprec->field_index;
-   uref->usage_index = vcprec->usage_index;
-#endif
    if (debug)
       dbgrpt_hiddev_usage_ref(uref, 1);
 
-   psc  = hiddev_get_usage_value(fd, uref, CALLOPT_ERR_MSG);
+   Public_Status_Code psc  = hiddev_get_usage_value(fd, uref, CALLOPT_ERR_MSG);
    // rc = ioctl(fd, HIDIOCGUSAGE, uref);  // Fills in usage value
-   if (psc != 0) {
-      // REPORT_IOCTL_ERROR("HIDIOCGUSAGE", rc);
-      // occasionally see -1, errno = 22 invalid argument - for Battery System Page: Run Time to Empty
-      // gsc = modulate_rc(-errsv, RR_ERRNO);
-   }
-   else {
+   if (psc == 0) {
       DBGMSF(debug, "usage_index=%d, value = 0x%08x",uref->usage_index, uref->value);
       *curval = uref->value;
    }
+   return psc;
+}
+
+
+/* Gets the current value of a usage, as identified by a Usb_Monitor_Vcp_Rec
+ *
+ * Arguments:
+ *    fd      file descriptor for open hiddev device
+ *    vcprec  pointer to a Usb_Monitor_Vcp_Rec identifying the value to retrieve
+ *    maxval  address at which to return max value of the usage
+ *    curval  address at which to return the current value of the usage
+ *
+ * Returns:  status code
+ *
+ * Calls to this function are valid only for Feature or Input reports.
+ */
+Public_Status_Code
+usb_get_usage_value_by_vcprec(
+      int                   fd,
+      Usb_Monitor_Vcp_Rec * vcprec,
+      __s32 *               maxval,
+      __s32 *               curval)
+{
+   bool debug = false;
+   DBGMSF(debug, "Starting. fd=%d, vcprec=%p", fd, vcprec);
+
+   DBGMSF(debug, "report_type=%d (%s), report_id=%d, field_index=%d, usage_index=%d",
+                 vcprec->report_type,
+                 hiddev_report_type_name(vcprec->report_type),
+                 vcprec->report_id,
+                 vcprec->field_index,
+                 vcprec->usage_index);
+   Public_Status_Code psc = usb_refresh_report_by_vcprec(fd, vcprec);
+   if (psc == 0)
+      psc = usb_get_usage_value_from_report(fd, vcprec, maxval, curval);
 
-bye:
    DBGMSF(debug, "Returning: %s", psc_desc(psc) );
    return psc;
 }
@@ -407,6 +443,50 @@ usb_set_usage_value_by_vcprec(
 }
 
 
+/* Returns the first Usb_Monitor_Vcp_Rec recorded for a feature at
+ * monitor detection that is usable for reading (is_read == true)
+ * or writing (is_read == false).
+ *
+ * Returns:  pointer to Usb_Monitor_Vcp_Rec, NULL if none
+ */
+static Usb_Monitor_Vcp_Rec *
+usb_find_vcprec(
+      Usb_Monitor_Info * moninfo,
+      Byte               feature_code,
+      bool               is_read)
+{
+   GPtrArray * vcp_recs = moninfo->vcp_codes[feature_code];
+   if (vcp_recs) {
+      // when reading, usage 0 returns correct value, usage 1 returns 0
+      // when writing, usage 0 works properly, usage 1 sets control to max value
+      for (int ndx=0; ndx<vcp_recs->len; ndx++) {
+         Usb_Monitor_Vcp_Rec * vcprec = g_ptr_array_index(vcp_recs,ndx);
+         assert( memcmp(vcprec->marker, USB_MONITOR_VCP_REC_MARKER,4) == 0 );
+         if (vcprec->report_type == ((is_read) ? HID_REPORT_TYPE_OUTPUT : HID_REPORT_TYPE_INPUT))
+            continue;
+         return vcprec;
+      }
+   }
+   return NULL;
+}
+
+
+static Parsed_Nontable_Vcp_Response *
+create_usb_nontable_response(Byte feature_code, __s32 maxval, __s32 curval) {
+   Parsed_Nontable_Vcp_Response * parsed_response = calloc(1, sizeof(Parsed_Nontable_Vcp_Response));
+   parsed_response->vcp_code = feature_code;
+   parsed_response->valid_response = true;
+   parsed_response->supported_opcode = true;
+   parsed_response->cur_value = curval;
+   parsed_response->max_value = maxval;
+   parsed_response->mh = (maxval >> 8) & 0xff;
+   parsed_response->ml = maxval & 0xff;
+   parsed_response->sh = (curval >> 8) & 0xff;
+   parsed_response->sl = curval & 0xff;
+   return parsed_response;
+}
+
+
 //
 //  High level getters/setters
 //
@@ -446,9 +526,25 @@ usb_get_nontable_vcp_value(
 
    __s32 maxval = 0;    // initialization logically unnecessary, but avoids clang scan warning
    __s32 curval = 0;    // ditto
-   bool use_alt_method = true;
 
-   if (use_alt_method) {
+   if (moninfo->use_hidraw && usb_hidraw_has_feature(moninfo->hidraw_dev, feature_code)) {
+      psc = usb_hidraw_get_nontable_vcp_value(moninfo->hidraw_dev, feature_code, &maxval, &curval);
+      DBGMSF(debug, "usb_hidraw_get_nontable_vcp_value() returned %s, maxval=%d, curval=%d",
+                    psc_desc(psc), maxval, curval);
+      if (psc == 0)
+         goto bye;
+   }
+
+   // Use the report, field, and usage indexes found when the monitor was
+   // detected.  Fall back to having hiddev locate the usage by usage code
+   // if the feature was not found in the reports or the read fails.
+   Usb_Monitor_Vcp_Rec * vcprec = usb_find_vcprec(moninfo, feature_code, /*is_read=*/ true);
+   if (vcprec) {
+      psc = usb_get_usage_value_by_vcprec(dh->fd,  vcprec, &maxval, &curval);
+      DBGMSF(debug, "usb_get_usage_value_by_vcprec() usage index: %d returned %d, maxval=%d, curval=%d",
+                    vcprec->usage_index, psc, maxval, curval);
+   }
+   if (!vcprec || psc != 0) {
       __u32 usage_code = 0x0082 << 16 | feature_code;
       psc = usb_get_usage_value_by_report_type_and_ucode(
                   dh->fd, HID_REPORT_TYPE_FEATURE, usage_code, &maxval, &curval);
@@ -456,53 +552,135 @@ usb_get_nontable_vcp_value(
          psc = usb_get_usage_value_by_report_type_and_ucode(
                   dh->fd, HID_REPORT_TYPE_INPUT,   usage_code, &maxval, &curval);
    }
-   else {
-      // find the field record
-      GPtrArray * vcp_recs = moninfo->vcp_codes[feature_code];
 
-      if (!vcp_recs) {
-         DBGMSF(debug, "Unrecognized feature code 0x%02x", feature_code);
-         psc = DDCRC_REPORTED_UNSUPPORTED;
+bye:
+   if (psc == 0)
+      parsed_response = create_usb_nontable_response(feature_code, maxval, curval);
+
+   DBGTRC(debug, TRACE_GROUP,
+             "Returning %s, *ppinterpreted_code=%p", psc_desc(psc), parsed_response);
+   *ppInterpretedCode = parsed_response;
+   return psc;
+}
+
+
+/* Gets the values of multiple non-table features.
+ *
+ * Features whose usages are located in the same HID report are read using
+ * a single HIDIOCGREPORT call, i.e. a single USB control transfer.  The
+ * individual values are then extracted from hiddev's copy of the report.
+ * Features for which no report was found at monitor detection are not
+ * read, and have status DDCRC_NOT_FOUND.  No feature is retried; features
+ * that were not read are left for the caller to read individually, e.g.
+ * using usb_get_nontable_vcp_value().
+ *
+ * If hidraw is in use for the monitor, features it can locate are read
+ * from raw feature reports first, and only those it cannot locate use hiddev.
+ *
+ * Arguments:
+ *   dh                 handle for open display
+ *   feature_codes      array of feature codes
+ *   feature_ct         number of feature codes
+ *   responses          array of feature_ct pointers, where to return
+ *                      a newly allocated response for each feature,
+ *                      NULL if the value could not be read
+ *   statuses           array of feature_ct status codes, where to return
+ *                      the status of each read
+ *
+ * Returns:
+ *   number of features successfully read
+ */
+int
+usb_get_nontable_vcp_values(
+       Display_Handle *                dh,
+       Byte *                          feature_codes,
+       int                             feature_ct,
+       Parsed_Nontable_Vcp_Response ** responses,
+       Public_Status_Code *            statuses)
+{
+   bool debug = false;
+   DBGTRC(debug, TRACE_GROUP, "Starting. dh=%s, feature_ct=%d", dh_repr_t(dh), feature_ct);
+   assert(dh->dref->io_path.io_mode == DDCA_IO_USB);
+
+   Usb_Monitor_Info * moninfo = usb_find_monitor_by_dh(dh);
+   assert(moninfo);
+
+   // Reports read so far in this call.  A monitor has only a handful of
+   // reports, so a linear search suffices.
+   typedef struct {
+      __u32              report_type;
+      __u32              report_id;
+      Public_Status_Code psc;
+   } Fetched_Report;
+   Fetched_Report * fetched = calloc(feature_ct+1, sizeof(Fetched_Report));
+   int fetched_ct = 0;
+   int ok_ct = 0;
+   int report_read_ct = 0;
+
+   Public_Status_Code * hidraw_statuses = NULL;
+   __s32 *              hidraw_maxvals  = NULL;
+   __s32 *              hidraw_curvals  = NULL;
+   if (moninfo->use_hidraw) {
+      hidraw_statuses = calloc(feature_ct+1, sizeof(Public_Status_Code));
+      hidraw_maxvals  = calloc(feature_ct+1, sizeof(__s32));
+      hidraw_curvals  = calloc(feature_ct+1, sizeof(__s32));
+      usb_hidraw_get_nontable_vcp_values(moninfo->hidraw_dev, feature_codes, feature_ct,
+                                         hidraw_maxvals, hidraw_curvals, hidraw_statuses);
+   }
+
+   for (int ndx = 0; ndx < feature_ct; ndx++) {
+      Byte feature_code = feature_codes[ndx];
+      responses[ndx] = NULL;
+      if (hidraw_statuses && hidraw_statuses[ndx] == 0) {
+         responses[ndx] = create_usb_nontable_response(
+                             feature_code, hidraw_maxvals[ndx], hidraw_curvals[ndx]);
+         statuses[ndx] = 0;
+         ok_ct++;
+         continue;
+      }
+      if (hidraw_statuses && hidraw_statuses[ndx] != DDCRC_REPORTED_UNSUPPORTED) {
+         statuses[ndx] = hidraw_statuses[ndx];     // located but read failed
+         continue;
+      }
+      Usb_Monitor_Vcp_Rec * vcprec = usb_find_vcprec(moninfo, feature_code, /*is_read=*/ true);
+      if (!vcprec) {
+         statuses[ndx] = DDCRC_NOT_FOUND;
       }
       else {
-         // DBGMSF(debug, "reading value");
-         // for testing purposes, try using each entry
-         // usage 0 returns correct value, usage 1 returns 0
-         // is usage 1 for writing?
-
-         for (int ndx=0; ndx<vcp_recs->len; ndx++) {
-         int ndx = 0;
-            Usb_Monitor_Vcp_Rec * vcprec = g_ptr_array_index(vcp_recs,ndx);
-            assert( memcmp(vcprec->marker, USB_MONITOR_VCP_REC_MARKER,4) == 0 );
-
-            if (vcprec->report_type == HID_REPORT_TYPE_OUTPUT)
-               continue;
-            psc = usb_get_usage_value_by_vcprec(dh->fd,  vcprec, &maxval, &curval);
-            DBGMSF(debug, "usb_get_usage() usage index: %d returned %d, maxval=%d, curval=%d",
-                          vcprec->usage_index, psc, maxval, curval);
-            if (psc == 0)
+         int fndx = 0;
+         for (; fndx < fetched_ct; fndx++) {
+            if (fetched[fndx].report_type == vcprec->report_type &&
+                fetched[fndx].report_id   == vcprec->report_id)
                break;
          }
-      }
-   }
+         if (fndx == fetched_ct) {
+            fetched[fndx].report_type = vcprec->report_type;
+            fetched[fndx].report_id   = vcprec->report_id;
+            fetched[fndx].psc         = usb_refresh_report_by_vcprec(dh->fd, vcprec);
+            fetched_ct++;
+            report_read_ct++;
+         }
 
-   if (psc == 0) {
-      parsed_response = calloc(1, sizeof(Parsed_Nontable_Vcp_Response));
-      parsed_response->vcp_code = feature_code;
-      parsed_response->valid_response = true;
-      parsed_response->supported_opcode = true;
-      parsed_response->cur_value = curval;
-      parsed_response->max_value = maxval;
-      parsed_response->mh = (maxval >> 8) & 0xff;
-      parsed_response->ml = maxval & 0xff;
-      parsed_response->sh = (curval >> 8) & 0xff;
-      parsed_response->sl = curval & 0xff;
+         __s32 maxval = 0;
+         __s32 curval = 0;
+         Public_Status_Code psc = fetched[fndx].psc;
+         if (psc == 0)
+            psc = usb_get_usage_value_from_report(dh->fd, vcprec, &maxval, &curval);
+         if (psc == 0)
+            responses[ndx] = create_usb_nontable_response(feature_code, maxval, curval);
+         statuses[ndx] = psc;
+      }
+      if (statuses[ndx] == 0)
+         ok_ct++;
    }
 
-   DBGTRC(debug, TRACE_GROUP,
-             "Returning %s, *ppinterpreted_code=%p", psc_desc(psc), parsed_response);
-   *ppInterpretedCode = parsed_response;
-   return psc;
+   free(fetched);
+   free(hidraw_statuses);
+   free(hidraw_maxvals);
+   free(hidraw_curvals);
+   DBGTRC(debug, TRACE_GROUP, "Done. Read %d of %d features using %d report reads",
+                              ok_ct, feature_ct, report_read_ct);
+   return ok_ct;
 }
 
 
@@ -605,49 +783,31 @@ usb_set_nontable_vcp_value(
    Usb_Monitor_Info * moninfo = usb_find_monitor_by_dh(dh);
    assert(moninfo);
 
-   bool use_alt = true;
-   if (use_alt) {
+   if (moninfo->use_hidraw && usb_hidraw_has_feature(moninfo->hidraw_dev, feature_code)) {
+      psc = usb_hidraw_set_nontable_vcp_value(moninfo->hidraw_dev, feature_code, new_value);
+      DBGMSF(debug, "usb_hidraw_set_nontable_vcp_value() returned %s", psc_desc(psc));
+      if (psc == 0)
+         goto bye;
+   }
+
+   // As with reading, prefer the report locators found at monitor detection
+   Usb_Monitor_Vcp_Rec * vcprec = usb_find_vcprec(moninfo, feature_code, /*is_read=*/ false);
+   if (vcprec) {
+      psc = usb_set_usage_value_by_vcprec(dh->fd,  vcprec, new_value);
+      DBGMSF(debug, "usb_set_usage_value_by_vcprec() usage index: %d returned %s",
+                    vcprec->usage_index, psc_desc(psc) );
+   }
+   if (!vcprec || psc != 0) {
       __u32 usage_code = 0x0082 << 16 | feature_code;
       psc = set_usage_value_by_report_type_and_ucode(
                dh->fd, HID_REPORT_TYPE_FEATURE, usage_code, new_value);
       // if (gsc != 0)
       //    gsc = set_usage_value_by_report_type_and_ucode(dh->fh, HID_REPORT_TYPE_OUTPUT, usage_code, new_value);
-      // if (gsc == modulate_rc(EINVAL, RR_ERRNO))
-      //   gsc = DDCRC_REPORTED_UNSUPPORTED;
       if (psc == -EINVAL)
          psc = DDCRC_REPORTED_UNSUPPORTED;
-
-   }
-   else {
-      // find the field record
-      GPtrArray * vcp_recs = moninfo->vcp_codes[feature_code];
-      if (!vcp_recs) {
-         DBGMSF(debug, "Unrecognized feature code 0x%02x", feature_code);
-         psc = DDCRC_REPORTED_UNSUPPORTED;
-      }
-      else {
-         DBGMSF(debug, "setting value");
-         // for testing purposes, try using each entry
-         // for reading, usage 0 returns correct value, usage 1 returns 0
-         // is usage 1 for writing?
-         // when writing, usage 0 works properly
-         //  usage 1, at least for brightness, sets control to max value
-
-         for (int ndx=0; ndx<vcp_recs->len; ndx++) {
-            Usb_Monitor_Vcp_Rec * vcprec = g_ptr_array_index(vcp_recs,ndx);
-            assert( memcmp(vcprec->marker, USB_MONITOR_VCP_REC_MARKER,4) == 0 );
-            if (vcprec->report_type == HID_REPORT_TYPE_INPUT)
-               continue;
-
-            psc = usb_set_usage_value_by_vcprec(dh->fd,  vcprec, new_value);
-            DBGMSF(debug, "usb_set_usage() usage index: %d returned %s",
-                          vcprec->usage_index, psc_desc(psc) );
-            if (psc == 0)
-               break;
-         }
-      }
    }
 
+bye:
    DBGTRC(debug, TRACE_GROUP, "Returning %s", psc_desc(psc));
    return psc;
 }
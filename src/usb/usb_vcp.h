@@ -34,6 +34,13 @@ Public_Status_Code usb_get_nontable_vcp_value(
       Byte                           feature_code,
       Parsed_Nontable_Vcp_Response** ppInterpretedCode);
 
+int usb_get_nontable_vcp_values(
+      Display_Handle *                dh,
+      Byte *                          feature_codes,
+      int                             feature_ct,
+      Parsed_Nontable_Vcp_Response ** responses,
+      Public_Status_Code *            statuses);
+
 Public_Status_Code usb_get_vcp_value(
       Display_Handle *          dh,
       Byte                      feature_code,
@@ -117,6 +117,7 @@ void summarize_parsed_hid_report(Parsed_Hid_Report * hr, int depth);
 void dbgrpt_parsed_hid_descriptor(Parsed_Hid_Descriptor * pdesc, int depth);
 
 bool is_monitor_by_parsed_hid_report_descriptor(Parsed_Hid_Descriptor * phd);
+Parsed_Hid_Collection * get_monitor_application_collection(Parsed_Hid_Descriptor * phd);
 
 // TODO: use same bit values as item type?   will that work?
 // TODO: poor names
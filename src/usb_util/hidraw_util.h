@@ -25,6 +25,11 @@
 #ifndef HIDRAW_UTIL_H_
 #define HIDRAW_UTIL_H_
 
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+
+GPtrArray * get_hidraw_device_names_using_filesys();
+
 void probe_hidraw(bool show_monitors_only, int depth);
 
 bool hidraw_is_monitor_device(char * devname);
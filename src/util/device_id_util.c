@@ -11,6 +11,7 @@
 #include <ctype.h>
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <glib-2.0/glib.h>
 #include <limits.h>
 #include <linux/limits.h>
@@ -18,6 +19,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <time.h>
 #include <unistd.h>
@@ -27,6 +29,7 @@
 #include "multi_level_map.h"
 #include "report_util.h"
 #include "string_util.h"
+#include "xdg_util.h"
 
 #include "device_id_util.h"
 
@@ -174,16 +177,42 @@ char * get_simple_id_name(Simple_Id_Table * simple_table, ushort id) {
 //   vendors:            2,066
 //   total devices:     11,745
 //   subsystem:         10,974
+//
+// Rather than parsing the entire pci.ids or usb.ids file into tables,
+// the file is mapped into memory.  The vendor, device, and subsystem or
+// interface lines are located in place, by binary search where the file
+// is sorted by id, and only names actually requested are copied.
+// A compact index of vendor line offsets is cached on disk.
 
-static Multi_Level_Map * pci_vendors_mlm = {0};
-static Multi_Level_Map * usb_vendors_mlm = {0};
+/** Vendor index entry */
+typedef struct {
+   uint16_t  id;         ///< vendor id
+   uint16_t  reserved;
+   uint32_t  offset;     ///< offset of vendor line in file
+} Devid_Vendor_Index_Entry;
 
+/** Memory mapped pci.ids or usb.ids file */
+typedef struct {
+   bool                       load_attempted;
+   const char *               data;          ///< mapped file contents, NULL if not found
+   size_t                     size;          ///< file size
+   time_t                     mtime;         ///< file modification time
+   size_t                     ids_end;       ///< end of vendor/device/subsystem section
+   Devid_Vendor_Index_Entry * vendors;       ///< sorted by vendor id
+   uint32_t                   vendor_ct;
+   GHashTable *               names;         ///< names returned to callers, keyed by line offset
+} Devid_Id_File;
+
+// keep in order with enum Device_Id_Type
+static Devid_Id_File id_files[2];
+static GMutex        devid_mutex;
+
+static bool              hid_tables_loaded = false;
 static Simple_Id_Table * hid_descriptor_types;       // tag HID
 static Simple_Id_Table * hid_descriptor_item_types;  // tag R
 static Simple_Id_Table * hid_country_codes;          // tag HCC - for keyboards
 static Multi_Level_Map * hid_usages_table;           // tag HUT
 
-
 //
 // *** Input File Parsing ***
 //
@@ -417,375 +446,494 @@ int find_next_segment_start(GPtrArray* lines, int cur_ndx, char* segment_tag) {
    return cur_ndx;
 }
 
+//
+// *** Memory Mapped Id Files ***
+//
 
-// returns line number of end of segment
-int load_device_ids(Device_Id_Type id_type, GPtrArray * all_lines) {
-   bool debug = false;
-    int total_vendors = 0;
-    int total_devices = 0;
-    int total_subsys  = 0;
-
-    MLM_Level usb_id_levels[] = {
-          {"vendor", 5000, 0},
-          {"product",  20, 0},
-          {"interface", 10, 0}
-    };
-
-    MLM_Level pci_id_levels[] = {
-          {"vendor",   10000, 0},
-          {"device",      20, 0},
-          {"subsystem",    5, 0}
-    };
-
-#define MAX_LEVELS 5
-     Multi_Level_Map * mlm = NULL;
-     int levelct = 3;
-
-     if (id_type == ID_TYPE_PCI) {
-        mlm = mlm_create("PCI Devices", 3, pci_id_levels);
-     }
-     else
-        mlm = mlm_create("USB Devices", 3, usb_id_levels);
-
-    MLM_Node * cur_node[MAX_LEVELS] = {NULL};
-
-    int linect = all_lines->len;
-    int linendx;
-    char * a_line;
-    bool device_ids_done = false;    // end of PCI id section seen?
-    for (linendx=0; linendx<linect && !device_ids_done; linendx++) {
-       a_line = g_ptr_array_index(all_lines, linendx);
-       int tabct = 0;
-       while (a_line[tabct] == '\t')
-          tabct++;
-       if (strlen(rtrim_in_place(a_line+tabct)) == 0 || a_line[tabct] == '#')
-          continue;
-       if (id_type == ID_TYPE_USB) {
-          // hacky test for end of id section
-          if (memcmp(a_line+tabct, "C", 1) == 0) {
-             device_ids_done = true;
-             continue;
-          }
-       }
-
-       switch(tabct) {
-
-       case (0):
-          {
-             ushort cur_id = 0;
-             char * cur_name = NULL;
-             int ct = sscanf(a_line+tabct, "%4hx %m[^\n]",
-                             &cur_id,
-                             &cur_name);
-
-             if (ct != 2) {
-                printf("(%s) Error reading line: %s\n", __func__, a_line+tabct);
-                // hex_dump(a_line+tabct, strlen(a_line+tabct));
-                for (int ndx = tabct; ndx < levelct; ndx++) {
-                   cur_node[ndx] = NULL;
-                }
-             }
-             else {
-                total_vendors++;
-                // usb.ids has no final ffff field, test works only for pci.ids
-                if (cur_id == 0xffff)
-                   device_ids_done = true;
-                cur_node[tabct] = mlm_add_node(mlm, NULL, cur_id, cur_name);
-                for (int ndx = tabct+1; ndx < levelct; ndx++) {
-                   cur_node[ndx] = NULL;
-                }
-             }
-             break;
-          }
-
-       case (1):
-          {
-             if (cur_node[tabct-1])  {
-                ushort cur_id;
-                char * cur_name;
-                int ct = sscanf(a_line+tabct, "%4hx %m[^\n]", &cur_id, &cur_name);
-
-                if (ct != 2) {
-                   printf("(%s) Error reading line: %s\n", __func__, a_line+tabct);
-                }
-                else {
-                   total_devices++;
-                   cur_node[tabct] = mlm_add_node(mlm, cur_node[tabct-1], cur_id, cur_name);
-                   for (int ndx = tabct+1; ndx < levelct; ndx++) {
-                      cur_node[ndx] = NULL;
-                   }
-                }
-
-             }
-             else {
-                // TODO: handle bad data case
-             }
-             break;
-          }
-
-       case (2):
-          {
-             if (cur_node[tabct-1]) {
-                if (id_type == ID_TYPE_PCI) {
-                   ushort this_subvendor_id = 0;
-                   ushort this_subdevice_id = 0;
-                   char * this_name = NULL;
-                   int ct = sscanf(a_line+tabct, "%4hx %4hx %m[^\n]",
-                                   &this_subvendor_id,
-                                   &this_subdevice_id,
-                                   &this_name);
-                   // transitional:
-
-                   uint   this_id = this_subvendor_id << 16 | this_subdevice_id;
-
-                   if (ct != 3) {
-                      printf("(%s) Error reading line: %s\n", __func__, a_line+tabct);
-                   }
-                   else {
-                      total_subsys++;
-                      cur_node[tabct] = mlm_add_node(mlm, cur_node[tabct-1], this_id, this_name);
-                   }
-                }  // ID_TYPE_PCI
-                else {     // ID_TYPE_USB
-                   ushort this_id = 0;
-                   char * this_name = NULL;
-                   int ct = sscanf(a_line+tabct, "%4hx  %m[^\n]",
-                                   &this_id,
-                                   &this_name);
-
-                   if (ct != 2) {
-                      printf("(%s) Error reading line: %s\n", __func__, a_line+tabct);
-                   }
-                   else {
-                      total_subsys++;
-                      // new
-                      cur_node[tabct] = mlm_add_node(mlm, cur_node[tabct-1], this_id, this_name);
-                   }
-                }  //ID_TYPE_USB
-             }  // if (cur_device)
-             break;
-          }
-
-       default:
-          printf("Unexpected number of leading tabs in line: %s\n", a_line);
-       } // switch
-    }    // line loop
-
-    if (id_type == ID_TYPE_PCI) {
-       pci_vendors_mlm = mlm;
-    }
-    else {
-       usb_vendors_mlm = mlm;
-    }
-
-    if (debug) {
-       char * level3_name = (id_type == ID_TYPE_PCI) ? "subsystems" : "interfaces";
-       printf("(%s) Total vendors: %d, total devices: %d, total %s: %d\n",
-              __func__, total_vendors, total_devices, level3_name, total_subsys);
-    }
-
-   return linendx;
+static inline size_t
+next_line(Devid_Id_File * idf, size_t pos) {
+   const char * nl = memchr(idf->data+pos, '\n', idf->ids_end-pos);
+   return (nl) ? (size_t) (nl - idf->data) + 1 : idf->ids_end;
 }
 
 
-static void load_file_lines(Device_Id_Type id_type, GPtrArray * all_lines) {
-   bool debug = false;
-   if (debug)
-      printf("(%s) Starting.  id_type=%d\n", __func__, id_type);
+/* Parses 4 hex digits.
+ *
+ * Returns:  value, -1 if not 4 hex digits
+ */
+static int
+parse_hex4(Devid_Id_File * idf, size_t pos) {
+   if (pos + 4 > idf->ids_end)
+      return -1;
+   int result = 0;
+   for (int ndx = 0; ndx < 4; ndx++) {
+      int v = g_ascii_xdigit_value(idf->data[pos+ndx]);
+      if (v < 0)
+         return -1;
+      result = result << 4 | v;
+   }
+   return result;
+}
 
-   int linendx;
-   // char * a_line;
 
-   linendx = load_device_ids(id_type, all_lines);
+/* Parses the id at the start of a line, after any leading tabs.
+ *
+ * Arguments:
+ *    idf       mapped file
+ *    pos       offset of start of line
+ *    tabct_loc where to return number of leading tabs
+ *
+ * Returns:     id, -1 if the line is not an id line, e.g. a comment
+ */
+static int
+parse_line_id(Devid_Id_File * idf, size_t pos, int * tabct_loc) {
+   int tabct = 0;
+   while (pos+tabct < idf->ids_end && idf->data[pos+tabct] == '\t')
+      tabct++;
+   *tabct_loc = tabct;
+   return parse_hex4(idf, pos+tabct);
+}
 
-   // if usb.ids, look for additional segments
-   if (id_type == ID_TYPE_USB) {
-         // a_line = g_ptr_array_index(all_lines, linendx);
-         // printf("(%s) First line of next segment: |%s|, linendx=%d\n", __func__, a_line, linendx);
-      linendx--; //  start looking on comment line before segment
-         // a_line = g_ptr_array_index(all_lines, linendx);
-         // printf("(%s) First line of next segment: |%s|, linendx=%d\n", __func__, a_line, linendx);
-#define MAX_TAG_SIZE 40
-      char tagbuf[MAX_TAG_SIZE];
-      tagbuf[0] = '\0';
-
-      // cast to avoid warning re loss of sign in implicit conversion
-      // signed int is more than ample to hold number of lines
-      int linect = all_lines->len;
-      while (linendx < linect) {
-            //printf("(%s) Before find_next_segment_start(), linendx=%d: |%s|\n",
-            //       __func__, linendx, (char *) g_ptr_array_index(all_lines, linendx));
-         linendx = find_next_segment_start(all_lines, linendx, tagbuf);
-            // printf("(%s) Next segment starts at line %d: |%s|\n",
-            //        __func__, linendx, (char *) g_ptr_array_index(all_lines, linendx));
-         if (linendx >= linect)
-            break;
-
-         if ( streq(tagbuf,"HID") ) {
-            hid_descriptor_types = create_simple_id_table(0);
-            load_simple_id_segment(hid_descriptor_types, all_lines, tagbuf, linendx, &linendx);
-            if (debug) {
-               printf("(%s) After processing tag HID, linendx=%d\n", __func__, linendx);
-               rpt_title("hid_descriptor_types: ", 0);
-               report_simple_id_table(hid_descriptor_types, 1);
-            }
-         }
-         else if ( streq(tagbuf,"R") ) {
-             hid_descriptor_item_types = create_simple_id_table(0);
-             load_simple_id_segment(hid_descriptor_item_types, all_lines, tagbuf, linendx, &linendx);
-             if (debug) {
-                printf("(%s) After processing tag R, linendx=%d\n", __func__, linendx);
-                rpt_title("hid_descriptor_item_types: ", 0);
-                report_simple_id_table(hid_descriptor_item_types, 1);
-             }
-          }
-         else if ( streq(tagbuf,"HCC") ) {
-             hid_country_codes = create_simple_id_table(0);
-             load_simple_id_segment(hid_country_codes, all_lines, tagbuf, linendx, &linendx);
-             if (debug) {
-                printf("(%s) After HCC, linendx=%d\n", __func__, linendx);
-                rpt_title("hid_country_codes: ", 0);
-                report_simple_id_table(hid_country_codes, 1);
-             }
-          }
-
-          else if ( streq(tagbuf,"HUT") ) {
-#ifdef OLD
-             hid_usages_table = mlm_create(
-                                                    hid_usages_table0.table_name,
-                                                    hid_usages_table0.levels,
-                                                    hid_usages_table0.level_detail);
-#endif
-             MLM_Level hut_level_desc[] = {
-                   {"usage page", 20, 0},
-                   {"usage_id",   20, 0}
-             };
-
-             hid_usages_table = mlm_create(
-                                  "HUT",
-                                  2,
-                                  hut_level_desc);
-
-
-             load_multi_level_segment(hid_usages_table, tagbuf, all_lines, &linendx);
-                // printf("(%s) After HUT, linendx=%d\n", __func__, linendx);
-                // rpt_title("usages table: ", 0);
-                // report_multi_level_table(hid_usages_table, 1);
-          }
+
+/* Finds the first id line with the specified number of leading tabs
+ * that starts at or after pos and before limit.
+ *
+ * Returns:  offset of line, >= limit if not found
+ */
+static size_t
+find_id_line(Devid_Id_File * idf, size_t pos, size_t limit, int tabct, int * id_loc) {
+   while (pos < limit) {
+      int ct;
+      int id = parse_line_id(idf, pos, &ct);
+      if (id >= 0 && ct == tabct) {
+         *id_loc = id;
+         break;
       }
+      pos = next_line(idf, pos);
    }
+   return pos;
+}
 
-   if (debug)
-      printf("(%s) Done.  id_type=%d\n", __func__, id_type);
+
+/* Returns the end of the block of child lines of the id line at pos,
+ * i.e. the offset of the next id line with no more leading tabs.
+ */
+static size_t
+find_block_end(Devid_Id_File * idf, size_t pos, int tabct) {
+   pos = next_line(idf, pos);
+   while (pos < idf->ids_end) {
+      int ct;
+      if (parse_line_id(idf, pos, &ct) >= 0 && ct <= tabct)
+         break;
+      pos = next_line(idf, pos);
+   }
+   return pos;
 }
 
 
-/* Locates a pci.ids or usb.ids file and loads its contents into internal tables.
+/* Locates the id line for a device, subsystem, or interface within the
+ * block of lines [lo,hi) for its parent.
+ *
+ * Entries are sorted by id in the files as distributed, so the block is
+ * binary searched.  In case a locally modified file is not sorted, the
+ * block is scanned linearly if the search fails.
  *
  * Arguments:
- *    id_type
+ *    idf     mapped file
+ *    lo      offset of first line of block
+ *    hi      end of block
+ *    tabct   number of leading tabs of lines sought
+ *    id      id sought
  *
- * Returns:    nothing
+ * Returns:   offset of line, -1 if not found
+ */
+static ssize_t
+find_child_line(Devid_Id_File * idf, size_t lo, size_t hi, int tabct, int id) {
+   size_t block_start = lo;
+   int cur_id;
+   while (lo < hi) {
+      size_t mid = lo + (hi-lo)/2;
+      size_t pos = mid;
+      if (pos > lo && idf->data[pos-1] != '\n')
+         pos = next_line(idf, pos);
+      pos = find_id_line(idf, pos, hi, tabct, &cur_id);
+      if (pos >= hi)
+         hi = mid;
+      else if (cur_id == id)
+         return pos;
+      else if (cur_id < id)
+         lo = next_line(idf, pos);
+      else
+         hi = mid;
+   }
+
+   for (size_t pos = find_id_line(idf, block_start, hi, tabct, &cur_id);
+        pos < idf->ids_end && pos < hi;
+        pos = find_id_line(idf, next_line(idf, pos), hi, tabct, &cur_id))
+   {
+      if (cur_id == id)
+         return pos;
+   }
+   return -1;
+}
+
+
+static int
+vendor_index_compare(const void * a, const void * b) {
+   const Devid_Vendor_Index_Entry * ea = a;
+   const Devid_Vendor_Index_Entry * eb = b;
+   return (int) ea->id - (int) eb->id;
+}
+
+
+/** Header of a cached vendor index file. */
+typedef struct {
+   char      magic[8];
+   uint64_t  file_size;     ///< size of indexed pci.ids or usb.ids
+   int64_t   file_mtime;    ///< modification time of indexed file
+   uint32_t  ids_end;
+   uint32_t  vendor_ct;
+} Devid_Index_Header;
+
+#define DEVID_INDEX_MAGIC "DEVIDX1"
+
+
+static char *
+index_file_name(Device_Id_Type id_type) {
+   char simple_fn[40];
+   snprintf(simple_fn, sizeof(simple_fn), "%s.idx", simple_device_fn[id_type]);
+   return xdg_cache_home_file("ddcutil", simple_fn);
+}
+
+
+/* Checks that each vendor line offset lies within the id section and
+ * that the entries are sorted by vendor id, as the binary search requires.
  */
-static void load_id_file(Device_Id_Type id_type){
+static bool
+vendor_index_is_valid(Devid_Vendor_Index_Entry * vendors, uint32_t vendor_ct, uint32_t ids_end) {
+   for (uint32_t ndx = 0; ndx < vendor_ct; ndx++) {
+      if (vendors[ndx].offset >= ids_end)
+         return false;
+      if (ndx > 0 && vendors[ndx-1].id > vendors[ndx].id)
+         return false;
+   }
+   return true;
+}
+
+
+/* Loads the vendor index from the cache file, if it exists, was
+ * built from the current pci.ids or usb.ids file, and is consistent.
+ */
+static bool
+load_vendor_index(Device_Id_Type id_type, Devid_Id_File * idf) {
    bool debug = false;
+   bool ok = false;
+   char * fn = index_file_name(id_type);
+   FILE * fp = (fn) ? fopen(fn, "r") : NULL;
+   if (fp) {
+      Devid_Index_Header hdr;
+      if (fread(&hdr, sizeof(hdr), 1, fp) == 1           &&
+          memcmp(hdr.magic, DEVID_INDEX_MAGIC, 8) == 0   &&
+          hdr.file_size  == idf->size                    &&
+          hdr.file_mtime == idf->mtime                   &&
+          hdr.ids_end    <= idf->size                    &&
+          hdr.vendor_ct  <= 0x10000)
+      {
+         idf->vendors = calloc(hdr.vendor_ct+1, sizeof(Devid_Vendor_Index_Entry));
+         if (fread(idf->vendors, sizeof(Devid_Vendor_Index_Entry), hdr.vendor_ct, fp) == hdr.vendor_ct &&
+             vendor_index_is_valid(idf->vendors, hdr.vendor_ct, hdr.ids_end))
+         {
+            idf->ids_end   = hdr.ids_end;
+            idf->vendor_ct = hdr.vendor_ct;
+            ok = true;
+         }
+         else {
+            free(idf->vendors);
+            idf->vendors = NULL;
+         }
+      }
+      fclose(fp);
+   }
    if (debug)
-      printf("(%s) id_type=%d\n", __func__, id_type);
+      printf("(%s) fn=%s, returning %s\n", __func__, fn, sbool(ok));
+   free(fn);
+   return ok;
+}
 
-   char * device_id_fqfn = devid_find_file(id_type);
-   if (device_id_fqfn) {
-      // char device_id_fqfn[MAX_PATH];
-      // snprintf(device_id_fqfn, MAX_PATH, id_fqfn, id_fn);  // ???
-      if (debug)
-         printf("(%s) device_id_fqfn = %s\n", __func__, device_id_fqfn);
-
-      GPtrArray * all_lines = g_ptr_array_sized_new(30000);
-      int linect = file_getlines(device_id_fqfn, all_lines, true);
-      if (linect > 0) {
-         load_file_lines(id_type, all_lines);
-      }       // if (all_lines)
-      // to do: call
-
-      g_ptr_array_set_free_func(all_lines, g_free);
-      g_ptr_array_free(all_lines, true);
-      free(device_id_fqfn);
-   }          // if pci.ids or usb.ids was found
-   else {
-      if (debug)
-         printf("(%s) File not found, creating dummy mlm", __func__);
-      if (id_type == ID_TYPE_PCI) {
-         MLM_Level pci_id_levels[] = {
-               {"vendor",   10000, 0},
-               {"device",      20, 0},
-               {"subsystem",    5, 0}
-         };
-          pci_vendors_mlm = mlm_create("PCI Devices", 3, pci_id_levels);
+
+/* Saves the vendor index to the cache file.  Failure is not an error,
+ * the index will simply be rebuilt next time.
+ */
+static void
+save_vendor_index(Device_Id_Type id_type, Devid_Id_File * idf) {
+   char * fn = index_file_name(id_type);
+   if (fn) {
+      char * tmpfn = g_strdup_printf("%s.%d", fn, getpid());
+      FILE * fp = NULL;
+      fopen_mkdir(tmpfn, "w", NULL, &fp);
+      if (fp) {
+         Devid_Index_Header hdr = {{0}};
+         memcpy(hdr.magic, DEVID_INDEX_MAGIC, 8);
+         hdr.file_size  = idf->size;
+         hdr.file_mtime = idf->mtime;
+         hdr.ids_end    = idf->ids_end;
+         hdr.vendor_ct  = idf->vendor_ct;
+         bool ok = fwrite(&hdr, sizeof(hdr), 1, fp) == 1 &&
+                   fwrite(idf->vendors, sizeof(Devid_Vendor_Index_Entry), idf->vendor_ct, fp) == idf->vendor_ct;
+         ok = (fclose(fp) == 0) && ok;
+         if (!ok || rename(tmpfn, fn) < 0)
+            unlink(tmpfn);
       }
-      else {
-         MLM_Level usb_id_levels[] = {
-               {"vendor", 5000, 0},
-               {"product",  20, 0},
-               {"interface", 10, 0}
-         };
-         usb_vendors_mlm = mlm_create("USB Devices", 3, usb_id_levels);
+      g_free(tmpfn);
+      free(fn);
+   }
+}
+
+
+/* Scans the mapped file to build the vendor index. */
+static void
+build_vendor_index(Devid_Id_File * idf) {
+   // The vendor/device/subsystem section ends at the first class ("C") line.
+   // (In usb.ids, it is followed by segments for HID descriptors etc.)
+   idf->ids_end = idf->size;
+   const char * c_line = g_strstr_len(idf->data, idf->size, "\nC ");
+   if (c_line)
+      idf->ids_end = (c_line - idf->data) + 1;
+
+   GArray * vendors = g_array_sized_new(false, false, sizeof(Devid_Vendor_Index_Entry), 3000);
+   int id;
+   for (size_t pos = find_id_line(idf, 0, idf->ids_end, 0, &id);
+        pos < idf->ids_end;
+        pos = find_id_line(idf, next_line(idf, pos), idf->ids_end, 0, &id))
+   {
+      Devid_Vendor_Index_Entry entry = {.id = id, .offset = pos};
+      g_array_append_val(vendors, entry);
+   }
+   qsort(vendors->data, vendors->len, sizeof(Devid_Vendor_Index_Entry), vendor_index_compare);
+   idf->vendor_ct = vendors->len;
+   idf->vendors = (Devid_Vendor_Index_Entry *) g_array_free(vendors, false);
+}
+
+
+/* Locates and maps a pci.ids or usb.ids file, and loads or builds
+ * its vendor index.  Must be called with devid_mutex locked.
+ */
+static Devid_Id_File *
+get_id_file(Device_Id_Type id_type) {
+   bool debug = false;
+   Devid_Id_File * idf = &id_files[id_type];
+   if (!idf->load_attempted) {
+      idf->load_attempted = true;
+      idf->names = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+      char * device_id_fqfn = devid_find_file(id_type);
+      if (device_id_fqfn) {
+         int fd = open(device_id_fqfn, O_RDONLY);
+         struct stat stat_buf;
+         if (fd >= 0 && fstat(fd, &stat_buf) == 0 && stat_buf.st_size > 0 && stat_buf.st_size < UINT32_MAX) {
+            void * data = mmap(NULL, stat_buf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+               idf->data  = data;
+               idf->size  = stat_buf.st_size;
+               idf->mtime = stat_buf.st_mtime;
+            }
+         }
+         if (fd >= 0)
+            close(fd);
+         if (idf->data && !load_vendor_index(id_type, idf)) {
+            build_vendor_index(idf);
+            save_vendor_index(id_type, idf);
+         }
+         free(device_id_fqfn);
       }
+      if (debug)
+         printf("(%s) id_type=%d, data=%p, size=%zu, ids_end=%zu, vendor_ct=%u\n",
+                __func__, id_type, idf->data, idf->size, idf->ids_end, idf->vendor_ct);
    }
+   return idf;
+}
 
-   if (debug)
-      printf("(%s) Done. pci_vendors_mlm=%p, usb_vendors_mlm=%p\n",
-             __func__, pci_vendors_mlm, usb_vendors_mlm);
-   return;
+
+/* Returns the name on an id line, i.e. the text following the
+ * leading tabs and fieldct hex id fields.
+ *
+ * The returned value is owned by the Devid_Id_File.
+ */
+static char *
+get_line_name(Devid_Id_File * idf, size_t pos, int fieldct) {
+   gpointer key = GSIZE_TO_POINTER(pos+1);
+   char * name = g_hash_table_lookup(idf->names, key);
+   if (!name) {
+      size_t end = next_line(idf, pos);
+      while (pos < end && idf->data[pos] == '\t')
+         pos++;
+      for (int ndx = 0; ndx < fieldct; ndx++) {
+         while (pos < end && g_ascii_isxdigit(idf->data[pos]))
+            pos++;
+         while (pos < end && (idf->data[pos] == ' ' || idf->data[pos] == '\t'))
+            pos++;
+      }
+      while (end > pos && g_ascii_isspace(idf->data[end-1]))
+         end--;
+      name = g_strndup(idf->data+pos, end-pos);
+      g_hash_table_insert(idf->names, key, name);
+   }
+   return name;
 }
 
 
-//
-// Internal Report Functions
-//
+/* Returns the offset of the line for a vendor, -1 if not found */
+static ssize_t
+find_vendor_line(Devid_Id_File * idf, ushort vendor_id) {
+   Devid_Vendor_Index_Entry key = {.id = vendor_id};
+   Devid_Vendor_Index_Entry * entry = NULL;
+   if (idf->vendors)
+      entry = bsearch(&key, idf->vendors, idf->vendor_ct,
+                      sizeof(Devid_Vendor_Index_Entry), vendor_index_compare);
+   return (entry) ? (ssize_t) entry->offset : -1;
+}
+
 
-/* Reports a device id table.
+/* Looks up the names for up to 3 levels of ids.
  *
  * Arguments:
- *    id_type
+ *    id_type     ID_TYPE_PCI or ID_TYPE_USB
+ *    levelct     number of ids
+ *    ids         ids, for the third PCI level the subvendor id
+ *                is in the upper 16 bits and the subdevice id in
+ *                the lower 16 bits
+ *    names       set to the names found
  *
- * Returns:    nothing
+ * Returns:       number of levels found
+ *
+ * Must be called with devid_mutex locked.
  */
-void report_device_ids_mlm(Device_Id_Type id_type) {
-   Multi_Level_Map * all_devices = (id_type == ID_TYPE_PCI) ? pci_vendors_mlm : usb_vendors_mlm;
-   GPtrArray * top_level_nodes = all_devices->root;
-   int total_vendors = 0;
-   int total_devices = 0;
-   int total_subsys  = 0;
-   int vctr, dctr, sctr;
-   MLM_Node * cur_vendor;
-   MLM_Node * cur_device;
-   MLM_Node * cur_subsys;
-   for (vctr=0; vctr < top_level_nodes->len; vctr++) {
-      total_vendors++;
-      cur_vendor = g_ptr_array_index(top_level_nodes, vctr);
-      printf("%04x %s\n", cur_vendor->code, cur_vendor->name);
-      if (cur_vendor->children) {
-         for (dctr=0; dctr<cur_vendor->children->len; dctr++) {
-            total_devices++;
-            cur_device = g_ptr_array_index(cur_vendor->children, dctr);
-            printf("\t%04x %s\n", cur_device->code, cur_device->name);
-            if (cur_device->children) {
-               for (sctr=0; sctr<cur_device->children->len; sctr++) {
-                  total_subsys++;
-                  cur_subsys = g_ptr_array_index(cur_device->children, sctr);
-                  if (id_type == ID_TYPE_PCI)
-                     printf("\t\t%04x %04x %s\n",
-                            cur_subsys->code>>16, cur_subsys->code&0xffff, cur_subsys->name);
-                  else
-                     printf("\t\t%04x %s\n",
-                            cur_subsys->code, cur_subsys->name);
+static int
+devid_get_names(Device_Id_Type id_type, int levelct, uint * ids, char ** names) {
+   Devid_Id_File * idf = get_id_file(id_type);
+   int found = 0;
+   if (!idf->data)
+      return 0;
+
+   ssize_t pos = find_vendor_line(idf, ids[0]);
+   if (pos >= 0) {
+      names[found++] = get_line_name(idf, pos, 1);
+      if (levelct > 1) {
+         size_t block_end = find_block_end(idf, pos, 0);
+         pos = find_child_line(idf, next_line(idf, pos), block_end, 1, ids[1]);
+         if (pos >= 0) {
+            names[found++] = get_line_name(idf, pos, 1);
+            if (levelct > 2) {
+               block_end = find_block_end(idf, pos, 1);
+               size_t cur = next_line(idf, pos);
+               int cur_id;
+               // subsystem and interface blocks are short, and pci.ids
+               // subsystem lines are not reliably sorted, so scan linearly
+               for (cur = find_id_line(idf, cur, block_end, 2, &cur_id);
+                    cur < block_end;
+                    cur = find_id_line(idf, next_line(idf, cur), block_end, 2, &cur_id))
+               {
+                  if (id_type == ID_TYPE_PCI) {
+                     // line is: subvendor subdevice name
+                     size_t subdev_pos = cur + 2 + 4;
+                     while (subdev_pos < block_end && idf->data[subdev_pos] == ' ')
+                        subdev_pos++;
+                     int subdev_id = parse_hex4(idf, subdev_pos);
+                     if (subdev_id >= 0 && (uint) (cur_id << 16 | subdev_id) == ids[2])
+                     {
+                        names[found++] = get_line_name(idf, cur, 2);
+                        break;
+                     }
+                  }
+                  else if ((uint) cur_id == ids[2]) {
+                     names[found++] = get_line_name(idf, cur, 1);
+                     break;
+                  }
                }
             }
          }
       }
    }
-   char * level3_name = (id_type == ID_TYPE_PCI) ? "subsystems" : "interfaces";
-   printf("(%s) Total vendors: %d, total devices: %d, total %s: %d\n",
-          __func__, total_vendors, total_devices, level3_name, total_subsys);
+   return found;
+}
+
+
+/* Loads the HID related segments of usb.ids, which follow the
+ * vendor/device/interface section.  These are small, so are parsed
+ * into tables.  Must be called with devid_mutex locked.
+ */
+static void
+ensure_hid_tables_loaded() {
+   bool debug = false;
+   if (hid_tables_loaded)
+      return;
+   hid_tables_loaded = true;
+
+   Devid_Id_File * idf = get_id_file(ID_TYPE_USB);
+   if (!idf->data)
+      return;
+
+   GPtrArray * all_lines = g_ptr_array_sized_new(2000);
+   g_ptr_array_set_free_func(all_lines, g_free);
+   for (size_t pos = idf->ids_end; pos < idf->size; ) {
+      const char * nl = memchr(idf->data+pos, '\n', idf->size-pos);
+      size_t end = (nl) ? (size_t) (nl - idf->data) : idf->size;
+      g_ptr_array_add(all_lines, g_strndup(idf->data+pos, end-pos));
+      pos = end+1;
+   }
+
+   int linendx = 0;
+#define MAX_TAG_SIZE 40
+   char tagbuf[MAX_TAG_SIZE];
+   tagbuf[0] = '\0';
+
+   // cast to avoid warning re loss of sign in implicit conversion
+   // signed int is more than ample to hold number of lines
+   int linect = all_lines->len;
+   while (linendx < linect) {
+      linendx = find_next_segment_start(all_lines, linendx, tagbuf);
+      if (linendx >= linect)
+         break;
+
+      if ( streq(tagbuf,"HID") ) {
+         hid_descriptor_types = create_simple_id_table(0);
+         load_simple_id_segment(hid_descriptor_types, all_lines, tagbuf, linendx, &linendx);
+         if (debug) {
+            printf("(%s) After processing tag HID, linendx=%d\n", __func__, linendx);
+            rpt_title("hid_descriptor_types: ", 0);
+            report_simple_id_table(hid_descriptor_types, 1);
+         }
+      }
+      else if ( streq(tagbuf,"R") ) {
+         hid_descriptor_item_types = create_simple_id_table(0);
+         load_simple_id_segment(hid_descriptor_item_types, all_lines, tagbuf, linendx, &linendx);
+         if (debug) {
+            printf("(%s) After processing tag R, linendx=%d\n", __func__, linendx);
+            rpt_title("hid_descriptor_item_types: ", 0);
+            report_simple_id_table(hid_descriptor_item_types, 1);
+         }
+      }
+      else if ( streq(tagbuf,"HCC") ) {
+         hid_country_codes = create_simple_id_table(0);
+         load_simple_id_segment(hid_country_codes, all_lines, tagbuf, linendx, &linendx);
+         if (debug) {
+            printf("(%s) After HCC, linendx=%d\n", __func__, linendx);
+            rpt_title("hid_country_codes: ", 0);
+            report_simple_id_table(hid_country_codes, 1);
+         }
+      }
+      else if ( streq(tagbuf,"HUT") ) {
+         MLM_Level hut_level_desc[] = {
+               {"usage page", 20, 0},
+               {"usage_id",   20, 0}
+         };
+         hid_usages_table = mlm_create("HUT", 2, hut_level_desc);
+         load_multi_level_segment(hid_usages_table, tagbuf, all_lines, &linendx);
+      }
+   }
+
+   g_ptr_array_free(all_lines, true);
+   if (debug)
+      printf("(%s) Done.\n", __func__);
 }
 
 
@@ -824,22 +972,24 @@ Pci_Usb_Id_Names devid_get_pci_names(
              vendor_id, device_id, subvendor_id, subdevice_id);
    }
    assert( argct==1 || argct==2 || argct==4);
-   devid_ensure_initialized();
    uint ids[3] = {vendor_id, device_id, subvendor_id << 16 | subdevice_id};   // only diff from usb_id_get_names
    int levelct = (argct == 4) ? 3 : argct;              // also this
-   Multi_Level_Names mlm_names =  mlm_get_names2(pci_vendors_mlm, levelct, ids);  // and this
-   Pci_Usb_Id_Names names2;
-   names2.vendor_name = mlm_names.names[0];
-   names2.device_name = mlm_names.names[1];
-   names2.subsys_or_interface_name = mlm_names.names[2];
-   if (levelct == 3 && mlm_names.levels == 2) {
+   char * names[3] = {NULL};
+   g_mutex_lock(&devid_mutex);
+   int found = devid_get_names(ID_TYPE_PCI, levelct, ids, names);
+   if (levelct == 3 && found == 2) {
       // couldn't find the subsystem, see if at least we can look up the subsystem vendor
       uint ids[1] = {subvendor_id};
-      Multi_Level_Names mlm_names3 = mlm_get_names2(pci_vendors_mlm, 1, ids);
-      if (mlm_names3.levels == 1) {
-         names2.subsys_or_interface_name = mlm_names3.names[0];
+      char * names3[1] = {NULL};
+      if (devid_get_names(ID_TYPE_PCI, 1, ids, names3) == 1) {
+         names[2] = names3[0];
       }
    }
+   g_mutex_unlock(&devid_mutex);
+   Pci_Usb_Id_Names names2;
+   names2.vendor_name = names[0];
+   names2.device_name = names[1];
+   names2.subsys_or_interface_name = names[2];
 
    if (debug) {
       printf("(%s) names2: vendor_name=%s, device_name=%s, subsys_or_interface_name=%s\n",
@@ -875,13 +1025,15 @@ Pci_Usb_Id_Names devid_get_usb_names(
              vendor_id, device_id, interface_id);
    }
    assert( argct==1 || argct==2 || argct==3);
-   devid_ensure_initialized();
    uint ids[3] = {vendor_id, device_id, interface_id};
-   Multi_Level_Names mlm_names =  mlm_get_names2(usb_vendors_mlm, argct, ids);
+   char * names[3] = {NULL};
+   g_mutex_lock(&devid_mutex);
+   devid_get_names(ID_TYPE_USB, argct, ids, names);
+   g_mutex_unlock(&devid_mutex);
    Pci_Usb_Id_Names names2;
-   names2.vendor_name = mlm_names.names[0];
-   names2.device_name = mlm_names.names[1];
-   names2.subsys_or_interface_name = mlm_names.names[2];
+   names2.vendor_name = names[0];
+   names2.device_name = names[1];
+   names2.subsys_or_interface_name = names[2];
 
    if (debug) {
       printf("(%s) names2: vendor_name=%s, device_name=%s, subsys_or_interface_name=%s\n",
@@ -904,7 +1056,6 @@ Pci_Usb_Id_Names devid_get_usb_names(
  * - Corresponds to names_huts() in names.c
  */
 char * devid_usage_code_page_name(ushort usage_page_code) {
-   devid_ensure_initialized();
    // Per USB HID Usage Tables spec v1.12, section 3.0,
    // Usage page ID xff00..xffff are vendor defined
    //               x0092..xfeff are reserved
@@ -919,9 +1070,14 @@ char * devid_usage_code_page_name(ushort usage_page_code) {
       result = "Vendor-defined";
    else {
       // ushort * args = {usage_page_code};
-      Multi_Level_Names names_found = mlm_get_names(hid_usages_table, /*argct=*/ 1, usage_page_code);
-      if (names_found.levels == 1)
-         result = names_found.names[0];
+      g_mutex_lock(&devid_mutex);
+      ensure_hid_tables_loaded();
+      if (hid_usages_table) {
+         Multi_Level_Names names_found = mlm_get_names(hid_usages_table, /*argct=*/ 1, usage_page_code);
+         if (names_found.levels == 1)
+            result = names_found.names[0];
+      }
+      g_mutex_unlock(&devid_mutex);
    }
    return result;
 }
@@ -945,7 +1101,6 @@ char * devid_usage_code_id_name(ushort usage_page_code, ushort usage_simple_id)
       printf("(%s) usage_page_code=0x%04x, usage_simple_id=0x%04x\n",
              __func__, usage_page_code, usage_simple_id);
    }
-   devid_ensure_initialized();
    char * result = NULL;
    if (usage_page_code == 0x81) {
       snprintf(resultbuf, 11, "ENUM_%d", usage_simple_id);
@@ -953,9 +1108,14 @@ char * devid_usage_code_id_name(ushort usage_page_code, ushort usage_simple_id)
    }
    else {
       // ushort * args = {usage_page_code, usage_simple_id};
-      Multi_Level_Names names_found = mlm_get_names(hid_usages_table, 2, usage_page_code, usage_simple_id);
-      if (names_found.levels == 2)
-         result = names_found.names[1];
+      g_mutex_lock(&devid_mutex);
+      ensure_hid_tables_loaded();
+      if (hid_usages_table) {
+         Multi_Level_Names names_found = mlm_get_names(hid_usages_table, 2, usage_page_code, usage_simple_id);
+         if (names_found.levels == 2)
+            result = names_found.names[1];
+      }
+      g_mutex_unlock(&devid_mutex);
    }
    return result;
 }
@@ -986,26 +1146,35 @@ char * devid_usage_code_name_by_extended_id(uint32_t extended_usage) {
  * - This function corresponds to names.c function names_reporttag()
  */
 char * devid_hid_descriptor_item_type(ushort id) {
-   devid_ensure_initialized();
    char * result = NULL;
-   result = get_simple_id_name(hid_descriptor_item_types, id);
+   g_mutex_lock(&devid_mutex);
+   ensure_hid_tables_loaded();
+   if (hid_descriptor_item_types)
+      result = get_simple_id_name(hid_descriptor_item_types, id);
+   g_mutex_unlock(&devid_mutex);
    return result;
 }
 
 
 // not used, but without this valgrind complains of memory leak
 char * devid_hid_descriptor_type(ushort id) {
-   devid_ensure_initialized();
    char * result = NULL;
-   result = get_simple_id_name(hid_descriptor_types, id);
+   g_mutex_lock(&devid_mutex);
+   ensure_hid_tables_loaded();
+   if (hid_descriptor_types)
+      result = get_simple_id_name(hid_descriptor_types, id);
+   g_mutex_unlock(&devid_mutex);
    return result;
 }
 
 // not used, but without this valgrind complains of memory leak
 char * devid_hid_descriptor_country_code(ushort id) {
-   devid_ensure_initialized();
    char * result = NULL;
-   result = get_simple_id_name(hid_country_codes, id);
+   g_mutex_lock(&devid_mutex);
+   ensure_hid_tables_loaded();
+   if (hid_country_codes)
+      result = get_simple_id_name(hid_country_codes, id);
+   g_mutex_unlock(&devid_mutex);
    return result;
 }
 
@@ -1014,29 +1183,20 @@ char * devid_hid_descriptor_country_code(ushort id) {
 // *** Initialization ***
 //
 
-/** Initializes the PCI and USB id tables.
- *  If the tables are already initialized, does nothing.
+/** Locates and maps the PCI and USB id files.
+ *  If already done, does nothing.
+ *
+ *  @remark
+ *  Names are looked up on demand, so this is not required before
+ *  calling the lookup functions.
  */
 bool devid_ensure_initialized() {
    bool debug = false;
-   if (debug)
-      printf("(%s) Starting. pci_vendors_mlm=%p, usb_vendors_mlm=%p\n",
-             __func__, pci_vendors_mlm, usb_vendors_mlm);
-   bool ok = (pci_vendors_mlm && usb_vendors_mlm);
-
-   if (!ok) {
-      if (debug)
-         printf("(%s) Loading.\n", __func__);
-      load_id_file(ID_TYPE_PCI);
-      load_id_file(ID_TYPE_USB);
-      ok = true;
-      if (ok && debug) {
-         // report_device_ids(ID_TYPE_PCI);
-         // report_device_ids_mlm(ID_TYPE_PCI);
-         // report_device_ids(ID_TYPE_USB);
-         // report_device_ids_mlm(ID_TYPE_USB);
-      }
-   }
+   g_mutex_lock(&devid_mutex);
+   get_id_file(ID_TYPE_PCI);
+   get_id_file(ID_TYPE_USB);
+   g_mutex_unlock(&devid_mutex);
+   bool ok = true;
    if (debug)
       printf("(%s) Returning: %s\n", __func__, sbool(ok));
    return ok;
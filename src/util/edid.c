@@ -55,6 +55,18 @@ Byte edid_checksum(Byte * edid) {
    return checksum;
 }
 
+/* Calculates a hash of a 128 byte EDID (32 bit FNV-1a), e.g. for use as
+ * a key in files that hold data for multiple monitors.
+ */
+uint32_t edid_fnv1a_hash(const Byte * edid) {
+   uint32_t hash = 2166136261u;
+   for (int ndx = 0; ndx < 128; ndx++) {
+      hash ^= edid[ndx];
+      hash *= 16777619u;
+   }
+   return hash;
+}
+
 bool is_valid_edid_checksum(Byte * edidbytes) {
    return (edid_checksum(edidbytes) == 0);
 }
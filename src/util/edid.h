@@ -34,6 +34,9 @@
 //Calculates checksum for a 128 byte EDID
 Byte edid_checksum(Byte * edid);
 
+// Calculates a hash of a 128 byte EDID
+uint32_t edid_fnv1a_hash(const Byte * edid);
+
 bool is_valid_edid_checksum(Byte * edidbytes);
 bool is_valid_edid_header(Byte * edidbytes);
 bool is_valid_raw_edid(Byte * edidbytes, int len);
@@ -44,6 +44,8 @@ void fsim_set_name_to_number_funcs(
 // singleton failure simulation table
 static GHashTable * fst = NULL;
 
+static bool report_simulated_failures = true;
+
 
 // Describes a call occurrence for which an error is to be simulated
 typedef struct fsim_call_occ_rec {
@@ -224,6 +226,20 @@ void fsim_clear_errors_for_func(char * funcname) {
 }
 
 
+/** Controls whether each simulated failure is reported, with a backtrace.
+ *  Reports are normally wanted, but distort timing when many failures are
+ *  simulated.
+ *
+ *  @param  onoff  new setting
+ *  @return prior setting
+ */
+bool fsim_enable_failure_reports(bool onoff) {
+   bool old = report_simulated_failures;
+   report_simulated_failures = onoff;
+   return old;
+}
+
+
 /* Clears the entire failure simulation table.
  */
 void fsim_clear_error_table() {
@@ -362,7 +378,8 @@ bool fsim_load_control_from_gptrarray(GPtrArray * lines) {
    }
 
    bool ok = true;
-   fst = g_hash_table_new(g_str_hash, g_str_equal);
+   fsim_clear_error_table();
+   fsim_get_or_create_failsim_table();
    for (int ndx = 0; ndx < lines->len; ndx++) {
       char * aline = g_ptr_array_index(lines, ndx);
       if (debug)
@@ -502,7 +519,7 @@ Failsim_Result fsim_check_failure(const char * fn, const char * funcname) {
                }
             }
          }
-         if (result.force_failure) {
+         if (result.force_failure && report_simulated_failures) {
             printf("Simulating failure for call %d of function %s, returning %d\n",
                    frec->callct, funcname, result.failure_value);
             // printf("Call stack:\n");
@@ -46,6 +46,7 @@ void fsim_clear_errors_for_func(char * funcname);
 void fsim_clear_error_table();
 void fsim_report_error_table(int depth);
 void fsim_reset_callct(char * funcname);
+bool fsim_enable_failure_reports(bool onoff);
 
 
 //
@@ -202,7 +202,7 @@ read_binary_file(
 
    // DBGMSG("fn=%s", fn);
 
-   Byte  buf[1];
+   Byte  buf[4096];
 
    GByteArray * gbarray = NULL;
 
@@ -220,10 +220,8 @@ read_binary_file(
    else
       gbarray = g_byte_array_sized_new(est_size);
 
-   // TODO: read bigger hunks
    size_t ct = 0;
-   while ( (ct = fread(buf, /*size*/ 1, /*nmemb*/ 1, fp) ) > 0) {
-      assert(ct == 1);
+   while ( (ct = fread(buf, /*size*/ 1, /*nmemb*/ sizeof(buf), fp) ) > 0) {
       g_byte_array_append(gbarray, buf, ct);
    }
    fclose(fp);
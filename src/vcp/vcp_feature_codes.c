@@ -2676,6 +2676,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
               "used to change and save (or autosave) a new value.",
       .v20_flags = DDCA_RW | DDCA_COMPLEX_NC,
       .v20_name = "New control value",
+      .cache_ttl_millisec = VCP_CACHE_VOLATILE,
    },
    {  .code=0x03,                        // defined in 2.0, identical in 3.0
       .vcp_spec_groups = VCP_SPEC_MISC,
@@ -3146,6 +3147,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .desc= "Read id of one feature that has changed, 0x00 indicates no more",  // my desc
       .v20_flags = DDCA_RO |  DDCA_COMPLEX_NC,
       .v20_name  = "Active control",
+      .cache_ttl_millisec = VCP_CACHE_VOLATILE,
    },
    {  .code= 0x54,
       .vcp_spec_groups = VCP_SPEC_MISC,
@@ -3253,7 +3255,8 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .v20_flags =  DDCA_RW | DDCA_SIMPLE_NC,
       .v20_name = "Input Source",
       .v30_flags = DDCA_RW | DDCA_NORMAL_TABLE,
-      .v22_flags = DDCA_RW | DDCA_SIMPLE_NC
+      .v22_flags = DDCA_RW | DDCA_SIMPLE_NC,
+      .cache_ttl_millisec = 1000,       // display may switch to an active input on its own
    },
    {  .code=0x62,
       .vcp_spec_groups = VCP_SPEC_AUDIO,
@@ -3812,6 +3815,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       // 2.0: 0xff 0xff 0xff indicates the display cannot supply this info
       .v20_flags = DDCA_RO | DDCA_COMPLEX_CONT,
       .v20_name  = "Horizontal frequency",
+      .cache_ttl_millisec = VCP_CACHE_VOLATILE,
    },
    {  .code=0xae,
       .vcp_spec_groups = VCP_SPEC_MISC,   // 2.0
@@ -3821,6 +3825,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       // 2.0: 0xff 0xff indicates the display cannot supply this info
       .v20_flags =DDCA_RO |  DDCA_COMPLEX_CONT,
       .v20_name  = "Vertical frequency",
+      .cache_ttl_millisec = VCP_CACHE_VOLATILE,
    },
    {  .code=0xb0,
       .vcp_spec_groups = VCP_SPEC_PRESET,
@@ -3933,6 +3938,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .desc = "Active power on time in hours",
       .v20_flags =DDCA_RO |  DDCA_COMPLEX_CONT,
       .v20_name = "Display usage time",
+      .cache_ttl_millisec = VCP_CACHE_VOLATILE,
    },
    {  .code=0xc2,
       .vcp_spec_groups = VCP_SPEC_MISC,    // 2.0
@@ -4056,6 +4062,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .desc = "DPM and DPMS status",
       .v20_flags = DDCA_RW | DDCA_SIMPLE_NC,
       .v20_name = "Power mode",
+      .cache_ttl_millisec = 1000,       // display may enter a power saving mode on its own
    },
    {  .code=0xd7,                          // DONE - identical in 2.0, 3.0, 2.2
       .vcp_spec_groups = VCP_SPEC_MISC,    // 2.0, 3.0, 2.2
@@ -4335,6 +4342,7 @@ void dbgrpt_vcp_entry(VCP_Feature_Table_Entry * pfte, int depth) {
    rpt_vstring(d1, "v21_name:          %s", pfte->v21_name);
    rpt_vstring(d1, "v30_name:          %s", pfte->v30_name);
    rpt_vstring(d1, "v22_name:          %s", pfte->v22_name);
+   rpt_vstring(d1, "cache_ttl_millisec: %d", pfte->cache_ttl_millisec);
 //   rpt_vstring(d1, "v20_flags:         0x%04x - %s",
 //                   pfte->v20_flags,
 //                   vcp_interpret_version_feature_flags(pfte->v20_flags, buf, bufsz));
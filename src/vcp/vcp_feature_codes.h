@@ -137,6 +137,11 @@ extern DDCA_Feature_Value_Entry * pxc8_display_controller_type_values;
 // } Version_Specific_Info;
 
 #define VCP_FEATURE_TABLE_ENTRY_MARKER "VFTE"
+
+// Values for VCP_Feature_Table_Entry.cache_ttl_millisec
+#define VCP_CACHE_TTL_DEFAULT     0      ///< cached values use the default time to live
+#define VCP_CACHE_VOLATILE       -1      ///< value changes independently of writes, never cached
+
 typedef
 struct {
    char                                  marker[4];
@@ -160,6 +165,7 @@ struct {
    DDCA_Feature_Value_Entry *            v21_sl_values;
    DDCA_Feature_Value_Entry *            v30_sl_values;
    DDCA_Feature_Value_Entry *            v22_sl_values;
+   int                                   cache_ttl_millisec;  // see ddc_vcp_value_cache.c
 } VCP_Feature_Table_Entry;
 
 void dbgrpt_vcp_entry(VCP_Feature_Table_Entry * pfte, int depth);